@@ -414,15 +414,236 @@ Status validateBSONIterative(Buffer* buffer) {
     return Status::OK();
 }
 
+/**
+ * Width of the value of each BSON type whose value has a fixed size, indexed by the type byte.
+ * Types whose value must be parsed, and invalid types, map to kVariableValueSize.
+ */
+constexpr int8_t kVariableValueSize = -1;
+
+struct FixedValueSizeTable {
+    constexpr FixedValueSizeTable() : sizes() {
+        for (auto& size : sizes) {
+            size = kVariableValueSize;
+        }
+        sizes[static_cast<unsigned char>(MinKey)] = 0;
+        sizes[static_cast<unsigned char>(MaxKey)] = 0;
+        sizes[static_cast<unsigned char>(jstNULL)] = 0;
+        sizes[static_cast<unsigned char>(Undefined)] = 0;
+        sizes[static_cast<unsigned char>(NumberInt)] = sizeof(int32_t);
+        sizes[static_cast<unsigned char>(NumberDouble)] = sizeof(int64_t);
+        sizes[static_cast<unsigned char>(NumberLong)] = sizeof(int64_t);
+        sizes[static_cast<unsigned char>(bsonTimestamp)] = sizeof(int64_t);
+        sizes[static_cast<unsigned char>(Date)] = sizeof(int64_t);
+        sizes[static_cast<unsigned char>(jstOID)] = OID::kOIDSize;
+        sizes[static_cast<unsigned char>(NumberDecimal)] = sizeof(Decimal128::Value);
+    }
+
+    int8_t sizes[256];
+};
+
+constexpr FixedValueSizeTable kFixedValueSizes{};
+
+/**
+ * Objects nested more deeply than this are handed to the full validator. The frames live on the
+ * stack so that validating a typical message does not allocate.
+ */
+constexpr size_t kFastPathMaxFrames = 64;
+
+struct FastPathFrame {
+    uint64_t startPosition;
+    int32_t expectedSize;
+    bool isCodeWithScope;
+};
+
+/**
+ * Accepts exactly the buffers that validateBSONIterative() accepts, except that it gives up on
+ * objects nested deeper than kFastPathMaxFrames. It skips the _id and field name tracking that is
+ * only needed for error messages, and handles fixed-width values with a single table lookup.
+ */
+class FastPathValidator {
+public:
+    FastPathValidator(const char* buffer, uint64_t maxLength)
+        : _buffer(buffer), _maxLength(maxLength) {}
+
+    bool validate() {
+        const uint64_t maxDepth = BSONDepth::getMaxAllowableDepth();
+
+        if (!_beginObject(maxDepth))
+            return false;
+
+        while (true) {
+            if (_position >= _maxLength)
+                return false;
+            const unsigned char type = _buffer[_position++];
+
+            if (type == EOO) {
+                if (!_endFrame())
+                    return false;
+                if (_numFrames == 0)
+                    return true;
+                if (_frames[_numFrames - 1].isCodeWithScope) {
+                    if (!_endFrame() || _numFrames == 0)
+                        return false;
+                }
+                continue;
+            }
+
+            if (!_skipCString())
+                return false;
+
+            const int8_t fixedSize = kFixedValueSizes.sizes[type];
+            if (fixedSize != kVariableValueSize) {
+                _position += fixedSize;
+                if (_position >= _maxLength)
+                    return false;
+                continue;
+            }
+
+            switch (static_cast<signed char>(type)) {
+                case Bool:
+                    if (_position >= _maxLength)
+                        return false;
+                    if (static_cast<unsigned char>(_buffer[_position++]) > 1)
+                        return false;
+                    break;
+
+                case Code:
+                case Symbol:
+                case String:
+                    if (!_skipString())
+                        return false;
+                    break;
+
+                case DBRef:
+                    if (!_skipString())
+                        return false;
+                    _position += OID::kOIDSize;
+                    if (_position >= _maxLength)
+                        return false;
+                    break;
+
+                case RegEx:
+                    if (!_skipCString() || !_skipCString())
+                        return false;
+                    break;
+
+                case BinData: {
+                    int32_t size;
+                    if (!_readInt32(&size))
+                        return false;
+                    if (size < 0 || size == std::numeric_limits<int>::max())
+                        return false;
+                    _position += 1 + size;
+                    if (_position >= _maxLength)
+                        return false;
+                    break;
+                }
+
+                case CodeWScope:
+                    if (_numFrames == kFastPathMaxFrames)
+                        return false;
+                    _frames[_numFrames] = {_position, 0, true};
+                    if (!_readInt32(&_frames[_numFrames].expectedSize))
+                        return false;
+                    ++_numFrames;
+                    if (!_skipString() || !_beginObject(maxDepth))
+                        return false;
+                    break;
+
+                case Object:
+                case Array:
+                    if (!_beginObject(maxDepth))
+                        return false;
+                    break;
+
+                default:
+                    return false;
+            }
+        }
+    }
+
+private:
+    bool _beginObject(uint64_t maxDepth) {
+        if (_numFrames > maxDepth || _numFrames == kFastPathMaxFrames)
+            return false;
+        _frames[_numFrames] = {_position, 0, false};
+        if (!_readInt32(&_frames[_numFrames].expectedSize))
+            return false;
+        ++_numFrames;
+        return true;
+    }
+
+    bool _endFrame() {
+        const FastPathFrame& frame = _frames[--_numFrames];
+        return static_cast<int64_t>(_position - frame.startPosition) == frame.expectedSize;
+    }
+
+    bool _readInt32(int32_t* out) {
+        if (_position + sizeof(int32_t) > _maxLength)
+            return false;
+        *out = ConstDataView(_buffer).read<LittleEndian<int32_t>>(_position);
+        _position += sizeof(int32_t);
+        return true;
+    }
+
+    bool _skipCString() {
+        const void* end = memchr(_buffer + _position, 0, _maxLength - _position);
+        if (!end)
+            return false;
+        _position = static_cast<const char*>(end) - _buffer + 1;
+        return true;
+    }
+
+    bool _skipString() {
+        int32_t size;
+        if (!_readInt32(&size) || size <= 0)
+            return false;
+        _position += size - 1;
+        if (_position >= _maxLength || _buffer[_position] != '\0')
+            return false;
+        ++_position;
+        return true;
+    }
+
+    const char* const _buffer;
+    const uint64_t _maxLength;
+    uint64_t _position = 0;
+
+    FastPathFrame _frames[kFastPathMaxFrames];
+    size_t _numFrames = 0;
+};
+
 }  // namespace
 
-Status validateBSON(const char* originalBuffer, uint64_t maxLength, BSONVersion version) {
+namespace bson_validate_detail {
+
+bool validateBSONFastPath(const char* buf, uint64_t maxLength) {
+    if (maxLength < 5) {
+        return false;
+    }
+
+    return FastPathValidator(buf, maxLength).validate();
+}
+
+Status validateBSONFullPath(const char* buf, uint64_t maxLength, BSONVersion version) {
     if (maxLength < 5) {
         return Status(ErrorCodes::InvalidBSON, "bson data has to be at least 5 bytes");
     }
 
-    Buffer buf(originalBuffer, maxLength, version);
-    return validateBSONIterative(&buf);
+    Buffer buffer(buf, maxLength, version);
+    return validateBSONIterative(&buffer);
+}
+
+}  // namespace bson_validate_detail
+
+Status validateBSON(const char* originalBuffer, uint64_t maxLength, BSONVersion version) {
+    if (MONGO_likely(bson_validate_detail::validateBSONFastPath(originalBuffer, maxLength))) {
+        return Status::OK();
+    }
+
+    // The fast path only says whether the buffer is valid, so rerun the full validator to produce
+    // the error, or to accept objects nested too deeply for the fast path.
+    return bson_validate_detail::validateBSONFullPath(originalBuffer, maxLength, version);
 }
 
 }  // namespace mongo
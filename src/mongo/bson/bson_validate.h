@@ -46,4 +46,19 @@ class Status;
  */
 Status validateBSON(const char* buf, uint64_t maxLength, BSONVersion version);
 
+namespace bson_validate_detail {
+
+/**
+ * The two halves of validateBSON(), exposed so that tests can check them against each other.
+ *
+ * validateBSONFastPath() only answers whether 'buf' is valid and does no bookkeeping for error
+ * messages. A false result means the fast path could not prove the buffer valid, which includes
+ * objects nested more deeply than it tracks; validateBSON() then runs validateBSONFullPath() to
+ * produce the authoritative result and error status.
+ */
+bool validateBSONFastPath(const char* buf, uint64_t maxLength);
+Status validateBSONFullPath(const char* buf, uint64_t maxLength, BSONVersion version);
+
+}  // namespace bson_validate_detail
+
 }  // namespace mongo
@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/base/data_view.h"
+#include "mongo/bson/bson_depth.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/random.h"
@@ -42,6 +43,18 @@ using namespace mongo;
 using std::unique_ptr;
 using std::endl;
 
+/**
+ * The fast path may only decline buffers that the full validator rejects, or that are nested more
+ * deeply than the fast path tracks, which none of the callers here produce.
+ */
+void assertFastPathMatchesFullPath(const char* buffer, uint64_t maxLength) {
+    const bool fastPathValid = bson_validate_detail::validateBSONFastPath(buffer, maxLength);
+    const Status fullPathStatus =
+        bson_validate_detail::validateBSONFullPath(buffer, maxLength, BSONVersion::kLatest);
+    ASSERT_EQUALS(fastPathValid, fullPathStatus.isOK()) << fullPathStatus;
+    ASSERT_EQUALS(fullPathStatus, validateBSON(buffer, maxLength, BSONVersion::kLatest));
+}
+
 void appendInvalidStringElement(const char* fieldName, BufBuilder* bb) {
     // like a BSONObj string, but without a NUL terminator.
     bb->appendChar(String);
@@ -186,14 +199,75 @@ TEST(BSONValidate, Fuzz) {
         }
         BSONObj fuzzed(buffer.get());
 
-        // There is no assert here because there is no other BSON validator oracle
-        // to compare outputs against (BSONObj::valid() is a wrapper for validateBSON()).
-        // Thus, the reason for this test is to ensure that validateBSON() doesn't trip
-        // any ASAN or UBSAN check when fed fuzzed input.
-        validateBSON(fuzzed.objdata(), fuzzed.objsize(), BSONVersion::kLatest).isOK();
+        // Besides checking that validateBSON() doesn't trip any ASAN or UBSAN check when fed
+        // fuzzed input, use the full validator as an oracle for the fast path.
+        assertFastPathMatchesFullPath(fuzzed.objdata(), fuzzed.objsize());
     }
 }
 
+TEST(BSONValidate, FastPathMatchesFullPath) {
+    PseudoRandom randomSource(1234);
+
+    BSONObjBuilder bob;
+    bob.append("_id", OID("deadbeefdeadbeefdeadbeef"));
+    bob.append("int", 1);
+    bob.append("long", 2LL);
+    bob.append("double", 3.5);
+    bob.append("bool", true);
+    bob.appendNull("null");
+    bob.appendUndefined("undefined");
+    bob.appendMinKey("minKey");
+    bob.appendMaxKey("maxKey");
+    bob.append("date", Date_t::fromMillisSinceEpoch(44));
+    bob.append("timestamp", Timestamp(1, 2));
+    bob.append("string", "abc");
+    bob.appendSymbol("symbol", "sym");
+    bob.appendCode("code", "function() {}");
+    bob.appendCodeWScope("codeWScope", "function() { return x; }", BSON("x" << 1 << "y" << 2));
+    bob.appendRegex("regex", "^a.*b$", "i");
+    bob.appendDBRef("dbref", "db.coll", OID("01234567890123456789aaaa"));
+    bob.appendBinData("binData", 3, BinDataGeneral, "\x01\x02\x03");
+    bob.append("object", BSON("a" << BSON("b" << BSON_ARRAY(1 << "two" << BSONObj()))));
+    const BSONObj original = bob.obj();
+
+    for (int i = 0; i < 20000; ++i) {
+        std::vector<char> buffer(original.objdata(), original.objdata() + original.objsize());
+
+        // Overwrite a few random bytes, occasionally including the top-level size.
+        const int32_t numMutations = 1 + randomSource.nextInt32(4);
+        for (int32_t j = 0; j < numMutations; ++j) {
+            buffer[randomSource.nextInt32(buffer.size())] = randomSource.nextInt32(256);
+        }
+
+        // Occasionally claim less of the buffer is valid than the object says it needs.
+        uint64_t maxLength = buffer.size();
+        if (randomSource.nextInt32(4) == 0) {
+            maxLength = randomSource.nextInt32(buffer.size() + 1);
+        }
+
+        assertFastPathMatchesFullPath(buffer.data(), maxLength);
+    }
+}
+
+TEST(BSONValidate, DeeplyNestedObjectsFallBackToFullPath) {
+    auto makeNested = [](int depth) {
+        BSONObj obj = BSON("x" << 1);
+        for (int i = 0; i < depth; ++i) {
+            obj = BSON("a" << obj);
+        }
+        return obj;
+    };
+
+    // Too deep for the fast path to track, but within the default depth limit.
+    const BSONObj deep = makeNested(100);
+    ASSERT_FALSE(bson_validate_detail::validateBSONFastPath(deep.objdata(), deep.objsize()));
+    ASSERT_OK(validateBSON(deep.objdata(), deep.objsize(), BSONVersion::kLatest));
+
+    const BSONObj tooDeep = makeNested(BSONDepth::getMaxAllowableDepth() + 1);
+    ASSERT_EQUALS(ErrorCodes::Overflow,
+                  validateBSON(tooDeep.objdata(), tooDeep.objsize(), BSONVersion::kLatest));
+}
+
 TEST(BSONValidateFast, Empty) {
     BSONObj x;
     ASSERT_OK(validateBSON(x.objdata(), x.objsize(), BSONVersion::kLatest));
@@ -266,6 +266,7 @@ void CommandHelpers::filterCommandRequestForPassthrough(BSONObjIterator* cmdIter
         } else if (!isGenericArgument(name) ||  //
                    name == "$queryOptions" ||   //
                    name == "maxTimeMS" ||       //
+                   name == "priority" ||        //
                    name == "readConcern" ||     //
                    name == "writeConcern" ||    //
                    name == "lsid" ||            //
@@ -330,7 +331,8 @@ ResourcePattern Command::parseResourcePattern(const std::string& dbname,
 Command::Command(StringData name, StringData oldName)
     : _name(name.toString()),
       _commandsExecutedMetric("commands." + _name + ".total", &_commandsExecuted),
-      _commandsFailedMetric("commands." + _name + ".failed", &_commandsFailed) {
+      _commandsFailedMetric("commands." + _name + ".failed", &_commandsFailed),
+      _latencyMetric("commands." + _name + ".latency", &_latency) {
     globalCommandRegistry()->registerCommand(this, name, oldName);
 }
 
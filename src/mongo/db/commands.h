@@ -42,9 +42,11 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/stats/latency_histogram.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/rpc/reply_builder_interface.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/net/op_msg.h"
 #include "mongo/util/string_map.h"
 
@@ -127,6 +129,7 @@ struct CommandHelpers {
             arg == "$replData" ||                        //
             arg == "$clusterTime" ||                     //
             arg == "maxTimeMS" ||                        //
+            arg == "priority" ||                         //
             arg == "readConcern" ||                      //
             arg == "shardVersion" ||                     //
             arg == "tracking_info" ||                    //
@@ -340,6 +343,14 @@ public:
         return true; /* assumed true prior to commit */
     }
 
+    /**
+     * Returns the priority with which the command queues for storage engine tickets when the
+     * request does not specify one. Commands doing long-running batch work return kLow.
+     */
+    virtual TicketHolder::Priority getTicketPriority() const {
+        return TicketHolder::Priority::kNormal;
+    }
+
     /**
      * Returns true if this Command supports the given readConcern level. Takes the command object
      * and the name of the database on which it was invoked as arguments, so that readConcern can be
@@ -399,6 +410,13 @@ public:
         _commandsFailed.increment();
     }
 
+    /**
+     * Records how long, in microseconds, one execution of this command took.
+     */
+    void recordLatency(uint64_t micros) {
+        _latency.record(micros);
+    }
+
     /**
      * Runs the command.
      *
@@ -470,12 +488,16 @@ private:
     Counter64 _commandsExecuted;
     Counter64 _commandsFailed;
 
+    // Distribution of the execution times of this command
+    LatencyHistogram _latency;
+
     // The full name of the command
     const std::string _name;
 
     // Pointers to hold the metrics tree references
     ServerStatusMetricField<Counter64> _commandsExecutedMetric;
     ServerStatusMetricField<Counter64> _commandsFailedMetric;
+    ServerStatusMetricField<LatencyHistogram> _latencyMetric;
 };
 
 /**
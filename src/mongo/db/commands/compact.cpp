@@ -64,6 +64,9 @@ public:
     AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
         return AllowedOnSecondary::kAlways;
     }
+    TicketHolder::Priority getTicketPriority() const override {
+        return TicketHolder::Priority::kLow;
+    }
     virtual bool maintenanceMode() const {
         return true;
     }
@@ -0,0 +1,223 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * Server parameters, command and serverStatus section for the CPU sampling profiler.
+ *
+ * The profiler is started at startup with
+ *
+ *     mongod --setParameter cpuSamplingProfilerEnabled=true
+ *
+ * or at runtime with
+ *
+ *     db.adminCommand({setParameter: 1, cpuSamplingProfilerEnabled: true})
+ *
+ * While it runs, serverStatus includes a cpuSamplingProfile section with the number of samples
+ * taken for each tag, which FTDC collects along with the rest of serverStatus. The sampled stacks
+ * are returned in the folded format used by flame graph tools by
+ *
+ *     db.adminCommand({getCpuSamplingProfile: 1, limit: <n>, reset: <bool>})
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/commands/cpu_sampling_profile.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/cpu_sampling_profiler.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+// Set by startCpuSamplingProfiler(). Before that, the parameters only record their value.
+AtomicBool startupComplete(false);
+
+AtomicInt32 localSamplesPerSecond(100);
+
+class ExportedCpuSamplingProfilerSamplesPerSecondParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedCpuSamplingProfilerSamplesPerSecondParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "cpuSamplingProfilerSamplesPerSecond",
+              &localSamplesPerSecond) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > 1000) {
+            return Status(ErrorCodes::BadValue,
+                          "cpuSamplingProfilerSamplesPerSecond must be between 1 and 1000");
+        }
+
+        if (startupComplete.load() && CpuSamplingProfiler::isRunning()) {
+            return CpuSamplingProfiler::start(potentialNewValue);
+        }
+
+        return Status::OK();
+    }
+
+} exportedCpuSamplingProfilerSamplesPerSecondParameter;
+
+AtomicBool localEnabled(false);
+
+class ExportedCpuSamplingProfilerEnabledParameter
+    : public ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedCpuSamplingProfilerEnabledParameter()
+        : ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(), "cpuSamplingProfilerEnabled", &localEnabled) {}
+
+    virtual Status validate(const bool& potentialNewValue) {
+        if (!startupComplete.load()) {
+            return Status::OK();
+        }
+
+        if (!potentialNewValue) {
+            CpuSamplingProfiler::stop();
+            return Status::OK();
+        }
+
+        return CpuSamplingProfiler::start(localSamplesPerSecond.load());
+    }
+
+} exportedCpuSamplingProfilerEnabledParameter;
+
+class CpuSamplingProfileServerStatusSection final : public ServerStatusSection {
+public:
+    CpuSamplingProfileServerStatusSection() : ServerStatusSection("cpuSamplingProfile") {}
+
+    bool includeByDefault() const override {
+        return CpuSamplingProfiler::isRunning();
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        CpuSamplingProfiler::appendStats(&builder);
+        return builder.obj();
+    }
+} cpuSamplingProfileServerStatusSection;
+
+/**
+ * Returns the stacks sampled by the CPU sampling profiler.
+ *
+ * Format
+ * {
+ *    getCpuSamplingProfile: 1,
+ *    limit: <int>, // optional, the number of stacks to return, the most frequent first.
+ *    reset: <bool> // optional, discard the stacks and statistics once returned.
+ * }
+ */
+class GetCpuSamplingProfileCmd : public BasicCommand {
+public:
+    GetCpuSamplingProfileCmd() : BasicCommand("getCpuSamplingProfile") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+        ActionSet actions;
+        actions.addAction(ActionType::cpuProfiler);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+
+    std::string help() const override {
+        return "{ getCpuSamplingProfile: 1, limit: <n>, reset: <bool> } returns the stacks "
+               "sampled by the CPU sampling profiler in the folded flame graph format";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        long long limit;
+        uassertStatusOK(bsonExtractIntegerFieldWithDefault(cmdObj, "limit", 1000, &limit));
+        uassert(ErrorCodes::BadValue, "limit must not be negative", limit >= 0);
+
+        bool reset;
+        uassertStatusOK(bsonExtractBooleanFieldWithDefault(cmdObj, "reset", false, &reset));
+
+        {
+            BSONObjBuilder statsBuilder(result.subobjStart("stats"));
+            CpuSamplingProfiler::appendStats(&statsBuilder);
+        }
+
+        const auto stacks = CpuSamplingProfiler::getFoldedStacks();
+        BSONArrayBuilder stacksBuilder(result.subarrayStart("stacks"));
+        for (size_t i = 0; i < stacks.size() && i < static_cast<size_t>(limit); i++) {
+            // Stop short of the maximum document size, the least frequent stacks are dropped.
+            if (stacksBuilder.len() + stacks[i].stack.size() > BSONObjMaxUserSize / 2)
+                break;
+
+            BSONObjBuilder stackBuilder(stacksBuilder.subobjStart());
+            stackBuilder.append("stack", stacks[i].stack);
+            stackBuilder.append("samples", stacks[i].samples);
+        }
+        stacksBuilder.doneFast();
+
+        if (reset) {
+            CpuSamplingProfiler::reset();
+        }
+
+        return true;
+    }
+} getCpuSamplingProfileCmd;
+
+}  // namespace
+
+void startCpuSamplingProfiler() {
+    startupComplete.store(true);
+    if (localEnabled.load()) {
+        uassertStatusOK(CpuSamplingProfiler::start(localSamplesPerSecond.load()));
+    }
+}
+
+}  // namespace mongo
@@ -219,6 +219,9 @@ public:
     AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
         return AllowedOnSecondary::kNever;
     }
+    TicketHolder::Priority getTicketPriority() const override {
+        return TicketHolder::Priority::kLow;
+    }
 
     virtual Status checkAuthForCommand(Client* client,
                                        const std::string& dbname,
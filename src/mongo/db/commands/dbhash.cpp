@@ -65,6 +65,9 @@ public:
     AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
         return AllowedOnSecondary::kAlways;
     }
+    TicketHolder::Priority getTicketPriority() const override {
+        return TicketHolder::Priority::kLow;
+    }
 
     virtual void addRequiredPrivileges(const std::string& dbname,
                                        const BSONObj& cmdObj,
@@ -30,6 +30,7 @@
 
 #include "mongo/db/command_can_run_here.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/util/mongoutils/str.h"
@@ -154,6 +155,11 @@ public:
             return false;
         }
 
+        // Report the time spent in each phase along with the execution stats.
+        if (verbosity.getValue() >= ExplainOptions::Verbosity::kExecStats) {
+            OperationTrace::get(opCtx).enable(opCtx->getServiceContext()->getTickSource());
+        }
+
         // Actually call the nested command's explain(...) method.
         Status explainStatus =
             commToExplain->explain(opCtx, dbname, explainObj, verbosity.getValue(), &result);
@@ -38,6 +38,7 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/find.h"
@@ -140,7 +141,10 @@ public:
 
         // Parse the command BSON to a QueryRequest.
         const bool isExplain = true;
-        auto qrStatus = QueryRequest::makeFromFindCommand(nss, cmdObj, isExplain);
+        auto qrStatus = [&] {
+            OperationTrace::Span span(opCtx, OperationTrace::Phase::kParse);
+            return QueryRequest::makeFromFindCommand(nss, cmdObj, isExplain);
+        }();
         if (!qrStatus.isOK()) {
             return qrStatus.getStatus();
         }
@@ -148,13 +152,16 @@ public:
         // Finish the parsing step by using the QueryRequest to create a CanonicalQuery.
         const ExtensionsCallbackReal extensionsCallback(opCtx, &nss);
         const boost::intrusive_ptr<ExpressionContext> expCtx;
-        auto statusWithCQ =
-            CanonicalQuery::canonicalize(opCtx,
-                                         std::move(qrStatus.getValue()),
-                                         expCtx,
-                                         extensionsCallback,
-                                         MatchExpressionParser::kAllowAllSpecialFeatures &
-                                             ~MatchExpressionParser::AllowedFeatures::kIsolated);
+        auto statusWithCQ = [&] {
+            OperationTrace::Span span(opCtx, OperationTrace::Phase::kCanonicalize);
+            return CanonicalQuery::canonicalize(
+                opCtx,
+                std::move(qrStatus.getValue()),
+                expCtx,
+                extensionsCallback,
+                MatchExpressionParser::kAllowAllSpecialFeatures &
+                    ~MatchExpressionParser::AllowedFeatures::kIsolated);
+        }();
         if (!statusWithCQ.isOK()) {
             return statusWithCQ.getStatus();
         }
@@ -232,8 +239,11 @@ public:
         // Parse the command BSON to a QueryRequest.
         const bool isExplain = false;
         // Pass parseNs to makeFromFindCommand in case cmdObj does not have a UUID.
-        auto qrStatus = QueryRequest::makeFromFindCommand(
-            NamespaceString(parseNs(dbname, cmdObj)), cmdObj, isExplain);
+        auto qrStatus = [&] {
+            OperationTrace::Span span(opCtx, OperationTrace::Phase::kParse);
+            return QueryRequest::makeFromFindCommand(
+                NamespaceString(parseNs(dbname, cmdObj)), cmdObj, isExplain);
+        }();
         if (!qrStatus.isOK()) {
             return CommandHelpers::appendCommandStatus(result, qrStatus.getStatus());
         }
@@ -272,13 +282,16 @@ public:
         // Finish the parsing step by using the QueryRequest to create a CanonicalQuery.
         const ExtensionsCallbackReal extensionsCallback(opCtx, &nss);
         const boost::intrusive_ptr<ExpressionContext> expCtx;
-        auto statusWithCQ =
-            CanonicalQuery::canonicalize(opCtx,
-                                         std::move(qr),
-                                         expCtx,
-                                         extensionsCallback,
-                                         MatchExpressionParser::kAllowAllSpecialFeatures &
-                                             ~MatchExpressionParser::AllowedFeatures::kIsolated);
+        auto statusWithCQ = [&] {
+            OperationTrace::Span span(opCtx, OperationTrace::Phase::kCanonicalize);
+            return CanonicalQuery::canonicalize(
+                opCtx,
+                std::move(qr),
+                expCtx,
+                extensionsCallback,
+                MatchExpressionParser::kAllowAllSpecialFeatures &
+                    ~MatchExpressionParser::AllowedFeatures::kIsolated);
+        }();
         if (!statusWithCQ.isOK()) {
             return CommandHelpers::appendCommandStatus(result, statusWithCQ.getStatus());
         }
@@ -349,17 +362,21 @@ public:
         BSONObj obj;
         PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
         long long numResults = 0;
-        while (!FindCommon::enoughForFirstBatch(originalQR, numResults) &&
-               PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL))) {
-            // If we can't fit this result inside the current batch, then we stash it for later.
-            if (!FindCommon::haveSpaceForNext(obj, numResults, firstBatch.bytesUsed())) {
-                exec->enqueue(obj);
-                break;
-            }
+        {
+            OperationTrace::Span span(opCtx, OperationTrace::Phase::kExecution);
+            while (!FindCommon::enoughForFirstBatch(originalQR, numResults) &&
+                   PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL))) {
+                // If we can't fit this result inside the current batch, then we stash it for
+                // later.
+                if (!FindCommon::haveSpaceForNext(obj, numResults, firstBatch.bytesUsed())) {
+                    exec->enqueue(obj);
+                    break;
+                }
 
-            // Add result to output buffer.
-            firstBatch.append(obj);
-            numResults++;
+                // Add result to output buffer.
+                firstBatch.append(obj);
+                numResults++;
+            }
         }
 
         // Throw an assertion if query execution fails for any reason.
@@ -43,6 +43,7 @@
 #include "mongo/db/cursor_manager.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/find.h"
 #include "mongo/db/query/find_common.h"
@@ -387,7 +388,10 @@ public:
                                       &readLock);
         }
 
-        Status batchStatus = generateBatch(opCtx, cursor, request, &nextBatch, &state, &numResults);
+        Status batchStatus = [&] {
+            OperationTrace::Span span(opCtx, OperationTrace::Phase::kExecution);
+            return generateBatch(opCtx, cursor, request, &nextBatch, &state, &numResults);
+        }();
         if (!batchStatus.isOK()) {
             return CommandHelpers::appendCommandStatus(result, batchStatus);
         }
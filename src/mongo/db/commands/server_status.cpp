@@ -180,6 +180,21 @@ public:
         _sections[section->getSectionName()] = section;
     }
 
+    void appendSections(OperationContext* opCtx,
+                        const std::vector<std::string>& sectionNames,
+                        BSONObjBuilder* result) {
+        _runCalled = true;
+
+        for (const auto& sectionName : sectionNames) {
+            auto it = _sections.find(sectionName);
+            if (it == _sections.end()) {
+                continue;
+            }
+
+            it->second->appendSection(opCtx, BSONElement(), result);
+        }
+    }
+
 private:
     const Date_t _started;
     bool _runCalled;
@@ -210,6 +225,12 @@ ServerStatusSection::ServerStatusSection(const string& sectionName) : _sectionNa
     CmdServerStatusInstantiator::getInstance().addSection(this);
 }
 
+void appendServerStatusSections(OperationContext* opCtx,
+                                const std::vector<std::string>& sectionNames,
+                                BSONObjBuilder* builder) {
+    CmdServerStatusInstantiator::getInstance().appendSections(opCtx, sectionNames, builder);
+}
+
 OpCounterServerStatusSection::OpCounterServerStatusSection(const string& sectionName,
                                                            OpCounters* counters)
     : ServerStatusSection(sectionName), _counters(counters) {}
@@ -108,6 +108,16 @@ private:
     const std::string _sectionName;
 };
 
+/**
+ * Appends the named serverStatus sections to builder as the serverStatus command would, without
+ * the fields and sections that the command always includes. Unknown names are skipped.
+ *
+ * Intended for internal callers that sample a few sections frequently, i.e., FTDC.
+ */
+void appendServerStatusSections(OperationContext* opCtx,
+                                const std::vector<std::string>& sectionNames,
+                                BSONObjBuilder* builder);
+
 class OpCounterServerStatusSection : public ServerStatusSection {
 public:
     OpCounterServerStatusSection(const std::string& sectionName, OpCounters* counters);
@@ -70,6 +70,9 @@ public:
     AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
         return AllowedOnSecondary::kAlways;
     }
+    TicketHolder::Priority getTicketPriority() const override {
+        return TicketHolder::Priority::kLow;
+    }
 
     std::string help() const override {
         return "Validate contents of a namespace by scanning its data structures for correctness.  "
@@ -1310,6 +1310,26 @@ TEST_F(DConcurrencyTestFixture, PerformanceResourceMutexExclusive) {
              kMaxPerfThreads);
 }
 
+TEST_F(DConcurrencyTestFixture, PerformanceGlobalIntentSharedLock) {
+    std::vector<std::pair<ServiceContext::UniqueClient, ServiceContext::UniqueOperationContext>>
+        clients = makeKClientsWithLockers<DefaultLockerImpl>(kMaxPerfThreads);
+    perfTest(
+        [&](int threadId) {
+            Lock::GlobalLock glk(clients[threadId].second.get(), MODE_IS, Date_t::max());
+        },
+        kMaxPerfThreads);
+}
+
+TEST_F(DConcurrencyTestFixture, PerformanceGlobalIntentExclusiveLock) {
+    std::vector<std::pair<ServiceContext::UniqueClient, ServiceContext::UniqueOperationContext>>
+        clients = makeKClientsWithLockers<DefaultLockerImpl>(kMaxPerfThreads);
+    perfTest(
+        [&](int threadId) {
+            Lock::GlobalLock glk(clients[threadId].second.get(), MODE_IX, Date_t::max());
+        },
+        kMaxPerfThreads);
+}
+
 TEST_F(DConcurrencyTestFixture, PerformanceCollectionIntentSharedLock) {
     std::vector<std::pair<ServiceContext::UniqueClient, ServiceContext::UniqueOperationContext>>
         clients = makeKClientsWithLockers<DefaultLockerImpl>(kMaxPerfThreads);
@@ -156,6 +156,8 @@ struct LockHead {
 
         conversionsCount = 0;
         compatibleFirstCount = 0;
+
+        fastPathLock = nullptr;
     }
 
     /**
@@ -165,6 +167,14 @@ struct LockHead {
         return !partitions.empty();
     }
 
+    /**
+     * Bit-mask of the modes granted through the fast path for this resource, if it has one. Must be
+     * called with the bucket holding this lock head locked.
+     */
+    uint32_t fastPathGrantedModes() const {
+        return fastPathLock ? fastPathLock->grantedModes() : 0;
+    }
+
     /**
      * Locates the request corresponding to the particular locker or returns nullptr. Must be called
      * with the bucket holding this lock head locked.
@@ -199,9 +209,15 @@ struct LockHead {
         // access to that field is not protected. The 'partitioned' member instead indicates if a
         // request was initially partitioned.
 
+        // Requests granted through the fast path must be accounted for before the conflicting mode
+        // shows up on this LockHead, and no new ones may be granted afterwards
+        if (fastPathLock && conflicts(request->mode, intentModes)) {
+            fastPathLock->enabled.store(false);
+        }
+
         // New lock request. Queue after all granted modes and after any already requested
         // conflicting modes
-        if (conflicts(request->mode, grantedModes) ||
+        if (conflicts(request->mode, grantedModes | fastPathGrantedModes()) ||
             (!compatibleFirstCount && conflicts(request->mode, conflictModes))) {
             request->status = LockRequest::STATUS_WAITING;
 
@@ -313,6 +329,10 @@ struct LockHead {
     // TODO: Remove this vector and make LockHead a POD
     std::vector<LockManager::Partition*> partitions;
 
+    // References the fast path for this resource, if it has one. Requests granted through it are
+    // not on the granted queue, but must be taken into account for conflicts.
+    FastPathLockHead* fastPathLock;
+
     //
     // Conversion
     //
@@ -403,6 +423,34 @@ void LockHead::migratePartitionedLockHeads() {
     }
 }
 
+//
+// FastPathLockHead
+//
+
+AtomicInt64& FastPathLockHead::grantedCount(const LockRequest* request, LockMode mode) {
+    return partitions[request->locker->getId() % kNumPartitions].grantedCounts[mode];
+}
+
+long long FastPathLockHead::grantedCount(LockMode mode) const {
+    long long count = 0;
+    for (unsigned i = 0; i < kNumPartitions; i++) {
+        count += partitions[i].grantedCounts[mode].load();
+    }
+    return count;
+}
+
+uint32_t FastPathLockHead::grantedModes() const {
+    uint32_t modes = 0;
+    if (grantedCount(MODE_IS) > 0) {
+        modes |= modeMask(MODE_IS);
+    }
+    if (grantedCount(MODE_IX) > 0) {
+        modes |= modeMask(MODE_IX);
+    }
+    return modes;
+}
+
+
 //
 // LockManager
 //
@@ -417,6 +465,12 @@ const unsigned LockManager::_numPartitions = 32;
 LockManager::LockManager() {
     _lockBuckets = new LockBucket[_numLockBuckets];
     _partitions = new Partition[_numPartitions];
+
+    // Not using the resourceIdGlobal constants, because the global LockManager may be constructed
+    // before them
+    _fastPathLockHeads[0].resourceId = ResourceId(RESOURCE_GLOBAL, ResourceId::SINGLETON_GLOBAL);
+    _fastPathLockHeads[1].resourceId =
+        ResourceId(RESOURCE_GLOBAL, ResourceId::SINGLETON_PARALLEL_BATCH_WRITER_MODE);
 }
 
 LockManager::~LockManager() {
@@ -427,6 +481,10 @@ LockManager::~LockManager() {
         invariant(_lockBuckets[i].data.empty());
     }
 
+    for (unsigned i = 0; i < _numFastPathLockHeads; i++) {
+        invariant(_fastPathLockHeads[i].grantedModes() == 0);
+    }
+
     delete[] _lockBuckets;
     delete[] _partitions;
 }
@@ -436,9 +494,17 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
     invariant(request->status == LockRequest::STATUS_NEW);
     invariant(request->recursiveCount == 1);
 
-    request->partitioned = (mode == MODE_IX || mode == MODE_IS);
+    FastPathLockHead* const fastPathLock = _getFastPathLockHead(resId);
+    const bool isIntentMode = (mode == MODE_IX || mode == MODE_IS);
+
+    request->partitioned = isIntentMode && !fastPathLock;
     request->mode = mode;
 
+    // Fast path for intent locks on the resources every operation acquires
+    if (fastPathLock && isIntentMode && _tryFastPathLock(fastPathLock, request)) {
+        return LOCK_OK;
+    }
+
     // For intent modes, try the PartitionedLockHead
     if (request->partitioned) {
         Partition* partition = _getPartition(request);
@@ -462,6 +528,21 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     LockHead* lock = bucket->findOrInsert(resId);
 
+    if (fastPathLock) {
+        lock->fastPathLock = fastPathLock;
+
+        if (isIntentMode) {
+            // The fast path may have been enabled again in the mean time. Because it can only be
+            // disabled under the bucket mutex, this attempt is the final one.
+            if (_tryFastPathLock(fastPathLock, request)) {
+                return LOCK_OK;
+            }
+
+            // A conflicting request may have observed our attempts and be waiting for them
+            _onLockModeChanged(lock, true);
+        }
+    }
+
     // Start a partitioned lock if possible
     if (request->partitioned && !(lock->grantedModes & (~intentModes)) && !lock->conflictModes) {
         Partition* partition = _getPartition(request);
@@ -508,15 +589,27 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
     LockBucket* bucket = _getBucket(resId);
     stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
 
-    LockBucket::Map::iterator it = bucket->data.find(resId);
-    invariant(it != bucket->data.end());
+    LockHead* lock;
+    if (request->fastPathLock) {
+        // Conversions are only handled on the LockHead, which may not even exist yet
+        lock = bucket->findOrInsert(resId);
+        lock->fastPathLock = request->fastPathLock;
+        _migrateFastPathRequest(lock, request);
+    } else {
+        LockBucket::Map::iterator it = bucket->data.find(resId);
+        invariant(it != bucket->data.end());
 
-    LockHead* const lock = it->second;
+        lock = it->second;
+    }
 
     if (lock->partitioned()) {
         lock->migratePartitionedLockHeads();
     }
 
+    if (lock->fastPathLock && conflicts(newMode, intentModes)) {
+        lock->fastPathLock->enabled.store(false);
+    }
+
     // Construct granted mask without our current mode, so that it is not counted as
     // conflicting
     uint32_t grantedModesWithoutCurrentRequest = 0;
@@ -531,6 +624,8 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
         }
     }
 
+    grantedModesWithoutCurrentRequest |= lock->fastPathGrantedModes();
+
     // This check favours conversion requests over pending requests. For example:
     //
     // T1 requests lock L in IS
@@ -583,6 +678,20 @@ bool LockManager::unlock(LockRequest* request) {
 
         // not partitioned anymore, fall through to regular case
     }
+
+    if (request->fastPathLock) {
+        // Requests can only move off the fast path on their own thread, so no synchronization
+        // is needed to find out that this one is still on it.
+        invariant(request->status == LockRequest::STATUS_GRANTED);
+        FastPathLockHead* fastPathLock = request->fastPathLock;
+        fastPathLock->grantedCount(request, request->mode).fetchAndSubtract(1);
+
+        if (!fastPathLock->enabled.load()) {
+            _onFastPathModeChanged(fastPathLock);
+        }
+        return true;
+    }
+
     invariant(request->lock);
 
     LockHead* lock = request->lock;
@@ -637,7 +746,6 @@ bool LockManager::unlock(LockRequest* request) {
 }
 
 void LockManager::downgrade(LockRequest* request, LockMode newMode) {
-    invariant(request->lock);
     invariant(request->status == LockRequest::STATUS_GRANTED);
     invariant(request->recursiveCount > 0);
 
@@ -646,6 +754,21 @@ void LockManager::downgrade(LockRequest* request, LockMode newMode) {
     invariant((LockConflictsTable[request->mode] | LockConflictsTable[newMode]) ==
               LockConflictsTable[request->mode]);
 
+    if (request->fastPathLock) {
+        // Increment the new mode first, so the request is never missing from the counters
+        FastPathLockHead* fastPathLock = request->fastPathLock;
+        fastPathLock->grantedCount(request, newMode).fetchAndAdd(1);
+        fastPathLock->grantedCount(request, request->mode).fetchAndSubtract(1);
+        request->mode = newMode;
+
+        if (!fastPathLock->enabled.load()) {
+            _onFastPathModeChanged(fastPathLock);
+        }
+        return;
+    }
+
+    invariant(request->lock);
+
     LockHead* lock = request->lock;
 
     LockBucket* bucket = _getBucket(lock->resourceId);
@@ -696,6 +819,8 @@ void LockManager::_cleanupUnusedLocksInBucket(LockBucket* bucket) {
 }
 
 void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
+    const uint32_t fastPathModes = lock->fastPathGrantedModes();
+
     // Unblock any converting requests (because conversions are still counted as granted and
     // are on the granted queue).
     for (LockRequest* iter = lock->grantedList._front;
@@ -726,6 +851,8 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
                 }
             }
 
+            grantedModesWithoutCurrentRequest |= fastPathModes;
+
             if (!conflicts(iter->convertMode, grantedModesWithoutCurrentRequest)) {
                 lock->conversionsCount--;
                 lock->decGrantedModeCount(iter->mode);
@@ -765,7 +892,7 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
         // the granted queue.
         iterNext = iter->next;
 
-        if (conflicts(iter->mode, lock->grantedModes)) {
+        if (conflicts(iter->mode, lock->grantedModes | fastPathModes)) {
             // If iter doesn't have a previous pointer, this means that it is at the front of the
             // queue. If we continue scanning the queue beyond this point, we will starve it by
             // granting more and more requests. However, if we newly transition to compatibleFirst
@@ -803,6 +930,68 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
     // with the bitmask on the modes.
     invariant((lock->grantedModes == 0) ^ (lock->grantedList._front != nullptr));
     invariant((lock->conflictModes == 0) ^ (lock->conflictList._front != nullptr));
+
+    // Once only intent modes are left, new intent requests can be granted through the fast path
+    // again
+    if (lock->fastPathLock && !((lock->grantedModes | lock->conflictModes) & ~intentModes)) {
+        lock->fastPathLock->enabled.store(true);
+    }
+}
+
+FastPathLockHead* LockManager::_getFastPathLockHead(ResourceId resId) {
+    if (resId.getType() != RESOURCE_GLOBAL) {
+        return nullptr;
+    }
+
+    for (unsigned i = 0; i < _numFastPathLockHeads; i++) {
+        if (_fastPathLockHeads[i].resourceId == resId) {
+            return &_fastPathLockHeads[i];
+        }
+    }
+
+    return nullptr;
+}
+
+bool LockManager::_tryFastPathLock(FastPathLockHead* fastPathLock, LockRequest* request) {
+    AtomicInt64& grantedCount = fastPathLock->grantedCount(request, request->mode);
+
+    // The increment must come before checking whether the fast path is enabled. A conflicting
+    // request disables it before summing up the counters, so either it sees the increment or the
+    // check below fails.
+    grantedCount.fetchAndAdd(1);
+    if (fastPathLock->enabled.load()) {
+        request->fastPathLock = fastPathLock;
+        request->status = LockRequest::STATUS_GRANTED;
+        return true;
+    }
+
+    grantedCount.fetchAndSubtract(1);
+    return false;
+}
+
+void LockManager::_migrateFastPathRequest(LockHead* lock, LockRequest* request) {
+    invariant(request->fastPathLock == lock->fastPathLock);
+    invariant(request->status == LockRequest::STATUS_GRANTED);
+
+    // Anyone looking at the counters after this must hold the bucket mutex, so the request is
+    // never missing from both the counters and the granted queue.
+    request->fastPathLock->grantedCount(request, request->mode).fetchAndSubtract(1);
+    request->fastPathLock = nullptr;
+
+    request->lock = lock;
+    lock->grantedList.push_back(request);
+    lock->incGrantedModeCount(request->mode);
+}
+
+void LockManager::_onFastPathModeChanged(FastPathLockHead* fastPathLock) {
+    LockBucket* bucket = _getBucket(fastPathLock->resourceId);
+    stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+
+    // The conflicting request may be gone already, together with the LockHead
+    LockBucket::Map::iterator it = bucket->data.find(fastPathLock->resourceId);
+    if (it != bucket->data.end()) {
+        _onLockModeChanged(it->second, true);
+    }
 }
 
 LockManager::LockBucket* LockManager::_getBucket(ResourceId resId) const {
@@ -887,6 +1076,21 @@ void LockManager::getLockInfoBSON(const std::map<LockerId, BSONObj>& lockToClien
             lockInfo.append(b.obj());
         }
     }
+
+    // Requests granted through the fast path are not on any LockHead, so only their counts can be
+    // reported
+    for (unsigned i = 0; i < _numFastPathLockHeads; i++) {
+        const FastPathLockHead& fastPathLock = _fastPathLockHeads[i];
+        const long long isCount = fastPathLock.grantedCount(MODE_IS);
+        const long long ixCount = fastPathLock.grantedCount(MODE_IX);
+        if (isCount > 0 || ixCount > 0) {
+            lockInfo.append(BSON("resourceId" << fastPathLock.resourceId.toString()
+                                              << "fastPathGranted"
+                                              << BSON(modeName(MODE_IS) << isCount
+                                                                        << modeName(MODE_IX)
+                                                                        << ixCount)));
+        }
+    }
     result->append("lockInfo", lockInfo.arr());
 }
 
@@ -1170,6 +1374,7 @@ void LockRequest::initNew(Locker* locker, LockGrantNotification* notify) {
 
     lock = nullptr;
     partitionedLock = nullptr;
+    fastPathLock = nullptr;
     prev = nullptr;
     next = nullptr;
     status = STATUS_NEW;
@@ -41,11 +41,65 @@
 #include "mongo/platform/compiler.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/new.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/mutex.h"
 
 namespace mongo {
 
+/**
+ * Every operation acquires the global and the parallel batch writer mode locks, nearly always in
+ * an intent mode. For these resources, intent mode requests are granted by incrementing a counter
+ * in the partition of the requesting locker, without taking the bucket mutex, for as long as no
+ * request in MODE_S or MODE_X has reached the resource's LockHead.
+ *
+ * The fast path is disabled under the bucket mutex before such a request is queued or granted on
+ * the LockHead, after which the counters only serve to tell it when the intent holders have
+ * drained. New requests, which find the fast path disabled go through the LockHead, and holders,
+ * which release their counter while it is disabled re-evaluate the grants of the LockHead.
+ *
+ * The counters are only ever incremented optimistically before checking whether the fast path is
+ * enabled, so a conflicting request, which disables it and then sums up the counters may not miss
+ * a holder. It may see a holder which is about to back off, but that one re-evaluates the grants
+ * of the LockHead once it is gone.
+ */
+struct FastPathLockHead {
+    /**
+     * Returns the counter tracking the requests of 'request's locker granted in 'mode'.
+     */
+    AtomicInt64& grantedCount(const LockRequest* request, LockMode mode);
+
+    /**
+     * Returns the total number of requests currently granted through the fast path in 'mode'.
+     * Requests, which are about to back off from the fast path may be included.
+     */
+    long long grantedCount(LockMode mode) const;
+
+    /**
+     * Bit-mask of the modes in which requests are currently granted through the fast path.
+     */
+    uint32_t grantedModes() const;
+
+    // Balance scalability of the counters against the cost of summing them up for a
+    // conflicting request.
+    static const unsigned kNumPartitions = 32;
+
+    // Each partition falls on a separate cache line in order to avoid false sharing.
+    struct alignas(stdx::hardware_destructive_interference_size) Partition {
+        AtomicInt64 grantedCounts[LockModesCount];
+    };
+
+    // Id of the resource this fast path is for. Initialized at construction of the LockManager
+    // and does not change.
+    ResourceId resourceId;
+
+    // Cleared under the LockHead bucket's mutex before a request in a mode other than MODE_IS or
+    // MODE_IX is put on the LockHead, and set again once only intent modes are left on it.
+    AtomicBool enabled{true};
+
+    Partition partitions[kNumPartitions];
+};
+
 /**
  * Entry point for the lock manager scheduling functionality. Don't use it directly, but
  * instead go through the Locker interface.
@@ -170,6 +224,33 @@ private:
      */
     Partition* _getPartition(LockRequest* request) const;
 
+    /**
+     * Returns the fast path for the specified resource, or nullptr if intent mode requests for it
+     * always go through the partitions or the LockHead. There is no need to hold a lock when
+     * calling this function.
+     */
+    FastPathLockHead* _getFastPathLockHead(ResourceId resId);
+
+    /**
+     * Attempts to grant an intent mode request through the fast path. Returns false if the fast
+     * path is disabled, in which case the request must be put on the LockHead.
+     */
+    bool _tryFastPathLock(FastPathLockHead* fastPathLock, LockRequest* request);
+
+    /**
+     * Moves a request, which was granted through the fast path to the granted queue of 'lock',
+     * keeping its mode.
+     *
+     * MUST be called under the lock bucket's mutex.
+     */
+    void _migrateFastPathRequest(LockHead* lock, LockRequest* request);
+
+    /**
+     * Should be invoked when a fast path holder goes away while the fast path is disabled, since
+     * a request on the LockHead may be waiting for it. Takes the lock bucket's mutex.
+     */
+    void _onFastPathModeChanged(FastPathLockHead* fastPathLock);
+
     /**
      * Prints the contents of a bucket to the log.
      */
@@ -216,6 +297,10 @@ private:
 
     static const unsigned _numPartitions;
     Partition* _partitions;
+
+    // One for each of resourceIdGlobal and resourceIdParallelBatchWriterMode
+    static const unsigned _numFastPathLockHeads = 2;
+    FastPathLockHead _fastPathLockHeads[_numFastPathLockHeads];
 };
 
 
@@ -227,6 +312,8 @@ private:
  *
  * Implemented as a separate class in order to facilitate diagnostics and also unit-testing for
  * cases where locks come and go in parallel with deadlock detection.
+ *
+ * Requests granted through the fast path of a FastPathLockHead are not visible to the detector.
  */
 class DeadlockDetector {
 public:
@@ -41,6 +41,7 @@ namespace mongo {
 
 class Locker;
 
+struct FastPathLockHead;
 struct LockHead;
 struct PartitionedLockHead;
 
@@ -376,7 +377,8 @@ struct LockRequest {
 
     // Pointer to the lock to which this request belongs, or null if this request has not yet been
     // assigned to a lock or if it belongs to the PartitionedLockHead for locker (in which case
-    // partitionedLock must be set). The LockHead should be alive as long as there are LockRequests
+    // partitionedLock must be set) or was granted through the fast path (in which case
+    // fastPathLock must be set). The LockHead should be alive as long as there are LockRequests
     // on it, so it is safe to have this pointer hanging around.
     //
     // Written by LockManager on any thread
@@ -393,6 +395,15 @@ struct LockRequest {
     // Protected by LockHead bucket's mutex
     PartitionedLockHead* partitionedLock;
 
+    // Pointer to the fast path lock head through which this request was granted, or null if it
+    // was not granted through the fast path. A request can only transition from 'fastPathLock'
+    // to 'lock', never the other way around.
+    //
+    // Written by LockManager on Locker thread
+    // Read by LockManager on Locker thread
+    // Protected by LockHead bucket's mutex when transitioning to 'lock'
+    FastPathLockHead* fastPathLock;
+
     // The linked list chain on which this request hangs off the owning lock head. The reason
     // intrusive linked list is used instead of the std::list class is to allow for entries to be
     // removed from the middle of the list in O(1) time, if they are known instead of having to
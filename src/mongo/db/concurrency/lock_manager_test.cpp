@@ -28,6 +28,7 @@
 
 #include "mongo/db/concurrency/lock_manager_defs.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -951,4 +952,141 @@ TEST(LockManager, Fairness) {
     ASSERT(lockMgr.unlock(&requestIX1));
 }
 
+TEST(LockManager, FastPathIntentModesDoNotConflict) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_GLOBAL, ResourceId::SINGLETON_GLOBAL);
+
+    MMAPV1LockerImpl locker[4];
+    std::vector<std::unique_ptr<LockRequestCombo>> requests;
+    for (int i = 0; i < 4; i++) {
+        requests.push_back(stdx::make_unique<LockRequestCombo>(&locker[i]));
+        ASSERT(LOCK_OK == lockMgr.lock(resId, requests[i].get(), (i % 2) ? MODE_IX : MODE_IS));
+        ASSERT(requests[i]->fastPathLock != nullptr);
+        ASSERT(requests[i]->lock == nullptr);
+    }
+
+    // Recursive acquisitions in covered modes stay on the fast path
+    ASSERT(LOCK_OK == lockMgr.convert(resId, requests[1].get(), MODE_IS));
+    ASSERT(requests[1]->fastPathLock != nullptr);
+    ASSERT_FALSE(lockMgr.unlock(requests[1].get()));
+
+    for (auto& request : requests) {
+        ASSERT(lockMgr.unlock(request.get()));
+        ASSERT_EQ(0, request->numNotifies);
+    }
+}
+
+TEST(LockManager, FastPathConflictingRequestWaitsForHolders) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_GLOBAL, ResourceId::SINGLETON_GLOBAL);
+
+    MMAPV1LockerImpl lockerIS;
+    LockRequestCombo requestIS(&lockerIS);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIS, MODE_IS));
+
+    MMAPV1LockerImpl lockerIX;
+    LockRequestCombo requestIX(&lockerIX);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIX, MODE_IX));
+
+    MMAPV1LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestX, MODE_X));
+
+    // With a conflicting request queued, intent requests must queue behind it
+    MMAPV1LockerImpl lockerIS1;
+    LockRequestCombo requestIS1(&lockerIS1);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestIS1, MODE_IS));
+    ASSERT(requestIS1.fastPathLock == nullptr);
+
+    // The X request is granted once the last fast path holder is gone
+    ASSERT(lockMgr.unlock(&requestIS));
+    ASSERT_EQ(0, requestX.numNotifies);
+    ASSERT(lockMgr.unlock(&requestIX));
+    ASSERT_EQ(1, requestX.numNotifies);
+    ASSERT_EQ(LOCK_OK, requestX.lastResult);
+    ASSERT_EQ(0, requestIS1.numNotifies);
+
+    ASSERT(lockMgr.unlock(&requestX));
+    ASSERT_EQ(1, requestIS1.numNotifies);
+    ASSERT_EQ(LOCK_OK, requestIS1.lastResult);
+
+    // Only intent modes are left, so new intent requests use the fast path again
+    MMAPV1LockerImpl lockerIX1;
+    LockRequestCombo requestIX1(&lockerIX1);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIX1, MODE_IX));
+    ASSERT(requestIX1.fastPathLock != nullptr);
+
+    ASSERT(lockMgr.unlock(&requestIS1));
+    ASSERT(lockMgr.unlock(&requestIX1));
+}
+
+TEST(LockManager, FastPathCancelledConflictingRequestReenablesFastPath) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_GLOBAL, ResourceId::SINGLETON_GLOBAL);
+
+    MMAPV1LockerImpl lockerIX;
+    LockRequestCombo requestIX(&lockerIX);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIX, MODE_IX));
+
+    MMAPV1LockerImpl lockerS;
+    LockRequestCombo requestS(&lockerS);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestS, MODE_S));
+    ASSERT(lockMgr.unlock(&requestS));
+
+    MMAPV1LockerImpl lockerIS;
+    LockRequestCombo requestIS(&lockerIS);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIS, MODE_IS));
+    ASSERT(requestIS.fastPathLock != nullptr);
+
+    ASSERT(lockMgr.unlock(&requestIS));
+    ASSERT(lockMgr.unlock(&requestIX));
+}
+
+TEST(LockManager, FastPathConvert) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_GLOBAL, ResourceId::SINGLETON_GLOBAL);
+
+    MMAPV1LockerImpl locker1;
+    LockRequestCombo request1(&locker1);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IS));
+
+    MMAPV1LockerImpl locker2;
+    LockRequestCombo request2(&locker2);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_IS));
+
+    // Upgrading moves the request off the fast path and waits for the other holder
+    ASSERT(LOCK_WAITING == lockMgr.convert(resId, &request1, MODE_X));
+    ASSERT(request1.fastPathLock == nullptr);
+    ASSERT(request1.lock != nullptr);
+
+    ASSERT(lockMgr.unlock(&request2));
+    ASSERT_EQ(1, request1.numNotifies);
+    ASSERT_EQ(LOCK_OK, request1.lastResult);
+    ASSERT(request1.mode == MODE_X);
+
+    ASSERT_FALSE(lockMgr.unlock(&request1));
+    ASSERT(lockMgr.unlock(&request1));
+}
+
+TEST(LockManager, FastPathDowngrade) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_GLOBAL, ResourceId::SINGLETON_GLOBAL);
+
+    MMAPV1LockerImpl lockerIX;
+    LockRequestCombo requestIX(&lockerIX);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIX, MODE_IX));
+
+    MMAPV1LockerImpl lockerS;
+    LockRequestCombo requestS(&lockerS);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestS, MODE_S));
+
+    // Downgrading to IS no longer conflicts with the S request
+    lockMgr.downgrade(&requestIX, MODE_IS);
+    ASSERT_EQ(1, requestS.numNotifies);
+    ASSERT_EQ(LOCK_OK, requestS.lastResult);
+
+    ASSERT(lockMgr.unlock(&requestS));
+    ASSERT(lockMgr.unlock(&requestIX));
+}
+
 }  // namespace mongo
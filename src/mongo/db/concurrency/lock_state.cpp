@@ -36,6 +36,7 @@
 
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/latency_histogram.h"
 #include "mongo/platform/compiler.h"
 #include "mongo/stdx/new.h"
 #include "mongo/util/background.h"
@@ -43,6 +44,7 @@
 #include "mongo/util/debug_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -125,6 +127,9 @@ AtomicUInt64 idCounter(0);
 // Partitioned global lock statistics, so we don't hit the same bucket
 PartitionedInstanceWideLockStats globalStats;
 
+// Distribution of the total time spent blocked in each lock acquisition that had to wait
+LatencyHistogram globalLockWaitLatency;
+
 }  // namespace
 
 template <bool IsForMMAPV1>
@@ -302,11 +307,20 @@ LockResult LockerImpl<IsForMMAPV1>::_lockGlobalBegin(LockMode mode, Date_t deadl
     if (_modeForTicket == MODE_NONE) {
         const bool reader = isSharedLockMode(mode);
         auto holder = shouldAcquireTicket() ? ticketHolders[mode] : nullptr;
-        if (holder) {
+        const auto priority = getTicketPriority();
+        if (holder && !holder->tryAcquire(priority)) {
             _clientState.store(reader ? kQueuedReader : kQueuedWriter);
+
+            // Only time the wait once the uncontended attempt has failed, so that operations
+            // which get a ticket immediately do not pay for reading the clock.
+            const uint64_t startOfWait = curTimeMicros64();
+            ON_BLOCK_EXIT([&] {
+                _addTicketWaitTime(Microseconds(int64_t(curTimeMicros64() - startOfWait)));
+            });
+
             if (deadline == Date_t::max()) {
-                holder->waitForTicket();
-            } else if (!holder->waitForTicketUntil(deadline)) {
+                holder->waitForTicket(priority);
+            } else if (!holder->waitForTicketUntil(deadline, priority)) {
                 _clientState.store(kInactive);
                 return LOCK_TIMEOUT;
             }
@@ -787,6 +801,8 @@ LockResult LockerImpl<IsForMMAPV1>::lockComplete(ResourceId resId,
         }
     }
 
+    globalLockWaitLatency.record(startOfCurrentWaitTime - startOfTotalWaitTime);
+
     // Cleanup the state, since this is an unused lock now.
     // Note: in case of the _notify object returning LOCK_TIMEOUT, it is possible to find that the
     // lock was still granted after all, but we don't try to take advantage of that and will return
@@ -958,6 +974,10 @@ void reportGlobalLockingStats(SingleThreadedLockStats* outStats) {
     globalStats.report(outStats);
 }
 
+void reportGlobalLockWaitLatency(BSONObjBuilder* builder) {
+    globalLockWaitLatency.append(false, builder);
+}
+
 void resetGlobalLockStats() {
     globalStats.reset();
 }
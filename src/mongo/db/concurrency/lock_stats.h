@@ -195,6 +195,12 @@ typedef LockStats<AtomicInt64> AtomicLockStats;
  */
 void reportGlobalLockingStats(SingleThreadedLockStats* outStats);
 
+/**
+ * Appends the distribution of the time lock acquisitions spent waiting for their lock to be
+ * granted. Acquisitions which were granted immediately are not included.
+ */
+void reportGlobalLockWaitLatency(BSONObjBuilder* builder);
+
 /**
  * Currently used for testing only.
  */
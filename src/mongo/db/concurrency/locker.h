@@ -34,6 +34,7 @@
 #include "mongo/db/concurrency/lock_manager.h"
 #include "mongo/db/concurrency/lock_stats.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/ticketholder.h"
 
 namespace mongo {
 
@@ -346,13 +347,38 @@ public:
         return _shouldAcquireTicket;
     }
 
+    /**
+     * Sets the priority with which this locker queues for a ticket when acquiring the global
+     * lock. Long-running background work should use TicketHolder::Priority::kLow.
+     */
+    void setTicketPriority(TicketHolder::Priority priority) {
+        _ticketPriority = priority;
+    }
+    TicketHolder::Priority getTicketPriority() const {
+        return _ticketPriority;
+    }
+
+    /**
+     * Returns the total time this locker has spent waiting for a ticket to acquire the global
+     * lock. May be called from any thread.
+     */
+    Microseconds getTicketWaitTime() const {
+        return Microseconds{_ticketWaitMicros.load()};
+    }
+
 
 protected:
     Locker() {}
 
+    void _addTicketWaitTime(Microseconds waitTime) {
+        _ticketWaitMicros.fetchAndAdd(durationCount<Microseconds>(waitTime));
+    }
+
 private:
     bool _shouldConflictWithSecondaryBatchApplication = true;
     bool _shouldAcquireTicket = true;
+    TicketHolder::Priority _ticketPriority = TicketHolder::Priority::kNormal;
+    AtomicInt64 _ticketWaitMicros{0};
 };
 
 }  // namespace mongo
@@ -40,8 +40,10 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/json.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/util/log.h"
@@ -68,6 +70,10 @@ const std::vector<const char*> kDollarQueryModifiers = {
     "$maxTimeMS",
 };
 
+// When enabled, operations measure the CPU time and the disk reads of the thread running them,
+// which costs a few system calls per operation
+MONGO_EXPORT_SERVER_PARAMETER(measureOperationResourceUsage, bool, false);
+
 }  // namespace
 
 BSONObj upconvertQueryEntry(const BSONObj& query,
@@ -203,6 +209,14 @@ public:
         return retval;
     }
 
+    /**
+     * Returns the OperationContext this stack decorates, or nullptr if no CurOp has been pushed
+     * with one yet.
+     */
+    OperationContext* opCtx() const {
+        return _opCtx;
+    }
+
 private:
     OperationContext* _opCtx = nullptr;
 
@@ -263,6 +277,38 @@ void CurOp::setNS_inlock(StringData ns) {
 void CurOp::ensureStarted() {
     if (_start == 0) {
         _start = curTimeMicros64();
+
+        // Nested operations, such as those run through DBDirectClient, run on the same thread, so
+        // their resources are already measured by the outermost operation
+        if (!_parent && measureOperationResourceUsage.load()) {
+            _resourceUsage.start();
+        }
+
+        if (auto opCtx = _stack->opCtx()) {
+            _ticketWaitAtStart = opCtx->lockState()->getTicketWaitTime();
+        }
+    }
+}
+
+void CurOp::done() {
+    _end = curTimeMicros64();
+
+    if (_resourceUsage.isStarted()) {
+        if (auto cpuTime = _resourceUsage.cpuTime()) {
+            _debug.cpuNanos = durationCount<Nanoseconds>(*cpuTime);
+        }
+        if (auto bytesRead = _resourceUsage.bytesRead()) {
+            _debug.storageBytesRead = *bytesRead;
+        }
+    }
+    if (auto opCtx = _stack->opCtx()) {
+        _debug.ticketWaitMicros = durationCount<Microseconds>(
+            opCtx->lockState()->getTicketWaitTime() - _ticketWaitAtStart);
+
+        const auto& trace = OperationTrace::get(opCtx);
+        if (trace.isEnabled()) {
+            _debug.executionTimeBreakdown = trace.getBreakdown();
+        }
     }
 }
 
@@ -395,6 +441,17 @@ void CurOp::reportState(BSONObjBuilder* builder, bool truncateOps) {
     }
 
     builder->append("numYields", _numYields);
+
+    if (_start && !_end) {
+        if (auto cpuTime = _resourceUsage.cpuTime()) {
+            builder->append("cpuNanos", durationCount<Nanoseconds>(*cpuTime));
+        }
+        if (auto opCtx = _stack->opCtx()) {
+            builder->append("ticketWaitMicros",
+                            durationCount<Microseconds>(opCtx->lockState()->getTicketWaitTime() -
+                                                        _ticketWaitAtStart));
+        }
+    }
 }
 
 namespace {
@@ -523,6 +580,20 @@ string OpDebug::report(Client* client,
         s << " reslen:" << responseLength;
     }
 
+    OPDEBUG_TOSTRING_HELP(cpuNanos);
+
+    if (ticketWaitMicros > 0) {
+        s << " ticketWaitMicros:" << ticketWaitMicros;
+    }
+
+    if (storageBytesRead > 0) {
+        s << " storageBytesRead:" << storageBytesRead;
+    }
+
+    if (!executionTimeBreakdown.isEmpty()) {
+        s << " executionTimeBreakdown:" << executionTimeBreakdown.toString();
+    }
+
     {
         BSONObjBuilder locks;
         lockStats.report(&locks);
@@ -619,6 +690,20 @@ void OpDebug::append(const CurOp& curop,
     }
 
     OPDEBUG_APPEND_NUMBER(responseLength);
+    OPDEBUG_APPEND_NUMBER(cpuNanos);
+
+    if (ticketWaitMicros > 0) {
+        b.appendNumber("ticketWaitMicros", ticketWaitMicros);
+    }
+
+    if (storageBytesRead > 0) {
+        b.appendNumber("storageBytesRead", storageBytesRead);
+    }
+
+    if (!executionTimeBreakdown.isEmpty()) {
+        b.append("executionTimeBreakdown", executionTimeBreakdown);
+    }
+
     if (iscommand) {
         b.append("protocol", getProtoString(networkOp));
     }
@@ -39,6 +39,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/progress_meter.h"
+#include "mongo/util/thread_resource_usage.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -118,6 +119,17 @@ public:
     long long keysDeleted{0};   // Number of index keys removed.
     long long writeConflicts{0};
 
+    // Resources used by the thread which ran the operation. Left at -1 unless the
+    // measureOperationResourceUsage server parameter is enabled and the platform can measure them.
+    long long cpuNanos{-1};
+    long long storageBytesRead{-1};  // bytes read from disk, i.e. not from the file system cache
+
+    // Time spent queued for a ticket to acquire the global lock.
+    long long ticketWaitMicros{0};
+
+    // Time spent in each phase of the operation, if it was traced. See OperationTrace.
+    BSONObj executionTimeBreakdown;
+
     BSONObj execStats;  // Owned here.
 
     // Details of any error (whether from an exception or a command returning failure).
@@ -284,9 +296,12 @@ public:
         ensureStarted();
         return _start;
     }
-    void done() {
-        _end = curTimeMicros64();
-    }
+
+    /**
+     * Marks the operation as finished and records the resources it used in its OpDebug. Must be
+     * called on the thread which started the operation.
+     */
+    void done();
     bool isDone() const {
         return _end > 0;
     }
@@ -470,6 +485,14 @@ private:
     // The cumulative duration for which the timer has been paused.
     Microseconds _totalPausedDuration{0};
 
+    // Measures the CPU time and disk reads of the thread running this operation, from the time
+    // it was marked as started. reportState() reads it concurrently with ensureStarted(), which
+    // can not take the Client lock since enter_inlock() already holds it.
+    ThreadResourceUsage _resourceUsage;
+
+    // The ticket wait time of this operation's Locker at the time it was marked as started.
+    Microseconds _ticketWaitAtStart{0};
+
     // _networkOp represents the network-level op code: OP_QUERY, OP_GET_MORE, OP_COMMAND, etc.
     NetworkOp _networkOp{opInvalid};  // only set this through setNetworkOp_inlock() to keep synced
     // _logicalOp is the logical operation type, ie 'dbQuery' regardless of whether this is an
@@ -61,6 +61,7 @@
 #include "mongo/db/catalog/uuid_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
+#include "mongo/db/commands/cpu_sampling_profile.h"
 #include "mongo/db/commands/feature_compatibility_version.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/lock_state.h"
@@ -559,6 +560,8 @@ ExitCode _initAndListen(int listenPort) {
 
     startClientCursorMonitor();
 
+    startCpuSamplingProfiler();
+
     PeriodicTask::startRunningPeriodicTasks();
 
     // Set up the periodic runner for background job execution
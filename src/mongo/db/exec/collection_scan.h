@@ -32,6 +32,7 @@
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/matcher/compiled_matcher.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/record_id.h"
 
@@ -98,6 +99,10 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // A compiled form of '_filter' used to test fetched documents. Null if there is no filter or
+    // the compiled matcher is disabled.
+    std::unique_ptr<CompiledMatcher> _compiledFilter;
+
     // If a document does not pass '_filter' but passes '_endCondition', stop scanning and return
     // IS_EOF.
     BSONObj _endConditionBSON;
@@ -29,6 +29,7 @@
 #pragma once
 
 #include "mongo/db/exec/working_set.h"
+#include "mongo/db/matcher/compiled_matcher.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/matchable.h"
 
@@ -157,6 +158,19 @@ public:
         return filter->matches(&doc, NULL);
     }
 
+    /**
+     * Like passes() above, but evaluates 'compiled' instead when it is non-NULL and 'wsm' holds a
+     * full document. 'compiled' must have been built from 'filter'.
+     */
+    static bool passes(WorkingSetMember* wsm,
+                       const MatchExpression* filter,
+                       const CompiledMatcher* compiled) {
+        if (compiled && wsm->hasObj()) {
+            return compiled->matches(wsm->obj.value());
+        }
+        return passes(wsm, filter);
+    }
+
     static bool passes(const BSONObj& keyData,
                        const BSONObj& keyPattern,
                        const MatchExpression* filter) {
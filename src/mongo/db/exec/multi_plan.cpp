@@ -35,16 +35,20 @@
 #include <algorithm>
 #include <math.h>
 
+#include "mongo/base/counter.h"
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -58,6 +62,27 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+Counter64 trialsStoppedByTimeLimit;
+Counter64 coalescedWaits;
+Counter64 coalescedWaitMicros;
+Counter64 coalescedWaitsTimedOut;
+Counter64 coalescedCacheHits;
+
+ServerStatusMetricField<Counter64> displayTrialsStoppedByTimeLimit(
+    "query.planRanking.trialsStoppedByTimeLimit", &trialsStoppedByTimeLimit);
+ServerStatusMetricField<Counter64> displayCoalescedWaits("query.planRanking.coalescedWaits",
+                                                         &coalescedWaits);
+ServerStatusMetricField<Counter64> displayCoalescedWaitMicros(
+    "query.planRanking.coalescedWaitMicros", &coalescedWaitMicros);
+ServerStatusMetricField<Counter64> displayCoalescedWaitsTimedOut(
+    "query.planRanking.coalescedWaitsTimedOut", &coalescedWaitsTimedOut);
+ServerStatusMetricField<Counter64> displayCoalescedCacheHits(
+    "query.planRanking.coalescedCacheHits", &coalescedCacheHits);
+
+}  // namespace
+
 // static
 const char* MultiPlanStage::kStageType = "MULTI_PLAN";
 
@@ -152,7 +177,9 @@ Status MultiPlanStage::tryYield(PlanYieldPolicy* yieldPolicy) {
     //   3) we need to yield and retry due to a WriteConflictException.
     // In all cases, the actual yielding happens here.
     if (yieldPolicy->shouldYieldOrInterrupt()) {
+        const Date_t yieldStart = getClock()->now();
         auto yieldStatus = yieldPolicy->yieldOrInterrupt(_fetcher.get());
+        _yieldTime += getClock()->now() - yieldStart;
 
         if (!yieldStatus.isOK()) {
             _failure = true;
@@ -169,6 +196,76 @@ Status MultiPlanStage::tryYield(PlanYieldPolicy* yieldPolicy) {
     return Status::OK();
 }
 
+Status MultiPlanStage::waitForRanking(PlanYieldPolicy* yieldPolicy) {
+    const int waitMillis = internalQueryPlanRankingCoalesceWaitMillis.load();
+    if (waitMillis <= 0 || !yieldPolicy->canAutoYield() ||
+        !yieldPolicy->canReleaseLocksDuringExecution()) {
+        return Status::OK();
+    }
+
+    // The collection, along with its plan cache, can be dropped while locks are yielded.
+    const std::string rankingKey =
+        _collection->infoCache()->getPlanCache()->computeRankingKey(*_query);
+
+    auto clockSource = getOpCtx()->getServiceContext()->getPreciseClockSource();
+    const Date_t start = clockSource->now();
+
+    // The wait only happens if the yield actually released the locks, which also gives back the
+    // storage engine ticket.
+    auto result = PlanCache::RankingWaitResult::kNotRanking;
+    Status waitStatus = Status::OK();
+    Status yieldStatus = yieldPolicy->yieldOrInterrupt(nullptr, [&] {
+        try {
+            result = PlanCache::waitForRanking(
+                getOpCtx(), rankingKey, start + Milliseconds(waitMillis));
+        } catch (const DBException& ex) {
+            waitStatus = ex.toStatus();
+        }
+    });
+    if (!yieldStatus.isOK()) {
+        return yieldStatus;
+    }
+    if (!waitStatus.isOK()) {
+        return waitStatus;
+    }
+
+    if (result == PlanCache::RankingWaitResult::kNotRanking) {
+        return Status::OK();
+    }
+
+    coalescedWaits.increment();
+    coalescedWaitMicros.increment(durationCount<Microseconds>(clockSource->now() - start));
+
+    if (result == PlanCache::RankingWaitResult::kTimedOut) {
+        LOG(1) << "Timed out after " << waitMillis << "ms waiting for plans to be ranked for "
+               << redact(_query->toStringShort());
+        coalescedWaitsTimedOut.increment();
+        return Status::OK();
+    }
+
+    // Pick the candidate that the other operation cached as the winner. If it did not cache a
+    // plan, rank the candidates here.
+    CachedSolution* rawCS;
+    if (!_collection->infoCache()->getPlanCache()->get(*_query, &rawCS).isOK()) {
+        return Status::OK();
+    }
+    std::unique_ptr<CachedSolution> cs(rawCS);
+
+    const std::string winner = cs->plannerData[0]->toString();
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        const auto& cacheData = _candidates[ix].solution->cacheData;
+        if (cacheData && cacheData->toString() == winner) {
+            LOG(2) << "Using the winning plan cached by a concurrent ranking: "
+                   << redact(Explain::getPlanSummary(_candidates[ix].root));
+            coalescedCacheHits.increment();
+            _bestPlanIdx = ix;
+            return Status::OK();
+        }
+    }
+
+    return Status::OK();
+}
+
 // static
 size_t MultiPlanStage::getTrialPeriodWorks(OperationContext* opCtx, const Collection* collection) {
     // Run each plan some number of times. This number is at least as great as
@@ -206,17 +303,51 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // execution work that happens here, so this is needed for the time accounting to
     // make sense.
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    OperationTrace::Span span(getOpCtx(), OperationTrace::Phase::kMultiPlanTrial);
+
+    // Queries of the same shape that miss the plan cache while the plans are being ranked wait
+    // for the plan cached below, rather than ranking the same plans again.
+    std::unique_ptr<PlanCache::RankingInProgress> rankingInProgress;
+    if (_cachingMode != CachingMode::NeverCache && PlanCache::shouldCacheQuery(*_query)) {
+        rankingInProgress =
+            _collection->infoCache()->getPlanCache()->startRanking(getOpCtx(), *_query);
+        if (!rankingInProgress) {
+            Status waitStatus = waitForRanking(yieldPolicy);
+            if (!waitStatus.isOK()) {
+                return waitStatus;
+            }
+
+            if (bestPlanChosen()) {
+                return Status::OK();
+            }
+        }
+    }
 
     size_t numWorks = getTrialPeriodWorks(getOpCtx(), _collection);
     size_t numResults = getTrialPeriodNumToReturn(*_query);
 
+    // Time spent yielding, such as waiting for locks held by other operations, does not count
+    // against the trial period's time limit.
+    const int maxMillis = internalQueryPlanEvaluationMaxMillis.load();
+    const Date_t deadline =
+        maxMillis > 0 ? getClock()->now() + Milliseconds(maxMillis) : Date_t::max();
+    _yieldTime = Milliseconds(0);
+
     // Work the plans, stopping when a plan hits EOF or returns some
-    // fixed number of results.
+    // fixed number of results, or the trial period runs out of time.
     for (size_t ix = 0; ix < numWorks; ++ix) {
         bool moreToDo = workAllPlans(numResults, yieldPolicy);
         if (!moreToDo) {
             break;
         }
+
+        if (getClock()->now() - _yieldTime >= deadline) {
+            LOG(1) << "Stopping the plan ranking trial period after " << maxMillis
+                   << "ms and " << ix + 1 << " works. ns: " << _collection->ns() << " "
+                   << redact(_query->toStringShort());
+            trialsStoppedByTimeLimit.increment();
+            break;
+        }
     }
 
     if (_failure) {
@@ -176,6 +176,16 @@ private:
      */
     Status tryYield(PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Called when another operation is ranking the candidate plans for the same query shape.
+     * Waits for it with all locks yielded through 'yieldPolicy', then picks the candidate that
+     * matches the winning plan it cached, if any. Does not wait if 'yieldPolicy' can not release
+     * locks, since the ranking operation may need them.
+     *
+     * Returns a non-OK status if killed during the yield or interrupted.
+     */
+    Status waitForRanking(PlanYieldPolicy* yieldPolicy);
+
     static const int kNoSuchPlan = -1;
 
     // Not owned here. Must be non-null.
@@ -228,6 +238,9 @@ private:
     // just pass a NULL fetcher.
     std::unique_ptr<RecordFetcher> _fetcher;
 
+    // Time spent in tryYield() yielding during the current trial period.
+    Milliseconds _yieldTime{0};
+
     // Stats
     MultiPlanStats _specificStats;
 };
@@ -28,6 +28,8 @@
 
 #include "mongo/db/exec/working_set.h"
 
+#include <algorithm>
+
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/service_context.h"
@@ -42,12 +44,22 @@ namespace dps = ::mongo::dotted_path_support;
 WorkingSet::MemberHolder::MemberHolder() : member(NULL) {}
 WorkingSet::MemberHolder::~MemberHolder() {}
 
+constexpr size_t WorkingSet::kInitialMemberChunkSize;
+constexpr size_t WorkingSet::kMaxMemberChunkSize;
+
 WorkingSet::WorkingSet() : _freeList(INVALID_ID) {}
 
-WorkingSet::~WorkingSet() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
+WorkingSet::~WorkingSet() {}
+
+WorkingSetMember* WorkingSet::_newMember() {
+    if (_lastChunkUsed == _lastChunkSize) {
+        _lastChunkSize = _memberChunks.empty()
+            ? kInitialMemberChunkSize
+            : std::min(_lastChunkSize * 2, kMaxMemberChunkSize);
+        _memberChunks.emplace_back(new WorkingSetMember[_lastChunkSize]);
+        _lastChunkUsed = 0;
     }
+    return &_memberChunks.back()[_lastChunkUsed++];
 }
 
 WorkingSetID WorkingSet::allocate() {
@@ -58,7 +70,7 @@ WorkingSetID WorkingSet::allocate() {
         WorkingSetID id = _data.size();
         _data.resize(_data.size() + 1);
         _data.back().nextFreeOrSelf = id;
-        _data.back().member = new WorkingSetMember();
+        _data.back().member = _newMember();
         return id;
     }
 
@@ -96,10 +108,10 @@ bool WorkingSet::isFlagged(WorkingSetID id) const {
 }
 
 void WorkingSet::clear() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
-    }
     _data.clear();
+    _memberChunks.clear();
+    _lastChunkSize = 0;
+    _lastChunkUsed = 0;
 
     // Since working set is now empty, the free list pointer should
     // point to nothing.
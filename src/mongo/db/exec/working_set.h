@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <boost/container/small_vector.hpp>
+#include <memory>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
@@ -146,14 +148,28 @@ private:
         // Free list link if freed. Points to self if in use.
         WorkingSetID nextFreeOrSelf;
 
-        // Owning pointer
+        // Points into one of the chunks in '_memberChunks'.
         WorkingSetMember* member;
     };
 
+    /**
+     * Returns a member that no MemberHolder points to yet, adding a new chunk if needed.
+     */
+    WorkingSetMember* _newMember();
+
     // All WorkingSetIDs are indexes into this, except for INVALID_ID.
     // Elements are added to _freeList rather than removed when freed.
     std::vector<MemberHolder> _data;
 
+    // The members themselves live in chunks that double in size up to kMaxMemberChunkSize, so a
+    // WorkingSet of N members makes O(log N) heap allocations and its members are close together
+    // in memory. Chunks never move, so pointers returned by get() stay valid as the set grows.
+    static constexpr size_t kInitialMemberChunkSize = 4;
+    static constexpr size_t kMaxMemberChunkSize = 128;
+    std::vector<std::unique_ptr<WorkingSetMember[]>> _memberChunks;
+    size_t _lastChunkSize = 0;
+    size_t _lastChunkUsed = 0;
+
     // Index into _data, forming a linked-list using MemberHolder::nextFreeOrSelf as the next
     // link. INVALID_ID is the list terminator since 0 is a valid index.
     // If _freeList == INVALID_ID, the free list is empty and all elements in _data are in use.
@@ -279,7 +295,11 @@ public:
 
     RecordId recordId;
     Snapshotted<BSONObj> obj;
-    std::vector<IndexKeyDatum> keyData;
+
+    // Members hold keys from a single index, or from two after an index intersection, far more
+    // often than from more, so that many keys are stored inline. Storage is kept when the member
+    // is freed and reused.
+    boost::container::small_vector<IndexKeyDatum, 2> keyData;
 
     // True if this WSM has survived a yield in RID_AND_IDX state.
     // TODO consider replacing by tracking SnapshotIds for IndexKeyDatums.
@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Models an index-only (covered) scan: each result is allocated, given the key it was read from,
+ * handed to the parent stage and freed. The argument is the number of results the parent holds on
+ * to at a time, as a blocking stage such as a sort or an AND would.
+ */
+void BM_WorkingSetCoveredScan(benchmark::State& state) {
+    const BSONObj keyPattern = BSON("a" << 1);
+    const BSONObj key = BSON("" << 1);
+    const size_t numLive = static_cast<size_t>(state.range(0));
+
+    WorkingSet ws;
+    std::vector<WorkingSetID> live;
+    live.reserve(numLive);
+
+    for (auto _ : state) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* member = ws.get(id);
+        member->keyData.push_back(IndexKeyDatum(keyPattern, key, nullptr));
+        ws.transitionToRecordIdAndIdx(id);
+
+        live.push_back(id);
+        if (live.size() > numLive) {
+            for (auto liveId : live) {
+                ws.free(liveId);
+            }
+            live.clear();
+            ws.getAndClearYieldSensitiveIds();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_WorkingSetCoveredScan)->Arg(0)->Arg(100)->Arg(10000);
+
+/**
+ * Models an index intersection, where each result carries keys from two indexes.
+ */
+void BM_WorkingSetTwoKeys(benchmark::State& state) {
+    const BSONObj keyPatternA = BSON("a" << 1);
+    const BSONObj keyPatternB = BSON("b" << 1);
+    const BSONObj key = BSON("" << 1);
+
+    WorkingSet ws;
+    for (auto _ : state) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* member = ws.get(id);
+        member->keyData.push_back(IndexKeyDatum(keyPatternA, key, nullptr));
+        member->keyData.push_back(IndexKeyDatum(keyPatternB, key, nullptr));
+        benchmark::DoNotOptimize(member->getMemUsage());
+        ws.free(id);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_WorkingSetTwoKeys);
+
+/**
+ * Measures filling a WorkingSet with 'state.range(0)' members from empty, as a plan does when it
+ * buffers results, and then clearing it.
+ */
+void BM_WorkingSetFill(benchmark::State& state) {
+    const int64_t numMembers = state.range(0);
+    WorkingSet ws;
+    for (auto _ : state) {
+        for (int64_t i = 0; i < numMembers; ++i) {
+            WorkingSetID id = ws.allocate();
+            ws.get(id)->recordId = RecordId(i);
+        }
+        ws.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * numMembers);
+}
+
+BENCHMARK(BM_WorkingSetFill)->Arg(10)->Arg(1000)->Arg(100000);
+
+}  // namespace
+}  // namespace mongo
@@ -154,4 +154,48 @@ TEST_F(WorkingSetFixture, getDottedFieldFromIndex) {
     ASSERT_FALSE(member->getFieldDotted("y", &elt));
 }
 
+TEST(WorkingSetTest, MembersDoNotMoveAsTheSetGrows) {
+    WorkingSet ws;
+    std::vector<std::pair<WorkingSetID, WorkingSetMember*>> allocated;
+    for (int i = 0; i < 1000; ++i) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* member = ws.get(id);
+        member->recordId = RecordId(i);
+        allocated.emplace_back(id, member);
+    }
+
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQUALS(allocated[i].second, ws.get(allocated[i].first));
+        ASSERT_EQUALS(RecordId(i), allocated[i].second->recordId);
+    }
+}
+
+TEST(WorkingSetTest, FreedMembersAreReused) {
+    WorkingSet ws;
+    WorkingSetID id = ws.allocate();
+    WorkingSetMember* member = ws.get(id);
+    member->keyData.push_back(IndexKeyDatum(BSON("a" << 1), BSON("" << 1), NULL));
+    ws.transitionToRecordIdAndIdx(id);
+    ws.free(id);
+    ASSERT_TRUE(ws.isFree(id));
+
+    WorkingSetID reusedId = ws.allocate();
+    ASSERT_EQUALS(id, reusedId);
+    ASSERT_EQUALS(member, ws.get(reusedId));
+    ASSERT_EQUALS(WorkingSetMember::INVALID, member->getState());
+    ASSERT_TRUE(member->keyData.empty());
+}
+
+TEST(WorkingSetTest, ClearReleasesAllMembers) {
+    WorkingSet ws;
+    for (int i = 0; i < 100; ++i) {
+        ws.allocate();
+    }
+    ws.clear();
+
+    WorkingSetID id = ws.allocate();
+    ASSERT_EQUALS(0U, id);
+    ASSERT_EQUALS(WorkingSetMember::INVALID, ws.get(id)->getState());
+}
+
 }  // namespace
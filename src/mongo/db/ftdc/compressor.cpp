@@ -135,6 +135,7 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
         // 1. Delta Compression
         //   - i.e., we store the difference between pairs of samples, not their absolute values
         //   - this is done in addSamples
+        //   - for kDeltaOfDelta, the difference between consecutive deltas is taken here
         // 2. Run Length Encoding of zeros
         //   - We find consecutive sets of zeros and represent them as a tuple of (0, count - 1).
         //   - Each memeber is stored as VarInt packed integer
@@ -143,9 +144,18 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
         // These byte arrays are added to a buffer which is then concatenated with other chunks and
         // compressed with ZLIB.
         for (std::uint32_t i = 0; i < _metricsCount; i++) {
+            std::uint64_t prevDelta = 0;
+
             for (std::uint32_t j = 0; j < _deltaCount; j++) {
                 std::uint64_t delta = _deltas[getArrayOffset(_maxDeltas, j, i)];
 
+                // For delta-of-delta, the first delta of each metric is stored relative to zero.
+                if (_encoding == Encoding::kDeltaOfDelta) {
+                    std::uint64_t deltaOfDelta = zigZagEncode(delta - prevDelta);
+                    prevDelta = delta;
+                    delta = deltaOfDelta;
+                }
+
                 if (delta == 0) {
                     ++zeroesCount;
                     continue;
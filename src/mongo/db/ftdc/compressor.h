@@ -56,6 +56,10 @@ namespace mongo {
  * 4. Encodes zeros in Run Length Encoded pairs of <Count, Zero>
  * 5. ZLIB compresses the final processed array
  *
+ * With Encoding::kDeltaOfDelta, step 2 instead stores the ZigZag encoded difference between
+ * consecutive deltas of a metric. Counters sampled at a high frequency grow at a nearly constant
+ * rate, so their second differences are mostly zero and collapse into the zero runs of step 4.
+ *
  * NOTE: This compression ignores non-number data, and assumes the non-number data is constant
  * across all documents in the series of documents.
  */
@@ -79,7 +83,24 @@ public:
         kCompressorFull,
     };
 
-    explicit FTDCCompressor(const FTDCConfig* config) : _config(config) {}
+    /**
+     * How the samples following the reference document are encoded.
+     */
+    enum class Encoding {
+        /**
+         * Difference between consecutive samples. Used for kMetricChunk.
+         */
+        kDelta,
+
+        /**
+         * ZigZag encoded difference between consecutive deltas. Used for
+         * kHighFrequencyMetricChunk.
+         */
+        kDeltaOfDelta,
+    };
+
+    explicit FTDCCompressor(const FTDCConfig* config, Encoding encoding = Encoding::kDelta)
+        : _config(config), _encoding(encoding) {}
 
     /**
      * Add a bson document containing metrics into the compressor.
@@ -143,6 +164,21 @@ public:
         return metric * sampleCount + sample;
     }
 
+    /**
+     * Map a two's complement value onto an unsigned value so that numbers of small magnitude,
+     * negative or positive, pack into few VarInt bytes.
+     */
+    static std::uint64_t zigZagEncode(std::uint64_t value) {
+        return (value << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(value) >> 63);
+    }
+
+    /**
+     * Inverse of zigZagEncode.
+     */
+    static std::uint64_t zigZagDecode(std::uint64_t value) {
+        return (value >> 1) ^ (~(value & 1) + 1);
+    }
+
 private:
     /**
      * Reset the state
@@ -156,6 +192,9 @@ private:
     // Config
     const FTDCConfig* const _config;
 
+    // Encoding of the samples following the reference document
+    const Encoding _encoding;
+
     // Reference schema document
     BSONObj _referenceDoc;
 
@@ -31,6 +31,7 @@
 #include <limits>
 #include <random>
 
+#include "mongo/base/data_view.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobjbuilder.h"
@@ -125,7 +126,8 @@ TEST(FTDCCompressor, TestStrings) {
  */
 class TestTie {
 public:
-    TestTie() : _compressor(&_config) {}
+    TestTie(FTDCCompressor::Encoding encoding = FTDCCompressor::Encoding::kDelta)
+        : _encoding(encoding), _compressor(&_config, encoding) {}
 
     ~TestTie() {
         validate(boost::none);
@@ -157,13 +159,13 @@ public:
     void validate(boost::optional<ConstDataRange> cdr) {
         std::vector<BSONObj> list;
         if (cdr.is_initialized()) {
-            auto sw = _decompressor.uncompress(cdr.get());
+            auto sw = _decompressor.uncompress(cdr.get(), _encoding);
             ASSERT_TRUE(sw.isOK());
             list = sw.getValue();
         } else {
             auto swBuf = _compressor.getCompressedSamples();
             ASSERT_TRUE(swBuf.isOK());
-            auto sw = _decompressor.uncompress(std::get<0>(swBuf.getValue()));
+            auto sw = _decompressor.uncompress(std::get<0>(swBuf.getValue()), _encoding);
             ASSERT_TRUE(sw.isOK());
 
             list = sw.getValue();
@@ -175,6 +177,7 @@ public:
 private:
     std::vector<BSONObj> _docs;
     FTDCConfig _config;
+    const FTDCCompressor::Encoding _encoding;
     FTDCCompressor _compressor;
     FTDCDecompressor _decompressor;
 };
@@ -497,6 +500,100 @@ TEST(FTDCCompressor, TestFull) {
     }
 }
 
+TEST(FTDCCompressor, ZigZag) {
+    for (long long value : {0LL,
+                            1LL,
+                            -1LL,
+                            63LL,
+                            -64LL,
+                            std::numeric_limits<long long>::max(),
+                            std::numeric_limits<long long>::min()}) {
+        auto encoded = FTDCCompressor::zigZagEncode(static_cast<std::uint64_t>(value));
+        ASSERT_EQUALS(static_cast<long long>(FTDCCompressor::zigZagDecode(encoded)), value);
+    }
+
+    // Small magnitudes map to small values regardless of sign
+    ASSERT_EQUALS(FTDCCompressor::zigZagEncode(static_cast<std::uint64_t>(-1LL)), 1ULL);
+    ASSERT_EQUALS(FTDCCompressor::zigZagEncode(1), 2ULL);
+}
+
+// Test delta-of-delta round trips counters, gauges, and values that wrap around
+TEST(FTDCCompressor, TestDeltaOfDelta) {
+    for (int j = 0; j < 2; j++) {
+        TestTie c(FTDCCompressor::Encoding::kDeltaOfDelta);
+
+        auto st = c.addSample(BSON("name"
+                                   << "joe"
+                                   << "counter"
+                                   << 0LL
+                                   << "gauge"
+                                   << 10
+                                   << "extreme"
+                                   << std::numeric_limits<long long>::max()));
+        ASSERT_HAS_SPACE(st);
+
+        for (size_t i = 1; i != FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 1; i++) {
+            long long extreme = (i % 2) ? std::numeric_limits<long long>::min()
+                                        : std::numeric_limits<long long>::max();
+            st = c.addSample(BSON("name"
+                                  << "joe"
+                                  << "counter"
+                                  << static_cast<long long>(i * 1000 * (j + 1))
+                                  << "gauge"
+                                  << static_cast<int>((i * 7) % 13) - 6
+                                  << "extreme"
+                                  << extreme));
+            ASSERT_HAS_SPACE(st);
+        }
+
+        st = c.addSample(BSON("name"
+                              << "joe"
+                              << "counter"
+                              << 34LL
+                              << "gauge"
+                              << 45
+                              << "extreme"
+                              << 0LL));
+        ASSERT_FULL(st);
+
+        // Add Value
+        st = c.addSample(BSON("name"
+                              << "joe"
+                              << "counter"
+                              << 34LL
+                              << "gauge"
+                              << 45
+                              << "extreme"
+                              << 0LL));
+        ASSERT_HAS_SPACE(st);
+    }
+}
+
+// Test delta-of-delta encodes counters that grow at a steady rate into less data than delta
+TEST(FTDCCompressor, TestDeltaOfDeltaSteadyCounters) {
+    FTDCConfig config;
+    FTDCCompressor delta(&config, FTDCCompressor::Encoding::kDelta);
+    FTDCCompressor deltaOfDelta(&config, FTDCCompressor::Encoding::kDeltaOfDelta);
+
+    for (long long i = 0; i < 100; i++) {
+        BSONObj sample = BSON("a" << i * 1000 << "b" << i * 5000 << "c" << i * 123456);
+        auto st = delta.addSample(sample, Date_t());
+        ASSERT_HAS_SPACE(st);
+        st = deltaOfDelta.addSample(sample, Date_t());
+        ASSERT_HAS_SPACE(st);
+    }
+
+    // The first 4 bytes of a compressed chunk are its uncompressed length
+    auto uncompressedLength = [](FTDCCompressor& compressor) {
+        auto swBuf = compressor.getCompressedSamples();
+        ASSERT_OK(swBuf.getStatus());
+        return ConstDataView(std::get<0>(swBuf.getValue()).data())
+            .read<LittleEndian<std::uint32_t>>();
+    };
+
+    ASSERT_LT(uncompressedLength(deltaOfDelta), uncompressedLength(delta));
+}
+
 template <typename T>
 BSONObj generateSample(std::random_device& rd, T generator, size_t count) {
     BSONObjBuilder builder;
@@ -46,7 +46,9 @@ struct FTDCConfig {
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault),
+          highFrequencyEnabled(kHighFrequencyEnabledDefault),
+          highFrequencyPeriod(kHighFrequencyPeriodMillisDefault) {}
 
     /**
      * True if FTDC is collecting data. False otherwise
@@ -83,9 +85,22 @@ struct FTDCConfig {
      */
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * True if the high frequency collectors are run in addition to the periodic collectors.
+     */
+    bool highFrequencyEnabled;
+
+    /**
+     * Period at which to run the high frequency collectors. Samples are aligned to this period
+     * the same way periodic samples are aligned to period.
+     */
+    Milliseconds highFrequencyPeriod;
+
     static const bool kEnabledDefault = true;
+    static const bool kHighFrequencyEnabledDefault = false;
 
     static const std::int64_t kPeriodMillisDefault;
+    static const std::int64_t kHighFrequencyPeriodMillisDefault;
     static const std::uint64_t kMaxDirectorySizeBytesDefault = 200 * 1024 * 1024;
     static const std::uint64_t kMaxFileSizeBytesDefault = 10 * 1024 * 1024;
 
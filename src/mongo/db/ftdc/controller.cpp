@@ -32,6 +32,8 @@
 
 #include "mongo/db/ftdc/controller.h"
 
+#include <algorithm>
+
 #include "mongo/db/client.h"
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/util.h"
@@ -92,6 +94,18 @@ void FTDCController::setMaxSamplesPerInterimMetricChunk(size_t size) {
     _condvar.notify_one();
 }
 
+void FTDCController::setHighFrequencyEnabled(bool enabled) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.highFrequencyEnabled = enabled;
+    _condvar.notify_one();
+}
+
+void FTDCController::setHighFrequencyPeriod(Milliseconds millis) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.highFrequencyPeriod = millis;
+    _condvar.notify_one();
+}
+
 Status FTDCController::setDirectory(const boost::filesystem::path& path) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
 
@@ -118,6 +132,15 @@ void FTDCController::addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface
     }
 }
 
+void FTDCController::addHighFrequencyCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        invariant(_state == State::kNotStarted);
+
+        _highFrequencyCollectors.add(std::move(collector));
+    }
+}
+
 void FTDCController::addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
@@ -202,13 +225,28 @@ void FTDCController::doLoop() {
             // Get next time to run at
             auto next_time = FTDCUtil::roundTime(now, _config.period);
 
+            // When high frequency collection is enabled, wake up for whichever sample is due first.
+            // Both are due together when the periods line up.
+            auto wake_time = next_time;
+            bool collectPeriodic = true;
+            bool collectHighFrequency = false;
+
+            if (_config.highFrequencyEnabled) {
+                auto next_high_frequency_time =
+                    FTDCUtil::roundTime(now, _config.highFrequencyPeriod);
+
+                wake_time = std::min(next_time, next_high_frequency_time);
+                collectPeriodic = (next_time == wake_time);
+                collectHighFrequency = (next_high_frequency_time == wake_time);
+            }
+
             // Wait for the next run or signal to shutdown
             {
                 stdx::unique_lock<stdx::mutex> lock(_mutex);
                 MONGO_IDLE_THREAD_BLOCK;
 
                 // We ignore spurious wakeups by just doing an iteration of the loop
-                auto status = _condvar.wait_until(lock, next_time.toSystemTimePoint());
+                auto status = _condvar.wait_until(lock, wake_time.toSystemTimePoint());
 
                 // Are we done running?
                 if (_state == State::kStopRequested) {
@@ -241,17 +279,30 @@ void FTDCController::doLoop() {
                     _mgr = uassertStatusOK(std::move(swMgr));
                 }
 
-                auto collectSample = _periodicCollectors.collect(client);
+                if (collectHighFrequency) {
+                    auto collectSample = _highFrequencyCollectors.collect(client);
+
+                    if (!std::get<0>(collectSample).isEmpty()) {
+                        Status s = _mgr->writeHighFrequencySampleAndRotateIfNeeded(
+                            client, std::get<0>(collectSample), std::get<1>(collectSample));
+
+                        uassertStatusOK(s);
+                    }
+                }
+
+                if (collectPeriodic) {
+                    auto collectSample = _periodicCollectors.collect(client);
 
-                Status s = _mgr->writeSampleAndRotateIfNeeded(
-                    client, std::get<0>(collectSample), std::get<1>(collectSample));
+                    Status s = _mgr->writeSampleAndRotateIfNeeded(
+                        client, std::get<0>(collectSample), std::get<1>(collectSample));
 
-                uassertStatusOK(s);
+                    uassertStatusOK(s);
 
-                // Store a reference to the most recent document from the periodic collectors
-                {
-                    stdx::lock_guard<stdx::mutex> lock(_mutex);
-                    _mostRecentPeriodicDocument = std::get<0>(collectSample);
+                    // Store a reference to the most recent document from the periodic collectors
+                    {
+                        stdx::lock_guard<stdx::mutex> lock(_mutex);
+                        _mostRecentPeriodicDocument = std::get<0>(collectSample);
+                    }
                 }
             }
         }
@@ -98,6 +98,16 @@ public:
      */
     void setMaxSamplesPerInterimMetricChunk(size_t size);
 
+    /**
+     * Set whether the high frequency collectors are run.
+     */
+    void setHighFrequencyEnabled(bool enabled);
+
+    /**
+     * Set the period for high frequency data collection.
+     */
+    void setHighFrequencyPeriod(Milliseconds millis);
+
     /*
      * Set the path to store FTDC files if not already set.
      *
@@ -110,6 +120,12 @@ public:
      */
     void addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector);
 
+    /**
+     * Add a metric collector to collect at the high frequency period when enabled. It should be
+     * cheap since it runs many times a second, i.e., a few serverStatus sections.
+     */
+    void addHighFrequencyCollector(std::unique_ptr<FTDCCollectorInterface> collector);
+
     /**
      * Add a collector to collect on server start, and file rotation. i.e. hostInfo
      *
@@ -203,6 +219,9 @@ private:
     // Owned
     BSONObj _mostRecentPeriodicDocument;
 
+    // Set of high frequency collectors
+    FTDCCollectorCollection _highFrequencyCollectors;
+
     // Set of file rotation collectors
     FTDCCollectorCollection _rotateCollectors;
 
@@ -41,7 +41,8 @@
 
 namespace mongo {
 
-StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf) {
+StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf,
+                                                               FTDCCompressor::Encoding encoding) {
     ConstDataRangeCursor compressedDataRange(buf);
 
     // Read the length of the uncompressed buffer
@@ -157,6 +158,18 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
         }
     }
 
+    // Sum the deltas of deltas back into deltas
+    if (encoding == FTDCCompressor::Encoding::kDeltaOfDelta) {
+        for (std::uint32_t i = 0; i < metricsCount; i++) {
+            std::uint64_t delta = 0;
+            for (std::uint32_t j = 0; j < sampleCount; j++) {
+                auto offset = FTDCCompressor::getArrayOffset(sampleCount, j, i);
+                delta += FTDCCompressor::zigZagDecode(deltas[offset]);
+                deltas[offset] = delta;
+            }
+        }
+    }
+
     // Inflate the deltas
     for (std::uint32_t i = 0; i < metricsCount; i++) {
         deltas[FTDCCompressor::getArrayOffset(sampleCount, 0, i)] += metrics[i];
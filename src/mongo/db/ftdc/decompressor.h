@@ -34,6 +34,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/db/ftdc/block_compressor.h"
+#include "mongo/db/ftdc/compressor.h"
 #include "mongo/db/jsobj.h"
 
 namespace mongo {
@@ -53,8 +54,11 @@ public:
      * Will fail if the chunk is corrupt or too short.
      *
      * Returns N samples where N = sample count + 1. The 1 is the reference document.
+     *
+     * encoding must match the encoding of the FTDCCompressor that produced the chunk.
      */
-    StatusWith<std::vector<BSONObj>> uncompress(ConstDataRange buf);
+    StatusWith<std::vector<BSONObj>> uncompress(
+        ConstDataRange buf, FTDCCompressor::Encoding encoding = FTDCCompressor::Encoding::kDelta);
 
 private:
     BlockCompressor _compressor;
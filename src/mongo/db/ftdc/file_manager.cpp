@@ -177,6 +177,13 @@ Status FTDCFileManager::openArchiveFile(
         if (std::get<0>(triplet) == FTDCBSONUtil::FTDCType::kMetadata) {
             Status s = _writer.writeMetadata(std::get<1>(triplet), std::get<2>(triplet));
 
+            if (!s.isOK()) {
+                return s;
+            }
+        } else if (std::get<0>(triplet) == FTDCBSONUtil::FTDCType::kHighFrequencyMetricChunk) {
+            Status s =
+                _writer.writeHighFrequencySample(std::get<1>(triplet), std::get<2>(triplet));
+
             if (!s.isOK()) {
                 return s;
             }
@@ -306,6 +313,22 @@ Status FTDCFileManager::writeSampleAndRotateIfNeeded(Client* client,
     return Status::OK();
 }
 
+Status FTDCFileManager::writeHighFrequencySampleAndRotateIfNeeded(Client* client,
+                                                                  const BSONObj& sample,
+                                                                  Date_t date) {
+    Status s = _writer.writeHighFrequencySample(sample, date);
+
+    if (!s.isOK()) {
+        return s;
+    }
+
+    if (_writer.getSize() > _config->maxFileSizeBytes) {
+        return rotate(client);
+    }
+
+    return Status::OK();
+}
+
 Status FTDCFileManager::close() {
     return _writer.close();
 }
@@ -90,8 +90,10 @@ StatusWith<bool> FTDCFileReader::hasNext() {
                 }
 
                 _metadata = swMetadata.getValue();
-            } else if (type == FTDCBSONUtil::FTDCType::kMetricChunk) {
+            } else if (type == FTDCBSONUtil::FTDCType::kMetricChunk ||
+                       type == FTDCBSONUtil::FTDCType::kHighFrequencyMetricChunk) {
                 _state = State::kMetricChunk;
+                _chunkType = type;
 
                 auto swDocs = FTDCBSONUtil::getMetricsFromMetricDoc(_parent, &_decompressor);
                 if (!swDocs.isOK()) {
@@ -138,7 +140,7 @@ std::tuple<FTDCBSONUtil::FTDCType, const BSONObj&, Date_t> FTDCFileReader::next(
 
     if (_state == State::kMetricChunk) {
         return std::tuple<FTDCBSONUtil::FTDCType, const BSONObj&, Date_t>(
-            FTDCBSONUtil::FTDCType::kMetricChunk, _docs[_pos], _dateId);
+            _chunkType, _docs[_pos], _dateId);
     }
 
     MONGO_UNREACHABLE;
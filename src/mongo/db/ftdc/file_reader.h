@@ -69,6 +69,7 @@ public:
 
     /**
      * Returns the next document.
+     * Samples from a high frequency metric chunk are returned with kHighFrequencyMetricChunk.
      * Metadata documents are unowned.
      * Metric documents are owned.
      */
@@ -122,6 +123,9 @@ private:
     // Current set of metrics documents
     std::vector<BSONObj> _docs;
 
+    // Type of the current metric chunk
+    FTDCBSONUtil::FTDCType _chunkType{FTDCBSONUtil::FTDCType::kMetricChunk};
+
     // _id of current metadata or metric chunk
     Date_t _dateId;
 
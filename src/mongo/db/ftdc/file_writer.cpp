@@ -76,10 +76,28 @@ Status FTDCFileWriter::open(const boost::filesystem::path& file) {
     _interimTempFile = FTDCUtil::getInterimTempFile(file);
 
     _compressor.reset();
+    _highFrequencyCompressor.reset();
+    _interimDoc = BSONObj();
+    _highFrequencyInterimDoc = BSONObj();
 
     return Status::OK();
 }
 
+Status FTDCFileWriter::writeInterimFile() {
+    if (_interimDoc.isEmpty() && _highFrequencyInterimDoc.isEmpty()) {
+        boost::filesystem::remove(_interimFile);
+        _sizeInterim = 0;
+        return Status::OK();
+    }
+
+    BufBuilder buf;
+    for (const auto& doc : {_interimDoc, _highFrequencyInterimDoc}) {
+        buf.appendBuf(doc.objdata(), doc.isEmpty() ? 0 : doc.objsize());
+    }
+
+    return writeInterimFileBuffer({buf.buf(), static_cast<size_t>(buf.len())});
+}
+
 Status FTDCFileWriter::writeInterimFileBuffer(ConstDataRange buf) {
     // Fixed size interim stream
     std::ofstream interimStream;
@@ -152,43 +170,54 @@ Status FTDCFileWriter::writeMetadata(const BSONObj& metadata, Date_t date) {
 }
 
 Status FTDCFileWriter::writeSample(const BSONObj& sample, Date_t date) {
-    auto ret = _compressor.addSample(sample, date);
+    return writeSample(metricStream(), sample, date);
+}
+
+Status FTDCFileWriter::writeHighFrequencySample(const BSONObj& sample, Date_t date) {
+    return writeSample(highFrequencyMetricStream(), sample, date);
+}
+
+Status FTDCFileWriter::writeSample(const Stream& stream, const BSONObj& sample, Date_t date) {
+    FTDCCompressor* compressor = stream.compressor;
+    auto ret = compressor->addSample(sample, date);
 
     if (!ret.isOK()) {
         return ret.getStatus();
     }
 
     if (ret.getValue().is_initialized()) {
-        return flush(std::get<0>(ret.getValue().get()), std::get<2>(ret.getValue().get()));
+        return flush(stream, std::get<0>(ret.getValue().get()), std::get<2>(ret.getValue().get()));
     }
 
-    if (_compressor.getSampleCount() != 0 &&
-        (_compressor.getSampleCount() % _config->maxSamplesPerInterimMetricChunk) == 0) {
+    if (compressor->getSampleCount() != 0 &&
+        (compressor->getSampleCount() % _config->maxSamplesPerInterimMetricChunk) == 0) {
         // Check if we want to do a partial write to the interim buffer
-        auto swBuf = _compressor.getCompressedSamples();
+        auto swBuf = compressor->getCompressedSamples();
         if (!swBuf.isOK()) {
             return swBuf.getStatus();
         }
 
-        BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(swBuf.getValue()),
-                                                                std::get<1>(swBuf.getValue()));
-        return writeInterimFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
+        *stream.interimDoc = FTDCBSONUtil::createBSONMetricChunkDocument(
+            std::get<0>(swBuf.getValue()), std::get<1>(swBuf.getValue()), stream.type);
+        return writeInterimFile();
     }
 
     return Status::OK();
 }
 
-Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_t date) {
+Status FTDCFileWriter::flush(const Stream& stream,
+                             const boost::optional<ConstDataRange>& range,
+                             Date_t date) {
     if (!range.is_initialized()) {
-        if (_compressor.hasDataToFlush()) {
-            auto swBuf = _compressor.getCompressedSamples();
+        if (stream.compressor->hasDataToFlush()) {
+            auto swBuf = stream.compressor->getCompressedSamples();
 
             if (!swBuf.isOK()) {
                 return swBuf.getStatus();
             }
 
-            BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(swBuf.getValue()),
-                                                                    std::get<1>(swBuf.getValue()));
+            BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(
+                std::get<0>(swBuf.getValue()), std::get<1>(swBuf.getValue()), stream.type);
             Status s = writeArchiveFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
 
             if (!s.isOK()) {
@@ -196,7 +225,7 @@ Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_
             }
         }
     } else {
-        BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(range.get(), date);
+        BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(range.get(), date, stream.type);
         Status s = writeArchiveFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
 
         if (!s.isOK()) {
@@ -204,17 +233,22 @@ Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_
         }
     }
 
-    boost::filesystem::remove(_interimFile);
+    *stream.interimDoc = BSONObj();
 
-    return Status::OK();
+    return writeInterimFile();
 }
 
 Status FTDCFileWriter::close() {
     if (_archiveStream.is_open()) {
-        Status s = flush(boost::none, Date_t());
+        Status s = flush(metricStream(), boost::none, Date_t());
+        Status sHighFrequency = flush(highFrequencyMetricStream(), boost::none, Date_t());
 
         _archiveStream.close();
 
+        if (s.isOK()) {
+            return sHighFrequency;
+        }
+
         return s;
     }
 
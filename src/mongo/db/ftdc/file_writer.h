@@ -36,6 +36,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/db/ftdc/compressor.h"
+#include "mongo/db/ftdc/util.h"
 #include "mongo/db/jsobj.h"
 
 namespace mongo {
@@ -53,6 +54,9 @@ namespace mongo {
  * The chunks in the archive stream will have better compression since it compresses larger chunks
  * of data.
  *
+ * High frequency samples are compressed separately with delta-of-delta encoding and written as
+ * kHighFrequencyMetricChunk documents. The interim file holds the partial chunk of each stream.
+ *
  * File format is compatible with mongodump as it is just a sequential series of bson documents
  *
  * File rotation and cleanup is not handled by this class.
@@ -61,7 +65,10 @@ class FTDCFileWriter {
     MONGO_DISALLOW_COPYING(FTDCFileWriter);
 
 public:
-    FTDCFileWriter(const FTDCConfig* config) : _config(config), _compressor(_config) {}
+    FTDCFileWriter(const FTDCConfig* config)
+        : _config(config),
+          _compressor(_config),
+          _highFrequencyCompressor(_config, FTDCCompressor::Encoding::kDeltaOfDelta) {}
     ~FTDCFileWriter();
 
     /**
@@ -79,6 +86,11 @@ public:
      */
     Status writeSample(const BSONObj& sample, Date_t date);
 
+    /**
+     * Write a high frequency sample to interim and/or archive log as needed.
+     */
+    Status writeHighFrequencySample(const BSONObj& sample, Date_t date);
+
     /**
      * Close all the files and shutdown cleanly by zeroing the beginning of the interim file.
      */
@@ -101,9 +113,41 @@ public:
 
 private:
     /**
-     * Flush all changes to disk.
+     * State of one compressed stream of samples.
+     */
+    struct Stream {
+        FTDCCompressor* compressor;
+        FTDCBSONUtil::FTDCType type;
+
+        // Partial metric chunk last written to the interim file
+        BSONObj* interimDoc;
+    };
+
+    Stream metricStream() {
+        return {&_compressor, FTDCBSONUtil::FTDCType::kMetricChunk, &_interimDoc};
+    }
+
+    Stream highFrequencyMetricStream() {
+        return {&_highFrequencyCompressor,
+                FTDCBSONUtil::FTDCType::kHighFrequencyMetricChunk,
+                &_highFrequencyInterimDoc};
+    }
+
+    /**
+     * Write a sample to the given stream.
+     */
+    Status writeSample(const Stream& stream, const BSONObj& sample, Date_t date);
+
+    /**
+     * Flush all changes of a stream to disk.
      */
-    Status flush(const boost::optional<ConstDataRange>&, Date_t date);
+    Status flush(const Stream& stream, const boost::optional<ConstDataRange>&, Date_t date);
+
+    /**
+     * Rewrite the interim file with the partial chunks of both streams, or remove it if there are
+     * none.
+     */
+    Status writeInterimFile();
 
     /**
      * Write a buffer to the beginning of the interim file.
@@ -134,6 +178,13 @@ private:
     // FTDC compressor
     FTDCCompressor _compressor;
 
+    // FTDC compressor for high frequency samples
+    FTDCCompressor _highFrequencyCompressor;
+
+    // Partial metric chunks in the interim file
+    BSONObj _interimDoc;
+    BSONObj _highFrequencyInterimDoc;
+
     // Size of archive file
     std::size_t _size{0};
 
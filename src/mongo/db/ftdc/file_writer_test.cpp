@@ -37,6 +37,7 @@
 #include "mongo/db/ftdc/file_reader.h"
 #include "mongo/db/ftdc/file_writer.h"
 #include "mongo/db/ftdc/ftdc_test.h"
+#include "mongo/db/ftdc/util.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/temp_dir.h"
@@ -149,6 +150,118 @@ TEST(FTDCFileTest, TestFileBasicCompress) {
     ASSERT_EQUALS(sw.getValue(), false);
 }
 
+// Test high frequency samples are written to their own chunks and read back with their type
+TEST(FTDCFileTest, TestHighFrequencySamples) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path p(tempdir.path());
+    p /= kTestFile;
+
+    deleteFileIfNeeded(p);
+
+    FTDCConfig config;
+    FTDCFileWriter writer(&config);
+
+    ASSERT_OK(writer.open(p));
+
+    std::vector<BSONObj> samples;
+    std::vector<BSONObj> highFrequencySamples;
+
+    for (int i = 0; i < 500; i++) {
+        BSONObj highFrequencySample = BSON("name"
+                                           << "joe"
+                                           << "key1"
+                                           << i * 100
+                                           << "key2"
+                                           << i % 7);
+        ASSERT_OK(writer.writeHighFrequencySample(highFrequencySample, Date_t()));
+        highFrequencySamples.emplace_back(highFrequencySample);
+
+        if (i % 10 == 0) {
+            BSONObj sample = BSON("name"
+                                  << "joe"
+                                  << "key3"
+                                  << i);
+            ASSERT_OK(writer.writeSample(sample, Date_t()));
+            samples.emplace_back(sample);
+        }
+    }
+
+    ASSERT_OK(writer.close());
+
+    FTDCFileReader reader;
+    ASSERT_OK(reader.open(p));
+
+    std::vector<BSONObj> samplesRead;
+    std::vector<BSONObj> highFrequencySamplesRead;
+
+    auto sw = reader.hasNext();
+    for (; sw.isOK() && sw.getValue(); sw = reader.hasNext()) {
+        auto triplet = reader.next();
+        if (std::get<0>(triplet) == FTDCBSONUtil::FTDCType::kHighFrequencyMetricChunk) {
+            highFrequencySamplesRead.emplace_back(std::get<1>(triplet).getOwned());
+        } else {
+            ASSERT_TRUE(std::get<0>(triplet) == FTDCBSONUtil::FTDCType::kMetricChunk);
+            samplesRead.emplace_back(std::get<1>(triplet).getOwned());
+        }
+    }
+
+    ASSERT_OK(sw);
+
+    ValidateDocumentList(samplesRead, samples);
+    ValidateDocumentList(highFrequencySamplesRead, highFrequencySamples);
+}
+
+// Test the interim file holds the partial chunks of both regular and high frequency samples
+TEST(FTDCFileTest, TestHighFrequencyInterimFile) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path p(tempdir.path());
+    p /= kTestFile;
+
+    deleteFileIfNeeded(p);
+
+    FTDCConfig config;
+    FTDCFileWriter writer(&config);
+
+    ASSERT_OK(writer.open(p));
+
+    std::vector<BSONObj> samples;
+    std::vector<BSONObj> highFrequencySamples;
+
+    // One reference document plus enough deltas to trigger an interim write for each stream
+    for (std::uint32_t i = 0; i <= config.maxSamplesPerInterimMetricChunk; i++) {
+        BSONObj highFrequencySample = BSON("key1" << static_cast<int>(i * 3));
+        ASSERT_OK(writer.writeHighFrequencySample(highFrequencySample, Date_t()));
+        highFrequencySamples.emplace_back(highFrequencySample);
+
+        BSONObj sample = BSON("key2" << static_cast<int>(i));
+        ASSERT_OK(writer.writeSample(sample, Date_t()));
+        samples.emplace_back(sample);
+    }
+
+    writer.closeWithoutFlushForTest();
+
+    FTDCFileReader reader;
+    ASSERT_OK(reader.open(FTDCUtil::getInterimFile(p)));
+
+    std::vector<BSONObj> samplesRead;
+    std::vector<BSONObj> highFrequencySamplesRead;
+
+    auto sw = reader.hasNext();
+    for (; sw.isOK() && sw.getValue(); sw = reader.hasNext()) {
+        auto triplet = reader.next();
+        if (std::get<0>(triplet) == FTDCBSONUtil::FTDCType::kHighFrequencyMetricChunk) {
+            highFrequencySamplesRead.emplace_back(std::get<1>(triplet).getOwned());
+        } else {
+            samplesRead.emplace_back(std::get<1>(triplet).getOwned());
+        }
+    }
+
+    ASSERT_OK(sw);
+
+    ValidateDocumentList(samplesRead, samples);
+    ValidateDocumentList(highFrequencySamplesRead, highFrequencySamples);
+}
+
 /**
  * Validates all the data that gets written to file is returned as is
  */
@@ -37,6 +37,7 @@
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/controller.h"
@@ -241,6 +242,64 @@ public:
     }
 
 } exportedFTDCInterimChunkSizeParameter;
+
+AtomicBool localHighFrequencyEnabledFlag(FTDCConfig::kHighFrequencyEnabledDefault);
+
+class ExportedFTDCHighFrequencyEnabledParameter
+    : public ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCHighFrequencyEnabledParameter()
+        : ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionHighFrequencyEnabled",
+              &localHighFrequencyEnabledFlag) {}
+
+    virtual Status validate(const bool& potentialNewValue) {
+        auto controller = getGlobalFTDCController();
+        if (controller) {
+            controller->setHighFrequencyEnabled(potentialNewValue);
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCHighFrequencyEnabledParameter;
+
+AtomicInt32 localHighFrequencyPeriodMillis(FTDCConfig::kHighFrequencyPeriodMillisDefault);
+
+class ExportedFTDCHighFrequencyPeriodParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCHighFrequencyPeriodParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionHighFrequencyPeriodMillis",
+              &localHighFrequencyPeriodMillis) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue < 10) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionHighFrequencyPeriodMillis must be greater than "
+                          "or equal to 10ms");
+        }
+
+        auto controller = getGlobalFTDCController();
+        if (controller) {
+            controller->setHighFrequencyPeriod(Milliseconds(potentialNewValue));
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCHighFrequencyPeriodParameter;
+
+// The serverStatus sections sampled by the high frequency collector. These should be cheap to
+// generate and change every sample, so that they capture short stalls.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(
+    diagnosticDataCollectionHighFrequencySections,
+    std::vector<std::string>,
+    (std::vector<std::string>{"globalLock", "opLatencies", "opcounters", "connections"}));
+
 }  // namespace
 
 FTDCSimpleInternalCommandCollector::FTDCSimpleInternalCommandCollector(StringData command,
@@ -261,6 +320,18 @@ std::string FTDCSimpleInternalCommandCollector::name() const {
     return _name;
 }
 
+FTDCServerStatusSectionsCollector::FTDCServerStatusSectionsCollector(
+    std::vector<std::string> sectionNames)
+    : _sectionNames(std::move(sectionNames)) {}
+
+void FTDCServerStatusSectionsCollector::collect(OperationContext* opCtx, BSONObjBuilder& builder) {
+    appendServerStatusSections(opCtx, _sectionNames, &builder);
+}
+
+std::string FTDCServerStatusSectionsCollector::name() const {
+    return "serverStatus";
+}
+
 // Register the FTDC system
 // Note: This must be run before the server parameters are parsed during startup
 // so that the FTDCController is initialized.
@@ -278,6 +349,8 @@ void startFTDC(boost::filesystem::path& path,
     config.maxDirectorySizeBytes = localMaxDirectorySizeMB.load() * 1024 * 1024;
     config.maxSamplesPerArchiveMetricChunk = localMaxSamplesPerArchiveMetricChunk.load();
     config.maxSamplesPerInterimMetricChunk = localMaxSamplesPerInterimMetricChunk.load();
+    config.highFrequencyEnabled = localHighFrequencyEnabledFlag.load();
+    config.highFrequencyPeriod = Milliseconds(localHighFrequencyPeriodMillis.load());
 
     auto controller = stdx::make_unique<FTDCController>(path, config);
 
@@ -300,6 +373,11 @@ void startFTDC(boost::filesystem::path& path,
 
     registerCollectors(controller.get());
 
+    // Install high frequency collectors
+    // These are collected on the high frequency period in FTDCConfig when it is enabled.
+    controller->addHighFrequencyCollector(stdx::make_unique<FTDCServerStatusSectionsCollector>(
+        diagnosticDataCollectionHighFrequencySections));
+
     // Install System Metric Collector as a periodic collector
     installSystemMetricsCollector(controller.get());
 
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands.h"
@@ -96,4 +97,19 @@ private:
     const OpMsgRequest _request;
 };
 
+/**
+ * An FTDC Collector that appends a fixed set of serverStatus sections. It skips the fields the
+ * serverStatus command always returns so that it is cheap enough for high frequency collection.
+ */
+class FTDCServerStatusSectionsCollector final : public FTDCCollectorInterface {
+public:
+    explicit FTDCServerStatusSectionsCollector(std::vector<std::string> sectionNames);
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) override;
+    std::string name() const override;
+
+private:
+    const std::vector<std::string> _sectionNames;
+};
+
 }  // namespace mongo
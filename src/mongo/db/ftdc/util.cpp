@@ -64,6 +64,7 @@ const char kFTDCCollectStartField[] = "start";
 const char kFTDCCollectEndField[] = "end";
 
 const std::int64_t FTDCConfig::kPeriodMillisDefault = 1000;
+const std::int64_t FTDCConfig::kHighFrequencyPeriodMillisDefault = 100;
 
 const std::size_t kMaxRecursion = 10;
 
@@ -352,11 +353,13 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date) {
     return builder.obj();
 }
 
-BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t date) {
+BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t date, FTDCType type) {
+    dassert(type == FTDCType::kMetricChunk || type == FTDCType::kHighFrequencyMetricChunk);
+
     BSONObjBuilder builder;
 
     builder.appendDate(kFTDCIdField, date);
-    builder.appendNumber(kFTDCTypeField, static_cast<int>(FTDCType::kMetricChunk));
+    builder.appendNumber(kFTDCTypeField, static_cast<int>(type));
     builder.appendBinData(kFTDCDataField, buf.length(), BinDataType::BinDataGeneral, buf.data());
 
     return builder.obj();
@@ -382,6 +385,7 @@ StatusWith<FTDCType> getBSONDocumentType(const BSONObj& obj) {
     }
 
     if (static_cast<FTDCType>(value) != FTDCType::kMetricChunk &&
+        static_cast<FTDCType>(value) != FTDCType::kHighFrequencyMetricChunk &&
         static_cast<FTDCType>(value) != FTDCType::kMetadata) {
         return {ErrorCodes::BadValue,
                 str::stream() << "Field '" << std::string(kFTDCTypeField)
@@ -411,11 +415,14 @@ StatusWith<BSONObj> getBSONDocumentFromMetadataDoc(const BSONObj& obj) {
 
 StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
                                                          FTDCDecompressor* decompressor) {
-    if (kDebugBuild) {
-        auto swType = getBSONDocumentType(obj);
-        dassert(swType.isOK() && swType.getValue() == FTDCType::kMetricChunk);
+    auto swType = getBSONDocumentType(obj);
+    if (!swType.isOK()) {
+        return {swType.getStatus()};
     }
 
+    dassert(swType.getValue() == FTDCType::kMetricChunk ||
+            swType.getValue() == FTDCType::kHighFrequencyMetricChunk);
+
     BSONElement element;
 
     Status status = bsonExtractTypedField(obj, kFTDCDataField, BSONType::BinData, &element);
@@ -430,7 +437,10 @@ StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
                 str::stream() << "Field " << std::string(kFTDCTypeField) << " is not a BinData."};
     }
 
-    return decompressor->uncompress({buffer, static_cast<std::size_t>(length)});
+    return decompressor->uncompress({buffer, static_cast<std::size_t>(length)},
+                                    swType.getValue() == FTDCType::kHighFrequencyMetricChunk
+                                        ? FTDCCompressor::Encoding::kDeltaOfDelta
+                                        : FTDCCompressor::Encoding::kDelta);
 }
 
 }  // namespace FTDCBSONUtil
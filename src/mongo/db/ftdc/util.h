@@ -62,6 +62,13 @@ enum class FTDCType : std::int32_t {
     * See createBSONMetricChunkDocument
     */
     kMetricChunk = 1,
+
+    /**
+    * A high frequency metrics chunk is a metrics chunk whose samples are delta-of-delta encoded.
+    *
+    * See createBSONMetricChunkDocument
+    */
+    kHighFrequencyMetricChunk = 2,
 };
 
 
@@ -146,7 +153,9 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date);
  *  "data" : BinData(...)
  * }
  */
-BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t now);
+BSONObj createBSONMetricChunkDocument(ConstDataRange buf,
+                                      Date_t now,
+                                      FTDCType type = FTDCType::kMetricChunk);
 
 /**
  * Get the _id field of a BSON document
@@ -164,7 +173,8 @@ StatusWith<FTDCType> getBSONDocumentType(const BSONObj& obj);
 StatusWith<BSONObj> getBSONDocumentFromMetadataDoc(const BSONObj& obj);
 
 /**
- * Get the set of metric documents from the compressed chunk of a metric document
+ * Get the set of metric documents from the compressed chunk of a metric document. Accepts both
+ * kMetricChunk and kHighFrequencyMetricChunk documents.
  */
 StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
                                                          FTDCDecompressor* decompressor);
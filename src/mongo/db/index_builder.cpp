@@ -85,6 +85,7 @@ void IndexBuilder::run() {
     const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
     OperationContext& opCtx = *opCtxPtr;
     opCtx.lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+    opCtx.lockState()->setTicketPriority(TicketHolder::Priority::kLow);
 
     AuthorizationSession::get(opCtx.getClient())->grantInternalAuthorization();
 
@@ -0,0 +1,350 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_matcher.h"
+
+#include <algorithm>
+#include <boost/container/small_vector.hpp>
+#include <cmath>
+
+#include "mongo/base/compare_numbers.h"
+#include "mongo/db/field_ref.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_path.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+// Most filters touch only a handful of paths, so resolve them without allocating.
+constexpr size_t kInlineResolvedPaths = 16;
+
+bool compareResultMatches(MatchExpression::MatchType type, int cmp) {
+    switch (type) {
+        case MatchExpression::LT:
+            return cmp < 0;
+        case MatchExpression::LTE:
+            return cmp <= 0;
+        case MatchExpression::EQ:
+            return cmp == 0;
+        case MatchExpression::GT:
+            return cmp > 0;
+        case MatchExpression::GTE:
+            return cmp >= 0;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+}  // namespace
+
+CompiledMatcher::CompiledMatcher(const MatchExpression* root) {
+    invariant(root);
+    _paths.emplace_back();
+    _compile(root);
+}
+
+uint32_t CompiledMatcher::_estimateCost(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+        case MatchExpression::OR:
+        case MatchExpression::NOR:
+        case MatchExpression::NOT: {
+            uint32_t cost = 1;
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                cost += _estimateCost(expr->getChild(i));
+            }
+            return cost;
+        }
+        case MatchExpression::EQ:
+            return 1;
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::EXISTS:
+        case MatchExpression::TYPE_OPERATOR:
+            return 2;
+        case MatchExpression::MATCH_IN:
+            return 3;
+        case MatchExpression::REGEX:
+            return 8;
+        case MatchExpression::GEO:
+        case MatchExpression::EXPRESSION:
+            return 64;
+        case MatchExpression::WHERE:
+            return 1024;
+        default:
+            return 16;
+    }
+}
+
+void CompiledMatcher::_compile(const MatchExpression* expr) {
+    const uint32_t pc = _program.size();
+    _program.emplace_back();
+    _program[pc].expr = nullptr;
+    _program[pc].slot = 0;
+    _program[pc].compareType = expr->matchType();
+
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+        case MatchExpression::OR:
+        case MatchExpression::NOR: {
+            _program[pc].op = expr->matchType() == MatchExpression::AND
+                ? OpCode::kAnd
+                : expr->matchType() == MatchExpression::OR ? OpCode::kOr : OpCode::kNor;
+
+            // The result of a logical node does not depend on the order of its children, so
+            // evaluate the cheapest ones first and give short-circuiting the best chance to skip
+            // the expensive ones.
+            std::vector<std::pair<uint32_t, const MatchExpression*>> children;
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                children.emplace_back(_estimateCost(expr->getChild(i)), expr->getChild(i));
+            }
+            std::stable_sort(children.begin(), children.end(), [](const auto& a, const auto& b) {
+                return a.first < b.first;
+            });
+            for (auto&& child : children) {
+                _compile(child.second);
+            }
+            break;
+        }
+        case MatchExpression::NOT:
+            _program[pc].op = OpCode::kNot;
+            invariant(expr->numChildren() == 1);
+            _compile(expr->getChild(0));
+            break;
+        default:
+            _compileLeaf(expr, pc);
+            break;
+    }
+
+    _program[pc].end = _program.size();
+}
+
+void CompiledMatcher::_compileLeaf(const MatchExpression* expr, uint32_t pc) {
+    _program[pc].expr = expr;
+
+    auto pathExpr = dynamic_cast<const PathMatchExpression*>(expr);
+    if (!pathExpr || pathExpr->path().empty()) {
+        _program[pc].op = OpCode::kGeneric;
+        return;
+    }
+
+    const uint32_t slot = _internPath(pathExpr->path());
+    _program[pc].slot = slot;
+    _program[pc].op = OpCode::kPath;
+
+    auto comparison = dynamic_cast<const ComparisonMatchExpression*>(expr);
+    if (!comparison) {
+        return;
+    }
+
+    const BSONElement& rhs = comparison->getData();
+    _program[pc].rhs = rhs;
+    switch (rhs.type()) {
+        case NumberInt:
+            _program[pc].op = OpCode::kCompareInt;
+            break;
+        case NumberLong:
+            _program[pc].op = OpCode::kCompareLong;
+            break;
+        case NumberDouble:
+            // NaN has its own equality rules; leave it to the expression.
+            if (!std::isnan(rhs._numberDouble())) {
+                _program[pc].op = OpCode::kCompareDouble;
+            }
+            break;
+        case String:
+            if (!comparison->getCollator()) {
+                _program[pc].op = OpCode::kCompareString;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+uint32_t CompiledMatcher::_internPath(StringData path) {
+    FieldRef fieldRef(path);
+    uint32_t node = 0;
+    for (size_t i = 0; i < fieldRef.numParts(); ++i) {
+        const StringData part = fieldRef.getPart(i);
+
+        uint32_t next = 0;
+        for (auto child : _paths[node].children) {
+            if (_paths[child].fieldName == part) {
+                next = child;
+                break;
+            }
+        }
+
+        if (next == 0) {
+            next = _paths.size();
+            _paths.emplace_back();
+            _paths[next].fieldName = part.toString();
+            _paths[node].children.push_back(next);
+        }
+        node = next;
+    }
+    return node;
+}
+
+bool CompiledMatcher::matches(const BSONObj& doc) const {
+    boost::container::small_vector<ResolvedPath, kInlineResolvedPaths> resolved(_paths.size());
+    _resolveChildren(0, doc, resolved.data());
+    return _evaluate(0, doc, resolved.data());
+}
+
+void CompiledMatcher::_resolveChildren(uint32_t node,
+                                       const BSONObj& obj,
+                                       ResolvedPath* resolved) const {
+    const auto& children = _paths[node].children;
+    if (children.empty()) {
+        return;
+    }
+
+    // Like BSONObj::getField(), the first occurrence of a duplicated field name wins.
+    size_t remaining = children.size();
+    BSONObjIterator it(obj);
+    while (remaining > 0 && it.more()) {
+        BSONElement elem = it.next();
+        const StringData fieldName = elem.fieldNameStringData();
+        for (auto child : children) {
+            if (resolved[child].element.eoo() && _paths[child].fieldName == fieldName) {
+                resolved[child].element = elem;
+                --remaining;
+                break;
+            }
+        }
+    }
+
+    // Children that were not found, or that hold a scalar, leave their descendants resolved to
+    // EOO, which is what ElementPath yields for a missing path.
+    for (auto child : children) {
+        const BSONElement& elem = resolved[child].element;
+        if (elem.type() == Object) {
+            _resolveChildren(child, elem.embeddedObject(), resolved);
+        } else if (elem.type() == Array) {
+            _markArray(child, resolved);
+        }
+    }
+}
+
+void CompiledMatcher::_markArray(uint32_t node, ResolvedPath* resolved) const {
+    resolved[node].hitArray = true;
+    for (auto child : _paths[node].children) {
+        _markArray(child, resolved);
+    }
+}
+
+bool CompiledMatcher::_evaluate(uint32_t pc,
+                                const BSONObj& doc,
+                                const ResolvedPath* resolved) const {
+    const Instruction& instruction = _program[pc];
+    switch (instruction.op) {
+        case OpCode::kAnd:
+            for (uint32_t child = pc + 1; child < instruction.end; child = _program[child].end) {
+                if (!_evaluate(child, doc, resolved)) {
+                    return false;
+                }
+            }
+            return true;
+        case OpCode::kOr:
+            for (uint32_t child = pc + 1; child < instruction.end; child = _program[child].end) {
+                if (_evaluate(child, doc, resolved)) {
+                    return true;
+                }
+            }
+            return false;
+        case OpCode::kNor:
+            for (uint32_t child = pc + 1; child < instruction.end; child = _program[child].end) {
+                if (_evaluate(child, doc, resolved)) {
+                    return false;
+                }
+            }
+            return true;
+        case OpCode::kNot:
+            return !_evaluate(pc + 1, doc, resolved);
+        case OpCode::kGeneric:
+            return instruction.expr->matchesBSON(doc);
+        default:
+            return _evaluatePath(instruction, doc, resolved);
+    }
+}
+
+bool CompiledMatcher::_evaluatePath(const Instruction& instruction,
+                                    const BSONObj& doc,
+                                    const ResolvedPath* resolved) const {
+    const ResolvedPath& path = resolved[instruction.slot];
+    if (path.hitArray) {
+        // Arrays along the path fan out into several candidate elements; let the expression walk
+        // them itself.
+        return instruction.expr->matchesBSON(doc);
+    }
+
+    const BSONElement& elem = path.element;
+    const BSONElement& rhs = instruction.rhs;
+    switch (instruction.op) {
+        case OpCode::kCompareInt:
+            if (elem.type() == NumberInt) {
+                return compareResultMatches(instruction.compareType,
+                                            compareInts(elem._numberInt(), rhs._numberInt()));
+            }
+            break;
+        case OpCode::kCompareLong:
+            if (elem.type() == NumberLong) {
+                return compareResultMatches(instruction.compareType,
+                                            compareLongs(elem._numberLong(), rhs._numberLong()));
+            }
+            break;
+        case OpCode::kCompareDouble:
+            if (elem.type() == NumberDouble && !std::isnan(elem._numberDouble())) {
+                return compareResultMatches(
+                    instruction.compareType,
+                    compareDoubles(elem._numberDouble(), rhs._numberDouble()));
+            }
+            break;
+        case OpCode::kCompareString:
+            if (elem.type() == String) {
+                return compareResultMatches(
+                    instruction.compareType,
+                    elem.valueStringData().compare(rhs.valueStringData()));
+            }
+            break;
+        default:
+            break;
+    }
+
+    return instruction.expr->matchesSingleElement(elem);
+}
+
+}  // namespace mongo
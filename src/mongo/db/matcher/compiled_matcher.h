@@ -0,0 +1,168 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+
+namespace mongo {
+
+/**
+ * A CompiledMatcher is a flattened form of a MatchExpression tree which answers
+ * MatchExpression::matchesBSON() for whole documents with less work per document:
+ *
+ *  - The tree is laid out as a linear program in pre-order. Each instruction records where its
+ *    subtree ends, so $and, $or and $nor short-circuit by jumping over the remaining children.
+ *  - The children of logical nodes are ordered so that cheap, selective predicates (equality on a
+ *    short path) run before expensive ones ($regex, $where, $expr).
+ *  - The paths of all leaves are merged into a prefix tree which is resolved against the document
+ *    in a single pass per level, so "a.b" and "a.c" look up "a" once.
+ *  - Comparisons against a number or, in the absence of a collator, a string compare the value
+ *    directly when the document holds the same BSON type.
+ *
+ * Whenever a path reaches an array, or a node is not understood by the compiler, the instruction
+ * falls back to the original MatchExpression so that results are always identical to
+ * matchesBSON(). The MatchExpression must outlive the CompiledMatcher and must not be modified
+ * after compilation. MatchDetails are not supported.
+ */
+class CompiledMatcher {
+    MONGO_DISALLOW_COPYING(CompiledMatcher);
+
+public:
+    explicit CompiledMatcher(const MatchExpression* root);
+
+    /**
+     * Returns whether 'doc' matches the expression this CompiledMatcher was built from.
+     */
+    bool matches(const BSONObj& doc) const;
+
+    /**
+     * Returns the number of instructions in the compiled program.
+     */
+    size_t numInstructions() const {
+        return _program.size();
+    }
+
+    /**
+     * Returns the number of distinct path components resolved against each document. For
+     * example, the filter {"a.b": 1, "a.c": 1} resolves three: "a", "a.b" and "a.c".
+     */
+    size_t numResolvedPaths() const {
+        return _paths.size() - 1;
+    }
+
+    /**
+     * Returns the match expression evaluated by the instruction at 'index', or nullptr for a
+     * logical instruction. Exposed for testing the order chosen by the compiler.
+     */
+    const MatchExpression* getInstructionExpression(size_t index) const {
+        return _program[index].expr;
+    }
+
+private:
+    enum class OpCode : uint8_t {
+        kAnd,
+        kOr,
+        kNor,
+        kNot,
+
+        // Evaluates 'expr' against the element resolved for 'slot'.
+        kPath,
+
+        // Like kPath, but compares directly when the element has the type of 'expr's right-hand
+        // side.
+        kCompareInt,
+        kCompareLong,
+        kCompareDouble,
+        kCompareString,
+
+        // Evaluates 'expr' against the whole document.
+        kGeneric,
+    };
+
+    struct Instruction {
+        OpCode op;
+
+        // For comparisons, the match type of 'expr'.
+        MatchExpression::MatchType compareType;
+
+        // Index one past the last instruction of this instruction's subtree.
+        uint32_t end;
+
+        // For path instructions, the index in '_paths' of the element to test.
+        uint32_t slot;
+
+        const MatchExpression* expr;
+        BSONElement rhs;
+    };
+
+    /**
+     * A node in the prefix tree of leaf paths. Node 0 is the document itself.
+     */
+    struct PathNode {
+        std::string fieldName;
+        std::vector<uint32_t> children;
+    };
+
+    /**
+     * The result of resolving one PathNode against a document. If 'hitArray' is set, an array was
+     * found at or above this path and the element is not meaningful.
+     */
+    struct ResolvedPath {
+        BSONElement element;
+        bool hitArray = false;
+    };
+
+    /**
+     * Returns an estimate of the cost of evaluating 'expr' used to order the children of logical
+     * nodes. Lower is evaluated first.
+     */
+    static uint32_t _estimateCost(const MatchExpression* expr);
+
+    void _compile(const MatchExpression* expr);
+    void _compileLeaf(const MatchExpression* expr, uint32_t pc);
+    uint32_t _internPath(StringData path);
+
+    void _resolveChildren(uint32_t node, const BSONObj& obj, ResolvedPath* resolved) const;
+    void _markArray(uint32_t node, ResolvedPath* resolved) const;
+    bool _evaluate(uint32_t pc, const BSONObj& doc, const ResolvedPath* resolved) const;
+    bool _evaluatePath(const Instruction& instruction,
+                       const BSONObj& doc,
+                       const ResolvedPath* resolved) const;
+
+    std::vector<Instruction> _program;
+    std::vector<PathNode> _paths;
+};
+
+}  // namespace mongo
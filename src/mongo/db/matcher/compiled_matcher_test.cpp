@@ -0,0 +1,166 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_matcher.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& query) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto result = MatchExpressionParser::parse(query, expCtx);
+    ASSERT_OK(result.getStatus());
+    return std::move(result.getValue());
+}
+
+const std::vector<BSONObj> kDocuments = {
+    fromjson("{}"),
+    fromjson("{a: 1}"),
+    fromjson("{a: 2, b: 'x'}"),
+    fromjson("{a: 5, b: 'y', c: {d: 1}}"),
+    fromjson("{a: NumberLong(5), b: 'xy'}"),
+    fromjson("{a: 5.5, b: 'x\\u0000y'}"),
+    fromjson("{a: NaN}"),
+    fromjson("{a: null}"),
+    fromjson("{a: undefined}"),
+    fromjson("{a: 'abc'}"),
+    fromjson("{a: {$symbol: 'abc'}}"),
+    fromjson("{a: [1, 5, 9]}"),
+    fromjson("{a: [[1], 'x']}"),
+    fromjson("{a: {b: 1, c: 2}}"),
+    fromjson("{a: {b: [1, 2], c: 3}}"),
+    fromjson("{a: [{b: 1}, {b: 3}], c: 1}"),
+    fromjson("{a: {'0': 4, b: {c: 'z'}}}"),
+    fromjson("{a: 3, a: 7}"),
+    fromjson("{a: 3, a: 7, b: 'x'}"),
+    fromjson("{a: {b: 2}, a: {b: 9}}"),
+    fromjson("{b: 1, c: {d: [1, 2]}}"),
+    fromjson("{a: {$minKey: 1}, b: {$maxKey: 1}}"),
+    fromjson("{a: 4, b: 'y', c: {d: 2, e: 'q'}}"),
+};
+
+const std::vector<BSONObj> kFilters = {
+    fromjson("{}"),
+    fromjson("{a: 1}"),
+    fromjson("{a: 5}"),
+    fromjson("{a: null}"),
+    fromjson("{a: {$gt: 2}}"),
+    fromjson("{a: {$gte: NumberLong(5)}}"),
+    fromjson("{a: {$lt: 5.5}}"),
+    fromjson("{a: {$lte: NaN}}"),
+    fromjson("{a: {$eq: NaN}}"),
+    fromjson("{a: {$gt: 'abb'}}"),
+    fromjson("{a: 'abc'}"),
+    fromjson("{a: {$lt: {$maxKey: 1}}}"),
+    fromjson("{a: {$gt: {$minKey: 1}}}"),
+    fromjson("{b: {$gte: 'x'}}"),
+    fromjson("{b: {$lt: 'x\\u0000z'}}"),
+    fromjson("{'a.b': 1}"),
+    fromjson("{'a.b': null}"),
+    fromjson("{'a.b': {$gt: 1}, 'a.c': {$lte: 3}}"),
+    fromjson("{'a.0': 4}"),
+    fromjson("{'a.0': {$lt: 2}}"),
+    fromjson("{'a.b.c': 'z'}"),
+    fromjson("{'c.d': {$in: [1, 2]}}"),
+    fromjson("{'c.e': {$exists: true}}"),
+    fromjson("{a: {$exists: false}}"),
+    fromjson("{a: {$type: 'string'}}"),
+    fromjson("{a: {$size: 3}}"),
+    fromjson("{a: {$elemMatch: {b: 3}}}"),
+    fromjson("{a: /^a/}"),
+    fromjson("{a: {$mod: [2, 1]}}"),
+    fromjson("{a: {$not: {$gt: 2}}}"),
+    fromjson("{a: {$gt: 1}, b: 'y', 'c.d': 2}"),
+    fromjson("{a: 7, b: 'x'}"),
+    fromjson("{$or: [{a: 1}, {b: 'x'}, {'c.d': 1}]}"),
+    fromjson("{$and: [{a: {$gt: 1}}, {$or: [{b: /y/}, {'a.b': 2}]}]}"),
+    fromjson("{$nor: [{a: 5}, {b: {$exists: true}}]}"),
+    fromjson("{$expr: {$eq: ['$a', 5]}}"),
+    fromjson("{$expr: {$lt: ['$a', 3]}, b: 'x'}"),
+    fromjson("{$alwaysTrue: 1}"),
+    fromjson("{$alwaysFalse: 1, a: 1}"),
+};
+
+TEST(CompiledMatcherTest, MatchesAgreeWithMatchExpression) {
+    for (auto&& filter : kFilters) {
+        auto expr = parse(filter);
+        CompiledMatcher compiled(expr.get());
+        for (auto&& doc : kDocuments) {
+            ASSERT_EQ(expr->matchesBSON(doc), compiled.matches(doc)) << "filter: " << filter
+                                                                     << ", document: " << doc;
+        }
+    }
+}
+
+TEST(CompiledMatcherTest, StringComparisonsRespectCollator) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    const std::vector<BSONObj> filters = {fromjson("{b: 'x'}"), fromjson("{b: {$gt: 'xa'}}")};
+    for (auto&& filter : filters) {
+        auto expr = parse(filter);
+        expr->setCollator(&collator);
+        CompiledMatcher compiled(expr.get());
+        for (auto&& doc : kDocuments) {
+            ASSERT_EQ(expr->matchesBSON(doc), compiled.matches(doc)) << "filter: " << filter
+                                                                     << ", document: " << doc;
+        }
+    }
+}
+
+TEST(CompiledMatcherTest, SharedPathPrefixesAreResolvedOnce) {
+    BSONObj filter = fromjson("{'a.b': 1, 'a.c': 2, 'a.b.d': 3, e: 4}");
+    auto expr = parse(filter);
+    CompiledMatcher compiled(expr.get());
+
+    // One AND plus four leaves, over the paths "a", "a.b", "a.c", "a.b.d" and "e".
+    ASSERT_EQ(5U, compiled.numInstructions());
+    ASSERT_EQ(5U, compiled.numResolvedPaths());
+}
+
+TEST(CompiledMatcherTest, CheapPredicatesAreEvaluatedFirst) {
+    BSONObj filter = fromjson("{a: /x/, $expr: {$eq: ['$b', 1]}, c: {$gt: 1}, d: 2}");
+    auto expr = parse(filter);
+    CompiledMatcher compiled(expr.get());
+
+    ASSERT_EQ(5U, compiled.numInstructions());
+    ASSERT_EQ(MatchExpression::AND, expr->matchType());
+    ASSERT_EQ("d", compiled.getInstructionExpression(1)->path());
+    ASSERT_EQ("c", compiled.getInstructionExpression(2)->path());
+    ASSERT_EQ("a", compiled.getInstructionExpression(3)->path());
+    ASSERT_EQ(MatchExpression::EXPRESSION, compiled.getInstructionExpression(4)->matchType());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,139 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/operation_trace.h"
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/random.h"
+
+namespace mongo {
+namespace {
+
+AtomicDouble operationTraceSampleRate(0.0);
+
+class ExportedOperationTraceSampleRateParameter
+    : public ExportedServerParameter<double, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedOperationTraceSampleRateParameter()
+        : ExportedServerParameter<double, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "operationTraceSampleRate",
+              &operationTraceSampleRate) {}
+
+    virtual Status validate(const double& potentialNewValue) {
+        if (potentialNewValue < 0.0 || potentialNewValue > 1.0) {
+            return Status(ErrorCodes::BadValue,
+                          "operationTraceSampleRate must be between 0 and 1 inclusive");
+        }
+
+        return Status::OK();
+    }
+
+} exportedOperationTraceSampleRateParameter;
+
+}  // namespace
+
+constexpr int OperationTrace::kNumPhases;
+constexpr int OperationTrace::kNoPhase;
+
+const OperationContext::Decoration<OperationTrace> OperationTrace::get =
+    OperationContext::declareDecoration<OperationTrace>();
+
+StringData OperationTrace::phaseName(Phase phase) {
+    switch (phase) {
+        case Phase::kParse:
+            return "parse"_sd;
+        case Phase::kCanonicalize:
+            return "canonicalize"_sd;
+        case Phase::kPlan:
+            return "plan"_sd;
+        case Phase::kMultiPlanTrial:
+            return "multiPlanTrial"_sd;
+        case Phase::kExecution:
+            return "execution"_sd;
+        case Phase::kYield:
+            return "yield"_sd;
+        case Phase::kReplyBuild:
+            return "replyBuild"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+bool OperationTrace::shouldSample(PseudoRandom* prng) {
+    const double rate = operationTraceSampleRate.load();
+    if (rate <= 0.0)
+        return false;
+    return rate >= 1.0 || prng->nextCanonicalDouble() < rate;
+}
+
+void OperationTrace::enable(TickSource* tickSource) {
+    if (!_tickSource) {
+        _tickSource = tickSource;
+    }
+}
+
+BSONObj OperationTrace::getBreakdown() const {
+    BSONObjBuilder builder;
+    if (!_tickSource)
+        return builder.obj();
+
+    const double nanosPerTick = 1.0e9 / _tickSource->getTicksPerSecond();
+    for (int i = 0; i < kNumPhases; i++) {
+        if (_phases[i].count == 0)
+            continue;
+
+        const std::string fieldName = phaseName(static_cast<Phase>(i)) + "Nanos";
+        builder.append(fieldName, static_cast<long long>(_phases[i].ticks * nanosPerTick));
+    }
+    return builder.obj();
+}
+
+int OperationTrace::_enter(Phase phase) {
+    _charge(_tickSource->getTicks());
+
+    const int previousPhase = _currentPhase;
+    _currentPhase = static_cast<int>(phase);
+    _phases[_currentPhase].count++;
+    return previousPhase;
+}
+
+void OperationTrace::_exit(int previousPhase) {
+    _charge(_tickSource->getTicks());
+    _currentPhase = previousPhase;
+}
+
+void OperationTrace::_charge(TickSource::Tick now) {
+    if (_currentPhase != kNoPhase) {
+        _phases[_currentPhase].ticks += now - _currentPhaseStart;
+    }
+    _currentPhaseStart = now;
+}
+
+}  // namespace mongo
@@ -0,0 +1,148 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/util/tick_source.h"
+
+namespace mongo {
+
+class PseudoRandom;
+
+/**
+ * Records how long an operation spends in each phase of its lifecycle, such as parsing,
+ * planning and execution.
+ *
+ * Tracing is off by default and each Span then costs a single branch. It is enabled for a sampled
+ * fraction of operations, set by the operationTraceSampleRate server parameter, and for explain
+ * with executionStats or higher verbosity. Traced operations report the time in each phase as
+ * executionTimeBreakdown in the slow query log, the profiler and explain.
+ *
+ * Spans nest. Time is charged to the innermost open span only, so the time spent yielding during
+ * execution is reported under yield and not under execution, and the phases add up to the traced
+ * part of the operation.
+ */
+class OperationTrace {
+    MONGO_DISALLOW_COPYING(OperationTrace);
+
+public:
+    enum class Phase {
+        kParse,
+        kCanonicalize,
+        kPlan,
+        kMultiPlanTrial,
+        kExecution,
+        kYield,
+        kReplyBuild,
+    };
+
+    static constexpr int kNumPhases = static_cast<int>(Phase::kReplyBuild) + 1;
+
+    /**
+     * Times a phase of the operation while in scope. Does nothing if opCtx is null or the
+     * operation is not traced.
+     */
+    class Span {
+        MONGO_DISALLOW_COPYING(Span);
+
+    public:
+        Span(OperationContext* opCtx, Phase phase)
+            : _trace(opCtx && get(opCtx).isEnabled() ? &get(opCtx) : nullptr) {
+            if (_trace) {
+                _previousPhase = _trace->_enter(phase);
+            }
+        }
+
+        ~Span() {
+            if (_trace) {
+                _trace->_exit(_previousPhase);
+            }
+        }
+
+    private:
+        OperationTrace* const _trace;
+        int _previousPhase = kNoPhase;
+    };
+
+    static const OperationContext::Decoration<OperationTrace> get;
+
+    static StringData phaseName(Phase phase);
+
+    /**
+     * Returns true if this operation should be traced, according to operationTraceSampleRate.
+     */
+    static bool shouldSample(PseudoRandom* prng);
+
+    OperationTrace() = default;
+
+    /**
+     * Starts tracing this operation using tickSource to read the time. Has no effect if the
+     * operation is already traced.
+     */
+    void enable(TickSource* tickSource);
+
+    bool isEnabled() const {
+        return _tickSource != nullptr;
+    }
+
+    /**
+     * Returns the time spent in each phase entered so far, in nanoseconds, e.g.
+     * { parseNanos: 3100, canonicalizeNanos: 12800, planNanos: 51200, executionNanos: 902000 }.
+     * Phases that were never entered are omitted.
+     */
+    BSONObj getBreakdown() const;
+
+private:
+    static constexpr int kNoPhase = -1;
+
+    struct PhaseTotals {
+        TickSource::Tick ticks = 0;
+        long long count = 0;
+    };
+
+    int _enter(Phase phase);
+    void _exit(int previousPhase);
+
+    // Charges the time since the last transition to the phase that is currently open.
+    void _charge(TickSource::Tick now);
+
+    TickSource* _tickSource = nullptr;
+
+    int _currentPhase = kNoPhase;
+    TickSource::Tick _currentPhaseStart = 0;
+
+    std::array<PhaseTotals, kNumPhases> _phases;
+};
+
+}  // namespace mongo
@@ -0,0 +1,138 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/operation_trace.h"
+
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/tick_source_mock.h"
+
+namespace mongo {
+namespace {
+
+using Phase = OperationTrace::Phase;
+
+class OperationTraceTest : public unittest::Test {
+protected:
+    QueryTestServiceContext serviceContext;
+    ServiceContext::UniqueOperationContext opCtx = serviceContext.makeOperationContext();
+    TickSourceMock tickSource;
+};
+
+TEST_F(OperationTraceTest, DisabledByDefault) {
+    ASSERT_FALSE(OperationTrace::get(opCtx.get()).isEnabled());
+
+    {
+        OperationTrace::Span span(opCtx.get(), Phase::kParse);
+        tickSource.advance(Milliseconds(1));
+    }
+
+    ASSERT_BSONOBJ_EQ(BSONObj(), OperationTrace::get(opCtx.get()).getBreakdown());
+}
+
+TEST_F(OperationTraceTest, NullOperationContextIsIgnored) {
+    OperationTrace::Span span(nullptr, Phase::kParse);
+}
+
+TEST_F(OperationTraceTest, RecordsTimeInEachPhase) {
+    auto& trace = OperationTrace::get(opCtx.get());
+    trace.enable(&tickSource);
+    ASSERT_TRUE(trace.isEnabled());
+
+    {
+        OperationTrace::Span span(opCtx.get(), Phase::kParse);
+        tickSource.advance(Milliseconds(1));
+    }
+    {
+        OperationTrace::Span span(opCtx.get(), Phase::kCanonicalize);
+        tickSource.advance(Milliseconds(2));
+    }
+
+    // Time outside of any span is not charged to any phase.
+    tickSource.advance(Milliseconds(100));
+
+    {
+        OperationTrace::Span span(opCtx.get(), Phase::kExecution);
+        tickSource.advance(Milliseconds(3));
+    }
+    {
+        OperationTrace::Span span(opCtx.get(), Phase::kExecution);
+        tickSource.advance(Milliseconds(4));
+    }
+
+    ASSERT_BSONOBJ_EQ(BSON("parseNanos" << 1000000LL << "canonicalizeNanos" << 2000000LL
+                                        << "executionNanos"
+                                        << 7000000LL),
+                      trace.getBreakdown());
+}
+
+TEST_F(OperationTraceTest, NestedSpansAreChargedToTheInnermostPhase) {
+    auto& trace = OperationTrace::get(opCtx.get());
+    trace.enable(&tickSource);
+
+    {
+        OperationTrace::Span execution(opCtx.get(), Phase::kExecution);
+        tickSource.advance(Milliseconds(1));
+        {
+            OperationTrace::Span trial(opCtx.get(), Phase::kMultiPlanTrial);
+            tickSource.advance(Milliseconds(2));
+            {
+                OperationTrace::Span yield(opCtx.get(), Phase::kYield);
+                tickSource.advance(Milliseconds(4));
+            }
+            tickSource.advance(Milliseconds(8));
+        }
+        tickSource.advance(Milliseconds(16));
+    }
+
+    ASSERT_BSONOBJ_EQ(BSON("multiPlanTrialNanos" << 10000000LL << "executionNanos" << 17000000LL
+                                                 << "yieldNanos"
+                                                 << 4000000LL),
+                      trace.getBreakdown());
+}
+
+TEST_F(OperationTraceTest, EnableTwiceKeepsTheFirstTickSource) {
+    auto& trace = OperationTrace::get(opCtx.get());
+    trace.enable(&tickSource);
+
+    TickSourceMock otherTickSource;
+    trace.enable(&otherTickSource);
+
+    {
+        OperationTrace::Span span(opCtx.get(), Phase::kPlan);
+        tickSource.advance(Milliseconds(5));
+        otherTickSource.advance(Milliseconds(50));
+    }
+
+    ASSERT_BSONOBJ_EQ(BSON("planNanos" << 5000000LL), trace.getBreakdown());
+}
+
+}  // namespace
+}  // namespace mongo
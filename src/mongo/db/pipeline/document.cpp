@@ -30,6 +30,7 @@
 
 #include "mongo/db/pipeline/document.h"
 
+#include <algorithm>
 #include <boost/functional/hash.hpp>
 
 #include "mongo/bson/bson_depth.h"
@@ -44,6 +45,73 @@ using std::string;
 using std::vector;
 
 const DocumentStorage DocumentStorage::kEmptyDoc;
+const BSONObj DocumentStorage::kEmptyBson;
+
+namespace {
+
+// A Document is only charged for the size of its own BSON, so it shares a larger buffer only when
+// that keeps no more than this many bytes, beyond twice its own size, alive.
+const size_t kMaxUnchargedSharedBytes = 1024;
+
+/**
+ * Returns the owned BSONObj 'obj' if it takes up most of the buffer it shares, and a copy of it
+ * otherwise. This keeps a small document, such as a subdocument held on to by an accumulator or a
+ * sort, from pinning a much larger buffer that it is not charged for.
+ */
+BSONObj shareOrCopy(const BSONObj& obj) {
+    const size_t objSize = obj.objsize();
+    if (obj.sharedBuffer().capacity() > 2 * objSize + kMaxUnchargedSharedBytes) {
+        return obj.copy();
+    }
+    return obj;
+}
+
+/**
+ * Converts 'elem', which lies within the buffer held by 'owner', to a Value. Embedded objects
+ * become Documents sharing 'owner' rather than decoded copies, so they are decoded only when
+ * accessed. Small objects within a large buffer are copied out of it instead; see shareOrCopy().
+ */
+Value valueFromSharedBson(const BSONElement& elem, const ConstSharedBuffer& owner) {
+    switch (elem.type()) {
+        case Object: {
+            BSONObj embedded = elem.embeddedObject();
+            embedded.shareOwnershipWith(owner);
+            return Value(Document(embedded));
+        }
+        case Array: {
+            std::vector<Value> values;
+            for (auto&& sub : elem.embeddedObject()) {
+                values.push_back(valueFromSharedBson(sub, owner));
+            }
+            return Value(std::move(values));
+        }
+        default:
+            return Value(elem);
+    }
+}
+
+/**
+ * Returns how many levels of objects and arrays are nested within 'obj', giving up and returning
+ * a count greater than 'limit' as soon as it is exceeded.
+ */
+size_t nestingDepth(const BSONObj& obj, size_t limit) {
+    size_t depth = 0;
+    for (auto&& elem : obj) {
+        if (elem.type() != Object && elem.type() != Array) {
+            continue;
+        }
+        if (limit == 0) {
+            return 1;
+        }
+        depth = std::max(depth, 1 + nestingDepth(elem.embeddedObject(), limit - 1));
+        if (depth > limit) {
+            break;
+        }
+    }
+    return depth;
+}
+
+}  // namespace
 
 const std::vector<StringData> Document::allMetadataFieldNames = {
     Document::metaFieldTextScore, Document::metaFieldRandVal, Document::metaFieldSortKey};
@@ -65,17 +133,49 @@ Position DocumentStorage::findField(StringData requested) const {
             pos = elem.nextCollision;
         }
     } else {  // linear scan
-        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+        for (DocumentStorageIterator it = iteratorCached(); !it.atEnd(); it.advance()) {
             if (it->nameLen == reqSize && memcmp(requested.rawData(), it->_name, reqSize) == 0) {
                 return it.position();
             }
         }
     }
 
-    // if we got here, there's no such field
+    // if we got here, there's no such field among those decoded so far
+    if (hasLazyFields()) {
+        return loadLazyFieldsUntil(requested);
+    }
     return Position();
 }
 
+Position DocumentStorage::loadNextLazyField() const {
+    BSONElement elem(_bsonNext);
+    _bsonNext += elem.size();
+
+    // Decoding does not change the logical contents of the document, which is why this is allowed
+    // on a const DocumentStorage. Only heap-allocated storages have lazy fields.
+    auto self = const_cast<DocumentStorage*>(this);
+    const Position pos = self->getNextPosition();
+    self->appendField(elem.fieldNameStringData()) = valueFromSharedBson(elem, _bson.sharedBuffer());
+    return pos;
+}
+
+Position DocumentStorage::loadLazyFieldsUntil(StringData name) const {
+    while (hasLazyFields()) {
+        const Position pos = loadNextLazyField();
+        if (getField(pos).nameSD() == name) {
+            return pos;
+        }
+    }
+    return Position();
+}
+
+size_t DocumentStorage::getBsonNestingDepth() const {
+    if (_bsonNestingDepth < 0) {
+        _bsonNestingDepth = nestingDepth(_bson, BSONDepth::getMaxAllowableDepth());
+    }
+    return _bsonNestingDepth;
+}
+
 Value& DocumentStorage::appendField(StringData name) {
     Position pos = getNextPosition();
     const int nameSize = name.size();
@@ -186,6 +286,9 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
 }
 
 intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
+    // Positions must be the same after cloning, so decode everything before copying the buffer.
+    loadAllLazyFields();
+
     intrusive_ptr<DocumentStorage> out(new DocumentStorage());
 
     // Make a copy of the buffer.
@@ -205,9 +308,14 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
     out->_textScore = _textScore;
     out->_randVal = _randVal;
     out->_sortKey = _sortKey.getOwned();
+    out->_bson = _bson;
+    out->_bsonNext = _bsonNext;
+    out->_bsonEnd = _bsonEnd;
+    out->_bsonNestingDepth = _bsonNestingDepth;
+    out->_modified = _modified;
 
     // Tell values that they have been memcpyed (updates ref counts)
-    for (DocumentStorageIterator it = out->iteratorAll(); !it.atEnd(); it.advance()) {
+    for (DocumentStorageIterator it = out->iteratorCached(); !it.atEnd(); it.advance()) {
         it->val.memcpyed();
     }
 
@@ -217,21 +325,15 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
 DocumentStorage::~DocumentStorage() {
     std::unique_ptr<char[]> deleteBufferAtScopeEnd(_buffer);
 
-    for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+    for (DocumentStorageIterator it = iteratorCached(); !it.atEnd(); it.advance()) {
         it->val.~Value();  // explicit destructor call
     }
 }
 
 Document::Document(const BSONObj& bson) {
-    MutableDocument md(bson.nFields());
-
-    BSONObjIterator it(bson);
-    while (it.more()) {
-        BSONElement bsonElement(it.next());
-        md.addField(bsonElement.fieldNameStringData(), Value(bsonElement));
+    if (!bson.isEmpty()) {
+        _storage = new DocumentStorage(bson.isOwned() ? shareOrCopy(bson) : bson.getOwned());
     }
-
-    *this = md.freeze();
 }
 
 Document::Document(std::initializer_list<std::pair<StringData, ImplicitValue>> initializerList) {
@@ -251,6 +353,11 @@ BSONObjBuilder& operator<<(BSONObjBuilderValueStream& builder, const Document& d
     return builder.builder();
 }
 
+bool Document::canUseUnmodifiedBson(size_t recursionLevel) const {
+    return !storage().getUnmodifiedBson().isEmpty() &&
+        recursionLevel + storage().getBsonNestingDepth() <= BSONDepth::getMaxAllowableDepth();
+}
+
 void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
     uassert(ErrorCodes::Overflow,
             str::stream() << "cannot convert document to BSON because it exceeds the limit of "
@@ -258,12 +365,21 @@ void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
                           << " levels of nesting",
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
+    if (canUseUnmodifiedBson(recursionLevel)) {
+        builder->appendElements(storage().getUnmodifiedBson());
+        return;
+    }
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
         it->val.addToBsonObj(builder, it->nameSD(), recursionLevel);
     }
 }
 
 BSONObj Document::toBson() const {
+    if (canUseUnmodifiedBson(1)) {
+        return storage().getUnmodifiedBson();
+    }
+
     BSONObjBuilder bb;
     toBson(&bb);
     return bb.obj();
@@ -286,6 +402,14 @@ BSONObj Document::toBsonWithMetaData() const {
 }
 
 Document Document::fromBsonWithMetaData(const BSONObj& bson) {
+    // Metadata is rare, so check for it without decoding anything and keep the common case lazy.
+    const bool hasMetadata = std::any_of(bson.begin(), bson.end(), [](const BSONElement& elem) {
+        return elem.fieldNameStringData()[0] == '$';
+    });
+    if (!hasMetadata) {
+        return Document(bson);
+    }
+
     MutableDocument md;
 
     BSONObjIterator it(bson);
@@ -383,7 +507,12 @@ size_t Document::getApproximateSize() const {
     size_t size = sizeof(DocumentStorage);
     size += storage().allocatedBytes();
 
-    for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
+    // The BSON the fields are decoded from stays alive for as long as the storage does, whether
+    // or not all of them have been decoded. Embedded documents share their parent's BSON, which
+    // makes this an overestimate.
+    size += storage().retainedBsonSize();
+
+    for (DocumentStorageIterator it = storage().iteratorCached(); !it.atEnd(); it.advance()) {
         size += it->val.getApproximateSize();
         size -= sizeof(Value);  // already accounted for above
     }
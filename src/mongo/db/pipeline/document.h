@@ -99,7 +99,11 @@ public:
     /// Empty Document (does no allocation)
     Document() {}
 
-    /// Create a new Document deep-converted from the given BSONObj.
+    /**
+     * Create a new Document backed by an owned copy of the given BSONObj. Fields are decoded
+     * lazily as they are accessed, and an unmodified Document serializes back to the same BSON
+     * without re-encoding it.
+     */
     explicit Document(const BSONObj& bson);
 
     /**
@@ -144,7 +148,7 @@ public:
 
     /// True if this document has no fields.
     bool empty() const {
-        return !_storage || storage().iterator().atEnd();
+        return !_storage || storage().empty();
     }
 
     /// Create a new FieldIterator that can be used to examine the Document's fields in order.
@@ -293,6 +297,13 @@ private:
     const DocumentStorage& storage() const {
         return (_storage ? *_storage : DocumentStorage::emptyDoc());
     }
+
+    /**
+     * True if this Document is still identical to the BSON it was created from, and that BSON can
+     * be emitted at 'recursionLevel' without exceeding the maximum nesting depth.
+     */
+    bool canUseUnmodifiedBson(size_t recursionLevel) const;
+
     boost::intrusive_ptr<const DocumentStorage> _storage;
 };
 
@@ -568,7 +579,9 @@ private:
             return clonedStorage();
 
         // This function exists to ensure this is safe
-        return const_cast<DocumentStorage&>(*storagePtr());
+        auto& storage = const_cast<DocumentStorage&>(*storagePtr());
+        storage.makeModified();
+        return storage;
     }
     DocumentStorage& newStorage() {
         reset(new DocumentStorage);
@@ -576,7 +589,9 @@ private:
     }
     DocumentStorage& clonedStorage() {
         reset(storagePtr()->clone());
-        return const_cast<DocumentStorage&>(*storagePtr());
+        auto& storage = const_cast<DocumentStorage&>(*storagePtr());
+        storage.makeModified();
+        return storage;
     }
 
     // recursive helpers for same-named public methods
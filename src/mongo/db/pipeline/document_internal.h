@@ -178,7 +178,16 @@ private:
     bool _includeMissing;
 };
 
-/// Storage class used by both Document and MutableDocument
+/**
+ * Storage class used by both Document and MutableDocument
+ *
+ * A DocumentStorage may be backed by a BSONObj, in which case its fields are decoded from the BSON
+ * in order, and only as far as lookups require. Embedded objects become Documents backed by the
+ * same buffer, so subtrees that are never looked at are never decoded. Until it is modified
+ * through a MutableDocument, such a storage can hand back its BSON instead of re-serializing its
+ * fields. Decoding happens in const methods, so a Document must not be read from several threads
+ * at once.
+ */
 class DocumentStorage : public RefCountable {
 public:
     DocumentStorage()
@@ -191,6 +200,16 @@ public:
           _textScore(0),
           _randVal(0) {}
 
+    /**
+     * Constructs a storage whose fields are decoded lazily from 'bson', which must be owned.
+     */
+    explicit DocumentStorage(const BSONObj& bson) : DocumentStorage() {
+        invariant(bson.isOwned());
+        _bson = bson;
+        _bsonNext = _bson.objdata() + 4;
+        _bsonEnd = _bson.objdata() + _bson.objsize() - 1;
+    }
+
     ~DocumentStorage();
 
     enum MetaType : char {
@@ -213,6 +232,13 @@ public:
         return count;
     }
 
+    /// True if there are no fields, without decoding any lazy ones.
+    bool empty() const {
+        // Every BSON element decodes to a non-missing Value, but removed fields stay behind as
+        // missing ones.
+        return !hasLazyFields() && DocumentStorageIterator(_firstElement, end(), false).atEnd();
+    }
+
     /// Returns the position of the next field to be inserted
     Position getNextPosition() const {
         return Position(_usedBytes);
@@ -255,14 +281,63 @@ public:
 
     /// This skips missing values
     DocumentStorageIterator iterator() const {
+        loadAllLazyFields();
         return DocumentStorageIterator(_firstElement, end(), false);
     }
 
     /// This includes missing values
     DocumentStorageIterator iteratorAll() const {
+        loadAllLazyFields();
         return DocumentStorageIterator(_firstElement, end(), true);
     }
 
+    /// Like iteratorAll(), but only visits fields that have already been decoded.
+    DocumentStorageIterator iteratorCached() const {
+        return DocumentStorageIterator(_firstElement, end(), true);
+    }
+
+    /// True if some fields of the backing BSON have not been decoded yet.
+    bool hasLazyFields() const {
+        return _bsonNext < _bsonEnd;
+    }
+
+    /// Decodes every remaining field of the backing BSON.
+    void loadAllLazyFields() const {
+        while (MONGO_unlikely(hasLazyFields())) {
+            loadNextLazyField();
+        }
+    }
+
+    /**
+     * Returns the BSON this storage was built from if its fields have not been modified since,
+     * and an empty BSONObj otherwise.
+     */
+    const BSONObj& getUnmodifiedBson() const {
+        return _modified ? kEmptyBson : _bson;
+    }
+
+    /// Size of the BSON this storage was built from, which it keeps alive even once modified.
+    int retainedBsonSize() const {
+        return _bson.isEmpty() ? 0 : _bson.objsize();
+    }
+
+    /**
+     * Returns how many levels of nesting below the top level getUnmodifiedBson() has, as counted
+     * by Document::toBson(). Stops counting once the limit on nesting has been exceeded.
+     */
+    size_t getBsonNestingDepth() const;
+
+    /**
+     * Called by MutableDocument before it changes this storage: decodes all remaining fields so
+     * that positions stay valid, and stops getUnmodifiedBson() from returning the stale BSON.
+     */
+    void makeModified() {
+        if (MONGO_unlikely(!_modified)) {
+            loadAllLazyFields();
+            _modified = true;
+        }
+    }
+
     /// Shallow copy of this. Caller owns memory.
     boost::intrusive_ptr<DocumentStorage> clone() const;
 
@@ -320,6 +395,12 @@ public:
     }
 
 private:
+    /// Decodes the next field of the backing BSON and returns its position.
+    Position loadNextLazyField() const;
+
+    /// Decodes fields of the backing BSON until 'name' is found. Returns Position() if it is not.
+    Position loadLazyFieldsUntil(StringData name) const;
+
     /// Same as lastElement->next() or firstElement() if empty.
     const ValueElement* end() const {
         return _firstElement ? _firstElement->plusBytes(_usedBytes) : nullptr;
@@ -363,7 +444,7 @@ private:
     /// Adds all fields to the hash table
     void rehash() {
         hashTabInit();
-        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance())
+        for (DocumentStorageIterator it = iteratorCached(); !it.atEnd(); it.advance())
             addFieldToHashTable(it.position());
     }
 
@@ -401,9 +482,18 @@ private:
     double _textScore;
     double _randVal;
     BSONObj _sortKey;
+
+    // The BSON this storage was built from, if any. Fields of '_bson' before '_bsonNext' have been
+    // decoded into '_buffer'; '_bsonEnd' points at its terminating EOO byte.
+    BSONObj _bson;
+    mutable const char* _bsonNext = nullptr;
+    const char* _bsonEnd = nullptr;
+    mutable int _bsonNestingDepth = -1;  // Computed on first use.
+    bool _modified = false;
     // When adding a field, make sure to update clone() method
 
     // Defined in document.cpp
     static const DocumentStorage kEmptyDoc;
+    static const BSONObj kEmptyBson;
 };
 }
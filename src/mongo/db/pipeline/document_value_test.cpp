@@ -145,6 +145,108 @@ TEST(DocumentSerialization, CannotSerializeDocumentThatExceedsDepthLimit) {
     throwaway.abandon();
 }
 
+TEST(DocumentSerialization, UnmodifiedDocumentReturnsOriginalBson) {
+    BSONObj original = BSON("a" << 1 << "b" << BSON("c" << BSON_ARRAY(1 << BSON("d" << 2))));
+    Document doc(original);
+    ASSERT_VALUE_EQ(Value(2), doc.getNestedField(FieldPath("b.c")).getArray()[1]["d"]);
+
+    // Looking at fields does not prevent handing back the original buffer.
+    BSONObj serialized = doc.toBson();
+    ASSERT_EQUALS(static_cast<const void*>(original.objdata()),
+                  static_cast<const void*>(serialized.objdata()));
+}
+
+TEST(DocumentSerialization, ModifiedDocumentIsReserialized) {
+    BSONObj original = BSON("a" << 1 << "b" << BSON("c" << 2) << "d" << 3);
+    Document doc(original);
+
+    MutableDocument md(doc);
+    md.setNestedField(FieldPath("b.c"), Value(5));
+    md.addField("e", Value(4));
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << BSON("c" << 5) << "d" << 3 << "e" << 4),
+                      md.freeze().toBson());
+    ASSERT_BSONOBJ_EQ(original, doc.toBson());
+}
+
+TEST(DocumentSerialization, ModifiedEmbeddedDocumentIsReserialized) {
+    Document doc(BSON("a" << BSON("b" << 1 << "c" << 2)));
+
+    std::vector<Position> positions;
+    ASSERT_VALUE_EQ(Value(1), doc.getNestedField(FieldPath("a.b"), &positions));
+
+    MutableDocument md(doc);
+    md.removeNestedField(positions);
+    ASSERT_BSONOBJ_EQ(BSON("a" << BSON("c" << 2)), md.freeze().toBson());
+}
+
+TEST(DocumentSerialization, OnlyLargeEmbeddedDocumentsShareTheParentBuffer) {
+    BSONObj original = BSON("a" << std::string(16 * 1024, 'x') << "b" << BSON("c" << 1) << "d"
+                                << BSON("e" << std::string(80 * 1024, 'y')));
+    Document doc(original);
+    const char* begin = original.objdata();
+    const char* end = begin + original.objsize();
+
+    // A small subdocument is copied out rather than keeping the whole buffer alive.
+    BSONObj small = doc["b"].getDocument().toBson();
+    ASSERT_BSONOBJ_EQ(BSON("c" << 1), small);
+    ASSERT_FALSE(small.objdata() >= begin && small.objdata() < end);
+
+    BSONObj large = doc["d"].getDocument().toBson();
+    ASSERT_BSONOBJ_EQ(original["d"].Obj(), large);
+    ASSERT_TRUE(large.objdata() >= begin && large.objdata() < end);
+}
+
+TEST(DocumentConstruction, BsonBackedDocumentWithAllFieldsRemovedIsEmpty) {
+    Document doc(BSON("a" << 1 << "b" << 2));
+    MutableDocument md(doc);
+    md.remove("a");
+    md.remove("b");
+    Document empty = md.freeze();
+    ASSERT_TRUE(empty.empty());
+    ASSERT_EQUALS(0U, empty.size());
+    ASSERT_FALSE(doc.empty());
+}
+
+TEST(DocumentConstruction, ApproximateSizeCountsBsonOfDecodedDocument) {
+    BSONObj original = BSON("a" << 1 << "b" << std::string(4096, 'x'));
+    Document doc(original);
+    ASSERT_GTE(doc.getApproximateSize(), static_cast<size_t>(original.objsize()));
+
+    // Decoding every field keeps the BSON alive, so it is still counted.
+    ASSERT_EQUALS(2U, doc.size());
+    ASSERT_GTE(doc.getApproximateSize(), static_cast<size_t>(original.objsize()));
+}
+
+TEST(DocumentConstruction, FieldLookupOnBsonBackedDocument) {
+    Document doc(BSON("a" << 1 << "b"
+                          << "q"
+                          << "c"
+                          << BSON("d" << true)));
+    ASSERT_EQUALS("q", doc["b"].getString());
+    ASSERT_TRUE(doc["x"].missing());
+    ASSERT_EQUALS(1, doc["a"].getInt());
+    ASSERT_VALUE_EQ(Value(true), doc.getNestedField(FieldPath("c.d")));
+
+    ASSERT_EQUALS(3U, doc.size());
+    ASSERT_EQUALS("a", getNthField(doc, 0).first.toString());
+    ASSERT_EQUALS("b", getNthField(doc, 1).first.toString());
+    ASSERT_EQUALS("c", getNthField(doc, 2).first.toString());
+    ASSERT_FALSE(doc.empty());
+}
+
+TEST(DocumentConstruction, WideBsonBackedDocumentLookup) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < 100; ++i) {
+        builder.append("field" + std::to_string(i), i);
+    }
+    Document doc(builder.obj());
+    for (int i = 99; i >= 0; --i) {
+        ASSERT_EQUALS(i, doc["field" + std::to_string(i)].getInt());
+    }
+    ASSERT_EQUALS(100U, doc.size());
+    assertRoundTrips(doc);
+}
+
 /** Add Document fields. */
 class AddField {
 public:
@@ -568,6 +670,14 @@ TEST(MetaFields, ToAndFromBson) {
     ASSERT_EQ(20, fromBson.getRandMetaField());
 }
 
+TEST(MetaFields, FromBsonWithoutMetaDataIsUnchanged) {
+    BSONObj original = BSON("a" << 1 << "b" << BSON("$c" << 2));
+    Document doc = Document::fromBsonWithMetaData(original);
+    ASSERT_FALSE(doc.hasTextScore());
+    ASSERT_BSONOBJ_EQ(original, doc.toBson());
+    ASSERT_BSONOBJ_EQ(original, doc.toBsonWithMetaData());
+}
+
 TEST(MetaFields, BadSerialization) {
     // Write an unrecognized option to the buffer.
     BufBuilder bb;
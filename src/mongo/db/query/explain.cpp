@@ -43,6 +43,7 @@
 #include "mongo/db/exec/text.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/keypattern.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
@@ -781,6 +782,11 @@ void Explain::generateExecutionInfo(PlanExecutor* exec,
     const auto winningExecStats = getWinningPlanStatsTree(exec);
     generateSinglePlanExecutionInfo(winningExecStats.get(), verbosity, totalTimeMillis, &execBob);
 
+    const auto& trace = OperationTrace::get(opCtx);
+    if (trace.isEnabled()) {
+        execBob.append("executionTimeBreakdown", trace.getBreakdown());
+    }
+
     // Also generate exec stats for all plans, if the verbosity level is high enough.
     // These stats reflect what happened during the trial period that ranked the plans.
     if (verbosity >= ExplainOptions::Verbosity::kExecAllPlans) {
@@ -861,6 +867,7 @@ void Explain::explainStages(PlanExecutor* exec,
 
     // If we need execution stats, then run the plan in order to gather the stats.
     if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+        OperationTrace::Span span(exec->getOpCtx(), OperationTrace::Phase::kExecution);
         executePlanStatus = exec->executePlan();
 
         // If executing the query failed because it was killed, then the collection may no longer be
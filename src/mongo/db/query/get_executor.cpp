@@ -57,6 +57,7 @@
 #include "mongo/db/index_names.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/ops/update_lifecycle.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
@@ -378,7 +379,10 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         return PrepareExecutionResult(std::move(canonicalQuery), nullptr, std::move(root));
     }
 
-    auto statusWithSolutions = QueryPlanner::plan(*canonicalQuery, plannerParams);
+    auto statusWithSolutions = [&] {
+        OperationTrace::Span span(opCtx, OperationTrace::Phase::kPlan);
+        return QueryPlanner::plan(*canonicalQuery, plannerParams);
+    }();
     if (!statusWithSolutions.isOK()) {
         return Status(ErrorCodes::BadValue,
                       "error processing query: " + canonicalQuery->toString() +
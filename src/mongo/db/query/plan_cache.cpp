@@ -41,10 +41,13 @@
 #include "mongo/client/dbclientinterface.h"  // For QueryOption_foobar
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/plan_ranker.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_solution.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -53,6 +56,13 @@
 namespace mongo {
 namespace {
 
+// Query shapes whose candidate plans are being ranked, and the operation ranking them. Keyed by
+// namespace and plan cache key. This is kept outside of the PlanCache because a ranking yields, and
+// the collection, along with its plan cache, can be dropped in the meantime.
+stdx::mutex rankingsMutex;
+stdx::condition_variable rankingFinished;
+stdx::unordered_map<std::string, const OperationContext*> rankingsInProgress;
+
 // Delimiters for cache key encoding.
 const char kEncodeDiscriminatorsBegin = '<';
 const char kEncodeDiscriminatorsEnd = '>';
@@ -853,4 +863,48 @@ void PlanCache::notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries
     _indexabilityState.updateDiscriminators(indexEntries);
 }
 
+PlanCache::RankingInProgress::RankingInProgress(std::string key) : _key(std::move(key)) {}
+
+PlanCache::RankingInProgress::~RankingInProgress() {
+    stdx::lock_guard<stdx::mutex> lk(rankingsMutex);
+    rankingsInProgress.erase(_key);
+    rankingFinished.notify_all();
+}
+
+std::unique_ptr<PlanCache::RankingInProgress> PlanCache::startRanking(
+    OperationContext* opCtx, const CanonicalQuery& query) const {
+    std::string key = computeRankingKey(query);
+
+    stdx::lock_guard<stdx::mutex> lk(rankingsMutex);
+    if (!rankingsInProgress.emplace(key, opCtx).second) {
+        return nullptr;
+    }
+    return stdx::make_unique<RankingInProgress>(std::move(key));
+}
+
+std::string PlanCache::computeRankingKey(const CanonicalQuery& query) const {
+    return str::stream() << _ns << '\0' << computeKey(query);
+}
+
+PlanCache::RankingWaitResult PlanCache::waitForRanking(OperationContext* opCtx,
+                                                       const std::string& rankingKey,
+                                                       Date_t deadline) {
+    stdx::unique_lock<stdx::mutex> lk(rankingsMutex);
+    auto it = rankingsInProgress.find(rankingKey);
+    if (it == rankingsInProgress.end() || it->second == opCtx) {
+        return RankingWaitResult::kNotRanking;
+    }
+
+    // Another operation may start ranking the same shape once this one finishes, e.g. if the
+    // winning plan was not cached. Only wait for the ranking that was in progress on entry.
+    const OperationContext* rankingOpCtx = it->second;
+    const bool finished =
+        opCtx->waitForConditionOrInterruptUntil(rankingFinished, lk, deadline, [&] {
+            auto current = rankingsInProgress.find(rankingKey);
+            return current == rankingsInProgress.end() || current->second != rankingOpCtx;
+        });
+
+    return finished ? RankingWaitResult::kFinished : RankingWaitResult::kTimedOut;
+}
+
 }  // namespace mongo
@@ -31,6 +31,7 @@
 #include <boost/optional/optional.hpp>
 #include <set>
 
+#include "mongo/base/disallow_copying.h"
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/index_tag.h"
@@ -45,6 +46,7 @@ namespace mongo {
 // A PlanCacheKey is a string-ified version of a query's predicate/projection/sort.
 typedef std::string PlanCacheKey;
 
+class OperationContext;
 struct PlanRankingDecision;
 struct QuerySolution;
 struct QuerySolutionNode;
@@ -414,6 +416,54 @@ public:
      */
     void notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries);
 
+    /**
+     * Marks the candidate plans for a query shape as being ranked by an operation, for as long as
+     * this object lives.
+     */
+    class RankingInProgress {
+        MONGO_DISALLOW_COPYING(RankingInProgress);
+
+    public:
+        explicit RankingInProgress(std::string key);
+        ~RankingInProgress();
+
+    private:
+        const std::string _key;
+    };
+
+    /**
+     * Called by the MultiPlanStage before it ranks the candidate plans for 'query'. Other
+     * operations with the same query shape that miss the cache in the meantime can then wait in
+     * waitForRanking() for the plan this ranking caches, rather than running the same trial.
+     *
+     * Returns nullptr if another operation is already ranking plans for this query shape.
+     */
+    std::unique_ptr<RankingInProgress> startRanking(OperationContext* opCtx,
+                                                    const CanonicalQuery& query) const;
+
+    /**
+     * Returns the key under which startRanking() records a ranking of the plans for 'query'.
+     */
+    std::string computeRankingKey(const CanonicalQuery& query) const;
+
+    enum class RankingWaitResult {
+        kNotRanking,  // no other operation is ranking plans for the query shape
+        kFinished,    // the operation ranking plans for the query shape finished
+        kTimedOut,    // 'deadline' passed before the ranking finished
+    };
+
+    /**
+     * If another operation is ranking the candidate plans for the query shape 'rankingKey', as
+     * returned by computeRankingKey(), waits until it finishes or until 'deadline'. Throws if
+     * opCtx is interrupted.
+     *
+     * Does not use the PlanCache, so that it can be called with the collection lock released.
+     * Callers must not hold any locks, so that the wait never holds up the ranking operation.
+     */
+    static RankingWaitResult waitForRanking(OperationContext* opCtx,
+                                            const std::string& rankingKey,
+                                            Date_t deadline);
+
 private:
     void encodeKeyForMatch(const MatchExpression* tree, StringBuilder* keyBuilder) const;
     void encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuilder) const;
@@ -47,9 +47,11 @@
 #include "mongo/db/query/query_planner_test_lib.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/query/query_test_service_context.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 #include "mongo/util/transitional_tools_do_not_use/vector_spooling.h"
 
 using namespace mongo;
@@ -449,6 +451,56 @@ TEST(PlanCacheTest, AddValidSolution) {
     ASSERT_EQUALS(planCache.size(), 1U);
 }
 
+// Only one operation at a time ranks the plans for a query shape.
+TEST(PlanCacheTest, StartRankingOncePerQueryShape) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    unique_ptr<CanonicalQuery> sameShape(canonicalize("{a: 2}"));
+    unique_ptr<CanonicalQuery> otherShape(canonicalize("{b: 1}"));
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    auto ranking = planCache.startRanking(opCtx.get(), *cq);
+    ASSERT(ranking);
+    ASSERT_FALSE(planCache.startRanking(opCtx.get(), *sameShape));
+    ASSERT(planCache.startRanking(opCtx.get(), *otherShape));
+
+    ranking.reset();
+    ASSERT(planCache.startRanking(opCtx.get(), *sameShape));
+}
+
+TEST(PlanCacheTest, WaitForRanking) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    QueryTestServiceContext rankingServiceContext;
+    auto rankingOpCtx = rankingServiceContext.makeOperationContext();
+    QueryTestServiceContext waitingServiceContext;
+    auto waitingOpCtx = waitingServiceContext.makeOperationContext();
+
+    const std::string rankingKey = planCache.computeRankingKey(*cq);
+
+    ASSERT(PlanCache::RankingWaitResult::kNotRanking ==
+           PlanCache::waitForRanking(waitingOpCtx.get(), rankingKey, Date_t::max()));
+
+    auto ranking = planCache.startRanking(rankingOpCtx.get(), *cq);
+    ASSERT(ranking);
+
+    // The operation ranking the plans does not wait for itself.
+    ASSERT(PlanCache::RankingWaitResult::kNotRanking ==
+           PlanCache::waitForRanking(rankingOpCtx.get(), rankingKey, Date_t::max()));
+    ASSERT(PlanCache::RankingWaitResult::kTimedOut ==
+           PlanCache::waitForRanking(
+               waitingOpCtx.get(), rankingKey, Date_t::now() + Milliseconds(10)));
+
+    stdx::thread rankingThread([&] {
+        sleepmillis(10);
+        ranking.reset();
+    });
+    ASSERT(PlanCache::RankingWaitResult::kFinished ==
+           PlanCache::waitForRanking(waitingOpCtx.get(), rankingKey, Date_t::max()));
+    rankingThread.join();
+}
+
 /**
  * Each test in the CachePlanSelectionTest suite goes through
  * the following flow:
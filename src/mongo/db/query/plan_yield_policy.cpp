@@ -33,6 +33,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_yield.h"
 #include "mongo/db/service_context.h"
@@ -124,6 +125,8 @@ Status PlanYieldPolicy::yield(stdx::function<void()> beforeYieldingFn,
     invariant(opCtx);
     invariant(!opCtx->lockState()->inAWriteUnitOfWork());
 
+    OperationTrace::Span span(opCtx, OperationTrace::Phase::kYield);
+
     // Can't use writeConflictRetry since we need to call saveState before reseting the transaction.
     for (int attempt = 1; true; attempt++) {
         try {
@@ -38,6 +38,10 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationCollFraction, double, 0
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxResults, int, 101);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxMillis, int, 2000);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanRankingCoalesceWaitMillis, int, 2000);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheSize, int, 5000);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheFeedbacksStored, int, 20);
@@ -66,6 +70,8 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecEnableCompiledMatcher, bool, true);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetBufferSizeBytes, int, 100 * 1024 * 1024);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalInsertMaxBatchSize,
@@ -48,6 +48,13 @@ extern AtomicDouble internalQueryPlanEvaluationCollFraction;
 // Stop working plans once a plan returns this many results.
 extern AtomicInt32 internalQueryPlanEvaluationMaxResults;
 
+// Stop working plans once the trial period has run for this many milliseconds. 0 means no limit.
+extern AtomicInt32 internalQueryPlanEvaluationMaxMillis;
+
+// How long a query waits for another operation that is ranking plans for the same query shape,
+// before ranking the plans itself. 0 disables waiting.
+extern AtomicInt32 internalQueryPlanRankingCoalesceWaitMillis;
+
 // Do we give a big ranking bonus to intersection plans?
 extern AtomicBool internalQueryForceIntersectionPlans;
 
@@ -110,6 +117,9 @@ extern AtomicInt32 internalQueryExecYieldIterations;
 // Yield if it's been at least this many milliseconds since we last yielded.
 extern AtomicInt32 internalQueryExecYieldPeriodMS;
 
+// Should collection scans and fetches evaluate their filters with a CompiledMatcher?
+extern AtomicBool internalQueryExecEnableCompiledMatcher;
+
 // Limit the size that we write without yielding to 16MB / 64 (max expected number of indexes)
 const int64_t insertVectorMaxBytes = 256 * 1024;
 
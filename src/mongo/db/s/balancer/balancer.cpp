@@ -73,6 +73,10 @@ const Seconds kBalanceRoundDefaultInterval(10);
 // not being able to establish a stable shard version.
 const Seconds kShortBalanceRoundInterval(1);
 
+// Upper bound on how long a balancer round keeps selecting more chunks to move as earlier
+// migrations complete, before it lets the round end and the next one start afresh.
+const Minutes kMaxContinuousBalancingTime(5);
+
 const auto getBalancer = ServiceContext::declareDecoration<std::unique_ptr<Balancer>>();
 
 /**
@@ -377,7 +381,7 @@ void Balancer::_mainThread() {
                 }
 
                 const auto candidateChunks = uassertStatusOK(
-                    _chunkSelectionPolicy->selectChunksToMove(opCtx.get(), _balancedLastTime));
+                    _chunkSelectionPolicy->selectChunksToMove(opCtx.get(), _balancedLastTime, {}));
 
                 if (candidateChunks.empty()) {
                     LOG(1) << "no need to move any chunk";
@@ -573,12 +577,44 @@ int Balancer::_moveChunks(OperationContext* opCtx,
         return 0;
     }
 
+    // Every migration, including the ones selected while earlier ones were still running
+    auto allCandidateChunks = candidateChunks;
+
+    // As soon as a migration completes, select more chunks to move for the shards which became
+    // free instead of waiting for the entire round to finish. Stop doing so after a while so that
+    // the other balancer round duties are not postponed indefinitely.
+    Timer schedulingTimer;
+
+    auto selectMoreMigrations = [&](const std::set<ShardId>& busyShards) {
+        BalancerChunkSelectionPolicy::MigrateInfoVector moreCandidateChunks;
+
+        if (schedulingTimer.seconds() >= durationCount<Seconds>(kMaxContinuousBalancingTime) ||
+            _stopRequested() || !balancerConfig->refreshAndCheck(opCtx).isOK() ||
+            !balancerConfig->shouldBalance()) {
+            return moreCandidateChunks;
+        }
+
+        auto candidatesStatus =
+            _chunkSelectionPolicy->selectChunksToMove(opCtx, _balancedLastTime, busyShards);
+        if (!candidatesStatus.isOK()) {
+            warning() << "Unable to select more chunks to move"
+                      << causedBy(candidatesStatus.getStatus());
+            return moreCandidateChunks;
+        }
+
+        moreCandidateChunks = std::move(candidatesStatus.getValue());
+        allCandidateChunks.insert(
+            allCandidateChunks.end(), moreCandidateChunks.begin(), moreCandidateChunks.end());
+        return moreCandidateChunks;
+    };
+
     auto migrationStatuses =
         _migrationManager.executeMigrationsForAutoBalance(opCtx,
                                                           candidateChunks,
                                                           balancerConfig->getMaxChunkSizeBytes(),
                                                           balancerConfig->getSecondaryThrottle(),
-                                                          balancerConfig->waitForDelete());
+                                                          balancerConfig->waitForDelete(),
+                                                          selectMoreMigrations);
 
     int numChunksProcessed = 0;
 
@@ -591,12 +627,12 @@ int Balancer::_moveChunks(OperationContext* opCtx,
 
         const MigrationIdentifier& migrationId = migrationStatusEntry.first;
 
-        const auto requestIt = std::find_if(candidateChunks.begin(),
-                                            candidateChunks.end(),
+        const auto requestIt = std::find_if(allCandidateChunks.begin(),
+                                            allCandidateChunks.end(),
                                             [&migrationId](const MigrateInfo& migrateInfo) {
                                                 return migrateInfo.getName() == migrationId;
                                             });
-        invariant(requestIt != candidateChunks.end());
+        invariant(requestIt != allCandidateChunks.end());
 
         if (status == ErrorCodes::ChunkTooBig) {
             numChunksProcessed++;
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <set>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
@@ -93,9 +94,12 @@ public:
      * Potentially blocking method, which gives out a set of chunks to be moved. The
      * aggressiveBalanceHint indicates to the balancing logic that it should lower the threshold for
      * difference in number of chunks across shards and thus potentially cause more chunks to move.
+     * None of the returned migrations will involve any of the shards in excludedShards.
      */
-    virtual StatusWith<MigrateInfoVector> selectChunksToMove(OperationContext* opCtx,
-                                                             bool aggressiveBalanceHint) = 0;
+    virtual StatusWith<MigrateInfoVector> selectChunksToMove(
+        OperationContext* opCtx,
+        bool aggressiveBalanceHint,
+        const std::set<ShardId>& excludedShards) = 0;
 
     /**
      * Requests a single chunk to be relocated to a different shard, if possible. If some error
@@ -36,11 +36,13 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj_comparator_interface.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog/type_collection.h"
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/shard_util.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -55,6 +57,10 @@ using std::vector;
 
 namespace {
 
+// When enabled, the balancer compares shards by the size of each collection's data on them instead
+// of by the number of chunks they own
+MONGO_EXPORT_SERVER_PARAMETER(balancerBalanceByDataSize, bool, false);
+
 /**
  * Does a linear pass over the information cached in the specified chunk manager and extracts chunk
  * distribution and chunk placement information which is needed by the balancer policy.
@@ -108,6 +114,46 @@ StatusWith<DistributionStatus> createCollectionDistributionStatus(
     return {std::move(distribution)};
 }
 
+/**
+ * Retrieves the estimated size of the data in each chunk from the shards, which own chunks for the
+ * collection, and records it in the distribution so the balancer policy weighs shards by data size.
+ * The shards do not count orphaned documents, which are still waiting to be range deleted, towards
+ * their chunks. If the sizes cannot be obtained from any of the shards, the distribution is left
+ * unchanged and balancing falls back to chunk counts.
+ */
+void addCollectionDataSizes(OperationContext* opCtx,
+                            const ShardStatisticsVector& allShards,
+                            DistributionStatus* distribution) {
+    auto chunkDataSizes = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<long long>();
+
+    for (const auto& stat : allShards) {
+        if (distribution->numberOfChunksInShard(stat.shardId) == 0)
+            continue;
+
+        auto swChunkDataSizes =
+            shardutil::retrieveChunkDataSizes(opCtx, stat.shardId, distribution->nss());
+        if (!swChunkDataSizes.isOK()) {
+            warning() << "Unable to retrieve the chunk sizes of collection "
+                      << distribution->nss().ns() << " on shard " << stat.shardId
+                      << ", balancing it by chunk count" << causedBy(swChunkDataSizes.getStatus());
+            return;
+        }
+
+        for (const auto& chunkDataSize : swChunkDataSizes.getValue()) {
+            chunkDataSizes[chunkDataSize.first.getMin()] = chunkDataSize.second;
+        }
+    }
+
+    // Chunks which the shard did not know about yet, for example because it has not refreshed
+    // after a split, are treated as empty until the next round
+    for (const auto& stat : allShards) {
+        for (const auto& chunk : distribution->getChunks(stat.shardId)) {
+            const auto it = chunkDataSizes.find(chunk.getMin());
+            distribution->setChunkDataSize(chunk, it == chunkDataSizes.end() ? 0 : it->second);
+        }
+    }
+}
+
 /**
  * Helper class used to accumulate the split points for the same chunk together so they can be
  * submitted to the shard as a single call versus multiple. This is necessary in order to avoid
@@ -226,7 +272,9 @@ StatusWith<SplitInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToSpli
 }
 
 StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToMove(
-    OperationContext* opCtx, bool aggressiveBalanceHint) {
+    OperationContext* opCtx,
+    bool aggressiveBalanceHint,
+    const std::set<ShardId>& excludedShards) {
     auto shardStatsStatus = _clusterStats->getStats(opCtx);
     if (!shardStatsStatus.isOK()) {
         return shardStatsStatus.getStatus();
@@ -252,7 +300,7 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToMo
     }
 
     MigrateInfoVector candidateChunks;
-    std::set<ShardId> usedShards;
+    std::set<ShardId> usedShards(excludedShards);
 
     for (const auto& coll : collections) {
         if (coll.getDropped()) {
@@ -304,12 +352,16 @@ BalancerChunkSelectionPolicyImpl::selectSpecificChunkToMove(OperationContext* op
 
     const auto cm = routingInfoStatus.getValue().cm().get();
 
-    const auto collInfoStatus = createCollectionDistributionStatus(opCtx, shardStats, cm);
+    auto collInfoStatus = createCollectionDistributionStatus(opCtx, shardStats, cm);
     if (!collInfoStatus.isOK()) {
         return collInfoStatus.getStatus();
     }
 
-    const DistributionStatus& distribution = collInfoStatus.getValue();
+    DistributionStatus& distribution = collInfoStatus.getValue();
+
+    if (balancerBalanceByDataSize.load()) {
+        addCollectionDataSizes(opCtx, shardStats, &distribution);
+    }
 
     return BalancerPolicy::balanceSingleChunk(chunk, shardStats, distribution);
 }
@@ -421,12 +473,12 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
 
     const auto& shardKeyPattern = cm->getShardKeyPattern().getKeyPattern();
 
-    const auto collInfoStatus = createCollectionDistributionStatus(opCtx, shardStats, cm);
+    auto collInfoStatus = createCollectionDistributionStatus(opCtx, shardStats, cm);
     if (!collInfoStatus.isOK()) {
         return collInfoStatus.getStatus();
     }
 
-    const DistributionStatus& distribution = collInfoStatus.getValue();
+    DistributionStatus& distribution = collInfoStatus.getValue();
 
     for (const auto& tagRangeEntry : distribution.tagRanges()) {
         const auto& tagRange = tagRangeEntry.second;
@@ -467,6 +519,10 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
         }
     }
 
+    if (balancerBalanceByDataSize.load()) {
+        addCollectionDataSizes(opCtx, shardStats, &distribution);
+    }
+
     return BalancerPolicy::balance(shardStats, distribution, aggressiveBalanceHint, usedShards);
 }
 
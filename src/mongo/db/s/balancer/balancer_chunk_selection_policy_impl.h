@@ -41,8 +41,10 @@ public:
 
     StatusWith<SplitInfoVector> selectChunksToSplit(OperationContext* opCtx) override;
 
-    StatusWith<MigrateInfoVector> selectChunksToMove(OperationContext* opCtx,
-                                                     bool aggressiveBalanceHint) override;
+    StatusWith<MigrateInfoVector> selectChunksToMove(
+        OperationContext* opCtx,
+        bool aggressiveBalanceHint,
+        const std::set<ShardId>& excludedShards) override;
 
     StatusWith<boost::optional<MigrateInfo>> selectSpecificChunkToMove(
         OperationContext* opCtx, const ChunkType& chunk) override;
@@ -32,6 +32,8 @@
 
 #include "mongo/db/s/balancer/balancer_policy.h"
 
+#include <algorithm>
+
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/util/log.h"
@@ -52,11 +54,106 @@ namespace {
 const size_t kDefaultImbalanceThreshold = 2;
 const size_t kAggressiveImbalanceThreshold = 1;
 
+/**
+ * Suggests moving the first movable chunk with the specified tag from shard 'from' to shard 'to'
+ * and marks both shards as used. Returns false if all such chunks are jumbo.
+ */
+bool moveFirstChunkWithTag(const DistributionStatus& distribution,
+                           const ShardId& from,
+                           const ShardId& to,
+                           const string& tag,
+                           vector<MigrateInfo>* migrations,
+                           set<ShardId>* usedShards) {
+    const vector<ChunkType>& chunks = distribution.getChunks(from);
+
+    unsigned numJumboChunks = 0;
+
+    for (const auto& chunk : chunks) {
+        if (distribution.getTagForChunk(chunk) != tag)
+            continue;
+
+        if (chunk.getJumbo()) {
+            numJumboChunks++;
+            continue;
+        }
+
+        migrations->emplace_back(to, chunk);
+        invariant(usedShards->insert(chunk.getShard()).second);
+        invariant(usedShards->insert(to).second);
+        return true;
+    }
+
+    if (numJumboChunks) {
+        warning() << "Shard: " << from << ", collection: " << distribution.nss().ns()
+                  << " has only jumbo chunks for zone \'" << tag
+                  << "\' and cannot be balanced. Jumbo chunks count: " << numJumboChunks;
+    }
+
+    return false;
+}
+
+/**
+ * Suggests moving the largest movable chunk with the specified tag from shard 'from' to shard 'to',
+ * which holds some data but no more than 'maxChunkSizeBytes', and marks both shards as used.
+ * Returns false if there is no such chunk.
+ */
+bool moveLargestFittingChunkWithTag(const DistributionStatus& distribution,
+                                    const ShardId& from,
+                                    const ShardId& to,
+                                    const string& tag,
+                                    long long maxChunkSizeBytes,
+                                    vector<MigrateInfo>* migrations,
+                                    set<ShardId>* usedShards) {
+    const vector<ChunkType>& chunks = distribution.getChunks(from);
+
+    const ChunkType* best = nullptr;
+    long long bestChunkSize = 0;
+    unsigned numJumboChunks = 0;
+
+    for (const auto& chunk : chunks) {
+        if (distribution.getTagForChunk(chunk) != tag)
+            continue;
+
+        if (chunk.getJumbo()) {
+            numJumboChunks++;
+            continue;
+        }
+
+        // Moving an empty chunk does not change the balance, while one larger than the imbalance
+        // would overshoot it
+        const long long chunkSize = distribution.chunkDataSize(chunk);
+        if (chunkSize <= bestChunkSize || chunkSize > maxChunkSizeBytes)
+            continue;
+
+        best = &chunk;
+        bestChunkSize = chunkSize;
+    }
+
+    if (best) {
+        migrations->emplace_back(to, *best);
+        invariant(usedShards->insert(from).second);
+        invariant(usedShards->insert(to).second);
+        return true;
+    }
+
+    if (numJumboChunks) {
+        warning() << "Shard: " << from << ", collection: " << distribution.nss().ns()
+                  << " has jumbo chunks for zone \'" << tag
+                  << "\', which cannot be balanced. Jumbo chunks count: " << numJumboChunks;
+    }
+
+    LOG(1) << "No chunk of zone [" << tag << "] on shard " << from << " holds data and fits into "
+           << maxChunkSizeBytes << " bytes";
+
+    return false;
+}
+
 }  // namespace
 
 DistributionStatus::DistributionStatus(NamespaceString nss, ShardToChunksMap shardToChunksMap)
     : _nss(std::move(nss)),
       _shardChunks(std::move(shardToChunksMap)),
+      _chunkDataSizes(SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<long long>()),
       _zoneRanges(SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ZoneRange>()) {}
 
 size_t DistributionStatus::totalChunks() const {
@@ -99,6 +196,49 @@ size_t DistributionStatus::numberOfChunksInShardWithTag(const ShardId& shardId,
     return total;
 }
 
+void DistributionStatus::setChunkDataSize(const ChunkType& chunk, long long dataSizeBytes) {
+    invariant(_shardChunks.count(chunk.getShard()));
+    _chunkDataSizes[chunk.getMin()] = dataSizeBytes;
+}
+
+long long DistributionStatus::chunkDataSize(const ChunkType& chunk) const {
+    const auto it = _chunkDataSizes.find(chunk.getMin());
+    return it == _chunkDataSizes.end() ? 0 : it->second;
+}
+
+long long DistributionStatus::dataSizeInShard(const ShardId& shardId) const {
+    long long total = 0;
+
+    for (const auto& chunk : getChunks(shardId)) {
+        total += chunkDataSize(chunk);
+    }
+
+    return total;
+}
+
+long long DistributionStatus::dataSizeInShardWithTag(const ShardId& shardId,
+                                                     const string& tag) const {
+    long long total = 0;
+
+    for (const auto& chunk : getChunks(shardId)) {
+        if (tag == getTagForChunk(chunk)) {
+            total += chunkDataSize(chunk);
+        }
+    }
+
+    return total;
+}
+
+long long DistributionStatus::totalDataSizeWithTag(const string& tag) const {
+    long long total = 0;
+
+    for (const auto& shardChunk : _shardChunks) {
+        total += dataSizeInShardWithTag(shardChunk.first, tag);
+    }
+
+    return total;
+}
+
 const vector<ChunkType>& DistributionStatus::getChunks(const ShardId& shardId) const {
     ShardToChunksMap::const_iterator i = _shardChunks.find(shardId);
     invariant(i != _shardChunks.end());
@@ -181,6 +321,9 @@ void DistributionStatus::report(BSONObjBuilder* builder) const {
     for (const auto& shardChunk : _shardChunks) {
         BSONObjBuilder shardEntry(shardArr.subobjStart());
         shardEntry.append("name", shardChunk.first.toString());
+        if (hasDataSizes()) {
+            shardEntry.append("dataSize", dataSizeInShard(shardChunk.first));
+        }
 
         BSONArrayBuilder chunkArr(shardEntry.subarrayStart("chunks"));
         for (const auto& chunk : shardChunk.second) {
@@ -265,6 +408,69 @@ ShardId BalancerPolicy::_getLeastLoadedReceiverShard(const ShardStatisticsVector
     return best;
 }
 
+ShardId BalancerPolicy::_getLeastLoadedReceiverShardByDataSize(
+    const ShardStatisticsVector& shardStats,
+    const DistributionStatus& distribution,
+    const string& tag,
+    long long chunkSizeBytes,
+    const set<ShardId>& excludedShards) {
+    const uint64_t chunkSizeMB = static_cast<uint64_t>(chunkSizeBytes) / (1024 * 1024);
+
+    ShardId best;
+    long long minDataSize = numeric_limits<long long>::max();
+    uint64_t minCurrSizeMB = numeric_limits<uint64_t>::max();
+
+    for (const auto& stat : shardStats) {
+        if (excludedShards.count(stat.shardId))
+            continue;
+
+        auto status = isShardSuitableReceiver(stat, tag);
+        if (!status.isOK()) {
+            continue;
+        }
+
+        // Do not pick a shard, which would be pushed over its maximum size by the chunk
+        if (stat.maxSizeMB > 0 && stat.currSizeMB + chunkSizeMB > stat.maxSizeMB) {
+            continue;
+        }
+
+        const long long myDataSize = distribution.dataSizeInShardWithTag(stat.shardId, tag);
+        if (myDataSize > minDataSize ||
+            (myDataSize == minDataSize && stat.currSizeMB >= minCurrSizeMB)) {
+            continue;
+        }
+
+        best = stat.shardId;
+        minDataSize = myDataSize;
+        minCurrSizeMB = stat.currSizeMB;
+    }
+
+    return best;
+}
+
+ShardId BalancerPolicy::_getMostOverloadedShardByDataSize(const ShardStatisticsVector& shardStats,
+                                                          const DistributionStatus& distribution,
+                                                          const string& chunkTag,
+                                                          const set<ShardId>& excludedShards) {
+    ShardId worst;
+    long long maxDataSize = 0;
+
+    for (const auto& stat : shardStats) {
+        if (excludedShards.count(stat.shardId))
+            continue;
+
+        const long long shardDataSize =
+            distribution.dataSizeInShardWithTag(stat.shardId, chunkTag);
+        if (shardDataSize <= maxDataSize)
+            continue;
+
+        worst = stat.shardId;
+        maxDataSize = shardDataSize;
+    }
+
+    return worst;
+}
+
 ShardId BalancerPolicy::_getMostOverloadedShard(const ShardStatisticsVector& shardStats,
                                                 const DistributionStatus& distribution,
                                                 const string& chunkTag,
@@ -321,8 +527,14 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
 
                 const string tag = distribution.getTagForChunk(chunk);
 
-                const ShardId to =
-                    _getLeastLoadedReceiverShard(shardStats, distribution, tag, *usedShards);
+                const ShardId to = distribution.hasDataSizes()
+                    ? _getLeastLoadedReceiverShardByDataSize(
+                          shardStats,
+                          distribution,
+                          tag,
+                          distribution.chunkDataSize(chunk),
+                          *usedShards)
+                    : _getLeastLoadedReceiverShard(shardStats, distribution, tag, *usedShards);
                 if (!to.isValid()) {
                     if (migrations.empty()) {
                         warning() << "Chunk " << redact(chunk.toString())
@@ -368,8 +580,14 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
                     continue;
                 }
 
-                const ShardId to =
-                    _getLeastLoadedReceiverShard(shardStats, distribution, tag, *usedShards);
+                const ShardId to = distribution.hasDataSizes()
+                    ? _getLeastLoadedReceiverShardByDataSize(
+                          shardStats,
+                          distribution,
+                          tag,
+                          distribution.chunkDataSize(chunk),
+                          *usedShards)
+                    : _getLeastLoadedReceiverShard(shardStats, distribution, tag, *usedShards);
                 if (!to.isValid()) {
                     if (migrations.empty()) {
                         warning() << "Chunk " << redact(chunk.toString()) << " violates zone "
@@ -419,6 +637,26 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
             continue;
         }
 
+        if (distribution.hasDataSizes()) {
+            const long long totalDataSizeWithTag = distribution.totalDataSizeWithTag(tag);
+            const long long numShards = static_cast<long long>(totalNumberOfShardsWithTag);
+
+            // Calculate the ceiling of the optimal data size per shard
+            const long long idealDataSizePerShardForTag =
+                (totalDataSizeWithTag / numShards) + (totalDataSizeWithTag % numShards ? 1 : 0);
+
+            while (_singleZoneBalanceByDataSize(shardStats,
+                                                distribution,
+                                                tag,
+                                                idealDataSizePerShardForTag,
+                                                imbalanceThreshold,
+                                                &migrations,
+                                                usedShards))
+                ;
+
+            continue;
+        }
+
         // Calculate the ceiling of the optimal number of chunks per shard
         const size_t idealNumberOfChunksPerShardForTag =
             (totalNumberOfChunksWithTag / totalNumberOfShardsWithTag) +
@@ -443,8 +681,10 @@ boost::optional<MigrateInfo> BalancerPolicy::balanceSingleChunk(
     const DistributionStatus& distribution) {
     const string tag = distribution.getTagForChunk(chunk);
 
-    ShardId newShardId =
-        _getLeastLoadedReceiverShard(shardStats, distribution, tag, set<ShardId>());
+    ShardId newShardId = distribution.hasDataSizes()
+        ? _getLeastLoadedReceiverShardByDataSize(
+              shardStats, distribution, tag, distribution.chunkDataSize(chunk), set<ShardId>())
+        : _getLeastLoadedReceiverShard(shardStats, distribution, tag, set<ShardId>());
     if (!newShardId.isValid() || newShardId == chunk.getShard()) {
         return boost::optional<MigrateInfo>();
     }
@@ -496,32 +736,74 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     if (imbalance < imbalanceThreshold)
         return false;
 
-    const vector<ChunkType>& chunks = distribution.getChunks(from);
+    return moveFirstChunkWithTag(distribution, from, to, tag, migrations, usedShards);
+}
 
-    unsigned numJumboChunks = 0;
+bool BalancerPolicy::_singleZoneBalanceByDataSize(const ShardStatisticsVector& shardStats,
+                                                  const DistributionStatus& distribution,
+                                                  const string& tag,
+                                                  long long idealDataSizePerShardForTag,
+                                                  size_t imbalanceThreshold,
+                                                  vector<MigrateInfo>* migrations,
+                                                  set<ShardId>* usedShards) {
+    const ShardId from =
+        _getMostOverloadedShardByDataSize(shardStats, distribution, tag, *usedShards);
+    if (!from.isValid())
+        return false;
 
-    for (const auto& chunk : chunks) {
-        if (distribution.getTagForChunk(chunk) != tag)
-            continue;
+    const long long max = distribution.dataSizeInShardWithTag(from, tag);
 
-        if (chunk.getJumbo()) {
-            numJumboChunks++;
-            continue;
-        }
+    // Do not use a shard if it already has less data than the optimal per-shard data size
+    if (max <= idealDataSizePerShardForTag)
+        return false;
 
-        migrations->emplace_back(to, chunk);
-        invariant(usedShards->insert(chunk.getShard()).second);
-        invariant(usedShards->insert(to).second);
-        return true;
+    const long long averageChunkSize =
+        max / static_cast<long long>(distribution.numberOfChunksInShardWithTag(from, tag));
+
+    const ShardId to = _getLeastLoadedReceiverShardByDataSize(
+        shardStats, distribution, tag, averageChunkSize, *usedShards);
+    if (!to.isValid()) {
+        if (migrations->empty()) {
+            log() << "No available shards to take chunks for zone [" << tag << "]";
+        }
+        return false;
     }
 
-    if (numJumboChunks) {
-        warning() << "Shard: " << from << ", collection: " << distribution.nss().ns()
-                  << " has only jumbo chunks for zone \'" << tag
-                  << "\' and cannot be balanced. Jumbo chunks count: " << numJumboChunks;
+    const long long min = distribution.dataSizeInShardWithTag(to, tag);
+
+    // Do not use a shard if it already has more data than the optimal per-shard data size
+    if (min >= idealDataSizePerShardForTag)
+        return false;
+
+    const long long imbalance = max - idealDataSizePerShardForTag;
+
+    LOG(1) << "collection : " << distribution.nss().ns();
+    LOG(1) << "zone       : " << tag;
+    LOG(1) << "donor      : " << from << " bytes on " << max;
+    LOG(1) << "receiver   : " << to << " bytes on " << min;
+    LOG(1) << "ideal      : " << idealDataSizePerShardForTag;
+    LOG(1) << "chunk size : " << averageChunkSize;
+    LOG(1) << "threshold  : " << imbalanceThreshold;
+
+    // Check whether it is necessary to balance within this zone, measured in the donor's average
+    // chunks
+    if (imbalance < static_cast<long long>(imbalanceThreshold) * averageChunkSize)
+        return false;
+
+    // The chunk must neither take the donor below the ideal nor the receiver above it, otherwise
+    // it could bounce back and forth between the two shards
+    long long maxChunkSize = std::min(imbalance, idealDataSizePerShardForTag - min);
+
+    for (const auto& stat : shardStats) {
+        if (stat.shardId == to && stat.maxSizeMB > 0) {
+            const long long freeSizeMB = static_cast<long long>(stat.maxSizeMB) -
+                static_cast<long long>(stat.currSizeMB);
+            maxChunkSize = std::min(maxChunkSize, freeSizeMB * 1024 * 1024);
+        }
     }
 
-    return false;
+    return moveLargestFittingChunkWithTag(
+        distribution, from, to, tag, maxChunkSize, migrations, usedShards);
 }
 
 ZoneRange::ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone)
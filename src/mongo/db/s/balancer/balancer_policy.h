@@ -115,6 +115,43 @@ public:
      */
     size_t numberOfChunksInShardWithTag(const ShardId& shardId, const std::string& tag) const;
 
+    /**
+     * Records the estimated size in bytes of the data in the specified chunk, as reported by the
+     * shard which owns it. Once sizes have been recorded, the balancer policy weighs shards by the
+     * size of the data in their chunks rather than by their chunk count. Chunks for which no size
+     * is recorded are assumed to hold no data.
+     */
+    void setChunkDataSize(const ChunkType& chunk, long long dataSizeBytes);
+
+    /**
+     * Returns whether per-chunk data sizes have been recorded for this collection.
+     */
+    bool hasDataSizes() const {
+        return !_chunkDataSizes.empty();
+    }
+
+    /**
+     * Returns the estimated size in bytes of the data in the specified chunk.
+     */
+    long long chunkDataSize(const ChunkType& chunk) const;
+
+    /**
+     * Returns the size in bytes of this collection's data in the chunks owned by the specified
+     * shard.
+     */
+    long long dataSizeInShard(const ShardId& shardId) const;
+
+    /**
+     * Returns the size in bytes of the data in the chunks with the given tag, which are owned by
+     * the specified shard.
+     */
+    long long dataSizeInShardWithTag(const ShardId& shardId, const std::string& tag) const;
+
+    /**
+     * Returns the size in bytes of the data in the chunks with the given tag across all shards.
+     */
+    long long totalDataSizeWithTag(const std::string& tag) const;
+
     /**
      * Returns all chunks for the specified shard.
      */
@@ -153,6 +190,10 @@ private:
     // Map of what chunks are owned by each shard
     ShardToChunksMap _shardChunks;
 
+    // Map of chunk min key to the size in bytes of the chunk's data. Empty if balancing by chunk
+    // count.
+    BSONObjIndexedMap<long long> _chunkDataSizes;
+
     // Map of zone max key to the zone description
     BSONObjIndexedMap<ZoneRange> _zoneRanges;
 
@@ -181,6 +222,10 @@ public:
      * any of the shards have chunks, which are sufficiently higher than this number, suggests
      * moving chunks to shards, which are under this number.
      *
+     * If the distribution carries per-chunk data sizes, the optimum and the deviation from it are
+     * measured in bytes instead of chunks, so that shards owning fewer but larger chunks are still
+     * recognized as overloaded.
+     *
      * The shouldAggressivelyBalance parameter causes the threshold for chunk could disparity
      * between shards to be lowered.
      *
@@ -202,6 +247,25 @@ public:
                                                            const DistributionStatus& distribution);
 
 private:
+    /**
+     * Return the shard with the specified tag, which has the least amount of data in chunks with
+     * that tag and can fit a chunk of 'chunkSizeBytes' without exceeding its maximum size. Ties are
+     * broken in favour of the shard with the least total storage used.
+     */
+    static ShardId _getLeastLoadedReceiverShardByDataSize(const ShardStatisticsVector& shardStats,
+                                                          const DistributionStatus& distribution,
+                                                          const std::string& tag,
+                                                          long long chunkSizeBytes,
+                                                          const std::set<ShardId>& excludedShards);
+
+    /**
+     * Return the shard which has the most data in chunks with the specified tag.
+     */
+    static ShardId _getMostOverloadedShardByDataSize(const ShardStatisticsVector& shardStats,
+                                                     const DistributionStatus& distribution,
+                                                     const std::string& chunkTag,
+                                                     const std::set<ShardId>& excludedShards);
+
     /**
      * Return the shard with the specified tag, which has the least number of chunks. If the tag is
      * empty, considers all shards.
@@ -239,6 +303,20 @@ private:
                                    size_t imbalanceThreshold,
                                    std::vector<MigrateInfo>* migrations,
                                    std::set<ShardId>* usedShards);
+
+    /**
+     * Same as _singleZoneBalance, except that the shards are compared by the size of their data for
+     * the zone against 'idealDataSizePerShardForTag'. A migration is only suggested if the donor
+     * exceeds the ideal by at least 'imbalanceThreshold' of its average chunks, and it moves the
+     * largest non-empty chunk, which takes neither shard past the ideal.
+     */
+    static bool _singleZoneBalanceByDataSize(const ShardStatisticsVector& shardStats,
+                                             const DistributionStatus& distribution,
+                                             const std::string& tag,
+                                             long long idealDataSizePerShardForTag,
+                                             size_t imbalanceThreshold,
+                                             std::vector<MigrateInfo>* migrations,
+                                             std::set<ShardId>* usedShards);
 };
 
 }  // namespace mongo
@@ -110,6 +110,20 @@ std::pair<ShardStatisticsVector, ShardToChunksMap> generateCluster(
     return std::make_pair(std::move(shardStats), std::move(chunkMap));
 }
 
+/**
+ * Records the specified data sizes for the chunks of the given shard, in the order of the chunks.
+ */
+void setChunkDataSizes(DistributionStatus* distribution,
+                       const ShardId& shardId,
+                       const vector<long long>& dataSizes) {
+    const auto& chunks = distribution->getChunks(shardId);
+    ASSERT_EQ(chunks.size(), dataSizes.size());
+
+    for (size_t i = 0; i < chunks.size(); i++) {
+        distribution->setChunkDataSize(chunks[i], dataSizes[i]);
+    }
+}
+
 std::vector<MigrateInfo> balanceChunks(const ShardStatisticsVector& shardStats,
                                        const DistributionStatus& distribution,
                                        bool shouldAggressivelyBalance) {
@@ -609,6 +623,122 @@ TEST(BalancerPolicy, BalancerHandlesNoShardsWithTag) {
     ASSERT(balanceChunks(cluster.first, distribution, false).empty());
 }
 
+TEST(BalancerPolicy, BalanceByDataSizeMovesFromShardWithLargerChunks) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId2, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 4}});
+
+    // The chunk counts are even, so nothing should move unless the data sizes are known
+    ASSERT(balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), true)
+               .empty());
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    setChunkDataSizes(&distribution, kShardId0, {1000, 1000, 1000, 1000});
+    setChunkDataSizes(&distribution, kShardId1, {100, 100, 100, 100});
+    setChunkDataSizes(&distribution, kShardId2, {100, 100, 100, 100});
+    ASSERT(distribution.hasDataSizes());
+    ASSERT_EQ(4000, distribution.dataSizeInShard(kShardId0));
+    ASSERT_EQ(4800, distribution.totalDataSizeWithTag(""));
+
+    // Both receivers hold the same amount of the collection's data, so the one with the least
+    // storage used overall is preferred
+    const auto migrations(balanceChunks(cluster.first, distribution, false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId2, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][0].getMin(), migrations[0].minKey);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][0].getMax(), migrations[0].maxKey);
+}
+
+TEST(BalancerPolicy, BalanceByDataSizeNoMigrationWithinChunkSize) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 3}});
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    setChunkDataSizes(&distribution, kShardId0, {300, 300, 300});
+    setChunkDataSizes(&distribution, kShardId1, {200, 200, 200});
+
+    // Moving any 300 byte chunk off of shard0 would leave shard1 with more data than shard0
+    ASSERT(balanceChunks(cluster.first, distribution, true).empty());
+}
+
+TEST(BalancerPolicy, BalanceByDataSizeMovesLargestNonEmptyChunkWhichFits) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 4}});
+
+    // The ideal is 3900 bytes per shard, so the 5000 byte chunk would overshoot it and the empty
+    // chunk would not change anything
+    DistributionStatus distribution(kNamespace, cluster.second);
+    setChunkDataSizes(&distribution, kShardId0, {0, 5000, 1500, 900});
+    setChunkDataSizes(&distribution, kShardId1, {100, 100, 100, 100});
+
+    const auto migrations(balanceChunks(cluster.first, distribution, true));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][2].getMin(), migrations[0].minKey);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][2].getMax(), migrations[0].maxKey);
+}
+
+TEST(BalancerPolicy, BalanceByDataSizeNoMigrationOfEmptyOrOversizedChunks) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 1}});
+
+    // All of the donor's data is in a chunk, which would take the receiver past the ideal
+    DistributionStatus distribution(kNamespace, cluster.second);
+    setChunkDataSizes(&distribution, kShardId0, {0, 3000, 0});
+    setChunkDataSizes(&distribution, kShardId1, {0});
+
+    ASSERT(balanceChunks(cluster.first, distribution, true).empty());
+}
+
+TEST(BalancerPolicy, BalanceByDataSizeReceiverHasLeastDataForZone) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, {"a"}, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, {"a"}, emptyShardVersion), 3},
+         {ShardStatistics(kShardId2, kNoMaxSize, 0, false, {"a"}, emptyShardVersion), 3}});
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    ASSERT_OK(distribution.addRangeToZone(ZoneRange(kMinBSONKey, BSON("x" << 2), "a")));
+    ASSERT_OK(distribution.addRangeToZone(ZoneRange(BSON("x" << 3), BSON("x" << 4), "a")));
+    ASSERT_OK(distribution.addRangeToZone(ZoneRange(BSON("x" << 6), BSON("x" << 8), "a")));
+
+    // Shard1 holds the most data overall, but the least in zone 'a'
+    setChunkDataSizes(&distribution, kShardId0, {4000, 1000, 100});
+    setChunkDataSizes(&distribution, kShardId1, {100, 5000, 5000});
+    setChunkDataSizes(&distribution, kShardId2, {500, 500, 100});
+    ASSERT_EQ(100, distribution.dataSizeInShardWithTag(kShardId1, "a"));
+    ASSERT_EQ(1000, distribution.dataSizeInShardWithTag(kShardId2, "a"));
+
+    const auto migrations(balanceChunks(cluster.first, distribution, true));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][1].getMin(), migrations[0].minKey);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][1].getMax(), migrations[0].maxKey);
+}
+
+TEST(BalancerPolicy, BalanceByDataSizeSkipsReceiverWithoutSpaceForChunk) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 256, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, 100, 50, false, emptyTagSet, emptyShardVersion), 0},
+         {ShardStatistics(kShardId2, kNoMaxSize, 500, false, emptyTagSet, emptyShardVersion), 0}});
+
+    const long long kChunkSize = 64 * 1024 * 1024;
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    setChunkDataSizes(&distribution, kShardId0, {kChunkSize, kChunkSize, kChunkSize, kChunkSize});
+
+    const auto migrations(balanceChunks(cluster.first, distribution, false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId2, migrations[0].to);
+}
+
 TEST(DistributionStatus, AddTagRangeOverlap) {
     DistributionStatus d(kNamespace, ShardToChunksMap{});
 
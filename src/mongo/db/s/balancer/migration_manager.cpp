@@ -32,6 +32,8 @@
 
 #include "mongo/db/s/balancer/migration_manager.h"
 
+#include <algorithm>
+#include <list>
 #include <memory>
 
 #include "mongo/bson/simple_bsonobj_comparator.h"
@@ -42,8 +44,10 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/balancer/scoped_migration_request.h"
 #include "mongo/db/s/balancer/type_migration.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/s/catalog/type_changelog.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
@@ -62,8 +66,23 @@ using str::stream;
 
 namespace {
 
+// Upper bound on the number of migrations, which the balancer runs at the same time across the
+// cluster. Zero means that the only limit is that of each shard taking part in one migration.
+MONGO_EXPORT_SERVER_PARAMETER(balancerMaxConcurrentMigrations, int, 0);
+
+// Limits the rate at which each shard donates or receives chunk data during balancing, by delaying
+// the start of the shard's next migration until its last one would have completed at this rate.
+// Zero means no limit.
+MONGO_EXPORT_SERVER_PARAMETER(balancerMaxMigrationMBPerSecPerShard, int, 0);
+
 const char kChunkTooBig[] = "chunkTooBig";  // TODO: delete in 3.8
 
+const NamespaceString kChangeLogNamespace("config", "changelog");
+
+// Number of the most recent moveChunk.to changelog entries used to estimate the amount of data a
+// migration moves and how long it takes
+const long long kMigrationStatsSampleSize = 100;
+
 const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 WriteConcernOptions::SyncMode::UNSET,
                                                 Seconds(15));
@@ -101,8 +120,40 @@ bool isErrorDueToConfigStepdown(Status status, bool isStopping) {
             status == ErrorCodes::InterruptedDueToReplStateChange);
 }
 
+/**
+ * Tracks a migration scheduled by executeMigrationsForAutoBalance until its outcome is processed.
+ */
+struct AutoBalanceMigration {
+    AutoBalanceMigration(MigrateInfo a_migrateInfo,
+                         ScopedMigrationRequest a_scopedMigrationRequest,
+                         long long a_expectedBytes)
+        : migrateInfo(std::move(a_migrateInfo)),
+          scopedMigrationRequest(std::move(a_scopedMigrationRequest)),
+          expectedBytes(a_expectedBytes) {}
+
+    MigrateInfo migrateInfo;
+
+    // Keeps the config.migrations document for the duration of the migration
+    ScopedMigrationRequest scopedMigrationRequest;
+
+    // Signaled with the moveChunk response when the migration completes
+    shared_ptr<Notification<RemoteCommandResponse>> notification;
+
+    // When the migration was scheduled and how much data it is expected to move
+    Date_t startTime{Date_t::now()};
+    long long expectedBytes;
+};
+
 }  // namespace
 
+long long MigrationManager::ShardMigrationStats::avgBytes() const {
+    return numMigrations ? totalBytes / numMigrations : 0;
+}
+
+Milliseconds MigrationManager::ShardMigrationStats::avgTime() const {
+    return numMigrations ? totalTime / numMigrations : Milliseconds(0);
+}
+
 MigrationManager::MigrationManager(ServiceContext* serviceContext)
     : _serviceContext(serviceContext) {}
 
@@ -117,14 +168,81 @@ MigrationStatuses MigrationManager::executeMigrationsForAutoBalance(
     uint64_t maxChunkSizeBytes,
     const MigrationSecondaryThrottleOptions& secondaryThrottle,
     bool waitForDelete) {
+    return executeMigrationsForAutoBalance(
+        opCtx, migrateInfos, maxChunkSizeBytes, secondaryThrottle, waitForDelete, nullptr);
+}
+
+MigrationStatuses MigrationManager::executeMigrationsForAutoBalance(
+    OperationContext* opCtx,
+    const vector<MigrateInfo>& migrateInfos,
+    uint64_t maxChunkSizeBytes,
+    const MigrationSecondaryThrottleOptions& secondaryThrottle,
+    bool waitForDelete,
+    const SelectMigrationsFn& selectMoreMigrations) {
+    const size_t maxConcurrentMigrations =
+        static_cast<size_t>(std::max(balancerMaxConcurrentMigrations.load(), 0));
+    const long long maxBytesPerSecPerShard =
+        static_cast<long long>(std::max(balancerMaxMigrationMBPerSecPerShard.load(), 0)) * 1024 *
+        1024;
+
+    const auto recentStats = _loadRecentMigrationStats(opCtx);
+
+    // Combines the recent statistics of the donor and recipient shards of a migration
+    auto getExpectedStats = [&recentStats](const MigrateInfo& migrateInfo) {
+        ShardMigrationStats expectedStats;
+        for (const auto& shardId : {migrateInfo.from, migrateInfo.to}) {
+            auto it = recentStats.find(shardId);
+            if (it == recentStats.end())
+                continue;
+
+            expectedStats.numMigrations += it->second.numMigrations;
+            expectedStats.totalBytes += it->second.totalBytes;
+            expectedStats.totalTime += it->second.totalTime;
+        }
+        return expectedStats;
+    };
+
+    auto isStopping = [this] {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        return _state != State::kEnabled && _state != State::kRecovering;
+    };
 
     MigrationStatuses migrationStatuses;
 
-    {
-        std::map<MigrationIdentifier, ScopedMigrationRequest> scopedMigrationRequests;
-        vector<std::pair<shared_ptr<Notification<RemoteCommandResponse>>, MigrateInfo>> responses;
+    std::list<MigrateInfo> pendingMigrations(migrateInfos.begin(), migrateInfos.end());
+    std::list<AutoBalanceMigration> activeMigrations;
+
+    // Shards which take part in an active migration and the earliest time each shard may start its
+    // next migration without exceeding the bandwidth limit
+    std::set<ShardId> busyShards;
+    std::map<ShardId, Date_t> shardAvailableTime;
+
+    while (true) {
+        const Date_t now = Date_t::now();
+        const bool stopping = isStopping();
+        Date_t nextAvailableTime = Date_t::max();
+
+        for (auto it = pendingMigrations.begin(); it != pendingMigrations.end();) {
+            if (maxConcurrentMigrations && activeMigrations.size() >= maxConcurrentMigrations)
+                break;
+
+            const MigrateInfo& migrateInfo = *it;
+
+            if (busyShards.count(migrateInfo.from) || busyShards.count(migrateInfo.to)) {
+                ++it;
+                continue;
+            }
+
+            if (!stopping) {
+                const Date_t availableTime = std::max(shardAvailableTime[migrateInfo.from],
+                                                      shardAvailableTime[migrateInfo.to]);
+                if (availableTime > now) {
+                    nextAvailableTime = std::min(nextAvailableTime, availableTime);
+                    ++it;
+                    continue;
+                }
+            }
 
-        for (const auto& migrateInfo : migrateInfos) {
             // Write a document to the config.migrations collection, in case this migration must be
             // recovered by the Balancer. Fail if the chunk is already moving.
             auto statusWithScopedMigrationRequest =
@@ -132,32 +250,110 @@ MigrationStatuses MigrationManager::executeMigrationsForAutoBalance(
             if (!statusWithScopedMigrationRequest.isOK()) {
                 migrationStatuses.emplace(migrateInfo.getName(),
                                           std::move(statusWithScopedMigrationRequest.getStatus()));
+                it = pendingMigrations.erase(it);
                 continue;
             }
-            scopedMigrationRequests.emplace(migrateInfo.getName(),
-                                            std::move(statusWithScopedMigrationRequest.getValue()));
 
-            responses.emplace_back(
-                _schedule(opCtx, migrateInfo, maxChunkSizeBytes, secondaryThrottle, waitForDelete),
-                migrateInfo);
+            const auto expectedStats = getExpectedStats(migrateInfo);
+            if (expectedStats.numMigrations) {
+                LOG(1) << "Starting migration " << redact(migrateInfo.toString())
+                       << ", expected to move " << expectedStats.avgBytes() << " bytes in "
+                       << expectedStats.avgTime() << " based on " << expectedStats.numMigrations
+                       << " recent migrations";
+            }
+
+            activeMigrations.emplace_back(migrateInfo,
+                                          std::move(statusWithScopedMigrationRequest.getValue()),
+                                          expectedStats.numMigrations
+                                              ? expectedStats.avgBytes()
+                                              : static_cast<long long>(maxChunkSizeBytes));
+            busyShards.insert(migrateInfo.from);
+            busyShards.insert(migrateInfo.to);
+
+            activeMigrations.back().notification =
+                _schedule(opCtx, migrateInfo, maxChunkSizeBytes, secondaryThrottle, waitForDelete);
+
+            it = pendingMigrations.erase(it);
         }
 
-        // Wait for all the scheduled migrations to complete.
-        for (auto& response : responses) {
-            auto notification = std::move(response.first);
-            auto migrateInfo = std::move(response.second);
+        if (activeMigrations.empty() && pendingMigrations.empty())
+            break;
+
+        // Wait for any of the active migrations to complete or for a pending one to be allowed to
+        // start
+        {
+            stdx::unique_lock<stdx::mutex> lock(_mutex);
+
+            auto canMakeProgress = [&] {
+                if (_state != State::kEnabled && _state != State::kRecovering && !stopping)
+                    return true;
+
+                return std::any_of(activeMigrations.begin(),
+                                   activeMigrations.end(),
+                                   [](AutoBalanceMigration& migration) {
+                                       return static_cast<bool>(*migration.notification);
+                                   });
+            };
+
+            if (nextAvailableTime == Date_t::max()) {
+                _condVar.wait(lock, canMakeProgress);
+            } else {
+                _condVar.wait_until(lock, nextAvailableTime.toSystemTimePoint(), canMakeProgress);
+            }
+        }
+
+        bool anyCompleted = false;
+
+        for (auto it = activeMigrations.begin(); it != activeMigrations.end();) {
+            if (!*it->notification) {
+                ++it;
+                continue;
+            }
 
-            const auto& remoteCommandResponse = notification->get();
+            const MigrateInfo& migrateInfo = it->migrateInfo;
 
-            auto it = scopedMigrationRequests.find(migrateInfo.getName());
-            invariant(it != scopedMigrationRequests.end());
+            const auto& remoteCommandResponse = it->notification->get();
             Status commandStatus =
-                _processRemoteCommandResponse(remoteCommandResponse, &it->second);
+                _processRemoteCommandResponse(remoteCommandResponse, &it->scopedMigrationRequest);
             migrationStatuses.emplace(migrateInfo.getName(), std::move(commandStatus));
+
+            busyShards.erase(migrateInfo.from);
+            busyShards.erase(migrateInfo.to);
+
+            if (maxBytesPerSecPerShard) {
+                const Date_t availableTime = it->startTime +
+                    Milliseconds(it->expectedBytes * 1000 / maxBytesPerSecPerShard);
+                for (const auto& shardId : {migrateInfo.from, migrateInfo.to}) {
+                    auto& shardTime = shardAvailableTime[shardId];
+                    shardTime = std::max(shardTime, availableTime);
+                }
+            }
+
+            it = activeMigrations.erase(it);
+            anyCompleted = true;
+        }
+
+        if (!anyCompleted || !selectMoreMigrations || isStopping())
+            continue;
+
+        // Shards, which are already waiting to run a migration, are not available either
+        std::set<ShardId> unavailableShards(busyShards);
+        for (const auto& migrateInfo : pendingMigrations) {
+            unavailableShards.insert(migrateInfo.from);
+            unavailableShards.insert(migrateInfo.to);
+        }
+
+        for (auto& migrateInfo : selectMoreMigrations(unavailableShards)) {
+            if (migrationStatuses.count(migrateInfo.getName()))
+                continue;
+
+            invariant(!unavailableShards.count(migrateInfo.from));
+            invariant(!unavailableShards.count(migrateInfo.to));
+            pendingMigrations.push_back(std::move(migrateInfo));
         }
     }
 
-    invariant(migrationStatuses.size() == migrateInfos.size());
+    invariant(migrationStatuses.size() >= migrateInfos.size());
 
     return migrationStatuses;
 }
@@ -560,6 +756,63 @@ void MigrationManager::_complete(WithLock lock,
     }
 
     notificationToSignal->set(remoteCommandResponse);
+
+    // Wake up executeMigrationsForAutoBalance, which may be waiting for any migration to complete
+    _condVar.notify_all();
+}
+
+MigrationManager::ShardMigrationStatsMap MigrationManager::_loadRecentMigrationStats(
+    OperationContext* opCtx) {
+    ShardMigrationStatsMap stats;
+
+    auto statusWithChangeLogQueryResponse =
+        Grid::get(opCtx)->shardRegistry()->getConfigShard()->exhaustiveFindOnConfig(
+            opCtx,
+            ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+            repl::ReadConcernLevel::kLocalReadConcern,
+            kChangeLogNamespace,
+            BSON(ChangeLogType::what("moveChunk.to")
+                 << ChangeLogType::details.name() + ".note"
+                 << "success"),
+            // The changelog is capped and has no index on the time, so a sort on it would read and
+            // sort the whole collection. Its insertion order is close enough to the time order.
+            BSON("$natural" << -1),
+            kMigrationStatsSampleSize);
+    if (!statusWithChangeLogQueryResponse.isOK()) {
+        LOG(1) << "Unable to read recent migration statistics from the changelog"
+               << causedBy(redact(statusWithChangeLogQueryResponse.getStatus()));
+        return stats;
+    }
+
+    for (const BSONObj& entry : statusWithChangeLogQueryResponse.getValue().docs) {
+        const BSONObj details = entry[ChangeLogType::details.name()].Obj();
+
+        const BSONElement clonedBytesElem = details["clonedBytes"];
+        if (!clonedBytesElem.isNumber())
+            continue;
+
+        // MoveTimingHelper records the time taken by each step of the migration as a separate
+        // "step N of M" field
+        Milliseconds totalTime{0};
+        for (const auto& elem : details) {
+            if (elem.isNumber() && str::startsWith(elem.fieldName(), "step ")) {
+                totalTime += Milliseconds(elem.safeNumberLong());
+            }
+        }
+
+        for (const auto& shardField : {"from", "to"}) {
+            const BSONElement shardElem = details[shardField];
+            if (shardElem.type() != String)
+                continue;
+
+            auto& shardStats = stats[ShardId(shardElem.String())];
+            shardStats.numMigrations++;
+            shardStats.totalBytes += clonedBytesElem.safeNumberLong();
+            shardStats.totalTime += totalTime;
+        }
+    }
+
+    return stats;
 }
 
 void MigrationManager::_checkDrained(WithLock) {
@@ -30,6 +30,7 @@
 
 #include <list>
 #include <map>
+#include <set>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
@@ -41,10 +42,12 @@
 #include "mongo/s/catalog/dist_lock_manager.h"
 #include "mongo/s/request_types/migration_secondary_throttle_options.h"
 #include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/notification.h"
 #include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -69,16 +72,38 @@ public:
     MigrationManager(ServiceContext* serviceContext);
     ~MigrationManager();
 
+    /**
+     * Invoked by executeMigrationsForAutoBalance whenever a migration completes in order to obtain
+     * more migrations to run on the shards, which have become free. Receives the set of shards,
+     * which are still taking part in a migration, and must return migrations which do not involve
+     * any of them. Returning an empty vector means there is nothing more to do.
+     */
+    using SelectMigrationsFn =
+        stdx::function<std::vector<MigrateInfo>(const std::set<ShardId>& busyShards)>;
+
     /**
      * A blocking method that attempts to schedule all the migrations specified in
      * "candidateMigrations" and wait for them to complete. Takes the distributed lock for each
      * collection with a chunk being migrated.
      *
-     * If any of the migrations, which were scheduled in parallel fails with a LockBusy error
-     * reported from the shard, retries it serially without the distributed lock.
+     * Since a shard can only take part in one migration at a time, a migration is not started
+     * until any earlier migration involving its donor or recipient shard has completed. If
+     * "selectMoreMigrations" is set, it is called every time a migration completes and the
+     * migrations it returns are scheduled as well, so shards do not sit idle waiting for the
+     * slowest migration of the batch. The number of concurrent migrations and the rate at which
+     * each shard moves data are limited by the balancerMaxConcurrentMigrations and
+     * balancerMaxMigrationMBPerSecPerShard server parameters.
      *
      * Returns a map of migration Status objects to indicate the success/failure of each migration.
      */
+    MigrationStatuses executeMigrationsForAutoBalance(
+        OperationContext* opCtx,
+        const std::vector<MigrateInfo>& migrateInfos,
+        uint64_t maxChunkSizeBytes,
+        const MigrationSecondaryThrottleOptions& secondaryThrottle,
+        bool waitForDelete,
+        const SelectMigrationsFn& selectMoreMigrations);
+
     MigrationStatuses executeMigrationsForAutoBalance(
         OperationContext* opCtx,
         const std::vector<MigrateInfo>& migrateInfos,
@@ -175,6 +200,28 @@ private:
 
     using CollectionMigrationsStateMap = stdx::unordered_map<NamespaceString, MigrationsList>;
 
+    /**
+     * Throughput of the recent migrations in which a single shard took part, either as a donor or
+     * as a recipient, as recorded by the recipient shards in the moveChunk.to changelog entries.
+     */
+    struct ShardMigrationStats {
+        /**
+         * Returns the average number of bytes cloned per migration.
+         */
+        long long avgBytes() const;
+
+        /**
+         * Returns the average time it took to complete a migration.
+         */
+        Milliseconds avgTime() const;
+
+        int numMigrations{0};
+        long long totalBytes{0};
+        Milliseconds totalTime{0};
+    };
+
+    using ShardMigrationStatsMap = std::map<ShardId, ShardMigrationStats>;
+
     /**
      * Optionally takes the collection distributed lock and schedules a chunk migration with the
      * specified parameters. May block for distributed lock acquisition. If dist lock acquisition is
@@ -188,6 +235,13 @@ private:
         const MigrationSecondaryThrottleOptions& secondaryThrottle,
         bool waitForDelete);
 
+    /**
+     * Reads the most recent successful moveChunk.to entries from the config.changelog collection
+     * and aggregates the amount of data cloned and the time taken per shard. Returns an empty map
+     * if the changelog cannot be read.
+     */
+    static ShardMigrationStatsMap _loadRecentMigrationStats(OperationContext* opCtx);
+
     /**
      * Acquires the collection distributed lock for the specified namespace and if it succeeds,
      * schedules the migration.
@@ -398,6 +398,83 @@ TEST_F(MigrationManagerTest, TwoCollectionsTwoMigrationsEach) {
     future.timed_get(kFutureTimeout);
 }
 
+// As soon as a migration completes, the MigrationManager should ask for and start more migrations
+// for the shards which have become free, without waiting for the other migrations to finish.
+TEST_F(MigrationManagerTest, SchedulesMoreMigrationsAsShardsBecomeFree) {
+    // Set up two shards in the metadata.
+    ASSERT_OK(catalogClient()->insertConfigDocument(
+        operationContext(), ShardType::ConfigNS, kShard0, kMajorityWriteConcern));
+    ASSERT_OK(catalogClient()->insertConfigDocument(
+        operationContext(), ShardType::ConfigNS, kShard2, kMajorityWriteConcern));
+
+    // Set up the database and collection as sharded in the metadata.
+    const std::string dbName = "foo";
+    const NamespaceString collName(dbName, "bar");
+    ChunkVersion version(2, 0, OID::gen());
+
+    setUpDatabase(dbName, kShardId0);
+    setUpCollection(collName, version);
+
+    // Set up three chunks in the metadata, two of which are on the same shard.
+    ChunkType chunk1 =
+        setUpChunk(collName, kKeyPattern.globalMin(), BSON(kPattern << 49), kShardId0, version);
+    version.incMinor();
+    ChunkType chunk2 =
+        setUpChunk(collName, BSON(kPattern << 49), BSON(kPattern << 99), kShardId2, version);
+    version.incMinor();
+    ChunkType chunk3 =
+        setUpChunk(collName, BSON(kPattern << 99), kKeyPattern.globalMax(), kShardId0, version);
+
+    // Initially request that the first two chunks get migrated. The third chunk is only handed
+    // out once its donor shard is no longer busy.
+    const std::vector<MigrateInfo> migrationRequests{{kShardId1, chunk1}, {kShardId3, chunk2}};
+    const MigrateInfo moreMigration(kShardId1, chunk3);
+
+    auto future = launchAsync([this, chunk3, migrationRequests, moreMigration] {
+        ON_BLOCK_EXIT([&] { Client::destroy(); });
+        Client::initThreadIfNotAlready("Test");
+        auto opCtx = cc().makeOperationContext();
+
+        // Scheduling the moveChunk commands requires finding a host to which to send the command.
+        // Set up dummy hosts for the source shards.
+        shardTargeterMock(opCtx.get(), kShardId0)->setFindHostReturnValue(kShardHost0);
+        shardTargeterMock(opCtx.get(), kShardId2)->setFindHostReturnValue(kShardHost2);
+
+        int numSelections = 0;
+
+        MigrationStatuses migrationStatuses = _migrationManager->executeMigrationsForAutoBalance(
+            opCtx.get(),
+            migrationRequests,
+            0,
+            kDefaultSecondaryThrottle,
+            false,
+            [&](const std::set<ShardId>& busyShards) {
+                std::vector<MigrateInfo> moreMigrations;
+                if (numSelections++ == 0) {
+                    ASSERT(!busyShards.count(kShardId0));
+                    ASSERT(!busyShards.count(kShardId1));
+                    moreMigrations.push_back(moreMigration);
+                }
+                return moreMigrations;
+            });
+
+        ASSERT_GTE(numSelections, 1);
+        ASSERT_EQ(3U, migrationStatuses.size());
+        for (const auto& migrateInfo : migrationRequests) {
+            ASSERT_OK(migrationStatuses.at(migrateInfo.getName()));
+        }
+        ASSERT_OK(migrationStatuses.at(chunk3.getName()));
+    });
+
+    // Expect three moveChunk commands, the last one only after the first one has completed.
+    expectMoveChunkCommand(chunk1, kShardId1, Status::OK());
+    expectMoveChunkCommand(chunk2, kShardId3, Status::OK());
+    expectMoveChunkCommand(chunk3, kShardId1, Status::OK());
+
+    // Run the MigrationManager code.
+    future.timed_get(kFutureTimeout);
+}
+
 // The MigrationManager should fail the migration if a host is not found for the source shard.
 // Scheduling a moveChunk command requires finding a host to which to send the command.
 TEST_F(MigrationManagerTest, SourceShardNotFound) {
@@ -49,13 +49,19 @@
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/s/range_deleter_throttle.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/s/sharding_statistics.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/top.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -63,6 +69,9 @@ namespace {
 using Deletion = CollectionRangeDeleter::Deletion;
 using DeleteNotification = CollectionRangeDeleter::DeleteNotification;
 
+// Number of documents the range deleter removes in a single storage transaction
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterDocsPerWriteUnit, int, 32);
+
 const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 WriteConcernOptions::SyncMode::UNSET,
                                                 Seconds(60));
@@ -80,6 +89,48 @@ boost::optional<DeleteNotification> checkOverlap(std::list<Deletion> const& dele
     return boost::none;
 }
 
+/**
+ * Records the statistics of a deletion pass and returns when the next pass should start, pausing
+ * if the node shows signs of falling behind.
+ */
+Date_t throttleNextPass(OperationContext* opCtx,
+                        NamespaceString const& nss,
+                        RangeDeleterThrottle::PassStats passStats) {
+    BSONObjBuilder latencyStats;
+    Top::get(opCtx->getServiceContext()).appendGlobalLatencyStats(false, &latencyStats);
+    const auto writeLatencyStats = latencyStats.done()["writes"].Obj();
+    passStats.foregroundWriteOps = writeLatencyStats["ops"].safeNumberLong();
+    passStats.foregroundWriteLatencyMicros = writeLatencyStats["latency"].safeNumberLong();
+    passStats.storageCacheUnderPressure =
+        opCtx->getServiceContext()->getGlobalStorageEngine()->isCacheUnderPressure(opCtx);
+
+    const auto decision = RangeDeleterThrottle::get(opCtx).recordPass(passStats);
+
+    auto& stats = ShardingStatistics::get(opCtx);
+    stats.countDocsDeletedByRangeDeleter.addAndFetch(passStats.docsDeleted);
+    stats.totalRangeDeleterDeleteTimeMillis.addAndFetch(
+        durationCount<Milliseconds>(passStats.deleteTime));
+
+    switch (decision.reason) {
+        case RangeDeleterThrottle::PauseReason::kNone:
+            return Date_t{};
+        case RangeDeleterThrottle::PauseReason::kReplicationLag:
+            stats.countRangeDeleterPausesForReplicationLag.addAndFetch(1);
+            break;
+        case RangeDeleterThrottle::PauseReason::kStoragePressure:
+            stats.countRangeDeleterPausesForStoragePressure.addAndFetch(1);
+            break;
+        case RangeDeleterThrottle::PauseReason::kForegroundLatency:
+            stats.countRangeDeleterPausesForForegroundLatency.addAndFetch(1);
+            break;
+    }
+    stats.totalRangeDeleterPauseTimeMillis.addAndFetch(durationCount<Milliseconds>(decision.delay));
+
+    LOG(1) << "Pausing range deletions in " << nss.ns() << " for " << decision.delay
+           << " because of " << RangeDeleterThrottle::reasonToString(decision.reason);
+    return Date_t::now() + decision.delay;
+}
+
 }  // namespace
 
 CollectionRangeDeleter::CollectionRangeDeleter() = default;
@@ -100,6 +151,7 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
 
     auto range = boost::optional<ChunkRange>(boost::none);
     auto notification = DeleteNotification();
+    RangeDeleterThrottle::PassStats passStats;
 
     {
         AutoGetCollection autoColl(opCtx, nss, MODE_IX);
@@ -196,7 +248,9 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
 
         try {
             const auto keyPattern = scopedCollectionMetadata->getKeyPattern();
+            Timer deleteTimer;
             wrote = self->_doDeletion(opCtx, collection, keyPattern, *range, maxToDelete);
+            passStats.deleteTime = Microseconds(deleteTimer.micros());
         } catch (const DBException& e) {
             wrote = e.toStatus();
             warning() << e.what();
@@ -227,6 +281,7 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     const auto clientOpTime = repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp();
 
     // Wait for replication outside the lock
+    Timer replicationTimer;
     const auto status = [&] {
         try {
             WriteConcernResult unusedWCResult;
@@ -261,7 +316,10 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     }
 
     notification.abandon();
-    return Date_t{};
+
+    passStats.docsDeleted = wrote.getValue();
+    passStats.replicationWaitTime = Milliseconds(replicationTimer.millis());
+    return throttleNextPass(opCtx, nss, passStats);
 }
 
 StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
@@ -310,40 +368,65 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
         saver.emplace("moveChunk", nss.ns(), "cleaning");
     }
 
+    const int docsPerWriteUnit = std::max(rangeDeleterDocsPerWriteUnit.load(), 1);
+
     int numDeleted = 0;
-    do {
-        auto halfOpen = BoundInclusion::kIncludeStartKeyOnly;
-        auto manual = PlanExecutor::YIELD_MANUAL;
-        auto forward = InternalPlanner::FORWARD;
-        auto fetch = InternalPlanner::IXSCAN_FETCH;
-
-        auto exec = InternalPlanner::indexScan(
-            opCtx, collection, descriptor, min, max, halfOpen, manual, forward, fetch);
-
-        RecordId rloc;
-        BSONObj obj;
-        PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
-        if (state == PlanExecutor::IS_EOF) {
-            break;
-        }
-        if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
-            warning() << PlanExecutor::statestr(state) << " - cursor error while trying to delete "
-                      << redact(min) << " to " << redact(max) << " in " << nss << ": "
-                      << redact(WorkingSetCommon::toStatusString(obj))
-                      << ", stats: " << Explain::getWinningPlanStats(exec.get());
-            break;
-        }
-        invariant(PlanExecutor::ADVANCED == state);
+    bool reachedEnd = false;
+    while (!reachedEnd && numDeleted < maxToDelete) {
+        const int maxInWriteUnit = std::min(maxToDelete - numDeleted, docsPerWriteUnit);
+        int deletedInWriteUnit = 0;
 
         writeConflictRetry(opCtx, "delete range", nss.ns(), [&] {
+            deletedInWriteUnit = 0;
+            reachedEnd = false;
+
             WriteUnitOfWork wuow(opCtx);
-            if (saver) {
-                uassertStatusOK(saver->goingToDelete(obj));
+
+            // A single scan serves the whole unit of work. It is started afresh on each attempt,
+            // so that it finds again the documents whose deletion a write conflict rolled back.
+            auto exec = InternalPlanner::indexScan(opCtx,
+                                                   collection,
+                                                   descriptor,
+                                                   min,
+                                                   max,
+                                                   BoundInclusion::kIncludeStartKeyOnly,
+                                                   PlanExecutor::YIELD_MANUAL,
+                                                   InternalPlanner::FORWARD,
+                                                   InternalPlanner::IXSCAN_FETCH);
+
+            while (deletedInWriteUnit < maxInWriteUnit) {
+                RecordId rloc;
+                BSONObj obj;
+                PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
+                if (state == PlanExecutor::IS_EOF) {
+                    reachedEnd = true;
+                    break;
+                }
+                if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
+                    warning() << PlanExecutor::statestr(state)
+                              << " - cursor error while trying to delete " << redact(min) << " to "
+                              << redact(max) << " in " << nss << ": "
+                              << redact(WorkingSetCommon::toStatusString(obj))
+                              << ", stats: " << Explain::getWinningPlanStats(exec.get());
+                    reachedEnd = true;
+                    break;
+                }
+                invariant(PlanExecutor::ADVANCED == state);
+
+                if (saver) {
+                    uassertStatusOK(saver->goingToDelete(obj));
+                }
+
+                exec->saveState();
+                collection->deleteDocument(opCtx, kUninitializedStmtId, rloc, nullptr, true);
+                uassertStatusOK(exec->restoreState());
+                ++deletedInWriteUnit;
             }
-            collection->deleteDocument(opCtx, kUninitializedStmtId, rloc, nullptr, true);
             wuow.commit();
         });
-    } while (++numDeleted < maxToDelete);
+
+        numDeleted += deletedInWriteUnit;
+    }
 
     return numDeleted;
 }
@@ -0,0 +1,272 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/catalog/catalog_raii.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/keypattern.h"
+#include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/range_arithmetic.h"
+#include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/s/sharding_state.h"
+#include "mongo/s/shard_key_pattern.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+// Number of documents drawn at random to estimate how the collection's data is spread over the
+// chunks of the shard: kSampledDocumentsPerChunk for each chunk, within the bounds below.
+// Collections with at most that many documents are read in full instead.
+const long long kSampledDocumentsPerChunk = 10;
+const long long kMinSampledDocuments = 1000;
+const long long kMaxSampledDocuments = 100000;
+
+/**
+ * Estimates the size of the data in the chunk [min, max) from the number of keys it has in the
+ * shard key index 'idx' and the average size of the collection's documents.
+ */
+long long estimateChunkSizeFromIndex(OperationContext* opCtx,
+                                     Collection* collection,
+                                     IndexDescriptor* idx,
+                                     const BSONObj& min,
+                                     const BSONObj& max,
+                                     long long avgObjSize) {
+    KeyPattern kp(idx->keyPattern());
+    auto exec = InternalPlanner::indexScan(opCtx,
+                                           collection,
+                                           idx,
+                                           Helpers::toKeyFormat(kp.extendRangeBound(min, false)),
+                                           Helpers::toKeyFormat(kp.extendRangeBound(max, false)),
+                                           BoundInclusion::kIncludeStartKeyOnly,
+                                           PlanExecutor::NO_YIELD);
+
+    long long numKeys = 0;
+    BSONObj obj;
+    PlanExecutor::ExecState state;
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
+        ++numKeys;
+    }
+
+    uassert(ErrorCodes::OperationFailed,
+            "Executor error while estimating the size of a chunk: " +
+                WorkingSetCommon::toStatusString(obj),
+            PlanExecutor::DEAD != state && PlanExecutor::FAILURE != state);
+
+    return numKeys * avgObjSize;
+}
+
+/**
+ * Internal command run by the balancer against the primary of a shard, which estimates the size of
+ * the data in each chunk of a collection owned by the shard.
+ *
+ * Reading every chunk's documents would be too expensive to do on every balancer round, so the
+ * sizes are extrapolated from a random sample of the collection's documents. The few chunks that
+ * no sampled document falls in are small, so their keys in the shard key index are counted instead.
+ * Documents which fall outside of the shard's chunks, such as orphans left behind by migrations
+ * which are still waiting to be range deleted, are not attributed to any chunk and so are not
+ * counted.
+ *
+ * Format:
+ * {
+ *   _shardsvrGetChunkDataSizes: <string namespace>
+ * }
+ */
+class GetChunkDataSizesCommand : public BasicCommand {
+public:
+    GetChunkDataSizesCommand() : BasicCommand("_shardsvrGetChunkDataSizes") {}
+
+    std::string help() const override {
+        return "Internal command, which estimates the size of the data in each chunk of a "
+               "collection owned by this shard from a random sample of its documents.";
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kNever;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    std::string parseNs(const std::string& dbname, const BSONObj& cmdObj) const override {
+        return CommandHelpers::parseNsFullyQualified(dbname, cmdObj);
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const override {
+        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+                ResourcePattern::forClusterResource(), ActionType::internal)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+        return Status::OK();
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+        ActionSet actions;
+        actions.addAction(ActionType::internal);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        uassertStatusOK(ShardingState::get(opCtx)->canAcceptShardedCommands());
+
+        const NamespaceString nss(parseNs(dbname, cmdObj));
+
+        AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+
+        Collection* const collection = autoColl.getCollection();
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "Collection " << nss.ns() << " does not exist",
+                collection);
+
+        auto metadata = CollectionShardingState::get(opCtx, nss)->getMetadata();
+        uassert(ErrorCodes::NamespaceNotSharded,
+                str::stream() << "Collection " << nss.ns() << " is not sharded",
+                metadata);
+
+        const RangeMap& chunks = metadata->getChunks();
+        const ShardKeyPattern shardKeyPattern(metadata->getKeyPattern());
+
+        auto sampledChunkBytes =
+            SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<long long>();
+        long long sampledBytes = 0;
+        long long numSampled = 0;
+
+        const long long numToSample =
+            std::min(std::max(kSampledDocumentsPerChunk * static_cast<long long>(chunks.size()),
+                              kMinSampledDocuments),
+                     kMaxSampledDocuments);
+
+        RecordStore* const recordStore = collection->getRecordStore();
+        const long long numRecords = recordStore->numRecords(opCtx);
+        const bool sampleRandomly = numRecords > numToSample;
+
+        std::unique_ptr<RecordCursor> cursor;
+        if (sampleRandomly) {
+            cursor = recordStore->getRandomCursor(opCtx);
+            uassert(ErrorCodes::CommandNotSupported,
+                    str::stream() << "The storage engine cannot sample documents of " << nss.ns()
+                                  << " at random",
+                    cursor);
+        } else {
+            cursor = recordStore->getCursor(opCtx);
+        }
+
+        while (numSampled < numToSample) {
+            auto record = cursor->next();
+            if (!record)
+                break;
+
+            ++numSampled;
+            sampledBytes += record->data.size();
+
+            const BSONObj shardKey = shardKeyPattern.extractShardKeyFromDoc(record->data.toBson());
+            if (shardKey.isEmpty())
+                continue;
+
+            auto it = chunks.upper_bound(shardKey);
+            if (it == chunks.begin())
+                continue;
+
+            --it;
+            if (rangeContains(it->first, it->second, shardKey)) {
+                sampledChunkBytes[it->first] += record->data.size();
+            }
+        }
+
+        // Each sampled byte stands for the same share of the collection's data
+        const double scale = (sampleRandomly && sampledBytes > 0)
+            ? double(recordStore->dataSize(opCtx)) / sampledBytes
+            : 1.0;
+
+        // Only needed when sampling at random, since a full read sees every chunk
+        IndexDescriptor* const shardKeyIdx = sampleRandomly
+            ? collection->getIndexCatalog()->findShardKeyPrefixedIndex(
+                  opCtx, metadata->getKeyPattern(), false)  // requireSingleKey
+            : nullptr;
+        const long long avgObjSize = numRecords > 0 ? recordStore->dataSize(opCtx) / numRecords : 0;
+        long long numCountedFromIndex = 0;
+
+        BSONArrayBuilder chunksArr(result.subarrayStart("chunks"));
+        for (const auto& chunk : chunks) {
+            long long size = 0;
+
+            const auto it = sampledChunkBytes.find(chunk.first);
+            if (it != sampledChunkBytes.end()) {
+                size = static_cast<long long>(it->second * scale);
+            } else if (shardKeyIdx) {
+                size = estimateChunkSizeFromIndex(
+                    opCtx, collection, shardKeyIdx, chunk.first, chunk.second, avgObjSize);
+                ++numCountedFromIndex;
+            }
+
+            chunksArr.append(BSON("min" << chunk.first << "max" << chunk.second << "size" << size));
+        }
+        chunksArr.doneFast();
+
+        result.append("numSampled", numSampled);
+        result.append("numCountedFromIndex", numCountedFromIndex);
+
+        LOG(1) << "estimated the size of " << chunks.size() << " chunks of " << nss.ns()
+               << " from " << numSampled << " documents and the index keys of "
+               << numCountedFromIndex << " chunks";
+
+        return true;
+    }
+
+} getChunkDataSizesCmd;
+
+}  // namespace
+}  // namespace mongo
@@ -39,6 +39,7 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/range_arithmetic.h"
 #include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/s/range_deleter_throttle.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
@@ -133,8 +134,9 @@ void scheduleCleanup(executor::TaskExecutor* executor,
             Client::initThreadIfNotAlready("Collection Range Deleter");
             auto uniqueOpCtx = Client::getCurrent()->makeOperationContext();
             auto opCtx = uniqueOpCtx.get();
+            opCtx->lockState()->setTicketPriority(TicketHolder::Priority::kLow);
 
-            const int maxToDelete = std::max(int(internalQueryExecYieldIterations.load()), 1);
+            const int maxToDelete = RangeDeleterThrottle::get(opCtx).docsPerPass();
 
             MONGO_FAIL_POINT_PAUSE_WHILE_SET(suspendRangeDeletion);
 
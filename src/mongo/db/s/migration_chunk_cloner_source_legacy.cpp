@@ -32,6 +32,8 @@
 
 #include "mongo/db/s/migration_chunk_cloner_source_legacy.h"
 
+#include <algorithm>
+
 #include "mongo/base/status.h"
 #include "mongo/client/read_preference.h"
 #include "mongo/db/catalog/catalog_raii.h"
@@ -66,6 +68,11 @@ const char kRecvChunkAbort[] = "_recvChunkAbort";
 
 const int kMaxObjectPerChunk{250000};
 
+// How many record ids nextCloneBatch takes off the clone queue at a time. Small enough that
+// concurrent recipient streams are spread over the queue, large enough to keep them from
+// contending on the mutex for every document.
+const size_t kCloneLocsPerTake{64};
+
 bool isInRange(const BSONObj& obj,
                const BSONObj& min,
                const BSONObj& max,
@@ -98,7 +105,11 @@ public:
     void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) override {
         if (type == INVALIDATION_DELETION) {
             stdx::lock_guard<stdx::mutex> sl(_cloner->_mutex);
-            _cloner->_cloneLocs.erase(dl);
+            if (_cloner->_storingCurrentLocs) {
+                _cloner->_locsDeletedWhileStoring.push_back(dl);
+            } else {
+                _cloner->_cloneLocs.erase(dl);
+            }
         }
     }
 
@@ -276,7 +287,7 @@ Status MigrationChunkClonerSourceLegacy::awaitUntilCriticalSectionIsAppropriate(
 
         stdx::lock_guard<stdx::mutex> sl(_mutex);
 
-        const std::size_t cloneLocsRemaining = _cloneLocs.size();
+        const std::size_t cloneLocsRemaining = _cloneLocs.size() + _numCloneLocsInFlight;
 
         log() << "moveChunk data transfer progress: " << redact(res) << " mem used: " << _memoryUsed
               << " documents remaining to clone: " << cloneLocsRemaining;
@@ -466,35 +477,59 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
                            internalQueryExecYieldIterations.load(),
                            Milliseconds(internalQueryExecYieldPeriodMS.load()));
 
-    stdx::lock_guard<stdx::mutex> sl(_mutex);
-
-    std::set<RecordId>::iterator it;
+    // The recipient may have several clone streams calling this concurrently, so the documents are
+    // fetched without holding _mutex. This is safe because the caller's collection lock is held
+    // until we return: storage engines which reuse record ids do not allow concurrent writes under
+    // it, and the others do not reuse them. Record ids which were taken but not fetched are put
+    // back on the queue before returning.
+    bool batchFull = false;
+    while (!batchFull) {
+        std::vector<RecordId> locs;
+        {
+            stdx::lock_guard<stdx::mutex> sl(_mutex);
+            _cloneLocs.takeFront(kCloneLocsPerTake, &locs);
+            _numCloneLocsInFlight += locs.size();
+        }
 
-    for (it = _cloneLocs.begin(); it != _cloneLocs.end(); ++it) {
-        // We must always make progress in this method by at least one document because empty return
-        // indicates there is no more initial clone data.
-        if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
+        if (locs.empty()) {
             break;
         }
 
-        Snapshotted<BSONObj> doc;
-        if (collection->findDoc(opCtx, *it, &doc)) {
-            // Use the builder size instead of accumulating the document sizes directly so that we
-            // take into consideration the overhead of BSONArray indices.
-            if (arrBuilder->arrSize() &&
-                (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
+        auto it = locs.begin();
+        ON_BLOCK_EXIT([&] {
+            stdx::lock_guard<stdx::mutex> sl(_mutex);
+            std::for_each(it, locs.end(), [&](const RecordId& loc) { _cloneLocs.insert(loc); });
+            _numCloneLocsInFlight -= locs.size();
+        });
+
+        for (; it != locs.end(); ++it) {
+            // We must always make progress in this method by at least one document because empty
+            // return indicates there is no more initial clone data.
+            if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
+                batchFull = true;
                 break;
             }
 
-            arrBuilder->append(doc.value());
+            Snapshotted<BSONObj> doc;
+            if (collection->findDoc(opCtx, *it, &doc)) {
+                // Use the builder size instead of accumulating the document sizes directly so that
+                // we take into consideration the overhead of BSONArray indices.
+                if (arrBuilder->arrSize() &&
+                    (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
+                    batchFull = true;
+                    break;
+                }
+
+                arrBuilder->append(doc.value());
+            }
         }
     }
 
-    _cloneLocs.erase(_cloneLocs.begin(), it);
+    stdx::lock_guard<stdx::mutex> sl(_mutex);
 
     // If we have drained all the cloned data, there is no need to keep the delete notify executor
     // around
-    if (_cloneLocs.empty() && _deleteNotifyExec) {
+    if (_cloneLocs.empty() && _numCloneLocsInFlight == 0 && _deleteNotifyExec) {
         // We have a different OperationContext than when we created the PlanExecutor, so need to
         // manually destroy it ourselves.
         _deleteNotifyExec->dispose(opCtx, collection->getCursorManager());
@@ -643,6 +678,19 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
     bool isLargeChunk = false;
     unsigned long long recCount = 0;
 
+    // The record ids come in shard key order, so they are collected first and sorted into
+    // _cloneLocs at the end. Deletions notified in the meantime are applied at that point.
+    std::vector<RecordId> recordIds;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _storingCurrentLocs = true;
+    }
+    ON_BLOCK_EXIT([&] {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _storingCurrentLocs = false;
+        _locsDeletedWhileStoring.clear();
+    });
+
     BSONObj obj;
     RecordId recordId;
     PlanExecutor::ExecState state;
@@ -653,8 +701,7 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
         }
 
         if (!isLargeChunk) {
-            stdx::lock_guard<stdx::mutex> lk(_mutex);
-            _cloneLocs.insert(recordId);
+            recordIds.push_back(recordId);
         }
 
         if (++recCount > maxRecsWhenFull) {
@@ -693,6 +740,21 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
     }
 
     stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    // A record id deleted during the scan may have been reused by a document inserted after it,
+    // and scanned again. Dropping it is safe regardless, because such a document was inserted
+    // after this cloner started observing writes and is therefore already queued to be reloaded.
+    auto& deleted = _locsDeletedWhileStoring;
+    std::sort(deleted.begin(), deleted.end());
+    recordIds.erase(std::remove_if(recordIds.begin(),
+                                   recordIds.end(),
+                                   [&](const RecordId& recordId) {
+                                       return std::binary_search(
+                                           deleted.begin(), deleted.end(), recordId);
+                                   }),
+                    recordIds.end());
+
+    _cloneLocs = RecordIdRunList(std::move(recordIds));
     _averageObjectSizeForCloneLocs = collectionAverageObjectSize + 12;
 
     return Status::OK();
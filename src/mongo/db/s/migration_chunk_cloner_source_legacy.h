@@ -29,7 +29,7 @@
 #pragma once
 
 #include <list>
-#include <set>
+#include <vector>
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/client/connection_string.h"
@@ -38,6 +38,7 @@
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/s/migration_chunk_cloner_source.h"
 #include "mongo/db/s/migration_session_id.h"
+#include "mongo/db/s/record_id_run_list.h"
 #include "mongo/db/s/session_catalog_migration_source.h"
 #include "mongo/s/request_types/move_chunk_request.h"
 #include "mongo/s/shard_key_pattern.h"
@@ -116,6 +117,9 @@ public:
      * give a chance to the caller to perform some form of yielding. It does not free or acquire any
      * locks on its own.
      *
+     * May be called concurrently by the recipient's parallel clone streams, each of which gets a
+     * disjoint set of documents.
+     *
      * NOTE: Must be called with the collection lock held in at least IS mode.
      */
     Status nextCloneBatch(OperationContext* opCtx,
@@ -210,7 +214,17 @@ private:
     State _state{kNew};
 
     // List of record ids that needs to be transferred (initial clone)
-    std::set<RecordId> _cloneLocs;
+    RecordIdRunList _cloneLocs;
+
+    // Set while _storeCurrentLocs is collecting the record ids of the chunk. Deletions which
+    // happen in the meantime are remembered in _locsDeletedWhileStoring, and applied once
+    // _cloneLocs has been built.
+    bool _storingCurrentLocs{false};
+    std::vector<RecordId> _locsDeletedWhileStoring;
+
+    // Number of record ids taken off _cloneLocs by nextCloneBatch calls which are still fetching
+    // them. Any which do not fit in the batch are put back on _cloneLocs.
+    std::size_t _numCloneLocsInFlight{0};
 
     // The estimated average object size during the clone phase. Used for buffer size
     // pre-allocation (initial clone).
@@ -293,6 +293,65 @@ TEST_F(MigrationChunkClonerSourceLegacyTest, CorrectDocumentsFetched) {
     futureCommit.timed_get(kFutureTimeout);
 }
 
+TEST_F(MigrationChunkClonerSourceLegacyTest, DocumentsNotFittingInBatchAreReturnedLater) {
+    std::vector<BSONObj> contents;
+    for (int i = 100; i < 400; i++) {
+        contents.push_back(createCollectionDocument(i));
+    }
+
+    createShardedCollection(contents);
+
+    MigrationChunkClonerSourceLegacy cloner(
+        createMoveChunkRequest(ChunkRange(BSON("X" << 100), BSON("X" << 400))),
+        kShardKeyPattern,
+        kDonorConnStr,
+        kRecipientConnStr.getServers()[0]);
+
+    {
+        auto futureStartClone = launchAsync([&]() {
+            onCommand([&](const RemoteCommandRequest& request) { return BSON("ok" << true); });
+        });
+
+        ASSERT_OK(cloner.startClone(operationContext()));
+        futureStartClone.timed_get(kFutureTimeout);
+    }
+
+    // Batches are cut short after a number of iterations, so several are needed. Each document
+    // must be returned exactly once, in order.
+    {
+        AutoGetCollection autoColl(operationContext(), kNss, MODE_IS);
+
+        std::vector<BSONObj> cloned;
+        int numBatches = 0;
+        while (true) {
+            BSONArrayBuilder arrBuilder;
+            ASSERT_OK(
+                cloner.nextCloneBatch(operationContext(), autoColl.getCollection(), &arrBuilder));
+            if (arrBuilder.arrSize() == 0) {
+                break;
+            }
+
+            numBatches++;
+            for (auto&& elem : arrBuilder.arr()) {
+                cloned.push_back(elem.Obj().getOwned());
+            }
+        }
+
+        ASSERT_GT(numBatches, 1);
+        ASSERT_EQ(contents.size(), cloned.size());
+        for (size_t i = 0; i < contents.size(); i++) {
+            ASSERT_BSONOBJ_EQ(contents[i], cloned[i]);
+        }
+    }
+
+    auto futureCancel = launchAsync([&]() {
+        onCommand([&](const RemoteCommandRequest& request) { return BSON("ok" << true); });
+    });
+
+    cloner.cancelClone(operationContext());
+    futureCancel.timed_get(kFutureTimeout);
+}
+
 TEST_F(MigrationChunkClonerSourceLegacyTest, CollectionNotFound) {
     MigrationChunkClonerSourceLegacy cloner(
         createMoveChunkRequest(ChunkRange(BSON("X" << 100), BSON("X" << 200))),
@@ -38,19 +38,23 @@
 #include "mongo/client/connpool.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/catalog/index_create.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/ops/delete.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/migration_util.h"
 #include "mongo/db/s/move_timing_helper.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/client/shard_registry.h"
@@ -60,6 +64,7 @@
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -67,6 +72,9 @@ namespace {
 const auto getMigrationDestinationManager =
     ServiceContext::declareDecoration<MigrationDestinationManager>();
 
+// How many concurrent _migrateClone requests the recipient issues to copy the initial chunk data
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneStreams, int, 4);
+
 const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 // Note: Even though we're setting UNSET here,
                                                 // kMajority implies JOURNAL if journaling is
@@ -720,78 +728,119 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
 
         _chunkMarkedPending = true;  // no lock needed, only the migrate thread looks.
 
-        while (true) {
-            BSONObj res;
-            if (!conn->runCommand("admin",
-                                  migrateCloneRequest,
-                                  res)) {  // gets array of objects to copy, in disk order
-                setStateFail(str::stream() << "_migrateClone failed: " << redact(res.toString()));
-                conn.done();
-                return;
+        // The donor hands out disjoint batches of documents to concurrent _migrateClone requests,
+        // so the clone is split into streams, each with its own connection to the donor. The
+        // migrate thread runs the first stream itself, on the connection it already has.
+        const int numStreams = std::max(1, migrateCloneStreams.load());
+        std::vector<Status> streamStatuses(numStreams, Status::OK());
+        std::vector<CloneStreamStats> streamStats(numStreams);
+        AtomicBool stopCloning(false);
+
+        auto runStream = [&](int streamIndex, OperationContext* streamOpCtx, DBClientBase* donor) {
+            auto& status = streamStatuses[streamIndex];
+            try {
+                status = _cloneDocuments(streamOpCtx,
+                                         donor,
+                                         migrateCloneRequest,
+                                         min,
+                                         max,
+                                         shardKeyPattern,
+                                         writeConcern,
+                                         stopCloning,
+                                         &streamStats[streamIndex]);
+            } catch (const DBException& ex) {
+                status = ex.toStatus();
+            } catch (const std::exception& ex) {
+                status = {ErrorCodes::UnknownError,
+                          str::stream() << "migrate failed: " << redact(ex.what())};
             }
 
-            BSONObj arr = res["objects"].Obj();
-            int thisTime = 0;
+            if (!status.isOK()) {
+                stopCloning.store(true);
+            }
+        };
 
-            BSONObjIterator i(arr);
-            while (i.more()) {
-                opCtx->checkForInterrupt();
+        const auto cloneStartTime = Date_t::now();
 
-                if (getState() == ABORT) {
-                    log() << "Migration aborted while copying documents";
-                    return;
-                }
+        std::vector<stdx::thread> streamThreads;
 
-                BSONObj docToClone = i.next().Obj();
-                {
-                    OldClientWriteContext cx(opCtx, _nss.ns());
-
-                    BSONObj localDoc;
-                    if (willOverrideLocalId(opCtx,
-                                            _nss,
-                                            min,
-                                            max,
-                                            shardKeyPattern,
-                                            cx.db(),
-                                            docToClone,
-                                            &localDoc)) {
-                        const std::string errMsg = str::stream()
-                            << "cannot migrate chunk, local document " << redact(localDoc)
-                            << " has same _id as cloned "
-                            << "remote document " << redact(docToClone);
-                        warning() << errMsg;
-
-                        // Exception will abort migration cleanly
-                        uasserted(16976, errMsg);
-                    }
+        // The streams refer to this frame, so if starting one of them throws, the ones already
+        // running are stopped and joined before unwinding.
+        auto joinStreamsGuard = MakeGuard([&] {
+            stopCloning.store(true);
+            for (auto&& thread : streamThreads) {
+                thread.join();
+            }
+        });
 
-                    Helpers::upsert(opCtx, _nss.ns(), docToClone, true);
-                }
-                thisTime++;
+        for (int i = 1; i < numStreams; i++) {
+            streamThreads.emplace_back([&, i] {
+                Client::initThread(str::stream() << "migrateCloneStream-" << i);
+                auto streamOpCtx = Client::getCurrent()->makeOperationContext();
 
-                {
-                    stdx::lock_guard<stdx::mutex> statsLock(_mutex);
-                    _numCloned++;
-                    _clonedBytes += docToClone.objsize();
+                if (AuthorizationManager::get(serviceContext)->isAuthEnabled()) {
+                    AuthorizationSession::get(streamOpCtx->getClient())
+                        ->grantInternalAuthorization();
                 }
 
-                if (writeConcern.shouldWaitForOtherNodes()) {
-                    repl::ReplicationCoordinator::StatusAndDuration replStatus =
-                        repl::ReplicationCoordinator::get(opCtx)->awaitReplication(
-                            opCtx,
-                            repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp(),
-                            writeConcern);
-                    if (replStatus.status.code() == ErrorCodes::WriteConcernFailed) {
-                        warning() << "secondaryThrottle on, but doc insert timed out; "
-                                     "continuing";
-                    } else {
-                        massertStatusOK(replStatus.status);
+                DisableDocumentValidation streamValidationDisabler(streamOpCtx.get());
+
+                try {
+                    ScopedDbConnection streamConn(fromShardConnString);
+                    runStream(i, streamOpCtx.get(), streamConn.get());
+                    if (streamStatuses[i].isOK()) {
+                        streamConn.done();
                     }
+                } catch (const DBException& ex) {
+                    streamStatuses[i] = ex.toStatus();
+                    stopCloning.store(true);
                 }
+            });
+        }
+
+        runStream(0, opCtx, conn.get());
+
+        joinStreamsGuard.Dismiss();
+        for (auto&& thread : streamThreads) {
+            thread.join();
+        }
+
+        // The documents inserted by the other streams must be waited on for replication as well
+        repl::ReplClientInfo::forClient(opCtx->getClient()).setLastOpToSystemLastOpTime(opCtx);
+
+        if (getState() == ABORT) {
+            log() << "Migration aborted while copying documents";
+            return;
+        }
+
+        for (auto&& status : streamStatuses) {
+            if (!status.isOK()) {
+                setStateFail(status.reason());
+                return;
             }
+        }
 
-            if (thisTime == 0)
-                break;
+        {
+            const long long cloneMillis =
+                std::max(1LL, durationCount<Milliseconds>(Date_t::now() - cloneStartTime));
+
+            long long fetchMillis = 0;
+            long long insertMillis = 0;
+            for (auto&& stats : streamStats) {
+                fetchMillis += stats.fetchMillis;
+                insertMillis += stats.insertMillis;
+            }
+
+            stdx::lock_guard<stdx::mutex> statsLock(_mutex);
+            timing.appendStat("cloneStreams", numStreams);
+            timing.appendStat("clonedDocs", _numCloned);
+            timing.appendStat("clonedBytes", _clonedBytes);
+            timing.appendStat("clonedBytesPerSec", _clonedBytes * 1000 / cloneMillis);
+
+            // Summed over all streams. Comparing these shows whether the donor or the local writes
+            // held the clone back.
+            timing.appendStat("cloneFetchMillis", fetchMillis);
+            timing.appendStat("cloneInsertMillis", insertMillis);
         }
 
         timing.done(3);
@@ -958,6 +1007,155 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
     conn.done();
 }
 
+Status MigrationDestinationManager::_cloneDocuments(OperationContext* opCtx,
+                                                    DBClientBase* conn,
+                                                    const BSONObj& migrateCloneRequest,
+                                                    const BSONObj& min,
+                                                    const BSONObj& max,
+                                                    const BSONObj& shardKeyPattern,
+                                                    const WriteConcernOptions& writeConcern,
+                                                    const AtomicBool& stopCloning,
+                                                    CloneStreamStats* stats) {
+    while (!stopCloning.load()) {
+        Timer fetchTimer;
+
+        BSONObj res;
+        if (!conn->runCommand("admin",
+                              migrateCloneRequest,
+                              res)) {  // gets array of objects to copy, in disk order
+            return {ErrorCodes::OperationFailed,
+                    str::stream() << "_migrateClone failed: " << redact(res.toString())};
+        }
+
+        std::vector<BSONObj> docsToClone;
+        for (auto&& elem : res["objects"].Obj()) {
+            docsToClone.push_back(elem.Obj());
+        }
+
+        stats->fetchMillis += fetchTimer.millis();
+
+        if (docsToClone.empty()) {
+            break;
+        }
+
+        Timer insertTimer;
+
+        // Insert in batches no larger than those of a regular insert command, so that the locks
+        // are yielded between them.
+        const size_t maxBatchSize = std::max(1, internalInsertMaxBatchSize.load());
+        auto batchBegin = docsToClone.cbegin();
+        while (batchBegin != docsToClone.cend()) {
+            opCtx->checkForInterrupt();
+
+            if (getState() == ABORT || stopCloning.load()) {
+                return Status::OK();
+            }
+
+            auto batchEnd = batchBegin;
+            long long batchBytes = 0;
+            while (batchEnd != docsToClone.cend() &&
+                   static_cast<size_t>(batchEnd - batchBegin) < maxBatchSize &&
+                   (batchBytes == 0 || batchBytes + batchEnd->objsize() <= insertVectorMaxBytes)) {
+                batchBytes += batchEnd->objsize();
+                ++batchEnd;
+            }
+
+            _insertClonedDocuments(opCtx, min, max, shardKeyPattern, batchBegin, batchEnd);
+
+            {
+                stdx::lock_guard<stdx::mutex> statsLock(_mutex);
+                _numCloned += batchEnd - batchBegin;
+                _clonedBytes += batchBytes;
+            }
+
+            batchBegin = batchEnd;
+        }
+
+        if (writeConcern.shouldWaitForOtherNodes()) {
+            repl::ReplicationCoordinator::StatusAndDuration replStatus =
+                repl::ReplicationCoordinator::get(opCtx)->awaitReplication(
+                    opCtx,
+                    repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp(),
+                    writeConcern);
+            if (replStatus.status.code() == ErrorCodes::WriteConcernFailed) {
+                warning() << "secondaryThrottle on, but doc insert timed out; "
+                             "continuing";
+            } else {
+                massertStatusOK(replStatus.status);
+            }
+        }
+
+        stats->insertMillis += insertTimer.millis();
+    }
+
+    return Status::OK();
+}
+
+void MigrationDestinationManager::_insertClonedDocuments(
+    OperationContext* opCtx,
+    const BSONObj& min,
+    const BSONObj& max,
+    const BSONObj& shardKeyPattern,
+    std::vector<BSONObj>::const_iterator begin,
+    std::vector<BSONObj>::const_iterator end) {
+    auto assertWillNotOverrideLocalId = [&](Database* db, const BSONObj& docToClone) {
+        BSONObj localDoc;
+        if (willOverrideLocalId(
+                opCtx, _nss, min, max, shardKeyPattern, db, docToClone, &localDoc)) {
+            const std::string errMsg = str::stream()
+                << "cannot migrate chunk, local document " << redact(localDoc)
+                << " has same _id as cloned "
+                << "remote document " << redact(docToClone);
+            warning() << errMsg;
+
+            // Exception will abort migration cleanly
+            uasserted(16976, errMsg);
+        }
+    };
+
+    {
+        AutoGetCollection autoColl(opCtx, _nss, MODE_IX);
+        Collection* const collection = autoColl.getCollection();
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "Collection " << _nss.ns() << " was dropped during migration",
+                collection);
+
+        if (!collection->isCapped()) {
+            std::vector<InsertStatement> inserts;
+            inserts.reserve(end - begin);
+            for (auto it = begin; it != end; ++it) {
+                assertWillNotOverrideLocalId(autoColl.getDb(), *it);
+                inserts.emplace_back(*it);
+            }
+
+            try {
+                writeConflictRetry(opCtx, "migrateClone", _nss.ns(), [&] {
+                    WriteUnitOfWork wuow(opCtx);
+                    uassertStatusOK(collection->insertDocuments(opCtx,
+                                                                inserts.cbegin(),
+                                                                inserts.cend(),
+                                                                nullptr,
+                                                                true /* enforceQuota */,
+                                                                true /* fromMigrate */));
+                    wuow.commit();
+                });
+                return;
+            } catch (const DBException& ex) {
+                if (ex.code() != ErrorCodes::DuplicateKey) {
+                    throw;
+                }
+            }
+        }
+    }
+
+    // Some of the documents already exist or the collection is capped, so upsert them one by one
+    for (auto it = begin; it != end; ++it) {
+        OldClientWriteContext cx(opCtx, _nss.ns());
+        assertWillNotOverrideLocalId(cx.db(), *it);
+        Helpers::upsert(opCtx, _nss.ns(), *it, true);
+    }
+}
+
 bool MigrationDestinationManager::_applyMigrateOp(OperationContext* opCtx,
                                                   const NamespaceString& nss,
                                                   const BSONObj& min,
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/bsonobj.h"
@@ -40,6 +41,7 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/migration_session_id.h"
 #include "mongo/db/s/session_catalog_migration_destination.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/shard_id.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -49,6 +51,7 @@
 
 namespace mongo {
 
+class DBClientBase;
 class OperationContext;
 class Status;
 struct WriteConcernOptions;
@@ -150,6 +153,41 @@ private:
                         const OID& epoch,
                         const WriteConcernOptions& writeConcern);
 
+    // How long one stream of the initial clone spent waiting for batches of documents from the
+    // donor, and writing them locally.
+    struct CloneStreamStats {
+        long long fetchMillis{0};
+        long long insertMillis{0};
+    };
+
+    /**
+     * Runs one stream of the initial clone: requests batches of documents from the donor by
+     * sending 'migrateCloneRequest' over 'conn' and inserts them, until the donor has none left
+     * to hand out, the migration is aborted or 'stopCloning' is set. The migrate thread runs
+     * several of these at once, each with its own connection and OperationContext.
+     */
+    Status _cloneDocuments(OperationContext* opCtx,
+                           DBClientBase* conn,
+                           const BSONObj& migrateCloneRequest,
+                           const BSONObj& min,
+                           const BSONObj& max,
+                           const BSONObj& shardKeyPattern,
+                           const WriteConcernOptions& writeConcern,
+                           const AtomicBool& stopCloning,
+                           CloneStreamStats* stats);
+
+    /**
+     * Inserts documents received from the donor in a single write unit of work. Falls back to
+     * upserting them one at a time if any of them already exists locally. Throws if one of them
+     * would overwrite a local document with the same _id outside of the migrated range.
+     */
+    void _insertClonedDocuments(OperationContext* opCtx,
+                                const BSONObj& min,
+                                const BSONObj& max,
+                                const BSONObj& shardKeyPattern,
+                                std::vector<BSONObj>::const_iterator begin,
+                                std::vector<BSONObj>::const_iterator end);
+
     bool _applyMigrateOp(OperationContext* opCtx,
                          const NamespaceString& ns,
                          const BSONObj& min,
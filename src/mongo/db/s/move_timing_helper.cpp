@@ -113,4 +113,8 @@ void MoveTimingHelper::done(int step) {
     _t.reset();
 }
 
+void MoveTimingHelper::appendStat(StringData name, long long value) {
+    _b.appendNumber(name, value);
+}
+
 }  // namespace mongo
@@ -54,6 +54,11 @@ public:
 
     void done(int step);
 
+    /**
+     * Adds a statistic to the changelog entry, which is written when this object is destroyed.
+     */
+    void appendStat(StringData name, long long value);
+
 private:
     // Measures how long the receiving of a chunk takes
     Timer _t;
@@ -0,0 +1,158 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/range_deleter_throttle.h"
+
+#include <algorithm>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+// Upper bound on the number of documents a single range deletion pass removes
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxDocsPerPass, int, 1024);
+
+// Time for a pass's deletions to become majority committed above which the range deleter backs off
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxReplicationLagMillis, int, 1000);
+
+// Average time to delete one document above which the range deleter backs off
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxMicrosPerDoc, int, 1000);
+
+// Average latency of foreground writes above which the range deleter backs off. Zero disables the
+// check, since what is acceptable depends entirely on the workload.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxWriteLatencyMicros, int, 0);
+
+// Longest the range deleter pauses between two passes when backing off
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxPauseMillis, int, 5000);
+
+const int kInitialDocsPerPass = 128;
+const int kMinDocsPerPass = 8;
+const Milliseconds kMinPause(10);
+
+const auto getRangeDeleterThrottle = ServiceContext::declareDecoration<RangeDeleterThrottle>();
+
+}  // namespace
+
+RangeDeleterThrottle::RangeDeleterThrottle() : _docsPerPass(kInitialDocsPerPass) {}
+
+RangeDeleterThrottle& RangeDeleterThrottle::get(ServiceContext* serviceContext) {
+    return getRangeDeleterThrottle(serviceContext);
+}
+
+RangeDeleterThrottle& RangeDeleterThrottle::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+int RangeDeleterThrottle::docsPerPass() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return std::max(std::min(_docsPerPass, rangeDeleterMaxDocsPerPass.load()), 1);
+}
+
+RangeDeleterThrottle::Decision RangeDeleterThrottle::recordPass(const PassStats& stats) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    const int maxDocsPerPass = std::max(rangeDeleterMaxDocsPerPass.load(), 1);
+
+    Decision decision;
+    decision.reason = _checkSignals(stats);
+
+    if (decision.reason == PauseReason::kNone) {
+        // Only grow when the pass was limited by its size rather than by the end of the range
+        if (stats.docsDeleted >= _docsPerPass) {
+            _docsPerPass += std::max(_docsPerPass / 4, 1);
+        }
+        _docsPerPass = std::min(_docsPerPass, maxDocsPerPass);
+        return decision;
+    }
+
+    _docsPerPass = std::min(std::max(_docsPerPass / 2, kMinDocsPerPass), maxDocsPerPass);
+
+    // Give the node at least as long to catch up as the pass took to produce the pressure
+    const Milliseconds pressure = decision.reason == PauseReason::kReplicationLag
+        ? stats.replicationWaitTime
+        : duration_cast<Milliseconds>(stats.deleteTime);
+    const Milliseconds maxPause(std::max(rangeDeleterMaxPauseMillis.load(), 0));
+    decision.delay = std::min(std::max(pressure, kMinPause), maxPause);
+
+    return decision;
+}
+
+RangeDeleterThrottle::PauseReason RangeDeleterThrottle::_checkSignals(const PassStats& stats) {
+    // Always advance the foreground baseline, so that the average covers exactly one pass
+    const uint64_t writeOps = stats.foregroundWriteOps - _lastForegroundWriteOps;
+    const uint64_t writeLatencyMicros =
+        stats.foregroundWriteLatencyMicros - _lastForegroundWriteLatencyMicros;
+    _lastForegroundWriteOps = stats.foregroundWriteOps;
+    _lastForegroundWriteLatencyMicros = stats.foregroundWriteLatencyMicros;
+
+    if (stats.replicationWaitTime > Milliseconds(rangeDeleterMaxReplicationLagMillis.load())) {
+        return PauseReason::kReplicationLag;
+    }
+
+    if (stats.storageCacheUnderPressure) {
+        return PauseReason::kStoragePressure;
+    }
+
+    // A handful of deletions is too small a sample to tell a slow storage engine from noise
+    if (stats.docsDeleted >= kMinDocsPerPass) {
+        const auto microsPerDoc = durationCount<Microseconds>(stats.deleteTime) / stats.docsDeleted;
+        if (microsPerDoc > rangeDeleterMaxMicrosPerDoc.load()) {
+            return PauseReason::kStoragePressure;
+        }
+    }
+
+    const int maxWriteLatencyMicros = rangeDeleterMaxWriteLatencyMicros.load();
+    if (maxWriteLatencyMicros > 0 && writeOps > 0 &&
+        writeLatencyMicros / writeOps > static_cast<uint64_t>(maxWriteLatencyMicros)) {
+        return PauseReason::kForegroundLatency;
+    }
+
+    return PauseReason::kNone;
+}
+
+StringData RangeDeleterThrottle::reasonToString(PauseReason reason) {
+    switch (reason) {
+        case PauseReason::kNone:
+            return "none"_sd;
+        case PauseReason::kReplicationLag:
+            return "replicationLag"_sd;
+        case PauseReason::kStoragePressure:
+            return "storagePressure"_sd;
+        case PauseReason::kForegroundLatency:
+            return "foregroundLatency"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace mongo
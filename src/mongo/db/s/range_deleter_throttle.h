@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Paces the orphaned range deleter against the load it puts on the rest of the node. After each
+ * deletion pass, CollectionRangeDeleter reports what the pass observed and gets back how long to
+ * wait before the next one. The number of documents deleted per pass grows while the node keeps
+ * up and is halved as soon as one of the following signals crosses its threshold:
+ *
+ *  - replication lag: the time it took for the pass's deletions to become majority committed,
+ *  - storage pressure: the storage engine reporting that its cache is under pressure, or the
+ *    average time spent deleting one document growing too long, which is where eviction shows
+ *    up on storage engines that do not report it,
+ *  - foreground latency: the average latency of write operations served by the node since the
+ *    previous pass, as recorded by Top.
+ *
+ * There is a single instance per process, shared by the deletions of all collections, because the
+ * signals above are node-wide. All methods are thread-safe.
+ */
+class RangeDeleterThrottle {
+    MONGO_DISALLOW_COPYING(RangeDeleterThrottle);
+
+public:
+    enum class PauseReason { kNone, kReplicationLag, kStoragePressure, kForegroundLatency };
+
+    /**
+     * What one deletion pass observed. The foreground counters are cumulative totals, as found in
+     * the global latency statistics; the throttle computes the average between passes itself.
+     */
+    struct PassStats {
+        int docsDeleted{0};
+        Microseconds deleteTime{0};
+        Milliseconds replicationWaitTime{0};
+        bool storageCacheUnderPressure{false};
+        uint64_t foregroundWriteOps{0};
+        uint64_t foregroundWriteLatencyMicros{0};
+    };
+
+    struct Decision {
+        Milliseconds delay{0};
+        PauseReason reason{PauseReason::kNone};
+    };
+
+    RangeDeleterThrottle();
+
+    static RangeDeleterThrottle& get(ServiceContext* serviceContext);
+    static RangeDeleterThrottle& get(OperationContext* opCtx);
+
+    /**
+     * Number of documents the next deletion pass should delete at most.
+     */
+    int docsPerPass() const;
+
+    /**
+     * Adjusts the pass size to what the last pass observed and returns how long the range deleter
+     * should pause before the next pass, along with the reason for pausing.
+     */
+    Decision recordPass(const PassStats& stats);
+
+    static StringData reasonToString(PauseReason reason);
+
+private:
+    PauseReason _checkSignals(const PassStats& stats);
+
+    mutable stdx::mutex _mutex;
+
+    int _docsPerPass;
+
+    uint64_t _lastForegroundWriteOps{0};
+    uint64_t _lastForegroundWriteLatencyMicros{0};
+};
+
+}  // namespace mongo
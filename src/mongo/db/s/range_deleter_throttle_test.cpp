@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/range_deleter_throttle.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+using PassStats = RangeDeleterThrottle::PassStats;
+using PauseReason = RangeDeleterThrottle::PauseReason;
+
+PassStats makePassStats(int docsDeleted,
+                        Microseconds deleteTime,
+                        Milliseconds replicationWaitTime) {
+    PassStats stats;
+    stats.docsDeleted = docsDeleted;
+    stats.deleteTime = deleteTime;
+    stats.replicationWaitTime = replicationWaitTime;
+    return stats;
+}
+
+TEST(RangeDeleterThrottleTest, GrowsWhileFullPassesKeepUp) {
+    RangeDeleterThrottle throttle;
+    const int initial = throttle.docsPerPass();
+
+    auto decision = throttle.recordPass(makePassStats(initial, Milliseconds(5), Milliseconds(1)));
+    ASSERT(decision.reason == PauseReason::kNone);
+    ASSERT_EQ(Milliseconds(0), decision.delay);
+    ASSERT_GT(throttle.docsPerPass(), initial);
+}
+
+TEST(RangeDeleterThrottleTest, DoesNotGrowWhenRangeIsExhausted) {
+    RangeDeleterThrottle throttle;
+    const int initial = throttle.docsPerPass();
+
+    auto decision = throttle.recordPass(makePassStats(1, Microseconds(50), Milliseconds(1)));
+    ASSERT(decision.reason == PauseReason::kNone);
+    ASSERT_EQ(initial, throttle.docsPerPass());
+}
+
+TEST(RangeDeleterThrottleTest, NeverGrowsBeyondMaximum) {
+    RangeDeleterThrottle throttle;
+    for (int i = 0; i < 100; i++) {
+        throttle.recordPass(
+            makePassStats(throttle.docsPerPass(), Milliseconds(1), Milliseconds(1)));
+    }
+    ASSERT_EQ(1024, throttle.docsPerPass());
+}
+
+TEST(RangeDeleterThrottleTest, BacksOffOnReplicationLag) {
+    RangeDeleterThrottle throttle;
+    const int initial = throttle.docsPerPass();
+
+    auto decision =
+        throttle.recordPass(makePassStats(initial, Milliseconds(5), Milliseconds(3000)));
+    ASSERT(decision.reason == PauseReason::kReplicationLag);
+    ASSERT_EQ(Milliseconds(3000), decision.delay);
+    ASSERT_EQ(initial / 2, throttle.docsPerPass());
+
+    // The pause is capped
+    decision = throttle.recordPass(makePassStats(10, Milliseconds(5), Minutes(1)));
+    ASSERT(decision.reason == PauseReason::kReplicationLag);
+    ASSERT_EQ(Milliseconds(5000), decision.delay);
+}
+
+TEST(RangeDeleterThrottleTest, BacksOffOnSlowDeletes) {
+    RangeDeleterThrottle throttle;
+    const int initial = throttle.docsPerPass();
+
+    // 2ms per document is slower than the default threshold of 1ms
+    auto decision = throttle.recordPass(makePassStats(100, Milliseconds(200), Milliseconds(1)));
+    ASSERT(decision.reason == PauseReason::kStoragePressure);
+    ASSERT_EQ(Milliseconds(200), decision.delay);
+    ASSERT_EQ(initial / 2, throttle.docsPerPass());
+}
+
+TEST(RangeDeleterThrottleTest, BacksOffOnStorageCachePressure) {
+    RangeDeleterThrottle throttle;
+    const int initial = throttle.docsPerPass();
+
+    // The deletions themselves were fast, but the storage engine reports that its cache is dirty
+    auto stats = makePassStats(initial, Milliseconds(50), Milliseconds(1));
+    stats.storageCacheUnderPressure = true;
+    auto decision = throttle.recordPass(stats);
+    ASSERT(decision.reason == PauseReason::kStoragePressure);
+    ASSERT_EQ(Milliseconds(50), decision.delay);
+    ASSERT_EQ(initial / 2, throttle.docsPerPass());
+}
+
+TEST(RangeDeleterThrottleTest, ShrinksDownToMinimum) {
+    RangeDeleterThrottle throttle;
+    for (int i = 0; i < 100; i++) {
+        auto decision = throttle.recordPass(makePassStats(1, Microseconds(1), Seconds(2)));
+        ASSERT(decision.reason == PauseReason::kReplicationLag);
+    }
+    ASSERT_EQ(8, throttle.docsPerPass());
+}
+
+TEST(RangeDeleterThrottleTest, BacksOffOnForegroundWriteLatencyWhenEnabled) {
+    auto* param =
+        ServerParameterSet::getGlobal()->getMap().find("rangeDeleterMaxWriteLatencyMicros")->second;
+    ASSERT_OK(param->setFromString("1000"));
+    ON_BLOCK_EXIT([&] { invariant(param->setFromString("0").isOK()); });
+
+    RangeDeleterThrottle throttle;
+
+    auto stats = makePassStats(10, Microseconds(100), Milliseconds(1));
+    stats.foregroundWriteOps = 100;
+    stats.foregroundWriteLatencyMicros = 50000;
+    ASSERT(throttle.recordPass(stats).reason == PauseReason::kNone);
+
+    // 10 writes which took 5ms each since the previous pass
+    stats.foregroundWriteOps = 110;
+    stats.foregroundWriteLatencyMicros = 100000;
+    auto decision = throttle.recordPass(stats);
+    ASSERT(decision.reason == PauseReason::kForegroundLatency);
+    ASSERT_EQ(Milliseconds(10), decision.delay);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,275 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/record_id_run_list.h"
+
+#include <algorithm>
+
+namespace mongo {
+namespace {
+
+void appendVarInt(uint64_t value, std::string* out) {
+    while (value >= 0x80) {
+        out->push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out->push_back(static_cast<char>(value));
+}
+
+uint64_t readVarInt(const char** ptr) {
+    uint64_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        const uint8_t byte = static_cast<uint8_t>(*(*ptr)++);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+}
+
+}  // namespace
+
+RecordIdRunList::RecordIdRunList(std::vector<RecordId> recordIds) {
+    std::sort(recordIds.begin(), recordIds.end());
+    recordIds.erase(std::unique(recordIds.begin(), recordIds.end()), recordIds.end());
+
+    std::vector<Run> runs;
+    for (const auto& recordId : recordIds) {
+        if (!runs.empty() && runs.back().last() + 1 == recordId.repr()) {
+            runs.back().count++;
+        } else {
+            runs.push_back({recordId.repr(), 1});
+        }
+    }
+
+    _replaceBlocks(0, 0, runs);
+    _size = recordIds.size();
+}
+
+std::size_t RecordIdRunList::memUsageBytes() const {
+    std::size_t bytes = sizeof(*this) + _blocks.size() * sizeof(Block);
+    for (const auto& block : _blocks) {
+        bytes += block.data.capacity();
+    }
+    return bytes;
+}
+
+bool RecordIdRunList::contains(const RecordId& recordId) const {
+    if (_blocks.empty()) {
+        return false;
+    }
+
+    const int64_t repr = recordId.repr();
+    std::vector<Run> runs;
+    _decode(_blocks[_findBlock(repr)], &runs);
+
+    auto it = std::find_if(
+        runs.begin(), runs.end(), [&](const Run& run) { return run.last() >= repr; });
+    return it != runs.end() && it->first <= repr;
+}
+
+void RecordIdRunList::insert(const RecordId& recordId) {
+    const int64_t repr = recordId.repr();
+
+    if (_blocks.empty()) {
+        _replaceBlocks(0, 0, {{repr, 1}});
+        _size++;
+        return;
+    }
+
+    // The id may join the last run of its block to the first run of the next one
+    const std::size_t begin = _findBlock(repr);
+    std::size_t end = begin + 1;
+    if (end < _blocks.size() && _blocks[end].first - 1 == repr) {
+        end++;
+    }
+
+    std::vector<Run> runs;
+    for (std::size_t i = begin; i < end; i++) {
+        _decode(_blocks[i], &runs);
+    }
+
+    auto next = std::find_if(
+        runs.begin(), runs.end(), [&](const Run& run) { return run.last() >= repr; });
+    if (next != runs.end() && next->first <= repr) {
+        return;
+    }
+
+    // The id goes between 'prev' and 'next', either of which it may extend
+    auto prev = (next == runs.begin()) ? runs.end() : std::prev(next);
+    const bool extendsPrev = prev != runs.end() && prev->last() + 1 == repr;
+    const bool extendsNext = next != runs.end() && next->first - 1 == repr;
+
+    if (extendsPrev && extendsNext) {
+        prev->count += 1 + next->count;
+        runs.erase(next);
+    } else if (extendsPrev) {
+        prev->count++;
+    } else if (extendsNext) {
+        next->first--;
+        next->count++;
+    } else {
+        runs.insert(next, {repr, 1});
+    }
+
+    _replaceBlocks(begin, end, runs);
+    _size++;
+}
+
+void RecordIdRunList::erase(const RecordId& recordId) {
+    if (_blocks.empty()) {
+        return;
+    }
+
+    const int64_t repr = recordId.repr();
+    const std::size_t blockIndex = _findBlock(repr);
+
+    std::vector<Run> runs;
+    _decode(_blocks[blockIndex], &runs);
+
+    auto it = std::find_if(
+        runs.begin(), runs.end(), [&](const Run& run) { return run.last() >= repr; });
+    if (it == runs.end() || it->first > repr) {
+        return;
+    }
+
+    const int64_t last = it->last();
+    if (it->count == 1) {
+        runs.erase(it);
+    } else if (it->first == repr) {
+        it->first++;
+        it->count--;
+    } else if (last == repr) {
+        it->count--;
+    } else {
+        // Split the run around the erased id
+        it->count = repr - it->first;
+        runs.insert(std::next(it), {repr + 1, last - repr});
+    }
+
+    _replaceBlocks(blockIndex, blockIndex + 1, runs);
+    _size--;
+}
+
+void RecordIdRunList::takeFront(std::size_t maxCount, std::vector<RecordId>* out) {
+    std::vector<Run> runs;
+
+    while (maxCount > 0 && !_blocks.empty()) {
+        runs.clear();
+        _decode(_blocks.front(), &runs);
+
+        auto run = runs.begin();
+        while (maxCount > 0 && run != runs.end()) {
+            const int64_t numTaken = std::min(run->count, static_cast<int64_t>(maxCount));
+
+            for (int64_t i = 0; i < numTaken; i++) {
+                out->push_back(RecordId(run->first + i));
+            }
+
+            run->first += numTaken;
+            run->count -= numTaken;
+            if (run->count == 0) {
+                ++run;
+            }
+
+            _size -= numTaken;
+            maxCount -= numTaken;
+        }
+
+        runs.erase(runs.begin(), run);
+        _replaceBlocks(0, 1, runs);
+    }
+}
+
+std::size_t RecordIdRunList::_findBlock(int64_t repr) const {
+    auto it = std::upper_bound(_blocks.begin(),
+                               _blocks.end(),
+                               repr,
+                               [](int64_t repr, const Block& block) { return repr < block.first; });
+    return (it == _blocks.begin()) ? 0 : std::distance(_blocks.begin(), it) - 1;
+}
+
+void RecordIdRunList::_decode(const Block& block, std::vector<Run>* runs) {
+    const char* ptr = block.data.data();
+    const char* const end = ptr + block.data.size();
+
+    // Unsigned arithmetic, so that the distance between any two ids fits
+    uint64_t nextFirst = block.first;
+    while (ptr < end) {
+        Run run;
+        run.first = nextFirst + readVarInt(&ptr);
+        run.count = readVarInt(&ptr) + 1;
+        runs->push_back(run);
+        nextFirst = static_cast<uint64_t>(run.last()) + 1;
+    }
+}
+
+void RecordIdRunList::_replaceBlocks(std::size_t begin,
+                                     std::size_t end,
+                                     const std::vector<Run>& runs) {
+    for (std::size_t i = begin; i < end; i++) {
+        _numRuns -= _blocks[i].numRuns;
+    }
+
+    // Spread the runs evenly over as few blocks as possible. Blocks which already exist are
+    // overwritten in place, so that the common case of a block replacing itself moves no others.
+    const std::size_t numBlocks = (runs.size() + kMaxRunsPerBlock - 1) / kMaxRunsPerBlock;
+    std::size_t pos = begin;
+    for (std::size_t i = 0; i < numBlocks; i++, pos++) {
+        const std::size_t runsBegin = runs.size() * i / numBlocks;
+        const std::size_t runsEnd = runs.size() * (i + 1) / numBlocks;
+
+        Block block;
+        block.first = runs[runsBegin].first;
+        block.numRuns = runsEnd - runsBegin;
+
+        uint64_t nextFirst = block.first;
+        for (std::size_t r = runsBegin; r < runsEnd; r++) {
+            appendVarInt(static_cast<uint64_t>(runs[r].first) - nextFirst, &block.data);
+            appendVarInt(runs[r].count - 1, &block.data);
+            nextFirst = static_cast<uint64_t>(runs[r].last()) + 1;
+        }
+        block.data.shrink_to_fit();
+
+        if (pos < end) {
+            _blocks[pos] = std::move(block);
+        } else {
+            _blocks.insert(_blocks.begin() + pos, std::move(block));
+        }
+    }
+
+    if (pos < end) {
+        _blocks.erase(_blocks.begin() + pos, _blocks.begin() + end);
+    }
+
+    _numRuns += runs.size();
+}
+
+}  // namespace mongo
@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+/**
+ * A set of RecordIds, stored as a sorted sequence of runs of consecutive ids. The migration source
+ * uses it to remember which documents of a chunk remain to be cloned. Documents which were inserted
+ * together mostly have consecutive record ids, so even a chunk of millions of documents usually
+ * takes a handful of runs, and never more than one run per document.
+ *
+ * This class is not thread-safe.
+ */
+class RecordIdRunList {
+public:
+    RecordIdRunList() = default;
+
+    /**
+     * Builds the list from 'recordIds', which may be in any order and contain duplicates.
+     */
+    explicit RecordIdRunList(std::vector<RecordId> recordIds);
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    /**
+     * Number of record ids in the list.
+     */
+    std::size_t size() const {
+        return _size;
+    }
+
+    /**
+     * Number of runs of consecutive record ids the list is made of.
+     */
+    std::size_t numRuns() const {
+        return _numRuns;
+    }
+
+    /**
+     * Approximate number of bytes of memory used by the list.
+     */
+    std::size_t memUsageBytes() const;
+
+    bool contains(const RecordId& recordId) const;
+
+    /**
+     * Adds 'recordId' if it is not already present. This is cheapest next to the smallest or the
+     * largest id in the list.
+     */
+    void insert(const RecordId& recordId);
+
+    /**
+     * Removes 'recordId' if it is present.
+     */
+    void erase(const RecordId& recordId);
+
+    /**
+     * Removes up to 'maxCount' of the smallest record ids and appends them, in order, to 'out'.
+     */
+    void takeFront(std::size_t maxCount, std::vector<RecordId>* out);
+
+private:
+    struct Run {
+        int64_t last() const {
+            return first + count - 1;
+        }
+
+        int64_t first;
+        int64_t count;
+    };
+
+    // A block of consecutive runs. With a hashed shard key most runs hold a single id, so the runs
+    // are delta encoded to keep the list small: each run is stored as two unsigned varints, the
+    // number of ids between the end of the previous run, or 'first' for the first run, and the
+    // start of this run, then the number of ids in the run minus one. Blocks bound the number of
+    // runs which have to be decoded and re-encoded by a change in the middle of the list.
+    struct Block {
+        int64_t first;
+        uint32_t numRuns;
+        std::string data;
+    };
+
+    static const std::size_t kMaxRunsPerBlock = 64;
+
+    /**
+     * Returns the index of the last block which starts at or before 'repr', or 0 if there is none.
+     * The list must not be empty.
+     */
+    std::size_t _findBlock(int64_t repr) const;
+
+    /**
+     * Appends the runs of 'block' to 'runs'.
+     */
+    static void _decode(const Block& block, std::vector<Run>* runs);
+
+    /**
+     * Replaces the blocks in [begin, end) with blocks holding 'runs', which must be sorted and
+     * must not touch the runs of the neighbouring blocks.
+     */
+    void _replaceBlocks(std::size_t begin, std::size_t end, const std::vector<Run>& runs);
+
+    std::deque<Block> _blocks;
+    std::size_t _size{0};
+    std::size_t _numRuns{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,170 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <set>
+
+#include "mongo/db/s/record_id_run_list.h"
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<RecordId> takeAll(RecordIdRunList* list) {
+    std::vector<RecordId> out;
+    list->takeFront(list->size(), &out);
+    return out;
+}
+
+std::vector<RecordId> makeRecordIds(std::initializer_list<int64_t> reprs) {
+    std::vector<RecordId> recordIds;
+    for (auto repr : reprs) {
+        recordIds.push_back(RecordId(repr));
+    }
+    return recordIds;
+}
+
+TEST(RecordIdRunListTest, ConstructedFromUnsortedIds) {
+    RecordIdRunList list(makeRecordIds({7, 3, 4, 5, 10, 4, 6, 12, 11}));
+    ASSERT_EQ(8U, list.size());
+    ASSERT_EQ(2U, list.numRuns());
+    ASSERT_TRUE(list.contains(RecordId(3)));
+    ASSERT_TRUE(list.contains(RecordId(12)));
+    ASSERT_FALSE(list.contains(RecordId(8)));
+    ASSERT_FALSE(list.contains(RecordId(13)));
+
+    ASSERT(makeRecordIds({3, 4, 5, 6, 7, 10, 11, 12}) == takeAll(&list));
+    ASSERT_TRUE(list.empty());
+    ASSERT_EQ(0U, list.numRuns());
+}
+
+TEST(RecordIdRunListTest, InsertExtendsAndJoinsRuns) {
+    RecordIdRunList list(makeRecordIds({1, 2, 5, 6}));
+
+    list.insert(RecordId(3));
+    ASSERT_EQ(2U, list.numRuns());
+    list.insert(RecordId(4));
+    ASSERT_EQ(1U, list.numRuns());
+    list.insert(RecordId(0));
+    list.insert(RecordId(7));
+    ASSERT_EQ(1U, list.numRuns());
+    list.insert(RecordId(4));
+    ASSERT_EQ(8U, list.size());
+
+    list.insert(RecordId(20));
+    ASSERT_EQ(2U, list.numRuns());
+    ASSERT(makeRecordIds({0, 1, 2, 3, 4, 5, 6, 7, 20}) == takeAll(&list));
+}
+
+TEST(RecordIdRunListTest, EraseShrinksAndSplitsRuns) {
+    RecordIdRunList list(makeRecordIds({1, 2, 3, 4, 5, 9}));
+
+    list.erase(RecordId(3));
+    ASSERT_EQ(3U, list.numRuns());
+    list.erase(RecordId(1));
+    list.erase(RecordId(5));
+    list.erase(RecordId(9));
+    list.erase(RecordId(7));
+    ASSERT_EQ(2U, list.size());
+    ASSERT_EQ(2U, list.numRuns());
+    ASSERT(makeRecordIds({2, 4}) == takeAll(&list));
+}
+
+TEST(RecordIdRunListTest, TakeFrontSpansRuns) {
+    RecordIdRunList list(makeRecordIds({1, 2, 3, 7, 8, 20}));
+
+    std::vector<RecordId> taken;
+    list.takeFront(4, &taken);
+    ASSERT(makeRecordIds({1, 2, 3, 7}) == taken);
+    ASSERT_EQ(2U, list.size());
+
+    // Putting the ids back restores the original runs
+    for (const auto& recordId : taken) {
+        list.insert(recordId);
+    }
+    ASSERT_EQ(3U, list.numRuns());
+
+    taken.clear();
+    list.takeFront(100, &taken);
+    ASSERT(makeRecordIds({1, 2, 3, 7, 8, 20}) == taken);
+}
+
+TEST(RecordIdRunListTest, SparseIdsTakeFewBytesPerRun) {
+    // With a hashed shard key the record ids of a chunk are scattered, so each id is its own run
+    const int64_t numIds = 100000;
+    std::vector<RecordId> recordIds;
+    for (int64_t i = 0; i < numIds; i++) {
+        recordIds.push_back(RecordId(i * 1000));
+    }
+
+    RecordIdRunList list(recordIds);
+    ASSERT_EQ(static_cast<size_t>(numIds), list.numRuns());
+    ASSERT_LT(list.memUsageBytes(), static_cast<size_t>(numIds * 8));
+
+    // Splitting every block keeps the list small
+    for (int64_t i = 0; i < numIds; i += 50) {
+        list.insert(RecordId(i * 1000 + 500));
+    }
+    ASSERT_LT(list.memUsageBytes(), static_cast<size_t>(numIds * 8));
+
+    ASSERT_EQ(static_cast<size_t>(numIds + numIds / 50), takeAll(&list).size());
+    ASSERT_LT(list.memUsageBytes(), 1024U);
+}
+
+void assertMatchesStdSet(int32_t maxRepr, int numOps) {
+    PseudoRandom random(1);
+    std::set<RecordId> expected;
+    RecordIdRunList list;
+
+    for (int i = 0; i < numOps; i++) {
+        const RecordId recordId(random.nextInt32(maxRepr));
+        if (random.nextInt32(3) == 0) {
+            expected.erase(recordId);
+            list.erase(recordId);
+        } else {
+            expected.insert(recordId);
+            list.insert(recordId);
+        }
+        ASSERT_EQ(expected.size(), list.size());
+    }
+
+    ASSERT(std::vector<RecordId>(expected.begin(), expected.end()) == takeAll(&list));
+}
+
+TEST(RecordIdRunListTest, MatchesStdSet) {
+    assertMatchesStdSet(500, 10000);
+}
+
+TEST(RecordIdRunListTest, MatchesStdSetAcrossManyBlocks) {
+    assertMatchesStdSet(100000, 100000);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -57,6 +57,20 @@ void ShardingStatistics::report(BSONObjBuilder* builder) const {
     builder->append("totalCriticalSectionCommitTimeMillis",
                     totalCriticalSectionCommitTimeMillis.load());
     builder->append("totalCriticalSectionTimeMillis", totalCriticalSectionTimeMillis.load());
+
+    const long long rangeDeleterDocs = countDocsDeletedByRangeDeleter.load();
+    const long long rangeDeleterMillis = totalRangeDeleterDeleteTimeMillis.load();
+    builder->append("countDocsDeletedByRangeDeleter", rangeDeleterDocs);
+    builder->append("totalRangeDeleterDeleteTimeMillis", rangeDeleterMillis);
+    builder->append("rangeDeleterDocsPerSec",
+                    rangeDeleterMillis > 0 ? rangeDeleterDocs * 1000 / rangeDeleterMillis : 0LL);
+    builder->append("countRangeDeleterPausesForReplicationLag",
+                    countRangeDeleterPausesForReplicationLag.load());
+    builder->append("countRangeDeleterPausesForStoragePressure",
+                    countRangeDeleterPausesForStoragePressure.load());
+    builder->append("countRangeDeleterPausesForForegroundLatency",
+                    countRangeDeleterPausesForForegroundLatency.load());
+    builder->append("totalRangeDeleterPauseTimeMillis", totalRangeDeleterPauseTimeMillis.load());
 }
 
 }  // namespace mongo
@@ -70,6 +70,19 @@ struct ShardingStatistics {
     // from the donor to the recipient).
     AtomicInt64 totalCriticalSectionTimeMillis{0};
 
+    // Cumulative, always-increasing counter of how many orphaned documents the range deleter
+    // removed and how much time it spent doing so (excluding pauses and replication waits)
+    AtomicInt64 countDocsDeletedByRangeDeleter{0};
+    AtomicInt64 totalRangeDeleterDeleteTimeMillis{0};
+
+    // Cumulative, always-increasing counters of how many times the range deleter paused between
+    // two passes to let the node catch up, broken down by the signal which caused the pause, and
+    // of how long these pauses lasted in total
+    AtomicInt64 countRangeDeleterPausesForReplicationLag{0};
+    AtomicInt64 countRangeDeleterPausesForStoragePressure{0};
+    AtomicInt64 countRangeDeleterPausesForForegroundLatency{0};
+    AtomicInt64 totalRangeDeleterPauseTimeMillis{0};
+
     /**
      * Obtains the per-process instance of the sharding statistics object.
      */
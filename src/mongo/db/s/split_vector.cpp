@@ -32,10 +32,13 @@
 
 #include "mongo/db/s/split_vector.h"
 
+#include <cmath>
+
 #include "mongo/base/status_with.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/catalog/catalog_raii.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/index/index_descriptor.h"
@@ -43,6 +46,9 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -50,10 +56,247 @@ namespace {
 
 const int kMaxObjectPerChunk{250000};
 
+// Largest error, as a fraction of the documents in the chunk, with which split points may be
+// estimated from a random sample of the chunk's shard keys instead of being found by an exact scan
+// of the shard key index. Zero disables sampling.
+MONGO_EXPORT_SERVER_PARAMETER(splitVectorSampleMaxError, double, 0.0);
+
+// Probability that the split points estimated from a sample are within the requested error
+const double kSampleConfidence = 0.99;
+
+// Sampling is not attempted if it would need more keys than this, because holding them would take
+// more memory than the exact scan is worth saving
+const long long kMaxSampledKeys = 10000;
+
+// The random cursor is not used if it would read more than this fraction of the collection, in the
+// same way as $sample
+const double kMaxSampleRatio = 0.05;
+
+// The random cursor gives up if this many documents have been read per sampled key needed, which
+// means that the chunk holds only a small part of the collection. It is not used at all for a chunk
+// which is expected to need more draws than this per key.
+const long long kMaxDrawsPerSampledKey = 8;
+
 BSONObj prettyKey(const BSONObj& keyPattern, const BSONObj& key) {
     return key.replaceFieldNames(keyPattern).clientReadable();
 }
 
+/**
+ * A uniform random sample of the shard keys of a chunk's documents.
+ */
+struct ChunkSample {
+    std::vector<BSONObj> keys;
+
+    // Number of the chunk's documents which each sampled key stands for
+    double docsPerKey;
+
+    // Number of documents or index keys read to draw the sample, for logging
+    long long numRead;
+};
+
+/**
+ * Estimates the fraction of the collection's documents on this shard which lie in one of its
+ * chunks, without reading any data. Splitting keeps chunks below the maximum chunk size, so the
+ * documents of a sharded collection are spread over the chunks the shard owns. The only chunk of
+ * the shard, or of an unsharded collection, holds all of them.
+ */
+double estimateChunkShare(OperationContext* opCtx, const NamespaceString& nss) {
+    auto metadata = CollectionShardingState::get(opCtx, nss)->getMetadata();
+    if (!metadata || metadata->getNumChunks() == 0) {
+        return 1.0;
+    }
+    return 1.0 / metadata->getNumChunks();
+}
+
+/**
+ * Samples the shard keys of the chunk [min, max) from documents picked by a random cursor over the
+ * collection, which does not need to read the whole chunk.
+ *
+ * Returns boost::none if the storage engine has no random cursor, or if the chunk holds too small
+ * a part of the collection for the draws to find enough of its documents.
+ */
+boost::optional<ChunkSample> sampleChunkWithRandomCursor(OperationContext* opCtx,
+                                                         Collection* collection,
+                                                         const BSONObj& keyPattern,
+                                                         const BSONObj& min,
+                                                         const BSONObj& max,
+                                                         long long recCount,
+                                                         long long numSampledKeysNeeded) {
+    // The index on a hashed shard key stores hashes, which are not present in the documents
+    if (KeyPattern::isHashedKeyPattern(keyPattern)) {
+        return boost::none;
+    }
+
+    if (numSampledKeysNeeded > recCount * kMaxSampleRatio) {
+        return boost::none;
+    }
+
+    // The random cursor draws from the whole collection, so a chunk which holds only a small part
+    // of it, like most chunks that are auto-split, is sampled from the shard key index instead.
+    const double chunkShare = estimateChunkShare(opCtx, collection->ns());
+    if (chunkShare * kMaxDrawsPerSampledKey < 1) {
+        LOG(1) << "not using a random cursor to sample chunk " << collection->ns() << " "
+               << redact(min) << " -->> " << redact(max)
+               << ", which is expected to hold a fraction " << chunkShare << " of the collection";
+        return boost::none;
+    }
+
+    auto cursor = collection->getRecordStore()->getRandomCursor(opCtx);
+    if (!cursor) {
+        return boost::none;
+    }
+
+    ChunkSample sample;
+    sample.keys.reserve(numSampledKeysNeeded);
+    sample.numRead = 0;
+
+    while (sample.keys.size() < static_cast<size_t>(numSampledKeysNeeded)) {
+        if (sample.numRead >= numSampledKeysNeeded * kMaxDrawsPerSampledKey) {
+            return boost::none;
+        }
+
+        auto record = cursor->next();
+        if (!record) {
+            return boost::none;
+        }
+        ++sample.numRead;
+
+        // Documents without some of the shard key fields are indexed under null for these fields
+        auto key = dotted_path_support::extractElementsBasedOnTemplate(
+            record->data.toBson(), keyPattern, true);
+        if (key.woCompare(min) < 0 || (!max.isEmpty() && key.woCompare(max) >= 0)) {
+            continue;
+        }
+
+        sample.keys.push_back(std::move(key));
+    }
+
+    // Each sampled document stands for recCount / numRead documents of the collection
+    sample.docsPerKey = double(recCount) / sample.numRead;
+    return sample;
+}
+
+/**
+ * Samples the shard keys of the chunk [minKey, maxKey) with a reservoir over the range of the
+ * shard key index. This reads every key in the range once, but only keeps 'numSampledKeysNeeded'
+ * of them, so unlike the exact scan it needs a single pass when forcing a split.
+ */
+StatusWith<ChunkSample> sampleChunkFromIndex(OperationContext* opCtx,
+                                             Collection* collection,
+                                             IndexDescriptor* idx,
+                                             const BSONObj& keyPattern,
+                                             const BSONObj& minKey,
+                                             const BSONObj& maxKey,
+                                             long long numSampledKeysNeeded) {
+    auto exec = InternalPlanner::indexScan(opCtx,
+                                           collection,
+                                           idx,
+                                           minKey,
+                                           maxKey,
+                                           BoundInclusion::kIncludeStartKeyOnly,
+                                           PlanExecutor::YIELD_AUTO,
+                                           InternalPlanner::FORWARD);
+
+    auto& prng = opCtx->getClient()->getPrng();
+
+    ChunkSample sample;
+    sample.keys.reserve(numSampledKeysNeeded);
+    sample.numRead = 0;
+
+    BSONObj currKey;
+    PlanExecutor::ExecState state;
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&currKey, NULL))) {
+        ++sample.numRead;
+
+        // Keep each of the keys read so far in the reservoir with equal probability
+        if (sample.keys.size() < static_cast<size_t>(numSampledKeysNeeded)) {
+            sample.keys.push_back(currKey.getOwned());
+        } else {
+            const long long pos = prng.nextInt64(sample.numRead);
+            if (pos < numSampledKeysNeeded) {
+                sample.keys[pos] = currKey.getOwned();
+            }
+        }
+    }
+
+    if (PlanExecutor::DEAD == state || PlanExecutor::FAILURE == state) {
+        return {ErrorCodes::OperationFailed,
+                "Executor error during splitVector command: " +
+                    WorkingSetCommon::toStatusString(currKey)};
+    }
+
+    for (auto& key : sample.keys) {
+        key = dotted_path_support::extractElementsBasedOnTemplate(
+            prettyKey(idx->keyPattern(), key), keyPattern);
+    }
+
+    sample.docsPerKey = sample.keys.empty() ? 1 : double(sample.numRead) / sample.keys.size();
+    return sample;
+}
+
+/**
+ * Estimates the split points of the chunk [min, max) from a random sample of its shard keys,
+ * drawn with a random cursor over the collection when the chunk holds enough of it, and from the
+ * shard key index otherwise.
+ *
+ * The number of sampled keys is chosen by the Dvoretzky-Kiefer-Wolfowitz inequality, so that the
+ * fraction of the chunk's documents below each estimated split point is within 'maxError' of the
+ * fraction below the exact one with probability kSampleConfidence.
+ *
+ * Returns boost::none if the split points cannot be estimated within these bounds, in which case
+ * the caller should fall back to the exact scan.
+ */
+StatusWith<boost::optional<std::vector<BSONObj>>> sampleSplitKeys(
+    OperationContext* opCtx,
+    Collection* collection,
+    IndexDescriptor* idx,
+    const BSONObj& keyPattern,
+    const BSONObj& min,
+    const BSONObj& max,
+    const BSONObj& minKey,
+    const BSONObj& maxKey,
+    long long recCount,
+    long long keyCount,
+    bool force,
+    boost::optional<long long> maxSplitPoints,
+    double maxError) {
+    const long long numSampledKeysNeeded = static_cast<long long>(
+        std::ceil(std::log(2 / (1 - kSampleConfidence)) / (2 * maxError * maxError)));
+    if (numSampledKeysNeeded > kMaxSampledKeys) {
+        return {boost::none};
+    }
+
+    auto sample = sampleChunkWithRandomCursor(
+        opCtx, collection, keyPattern, min, max, recCount, numSampledKeysNeeded);
+    if (!sample) {
+        auto swSample = sampleChunkFromIndex(
+            opCtx, collection, idx, keyPattern, minKey, maxKey, numSampledKeysNeeded);
+        if (!swSample.isOK()) {
+            return swSample.getStatus();
+        }
+        sample = std::move(swSample.getValue());
+    }
+
+    std::sort(sample->keys.begin(),
+              sample->keys.end(),
+              SimpleBSONObjComparator::kInstance.makeLessThan());
+
+    // Forcing a split picks the halfway point of the chunk
+    const double samplesPerChunk =
+        force ? sample->keys.size() / 2.0 : keyCount / sample->docsPerKey;
+    if (samplesPerChunk < 1) {
+        return {boost::none};
+    }
+
+    auto splitKeys = splitPointsFromSample(sample->keys, samplesPerChunk, maxSplitPoints);
+
+    log() << "estimated " << splitKeys.size() << " split points for chunk " << collection->ns()
+          << " " << redact(min) << " -->> " << redact(max) << " from " << sample->keys.size()
+          << " keys sampled out of " << sample->numRead << " read";
+
+    return {std::move(splitKeys)};
+}
+
 }  // namespace
 
 StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
@@ -151,6 +394,29 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
             keyCount = maxChunkObjects.get();
         }
 
+        const double maxSampleError = splitVectorSampleMaxError.load();
+        if (maxSampleError > 0) {
+            auto swSampledSplitKeys = sampleSplitKeys(opCtx,
+                                                      collection,
+                                                      idx,
+                                                      keyPattern,
+                                                      min,
+                                                      max,
+                                                      minKey,
+                                                      maxKey,
+                                                      recCount,
+                                                      keyCount,
+                                                      force,
+                                                      maxSplitPoints,
+                                                      std::min(maxSampleError, 0.5));
+            if (!swSampledSplitKeys.isOK()) {
+                return swSampledSplitKeys.getStatus();
+            }
+            if (swSampledSplitKeys.getValue()) {
+                return std::move(*swSampledSplitKeys.getValue());
+            }
+        }
+
         //
         // Traverse the index and add the keyCount-th key to the result vector. If that key
         // appeared in the vector before, we omit it. The invariant here is that all the
@@ -277,4 +543,41 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
     return splitKeys;
 }
 
+std::vector<BSONObj> splitPointsFromSample(const std::vector<BSONObj>& sortedSample,
+                                           double samplesPerChunk,
+                                           boost::optional<long long> maxSplitPoints) {
+    invariant(samplesPerChunk >= 1);
+
+    std::vector<BSONObj> splitKeys;
+    if (sortedSample.empty()) {
+        return splitKeys;
+    }
+
+    const BSONObj* lastKey = &sortedSample.front();
+    double nextPos = samplesPerChunk;
+
+    while (nextPos < sortedSample.size()) {
+        // Do not use a split key if it is the same as the previous one
+        size_t pos = static_cast<size_t>(nextPos);
+        while (pos < sortedSample.size() && sortedSample[pos].woCompare(*lastKey) == 0) {
+            ++pos;
+        }
+        if (pos == sortedSample.size()) {
+            break;
+        }
+
+        // Stop if we have enough split points
+        if (maxSplitPoints && maxSplitPoints.get() &&
+            static_cast<long long>(splitKeys.size()) >= maxSplitPoints.get()) {
+            break;
+        }
+
+        splitKeys.push_back(sortedSample[pos]);
+        lastKey = &sortedSample[pos];
+        nextPos = pos + samplesPerChunk;
+    }
+
+    return splitKeys;
+}
+
 }  // namespace mongo
@@ -54,6 +54,10 @@ class StatusWith;
  * be specified.
  * If force is set, split at the halfway point of the chunk. This also effectively
  * makes maxChunkSize equal the size of the chunk.
+ * If the splitVectorSampleMaxError server parameter is set, the split points are estimated from a
+ * random sample of the chunk's shard keys. The sample is drawn with a random cursor over the
+ * collection when the storage engine supports it and the chunk holds a large part of the
+ * collection, and with a reservoir over the chunk's range of the shard key index otherwise.
  */
 StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
                                              const NamespaceString& nss,
@@ -66,4 +70,16 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
                                              boost::optional<long long> maxChunkSize,
                                              boost::optional<long long> maxChunkSizeBytes);
 
+/**
+ * Picks split points from 'sortedSample', a sorted random sample of the shard keys in a chunk, so
+ * that each resulting chunk contains approximately 'samplesPerChunk' of the sampled keys. Like the
+ * exact index scan, never picks the first key of the sample and moves past keys which are equal to
+ * the previous split point, so that all instances of a key end up in the same chunk.
+ *
+ * If maxSplitPoints is specified, returns at most "maxSplitPoints" split points.
+ */
+std::vector<BSONObj> splitPointsFromSample(const std::vector<BSONObj>& sortedSample,
+                                           double samplesPerChunk,
+                                           boost::optional<long long> maxSplitPoints);
+
 }  // namespace mongo
@@ -33,8 +33,10 @@
 #include "mongo/db/s/split_vector.h"
 
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/shard_server_test_fixture.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -300,5 +302,114 @@ TEST_F(SplitVectorTest, NoMaxChunkSize) {
     ASSERT_EQUALS(status.code(), ErrorCodes::InvalidOptions);
 }
 
+TEST_F(SplitVectorTest, SampleHoldsWholeChunk) {
+    auto* param =
+        ServerParameterSet::getGlobal()->getMap().find("splitVectorSampleMaxError")->second;
+    ASSERT_OK(param->setFromString("0.1"));
+    ON_BLOCK_EXIT([&] { invariant(param->setFromString("0").isOK()); });
+
+    // The sample needed for this error is larger than the chunk, so it holds every key and the
+    // estimated split points are exact
+    std::vector<BSONObj> splitKeys = unittest::assertGet(splitVector(operationContext(),
+                                                                     kNss,
+                                                                     BSON(kPattern << 1),
+                                                                     BSON(kPattern << 0),
+                                                                     BSON(kPattern << 100),
+                                                                     false,
+                                                                     boost::none,
+                                                                     boost::none,
+                                                                     boost::none,
+                                                                     getDocSizeBytes() * 100LL));
+    ASSERT_EQ(1UL, splitKeys.size());
+    ASSERT_BSONOBJ_EQ(BSON(kPattern << 50), splitKeys.front());
+
+    splitKeys = unittest::assertGet(splitVector(operationContext(),
+                                                kNss,
+                                                BSON(kPattern << 1),
+                                                BSON(kPattern << 0),
+                                                BSON(kPattern << 100),
+                                                true,
+                                                boost::none,
+                                                boost::none,
+                                                boost::none,
+                                                boost::none));
+    ASSERT_EQ(1UL, splitKeys.size());
+    ASSERT_BSONOBJ_EQ(BSON(kPattern << 50), splitKeys.front());
+}
+
+TEST_F(SplitVectorTest, SampleChunkRange) {
+    DBDirectClient dbclient(operationContext());
+    std::vector<BSONObj> docs;
+    for (int i = 100; i < 10000; i++) {
+        docs.push_back(BSON(kPattern << i));
+    }
+    dbclient.insert(kNss.toString(), docs);
+    ASSERT_EQUALS(10000ULL, dbclient.count(kNss.toString()));
+
+    auto* param =
+        ServerParameterSet::getGlobal()->getMap().find("splitVectorSampleMaxError")->second;
+    ASSERT_OK(param->setFromString("0.05"));
+    ON_BLOCK_EXIT([&] { invariant(param->setFromString("0").isOK()); });
+
+    // About 1000 of the 2000 keys in the chunk are sampled. The estimated split point is within 5%
+    // of the chunk of the exact one, 3000, with probability 0.99, and the bounds asserted here are
+    // more than six standard deviations of the estimate away from it.
+    std::vector<BSONObj> splitKeys = unittest::assertGet(splitVector(operationContext(),
+                                                                     kNss,
+                                                                     BSON(kPattern << 1),
+                                                                     BSON(kPattern << 2000),
+                                                                     BSON(kPattern << 4000),
+                                                                     false,
+                                                                     boost::none,
+                                                                     boost::none,
+                                                                     boost::none,
+                                                                     getDocSizeBytes() * 2000LL));
+    ASSERT_EQ(1UL, splitKeys.size());
+    ASSERT_GTE(splitKeys.front()[kPattern].numberInt(), 2800);
+    ASSERT_LTE(splitKeys.front()[kPattern].numberInt(), 3200);
+}
+
+std::vector<BSONObj> makeSample(const std::vector<int>& keys) {
+    std::vector<BSONObj> sample;
+    for (int key : keys) {
+        sample.push_back(BSON(kPattern << key));
+    }
+    return sample;
+}
+
+std::vector<int> makeRange(int count) {
+    std::vector<int> keys;
+    for (int i = 0; i < count; i++) {
+        keys.push_back(i);
+    }
+    return keys;
+}
+
+void assertSplitKeys(const std::vector<int>& expected, const std::vector<BSONObj>& splitKeys) {
+    ASSERT_EQ(expected.size(), splitKeys.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        ASSERT_BSONOBJ_EQ(BSON(kPattern << expected[i]), splitKeys[i]);
+    }
+}
+
+TEST(SplitPointsFromSampleTest, EvenlySpaced) {
+    const auto sample = makeSample(makeRange(100));
+    assertSplitKeys({25, 50, 75}, splitPointsFromSample(sample, 25, boost::none));
+    assertSplitKeys({33, 66, 99}, splitPointsFromSample(sample, 33, boost::none));
+    assertSplitKeys({}, splitPointsFromSample(sample, 100, boost::none));
+}
+
+TEST(SplitPointsFromSampleTest, MaxSplitPoints) {
+    assertSplitKeys({25, 50}, splitPointsFromSample(makeSample(makeRange(100)), 25, 2LL));
+}
+
+TEST(SplitPointsFromSampleTest, SkipsRepeatedKeys) {
+    const auto sample = makeSample({0, 1, 1, 1, 1, 2, 3, 4});
+    assertSplitKeys({1, 2, 4}, splitPointsFromSample(sample, 2, boost::none));
+
+    // The first key of the sample is never a split point
+    assertSplitKeys({}, splitPointsFromSample(makeSample({5, 5, 5, 5}), 1, boost::none));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -53,6 +53,7 @@
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/logical_session_id_helpers.h"
 #include "mongo/db/logical_time_validator.h"
+#include "mongo/db/operation_trace.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/ops/write_ops_exec.h"
 #include "mongo/db/query/find.h"
@@ -69,6 +70,7 @@
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/stats/top.h"
+#include "mongo/db/ticket_priority.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/metadata.h"
@@ -81,6 +83,7 @@
 #include "mongo/rpc/reply_builder_interface.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/stale_exception.h"
+#include "mongo/util/cpu_sampling_profiler.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/message.h"
@@ -462,6 +465,8 @@ void execCommandDatabase(OperationContext* opCtx,
                          const OpMsgRequest& request,
                          rpc::ReplyBuilderInterface* replyBuilder,
                          const ServiceEntryPointCommon::Hooks& behaviors) {
+    // Commands are never destroyed, so their name can be used as the profiler tag.
+    CpuSamplingProfiler::ScopedTag profilerTag(command->getName().c_str());
 
     auto startOperationTime = getClientOperationTime(opCtx);
     try {
@@ -513,6 +518,7 @@ void execCommandDatabase(OperationContext* opCtx,
         BSONElement helpField;
         BSONElement shardVersionFieldIdx;
         BSONElement queryOptionMaxTimeMSField;
+        BSONElement priorityField;
 
         StringMap<int> topLevelFields;
         for (auto&& element : request.body) {
@@ -527,6 +533,8 @@ void execCommandDatabase(OperationContext* opCtx,
                 shardVersionFieldIdx = element;
             } else if (fieldName == QueryRequest::queryOptionMaxTimeMS) {
                 queryOptionMaxTimeMSField = element;
+            } else if (fieldName == kTicketPriorityFieldName) {
+                priorityField = element;
             }
 
             uassert(ErrorCodes::FailedToParse,
@@ -613,6 +621,14 @@ void execCommandDatabase(OperationContext* opCtx,
             opCtx->setDeadlineAfterNowBy(Milliseconds{maxTimeMS});
         }
 
+        // Handle command option priority. Commands run through DBDirectClient keep the priority of
+        // the operation which issued them.
+        if (!opCtx->getClient()->isInDirectClient()) {
+            const auto priority = uassertStatusOK(
+                resolveTicketPriority(opCtx, priorityField, command->getTicketPriority()));
+            setOperationTicketPriority(opCtx, priority);
+        }
+
         auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
         readConcernArgs = uassertStatusOK(_extractReadConcern(command, dbname, request.body));
 
@@ -824,7 +840,10 @@ DbResponse runCommands(OperationContext* opCtx,
         return {};  // Don't reply.
     }
 
-    auto response = replyBuilder->done();
+    auto response = [&] {
+        OperationTrace::Span span(opCtx, OperationTrace::Phase::kReplyBuild);
+        return replyBuilder->done();
+    }();
     CurOp::get(opCtx)->debug().responseLength = response.header().dataLen();
 
     // TODO exhaust
@@ -1076,6 +1095,11 @@ DbResponse ServiceEntryPointCommon::handleRequest(OperationContext* opCtx,
 
     OpDebug& debug = currentOp.debug();
 
+    // Operations run through DBDirectClient are part of the operation that issued them.
+    if (!c.isInDirectClient() && OperationTrace::shouldSample(&c.getPrng())) {
+        OperationTrace::get(opCtx).enable(opCtx->getServiceContext()->getTickSource());
+    }
+
     long long logThresholdMs = serverGlobalParams.slowMS;
     bool shouldLogOpDebug = shouldLog(logger::LogSeverity::Debug(1));
 
@@ -1138,6 +1162,10 @@ DbResponse ServiceEntryPointCommon::handleRequest(OperationContext* opCtx,
             durationCount<Microseconds>(currentOp.elapsedTimeExcludingPauses()),
             currentOp.getReadWriteType());
 
+    if (auto command = currentOp.getCommand()) {
+        command->recordLatency(debug.executionTimeMicros);
+    }
+
     const bool shouldSample = serverGlobalParams.sampleRate == 1.0
         ? true
         : c.getPrng().nextCanonicalDouble() < serverGlobalParams.sampleRate;
@@ -0,0 +1,198 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/latency_histogram.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+void storeMax(AtomicUInt64* maxValue, uint64_t value) {
+    uint64_t current = maxValue->loadRelaxed();
+    while (value > current) {
+        const uint64_t previous = maxValue->compareAndSwap(current, value);
+        if (previous == current) {
+            return;
+        }
+        current = previous;
+    }
+}
+
+}  // namespace
+
+constexpr int LatencyHistogram::kSubBucketBits;
+constexpr int LatencyHistogram::kSubBucketCount;
+constexpr int LatencyHistogram::kMaxExponent;
+constexpr int LatencyHistogram::kNumBuckets;
+
+int LatencyHistogram::getBucket(uint64_t micros) {
+    if (micros < static_cast<uint64_t>(kSubBucketCount)) {
+        return static_cast<int>(micros);
+    }
+
+    const int exponent = 63 - countLeadingZeros64(micros);
+    if (exponent > kMaxExponent) {
+        return kNumBuckets - 1;
+    }
+
+    // The top kSubBucketBits + 1 bits of the value select the bucket within its power of two.
+    const int subBucket = static_cast<int>(micros >> (exponent - kSubBucketBits)) - kSubBucketCount;
+    return (exponent - kSubBucketBits + 1) * kSubBucketCount + subBucket;
+}
+
+uint64_t LatencyHistogram::getBucketLowerBound(int bucket) {
+    if (bucket < kSubBucketCount) {
+        return static_cast<uint64_t>(bucket);
+    }
+
+    const int exponent = bucket / kSubBucketCount + kSubBucketBits - 1;
+    const uint64_t subBucket = bucket % kSubBucketCount;
+    return (kSubBucketCount + subBucket) << (exponent - kSubBucketBits);
+}
+
+void LatencyHistogram::record(uint64_t micros) {
+    _buckets[getBucket(micros)].fetchAndAdd(1);
+    _count.fetchAndAdd(1);
+    _totalMicros.fetchAndAdd(micros);
+    storeMax(&_maxMicros, micros);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < kNumBuckets; i++) {
+        const uint64_t count = other._buckets[i].loadRelaxed();
+        if (count) {
+            _buckets[i].fetchAndAdd(count);
+        }
+    }
+    _count.fetchAndAdd(other._count.loadRelaxed());
+    _totalMicros.fetchAndAdd(other._totalMicros.loadRelaxed());
+    storeMax(&_maxMicros, other._maxMicros.loadRelaxed());
+}
+
+uint64_t LatencyHistogram::getCount() const {
+    return _count.loadRelaxed();
+}
+
+uint64_t LatencyHistogram::getTotalMicros() const {
+    return _totalMicros.loadRelaxed();
+}
+
+uint64_t LatencyHistogram::getMaxMicros() const {
+    return _maxMicros.loadRelaxed();
+}
+
+uint64_t LatencyHistogram::_snapshot(Counts* counts) const {
+    uint64_t total = 0;
+    for (int i = 0; i < kNumBuckets; i++) {
+        (*counts)[i] = _buckets[i].loadRelaxed();
+        total += (*counts)[i];
+    }
+    return total;
+}
+
+uint64_t LatencyHistogram::_getPercentile(const Counts& counts,
+                                          uint64_t total,
+                                          uint64_t maxMicros,
+                                          double percentile) {
+    invariant(percentile > 0 && percentile <= 100);
+
+    if (total == 0) {
+        return 0;
+    }
+
+    // Round to the nearest rank, as HdrHistogram does, so that floating point error in the
+    // percentile does not push the rank past an exact boundary.
+    const uint64_t rank =
+        std::max<uint64_t>(1, static_cast<uint64_t>(total * (percentile / 100.0) + 0.5));
+
+    uint64_t seen = 0;
+    for (int i = 0; i < kNumBuckets; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            // Report the highest value the bucket can hold, but never more than was recorded. The
+            // last bucket has no upper bound.
+            if (i == kNumBuckets - 1) {
+                return maxMicros;
+            }
+            return std::min(getBucketLowerBound(i + 1) - 1, maxMicros);
+        }
+    }
+
+    return maxMicros;
+}
+
+uint64_t LatencyHistogram::getPercentile(double percentile) const {
+    Counts counts;
+    const uint64_t total = _snapshot(&counts);
+    return _getPercentile(counts, total, getMaxMicros(), percentile);
+}
+
+void LatencyHistogram::append(bool includeBuckets, BSONObjBuilder* builder) const {
+    // Work from a single snapshot of the buckets so that the percentiles agree with each other
+    // even if values are being recorded concurrently.
+    Counts counts;
+    const uint64_t total = _snapshot(&counts);
+    const uint64_t maxMicros = getMaxMicros();
+
+    builder->append("count", static_cast<long long>(getCount()));
+    builder->append("totalMicros", static_cast<long long>(getTotalMicros()));
+    builder->append("maxMicros", static_cast<long long>(maxMicros));
+    builder->append("p50", static_cast<long long>(_getPercentile(counts, total, maxMicros, 50)));
+    builder->append("p95", static_cast<long long>(_getPercentile(counts, total, maxMicros, 95)));
+    builder->append("p99", static_cast<long long>(_getPercentile(counts, total, maxMicros, 99)));
+    builder->append("p999",
+                    static_cast<long long>(_getPercentile(counts, total, maxMicros, 99.9)));
+
+    if (includeBuckets) {
+        BSONArrayBuilder arrayBuilder(builder->subarrayStart("buckets"));
+        for (int i = 0; i < kNumBuckets; i++) {
+            if (counts[i] == 0)
+                continue;
+            BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+            entryBuilder.append("micros", static_cast<long long>(getBucketLowerBound(i)));
+            entryBuilder.append("count", static_cast<long long>(counts[i]));
+            entryBuilder.doneFast();
+        }
+        arrayBuilder.doneFast();
+    }
+}
+
+BSONObj LatencyHistogram::getReport() const {
+    BSONObjBuilder builder;
+    append(false, &builder);
+    return builder.obj();
+}
+
+}  // namespace mongo
@@ -0,0 +1,138 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+/**
+ * A log-linear latency histogram in the style of HdrHistogram. Values below kSubBucketCount
+ * microseconds are counted exactly. Above that, every power of two is split into kSubBucketCount
+ * equally sized buckets, so the relative error of any reported value is bounded by
+ * 1 / kSubBucketCount regardless of magnitude. Values beyond 2^(kMaxExponent + 1) microseconds
+ * are counted in the last bucket.
+ *
+ * Recording is lock-free and safe to call concurrently from any thread. Readers see a consistent
+ * enough view for reporting, but a snapshot taken while values are being recorded may not
+ * include all of them.
+ *
+ * Histograms with the same bucket layout can be merged, which makes them suitable for
+ * aggregating per-thread or per-node data.
+ */
+class LatencyHistogram {
+    MONGO_DISALLOW_COPYING(LatencyHistogram);
+
+public:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr int kSubBucketCount = 1 << kSubBucketBits;
+    static constexpr int kMaxExponent = 36;
+    static constexpr int kNumBuckets = (kMaxExponent - kSubBucketBits + 2) * kSubBucketCount;
+
+    LatencyHistogram() = default;
+
+    /**
+     * Records a single latency value, in microseconds.
+     */
+    void record(uint64_t micros);
+
+    /**
+     * Adds the counts, total and maximum of 'other' to this histogram.
+     */
+    void merge(const LatencyHistogram& other);
+
+    /**
+     * Returns the number of recorded values.
+     */
+    uint64_t getCount() const;
+
+    /**
+     * Returns the sum of all recorded values, in microseconds.
+     */
+    uint64_t getTotalMicros() const;
+
+    /**
+     * Returns the largest recorded value, in microseconds.
+     */
+    uint64_t getMaxMicros() const;
+
+    /**
+     * Returns the smallest value such that at least 'percentile' percent of the recorded values
+     * are less than or equal to it, up to the precision of the bucket. Returns 0 if the histogram
+     * is empty. 'percentile' must be in the range (0, 100].
+     */
+    uint64_t getPercentile(double percentile) const;
+
+    /**
+     * Appends the count, total, maximum and the 50th, 95th, 99th and 99.9th percentiles. If
+     * 'includeBuckets' is true, also appends the lower bound and count of every non-empty bucket,
+     * which is enough to reconstruct and merge the histogram elsewhere.
+     */
+    void append(bool includeBuckets, BSONObjBuilder* builder) const;
+
+    BSONObj getReport() const;
+    operator BSONObj() const {
+        return getReport();
+    }
+
+    /**
+     * Returns the index of the bucket that counts 'micros'.
+     */
+    static int getBucket(uint64_t micros);
+
+    /**
+     * Returns the inclusive lower bound of the values counted in 'bucket'.
+     */
+    static uint64_t getBucketLowerBound(int bucket);
+
+private:
+    using Counts = std::array<uint64_t, kNumBuckets>;
+
+    /**
+     * Copies the bucket counts into 'counts' and returns their sum.
+     */
+    uint64_t _snapshot(Counts* counts) const;
+
+    static uint64_t _getPercentile(const Counts& counts,
+                                   uint64_t total,
+                                   uint64_t maxMicros,
+                                   double percentile);
+
+    std::array<AtomicUInt64, kNumBuckets> _buckets;
+    AtomicUInt64 _count;
+    AtomicUInt64 _totalMicros;
+    AtomicUInt64 _maxMicros;
+};
+
+}  // namespace mongo
@@ -0,0 +1,157 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/latency_histogram.h"
+
+#include <cstdint>
+#include <limits>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const int kNumBuckets = LatencyHistogram::kNumBuckets;
+const int kSubBucketCount = LatencyHistogram::kSubBucketCount;
+
+TEST(LatencyHistogram, BucketBoundsAreContiguous) {
+    ASSERT_EQUALS(LatencyHistogram::getBucketLowerBound(0), 0ULL);
+    for (int i = 1; i < kNumBuckets; i++) {
+        const uint64_t lowerBound = LatencyHistogram::getBucketLowerBound(i);
+        ASSERT_GREATER_THAN(lowerBound, LatencyHistogram::getBucketLowerBound(i - 1));
+        ASSERT_EQUALS(LatencyHistogram::getBucket(lowerBound), i);
+        ASSERT_EQUALS(LatencyHistogram::getBucket(lowerBound - 1), i - 1);
+    }
+}
+
+TEST(LatencyHistogram, RelativeErrorIsBounded) {
+    for (uint64_t value = kSubBucketCount; value < (1ULL << 30); value = value * 3 / 2) {
+        const int bucket = LatencyHistogram::getBucket(value);
+        const uint64_t lowerBound = LatencyHistogram::getBucketLowerBound(bucket);
+        const uint64_t upperBound = LatencyHistogram::getBucketLowerBound(bucket + 1);
+        ASSERT_LESS_THAN_OR_EQUALS(lowerBound, value);
+        ASSERT_GREATER_THAN(upperBound, value);
+        ASSERT_LESS_THAN_OR_EQUALS((upperBound - lowerBound) * kSubBucketCount, lowerBound);
+    }
+}
+
+TEST(LatencyHistogram, LargeValuesAreClamped) {
+    ASSERT_EQUALS(LatencyHistogram::getBucket(std::numeric_limits<uint64_t>::max()),
+                  kNumBuckets - 1);
+
+    LatencyHistogram hist;
+    hist.record(std::numeric_limits<uint32_t>::max() * 1000ULL);
+    ASSERT_EQUALS(hist.getPercentile(100), std::numeric_limits<uint32_t>::max() * 1000ULL);
+}
+
+TEST(LatencyHistogram, EmptyHistogramReportsZero) {
+    LatencyHistogram hist;
+    ASSERT_EQUALS(hist.getCount(), 0ULL);
+    ASSERT_EQUALS(hist.getPercentile(50), 0ULL);
+    ASSERT_EQUALS(hist.getPercentile(99.9), 0ULL);
+}
+
+TEST(LatencyHistogram, PercentilesOfUniformDistribution) {
+    LatencyHistogram hist;
+    for (uint64_t i = 1; i <= 10000; i++) {
+        hist.record(i);
+    }
+
+    ASSERT_EQUALS(hist.getCount(), 10000ULL);
+    ASSERT_EQUALS(hist.getTotalMicros(), 10000ULL * 10001 / 2);
+    ASSERT_EQUALS(hist.getMaxMicros(), 10000ULL);
+
+    // Every percentile is reported as the upper bound of its bucket, which is never below the
+    // exact value and never above it by more than the bucket width.
+    for (double percentile : {50.0, 95.0, 99.0, 99.9}) {
+        const uint64_t exact = static_cast<uint64_t>(percentile * 100);
+        const uint64_t reported = hist.getPercentile(percentile);
+        ASSERT_GREATER_THAN_OR_EQUALS(reported, exact);
+        ASSERT_LESS_THAN_OR_EQUALS(reported, exact + exact / kSubBucketCount);
+    }
+    ASSERT_EQUALS(hist.getPercentile(100), 10000ULL);
+}
+
+TEST(LatencyHistogram, PercentileFindsOutlier) {
+    LatencyHistogram hist;
+    for (int i = 0; i < 999; i++) {
+        hist.record(100);
+    }
+    hist.record(1000000);
+
+    ASSERT_LESS_THAN(hist.getPercentile(99.9), 110ULL);
+    ASSERT_EQUALS(hist.getPercentile(100), 1000000ULL);
+}
+
+TEST(LatencyHistogram, MergeMatchesRecordingIntoOne) {
+    LatencyHistogram first, second, combined;
+    for (uint64_t i = 0; i < 5000; i++) {
+        first.record(i * 7);
+        combined.record(i * 7);
+        second.record(i * 13 + 1000);
+        combined.record(i * 13 + 1000);
+    }
+
+    first.merge(second);
+
+    BSONObjBuilder mergedBuilder, combinedBuilder;
+    first.append(true, &mergedBuilder);
+    combined.append(true, &combinedBuilder);
+    ASSERT_BSONOBJ_EQ(mergedBuilder.obj(), combinedBuilder.obj());
+}
+
+TEST(LatencyHistogram, AppendIncludesBucketsOnRequest) {
+    LatencyHistogram hist;
+    hist.record(3);
+    hist.record(3);
+    hist.record(100);
+
+    BSONObj report = hist.getReport();
+    ASSERT_EQUALS(report["count"].Long(), 3);
+    ASSERT_EQUALS(report["totalMicros"].Long(), 106);
+    ASSERT_EQUALS(report["maxMicros"].Long(), 100);
+    ASSERT_EQUALS(report["p50"].Long(), 3);
+    ASSERT_FALSE(report.hasField("buckets"));
+
+    BSONObjBuilder builder;
+    hist.append(true, &builder);
+    std::vector<BSONElement> buckets = builder.obj()["buckets"].Array();
+    ASSERT_EQUALS(buckets.size(), 2U);
+    ASSERT_EQUALS(buckets[0]["micros"].Long(), 3);
+    ASSERT_EQUALS(buckets[0]["count"].Long(), 2);
+    ASSERT_EQUALS(buckets[1]["micros"].Long(),
+                  static_cast<long long>(
+                      LatencyHistogram::getBucketLowerBound(LatencyHistogram::getBucket(100))));
+    ASSERT_EQUALS(buckets[1]["count"].Long(), 1);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -91,6 +91,12 @@ public:
             activeClientsBuilder.done();
         }
 
+        {
+            BSONObjBuilder waitLatencyBuilder(ret.subobjStart("waitLatency"));
+            reportGlobalLockWaitLatency(&waitLatencyBuilder);
+            waitLatencyBuilder.done();
+        }
+
         ret.done();
 
         return ret.obj();
@@ -89,4 +89,26 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatency) {
         ASSERT_EQUALS(bucket["count"].Long(), (i < kMaxBuckets - 1) ? 3 : 2);
     }
 }
+
+TEST(OperationLatencyHistogram, MergeAddsCountsAndLatency) {
+    OperationLatencyHistogram hist1, hist2;
+    hist1.increment(kLowerBounds[1], Command::ReadWriteType::kRead);
+    hist1.increment(kLowerBounds[5], Command::ReadWriteType::kWrite);
+    hist2.increment(kLowerBounds[1], Command::ReadWriteType::kRead);
+    hist2.increment(kLowerBounds[3], Command::ReadWriteType::kCommand);
+
+    hist1.merge(hist2);
+
+    BSONObjBuilder outBuilder;
+    hist1.append(true, &outBuilder);
+    BSONObj out = outBuilder.done();
+    ASSERT_EQUALS(out["reads"]["ops"].Long(), 2);
+    ASSERT_EQUALS(static_cast<uint64_t>(out["reads"]["latency"].Long()), 2 * kLowerBounds[1]);
+    std::vector<BSONElement> readBuckets = out["reads"]["histogram"].Array();
+    ASSERT_EQUALS(readBuckets.size(), 1U);
+    ASSERT_EQUALS(readBuckets[0].Obj()["count"].Long(), 2);
+    ASSERT_EQUALS(out["writes"]["ops"].Long(), 1);
+    ASSERT_EQUALS(out["commands"]["ops"].Long(), 1);
+    ASSERT_EQUALS(static_cast<uint64_t>(out["commands"]["latency"].Long()), kLowerBounds[3]);
+}
 }  // namespace mongo
@@ -50,6 +50,9 @@ const auto getTop = ServiceContext::declareDecoration<Top>();
 
 }  // namespace
 
+Top::Top()
+    : _usagePartitions(kNumUsagePartitions), _globalHistogramStripes(kNumHistogramStripes) {}
+
 Top::UsageData::UsageData(const UsageData& older, const UsageData& newer) {
     // this won't be 100% accurate on rollovers and drop(), but at least it won't be negative
     time = (newer.time >= older.time) ? (newer.time - older.time) : newer.time;
@@ -83,17 +86,24 @@ void Top::record(OperationContext* opCtx,
         return;
 
     auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    UsagePartition& partition = _getUsagePartition(hashedNs);
+    stdx::lock_guard<SimpleMutex> lk(partition.lock);
 
-    if ((command || logicalOp == LogicalOp::opQuery) && ns == _lastDropped) {
-        _lastDropped = "";
+    if ((command || logicalOp == LogicalOp::opQuery) && ns == partition.lastDropped) {
+        partition.lastDropped = "";
         return;
     }
 
-    CollectionData& coll = _usage[hashedNs];
+    CollectionData& coll = partition.usage[hashedNs];
     _record(opCtx, coll, logicalOp, lockType, micros, readWriteType);
 }
 
+Top::UsagePartition& Top::_getUsagePartition(const UsageMap::HashedKey& hashedNs) {
+    // The UsageMap picks its buckets from the low bits of the hash, so use the high ones here in
+    // order not to leave most of each partition's buckets empty
+    return _usagePartitions[(hashedNs.hash() >> 16) % kNumUsagePartitions];
+}
+
 void Top::_record(OperationContext* opCtx,
                   CollectionData& c,
                   LogicalOp logicalOp,
@@ -140,23 +150,33 @@ void Top::_record(OperationContext* opCtx,
 }
 
 void Top::collectionDropped(StringData ns, bool databaseDropped) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _usage.erase(ns);
+    auto hashedNs = UsageMap::HashedKey(ns);
+    UsagePartition& partition = _getUsagePartition(hashedNs);
+    stdx::lock_guard<SimpleMutex> lk(partition.lock);
+    partition.usage.erase(hashedNs);
     if (!databaseDropped) {
         // If a collection drop occurred, there will be a subsequent call to record for this
         // collection namespace which must be ignored. This does not apply to a database drop.
-        _lastDropped = ns.toString();
+        partition.lastDropped = ns.toString();
     }
 }
 
 void Top::cloneMap(Top::UsageMap& out) const {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    out = _usage;
+    out.clear();
+
+    // Each namespace lives in exactly one partition, so there is nothing to merge
+    for (const auto& partition : _usagePartitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.lock);
+        for (const auto& entry : partition.usage) {
+            out[entry.first] = entry.second;
+        }
+    }
 }
 
 void Top::append(BSONObjBuilder& b) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _appendToUsageMap(b, _usage);
+    UsageMap usage;
+    cloneMap(usage);
+    _appendToUsageMap(b, usage);
 }
 
 void Top::_appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const {
@@ -199,9 +219,10 @@ void Top::_appendStatsEntry(BSONObjBuilder& b, const char* statsName, const Usag
 
 void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuilder* builder) {
     auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    UsagePartition& partition = _getUsagePartition(hashedNs);
+    stdx::lock_guard<SimpleMutex> lk(partition.lock);
     BSONObjBuilder latencyStatsBuilder;
-    _usage[hashedNs].opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+    partition.usage[hashedNs].opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
     builder->append("ns", ns);
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
@@ -209,13 +230,18 @@ void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuild
 void Top::incrementGlobalLatencyStats(OperationContext* opCtx,
                                       uint64_t latency,
                                       Command::ReadWriteType readWriteType) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _incrementHistogram(opCtx, latency, &_globalHistogramStats, readWriteType);
+    HistogramStripe& stripe = _globalHistogramStripes[opCtx->getOpID() % kNumHistogramStripes];
+    stdx::lock_guard<SimpleMutex> guard(stripe.lock);
+    _incrementHistogram(opCtx, latency, &stripe.histogram, readWriteType);
 }
 
 void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.append(includeHistograms, builder);
+    OperationLatencyHistogram globalHistogramStats;
+    for (auto& stripe : _globalHistogramStripes) {
+        stdx::lock_guard<SimpleMutex> guard(stripe.lock);
+        globalHistogramStats.merge(stripe.histogram);
+    }
+    globalHistogramStats.append(includeHistograms, builder);
 }
 
 void Top::_incrementHistogram(OperationContext* opCtx,
@@ -29,11 +29,14 @@
 
 #pragma once
 
+#include <boost/align/aligned_allocator.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <vector>
 
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/stdx/new.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/string_map.h"
@@ -44,12 +47,15 @@ class ServiceContext;
 
 /**
  * tracks usage by collection
+ *
+ * Usage is partitioned by namespace and the global latency histogram is striped by operation, so
+ * that concurrent operations do not serialize on a single mutex. Readers merge the partitions.
  */
 class Top {
 public:
     static Top& get(ServiceContext* service);
 
-    Top() = default;
+    Top();
 
     struct UsageData {
         UsageData() : time(0), count(0) {}
@@ -125,6 +131,31 @@ public:
     void appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder);
 
 private:
+    static const size_t kNumUsagePartitions = 16;
+    static const size_t kNumHistogramStripes = 16;
+
+    template <typename T>
+    using AlignedVector = std::vector<T, boost::alignment::aligned_allocator<T>>;
+
+    // Holds the usage of all namespaces, which hash to this partition. Each partition and stripe
+    // starts on its own cache line, so that the mutexes of neighbouring ones do not share it. They
+    // live in heap allocated AlignedVectors, because Top itself is a ServiceContext decoration and
+    // decorations only get the alignment of max_align_t.
+    struct alignas(stdx::hardware_destructive_interference_size) UsagePartition {
+        mutable SimpleMutex lock;
+        UsageMap usage;
+
+        // Namespace of the last collection in this partition, which was dropped
+        std::string lastDropped;
+    };
+
+    struct alignas(stdx::hardware_destructive_interference_size) HistogramStripe {
+        SimpleMutex lock;
+        OperationLatencyHistogram histogram;
+    };
+
+    UsagePartition& _getUsagePartition(const UsageMap::HashedKey& hashedNs);
+
     void _appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const;
 
     void _appendStatsEntry(BSONObjBuilder& b, const char* statsName, const UsageData& map) const;
@@ -141,10 +172,8 @@ private:
                              OperationLatencyHistogram* histogram,
                              Command::ReadWriteType readWriteType);
 
-    mutable SimpleMutex _lock;
-    OperationLatencyHistogram _globalHistogramStats;
-    UsageMap _usage;
-    std::string _lastDropped;
+    AlignedVector<UsagePartition> _usagePartitions;
+    AlignedVector<HistogramStripe> _globalHistogramStripes;
 };
 
 }  // namespace mongo
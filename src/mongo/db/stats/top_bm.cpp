@@ -0,0 +1,89 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/service_context_noop.h"
+#include "mongo/db/stats/top.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/processinfo.h"
+
+namespace mongo {
+namespace {
+
+ServiceContext* getServiceContext() {
+    static ServiceContextNoop serviceContext;
+    return &serviceContext;
+}
+
+/**
+ * Records an operation in Top and in the global latency histogram, as every command does once it
+ * completes. The argument is the number of collections the operations are spread over.
+ *
+ * All threads share the same Top, in order to measure how well recording scales with the number of
+ * concurrent operations.
+ */
+void BM_TopRecord(benchmark::State& state) {
+    static Top top;
+
+    std::vector<std::string> namespaces;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        namespaces.push_back(str::stream() << "test.coll" << i);
+    }
+
+    auto client =
+        getServiceContext()->makeClient(str::stream() << "topBenchmark" << state.thread_index);
+    auto opCtx = client->makeOperationContext();
+
+    size_t i = state.thread_index;
+    for (auto _ : state) {
+        top.record(opCtx.get(),
+                   namespaces[i++ % namespaces.size()],
+                   LogicalOp::opQuery,
+                   Top::LockType::ReadLocked,
+                   100,
+                   false,
+                   Command::ReadWriteType::kRead);
+        top.incrementGlobalLatencyStats(opCtx.get(), 100, Command::ReadWriteType::kRead);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_TopRecord)
+    ->ThreadRange(1,
+                  [] {
+                      ProcessInfo pi;
+                      return static_cast<int>(pi.getNumAvailableCores().value_or(pi.getNumCores()));
+                  }())
+    ->Arg(1)
+    ->Arg(1000);
+
+}  // namespace
+}  // namespace mongo
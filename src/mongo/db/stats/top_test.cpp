@@ -29,6 +29,8 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/stats/top.h"
+
+#include "mongo/db/service_context_noop.h"
 #include "mongo/unittest/unittest.h"
 
 namespace {
@@ -39,4 +41,66 @@ TEST(TopTest, CollectionDropped) {
     Top().collectionDropped("coll");
 }
 
+TEST(TopTest, CloneMapIncludesAllNamespaces) {
+    ServiceContextNoop serviceContext;
+    auto client = serviceContext.makeClient("topTest");
+    auto opCtx = client->makeOperationContext();
+
+    Top top;
+    const int kNumCollections = 100;
+    for (int i = 0; i < kNumCollections; i++) {
+        const std::string ns = str::stream() << "test.coll" << i;
+        for (int j = 0; j <= i % 3; j++) {
+            top.record(opCtx.get(),
+                       ns,
+                       LogicalOp::opInsert,
+                       Top::LockType::WriteLocked,
+                       10,
+                       false,
+                       Command::ReadWriteType::kWrite);
+        }
+    }
+
+    Top::UsageMap usage;
+    top.cloneMap(usage);
+    ASSERT_EQ(static_cast<size_t>(kNumCollections), usage.size());
+    for (int i = 0; i < kNumCollections; i++) {
+        const std::string ns = str::stream() << "test.coll" << i;
+        const Top::CollectionData& coll = usage.find(ns)->second;
+        ASSERT_EQ(i % 3 + 1, coll.insert.count);
+        ASSERT_EQ(10 * (i % 3 + 1), coll.writeLock.time);
+    }
+
+    BSONObjBuilder builder;
+    top.append(builder);
+    ASSERT_EQ(kNumCollections, builder.obj().nFields());
+}
+
+TEST(TopTest, RecordAfterCollectionDroppedIsIgnored) {
+    ServiceContextNoop serviceContext;
+    auto client = serviceContext.makeClient("topTest");
+    auto opCtx = client->makeOperationContext();
+
+    Top top;
+    top.record(opCtx.get(),
+               "test.coll",
+               LogicalOp::opInsert,
+               Top::LockType::WriteLocked,
+               10,
+               false,
+               Command::ReadWriteType::kWrite);
+    top.collectionDropped("test.coll");
+    top.record(opCtx.get(),
+               "test.coll",
+               LogicalOp::opCommand,
+               Top::LockType::WriteLocked,
+               10,
+               true,
+               Command::ReadWriteType::kCommand);
+
+    Top::UsageMap usage;
+    top.cloneMap(usage);
+    ASSERT_EQ(0U, usage.size());
+}
+
 }  // namespace
@@ -282,6 +282,13 @@ public:
         return false;
     }
 
+    /**
+     * See `StorageEngine::isCacheUnderPressure`
+     */
+    virtual bool isCacheUnderPressure(OperationContext* opCtx) const {
+        return false;
+    }
+
     /**
      * See `StorageEngine::replicationBatchIsComplete()`
      */
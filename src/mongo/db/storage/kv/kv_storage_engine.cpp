@@ -583,6 +583,10 @@ bool KVStorageEngine::supportsReadConcernSnapshot() const {
     return _engine->supportsReadConcernSnapshot();
 }
 
+bool KVStorageEngine::isCacheUnderPressure(OperationContext* opCtx) const {
+    return _engine->isCacheUnderPressure(opCtx);
+}
+
 void KVStorageEngine::replicationBatchIsComplete() const {
     return _engine->replicationBatchIsComplete();
 }
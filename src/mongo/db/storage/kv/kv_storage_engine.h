@@ -125,6 +125,8 @@ public:
 
     bool supportsReadConcernSnapshot() const final;
 
+    bool isCacheUnderPressure(OperationContext* opCtx) const final;
+
     virtual void replicationBatchIsComplete() const override;
 
     SnapshotManager* getSnapshotManager() const final;
@@ -314,6 +314,15 @@ public:
         return false;
     }
 
+    /**
+     * Returns true if the storage engine's cache is full or dirty enough that writes have to help
+     * with evicting data from it. Background work, such as deleting orphaned documents, should
+     * back off while this is the case.
+     */
+    virtual bool isCacheUnderPressure(OperationContext* opCtx) const {
+        return false;
+    }
+
     /**
      * Recovers the storage engine state to the last stable timestamp. "Stable" in this case
      * refers to a timestamp that is guaranteed to never be rolled back. The stable timestamp
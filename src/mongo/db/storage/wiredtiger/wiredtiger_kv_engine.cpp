@@ -74,6 +74,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/background.h"
+#include "mongo/util/concurrency/adaptive_ticket_controller.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/exit.h"
@@ -302,11 +303,24 @@ public:
             return Status(ErrorCodes::BadValue, str::stream() << name() << " has to be > 0");
         }
 
-        return _holder->resize(newNum);
+        Status status = _holder->resize(newNum);
+        if (status.isOK()) {
+            _pinned.store(true);
+        }
+        return status;
+    }
+
+    /**
+     * Returns true if the number of tickets was set explicitly, in which case it is no longer
+     * adjusted automatically.
+     */
+    bool isPinned() const {
+        return _pinned.load();
     }
 
 private:
     TicketHolder* _holder;
+    AtomicBool _pinned{false};
 };
 
 TicketHolder openWriteTransaction(128);
@@ -317,11 +331,123 @@ TicketHolder openReadTransaction(128);
 TicketServerParameter openReadTransactionParam(&openReadTransaction,
                                                "wiredTigerConcurrentReadTransactions");
 
+// When enabled, resizes the pools above unless they have been pinned by setting the parameters
+// explicitly.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrentTransactions, bool, false);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerAdaptiveConcurrentTransactionsMin, int, 16);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerAdaptiveConcurrentTransactionsMax, int, 512);
+
+// Created by the first engine which is not read-only and reported in serverStatus.
+std::unique_ptr<AdaptiveTicketController> writeTicketController;
+std::unique_ptr<AdaptiveTicketController> readTicketController;
+
+void appendTicketStats(const TicketHolder& holder,
+                       const TicketServerParameter& param,
+                       const AdaptiveTicketController* controller,
+                       BSONObjBuilder* builder) {
+    builder->append("out", holder.used());
+    builder->append("available", holder.available());
+    builder->append("totalTickets", holder.outof());
+    {
+        BSONObjBuilder queues(builder->subobjStart("queues"));
+        holder.appendQueueStats(&queues);
+    }
+    if (controller) {
+        BSONObjBuilder adaptive(builder->subobjStart("adaptive"));
+        adaptive.append("enabled",
+                        wiredTigerAdaptiveConcurrentTransactions.load() && !param.isPinned());
+        controller->append(&adaptive);
+    }
+}
+
+// WiredTiger's default eviction_trigger and eviction_dirty_trigger.
+const int64_t kCacheUsedTriggerPercent = 95;
+const int64_t kCacheDirtyTriggerPercent = 20;
+
+/**
+ * Returns whether the WiredTiger cache is full enough, or dirty enough, for application threads to
+ * be drafted into eviction.
+ */
+bool isWiredTigerCacheUnderPressure(WiredTigerSessionCache* sessionCache) {
+    UniqueWiredTigerSession session = sessionCache->getSession();
+    WT_SESSION* s = session->getSession();
+
+    auto getStat = [&](int key) -> int64_t {
+        auto result = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+            s, "statistics:", "statistics=(fast)", key);
+        return result.isOK() ? result.getValue() : 0;
+    };
+
+    const int64_t max = getStat(WT_STAT_CONN_CACHE_BYTES_MAX);
+    if (max <= 0) {
+        return false;
+    }
+    return getStat(WT_STAT_CONN_CACHE_BYTES_INUSE) * 100 >= max * kCacheUsedTriggerPercent ||
+        getStat(WT_STAT_CONN_CACHE_BYTES_DIRTY) * 100 >= max * kCacheDirtyTriggerPercent;
+}
+
 stdx::function<bool(StringData)> initRsOplogBackgroundThreadCallback = [](StringData) -> bool {
     fassertFailed(40358);
 };
 }  // namespace
 
+/**
+ * Resizes the read and write ticket pools once a second. Once the WiredTiger cache is under
+ * pressure, admitting more operations only adds to the contention.
+ */
+class WiredTigerKVEngine::WiredTigerTicketAdjuster : public BackgroundJob {
+public:
+    explicit WiredTigerTicketAdjuster(WiredTigerSessionCache* sessionCache)
+        : BackgroundJob(false /* deleteSelf */), _sessionCache(sessionCache) {}
+
+    virtual string name() const {
+        return "WTTicketAdjuster";
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+
+        LOG(1) << "starting " << name() << " thread";
+
+        while (!_shuttingDown.load()) {
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(lock, stdx::chrono::seconds(1));
+            }
+
+            if (_shuttingDown.load() || !wiredTigerAdaptiveConcurrentTransactions.load()) {
+                continue;
+            }
+
+            try {
+                const bool underPressure = isWiredTigerCacheUnderPressure(_sessionCache);
+                if (!openWriteTransactionParam.isPinned()) {
+                    writeTicketController->adjust(underPressure);
+                }
+                if (!openReadTransactionParam.isPinned()) {
+                    readTicketController->adjust(underPressure);
+                }
+            } catch (const AssertionException& exc) {
+                invariant(exc.code() == ErrorCodes::ShutdownInProgress);
+            }
+        }
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        _condvar.notify_one();
+        wait();
+    }
+
+private:
+    WiredTigerSessionCache* _sessionCache;
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    AtomicBool _shuttingDown{false};
+};
+
 WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
                                        const std::string& path,
                                        ClockSource* cs,
@@ -434,6 +560,21 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
         _checkpointThread->go();
     }
 
+    if (!_readOnly) {
+        if (!writeTicketController) {
+            AdaptiveTicketController::Options options;
+            options.minTickets = std::max(5, wiredTigerAdaptiveConcurrentTransactionsMin);
+            options.maxTickets =
+                std::max(options.minTickets, wiredTigerAdaptiveConcurrentTransactionsMax);
+            writeTicketController =
+                stdx::make_unique<AdaptiveTicketController>(&openWriteTransaction, options);
+            readTicketController =
+                stdx::make_unique<AdaptiveTicketController>(&openReadTransaction, options);
+        }
+        _ticketAdjuster = stdx::make_unique<WiredTigerTicketAdjuster>(_sessionCache.get());
+        _ticketAdjuster->go();
+    }
+
     _sizeStorerUri = "table:sizeStorer";
     WiredTigerSession session(_conn);
     if (!_readOnly && repair && _hasUri(session.getSession(), _sizeStorerUri)) {
@@ -462,16 +603,14 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
     BSONObjBuilder bb(b.subobjStart("concurrentTransactions"));
     {
         BSONObjBuilder bbb(bb.subobjStart("write"));
-        bbb.append("out", openWriteTransaction.used());
-        bbb.append("available", openWriteTransaction.available());
-        bbb.append("totalTickets", openWriteTransaction.outof());
+        appendTicketStats(
+            openWriteTransaction, openWriteTransactionParam, writeTicketController.get(), &bbb);
         bbb.done();
     }
     {
         BSONObjBuilder bbb(bb.subobjStart("read"));
-        bbb.append("out", openReadTransaction.used());
-        bbb.append("available", openReadTransaction.available());
-        bbb.append("totalTickets", openReadTransaction.outof());
+        appendTicketStats(
+            openReadTransaction, openReadTransactionParam, readTicketController.get(), &bbb);
         bbb.done();
     }
     bb.done();
@@ -487,6 +626,8 @@ void WiredTigerKVEngine::cleanShutdown() {
             _journalFlusher->shutdown();
         if (_checkpointThread)
             _checkpointThread->shutdown();
+        if (_ticketAdjuster)
+            _ticketAdjuster->shutdown();
         _sizeStorer.reset();
         _sessionCache->shuttingDown();
 
@@ -1178,6 +1319,10 @@ bool WiredTigerKVEngine::supportsReadConcernSnapshot() const {
     return true;
 }
 
+bool WiredTigerKVEngine::isCacheUnderPressure(OperationContext* opCtx) const {
+    return isWiredTigerCacheUnderPressure(_sessionCache.get());
+}
+
 void WiredTigerKVEngine::startOplogManager(OperationContext* opCtx,
                                            const std::string& uri,
                                            WiredTigerRecordStore* oplogRecordStore) {
@@ -184,6 +184,8 @@ public:
 
     bool supportsReadConcernSnapshot() const final;
 
+    bool isCacheUnderPressure(OperationContext* opCtx) const final;
+
     // wiredtiger specific
     // Calls WT_CONNECTION::reconfigure on the underlying WT_CONNECTION
     // held by this class
@@ -253,6 +255,7 @@ public:
 private:
     class WiredTigerJournalFlusher;
     class WiredTigerCheckpointThread;
+    class WiredTigerTicketAdjuster;
 
     Status _salvageIfNeeded(const char* uri);
     void _checkIdentPath(StringData ident);
@@ -293,6 +296,7 @@ private:
     bool _readOnly;
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
     std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerTicketAdjuster> _ticketAdjuster;
 
     std::string _rsOptions;
     std::string _indexOptions;
@@ -35,12 +35,15 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/stats/latency_histogram.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/util/hex.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -50,6 +53,11 @@ namespace {
 AtomicUInt64 nextSnapshotId{1};
 
 logger::LogSeverity kSlowTransactionSeverity = logger::LogSeverity::Debug(1);
+
+// Time spent in WT_SESSION::commit_transaction for write units of work.
+LatencyHistogram commitLatency;
+ServerStatusMetricField<LatencyHistogram> displayCommitLatency("storage.wiredTiger.commitLatency",
+                                                               &commitLatency);
 }  // namespace
 
 WiredTigerRecoveryUnit::WiredTigerRecoveryUnit(WiredTigerSessionCache* sc)
@@ -208,7 +216,9 @@ void WiredTigerRecoveryUnit::_txnClose(bool commit) {
             _isTimestamped = true;
         }
 
+        Timer commitTimer;
         wtRet = s->commit_transaction(s, NULL);
+        commitLatency.record(commitTimer.micros());
         LOG(3) << "WT commit_transaction for snapshot id " << _mySnapshotId;
     } else {
         wtRet = s->rollback_transaction(s, NULL);
@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ticket_priority.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/locker.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/rpc/metadata/client_metadata_ismaster.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+// Commands from clients with one of these application names queue for tickets at low priority.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(lowPriorityAppNames, std::vector<std::string>, {});
+
+const auto getTicketPriority = OperationContext::declareDecoration<TicketHolder::Priority>();
+
+}  // namespace
+
+StatusWith<TicketHolder::Priority> resolveTicketPriority(OperationContext* opCtx,
+                                                         const BSONElement& priorityField,
+                                                         TicketHolder::Priority defaultPriority) {
+    if (!priorityField.eoo()) {
+        if (priorityField.type() != String) {
+            return {ErrorCodes::TypeMismatch,
+                    str::stream() << kTicketPriorityFieldName << " must be a string"};
+        }
+        return TicketHolder::parsePriority(priorityField.valueStringData());
+    }
+
+    if (!lowPriorityAppNames.empty()) {
+        const auto& clientMetadata =
+            ClientMetadataIsMasterState::get(opCtx->getClient()).getClientMetadata();
+        if (clientMetadata) {
+            auto appName = clientMetadata.get().getApplicationName();
+            if (std::find(lowPriorityAppNames.begin(), lowPriorityAppNames.end(), appName) !=
+                lowPriorityAppNames.end()) {
+                return TicketHolder::Priority::kLow;
+            }
+        }
+    }
+
+    return defaultPriority;
+}
+
+void setOperationTicketPriority(OperationContext* opCtx, TicketHolder::Priority priority) {
+    getTicketPriority(opCtx) = priority;
+
+    if (auto locker = opCtx->lockState()) {
+        locker->setTicketPriority(priority);
+    }
+}
+
+BSONObj appendTicketPriority(OperationContext* opCtx, const BSONObj& cmdObj) {
+    if (!opCtx || getTicketPriority(opCtx) == TicketHolder::Priority::kNormal ||
+        cmdObj.hasField(kTicketPriorityFieldName)) {
+        return cmdObj;
+    }
+
+    BSONObjBuilder bob(cmdObj);
+    bob.append(kTicketPriorityFieldName, TicketHolder::priorityName(getTicketPriority(opCtx)));
+    return bob.obj();
+}
+
+}  // namespace mongo
@@ -0,0 +1,67 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/util/concurrency/ticketholder.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * Name of the generic command argument which carries the TicketHolder::Priority of an operation,
+ * either "normal" or "low".
+ */
+constexpr StringData kTicketPriorityFieldName = "priority"_sd;
+
+/**
+ * Returns the ticket priority of a command: the one in 'priorityField' if present, otherwise low
+ * for clients listed in the lowPriorityAppNames server parameter, otherwise 'defaultPriority'.
+ */
+StatusWith<TicketHolder::Priority> resolveTicketPriority(OperationContext* opCtx,
+                                                         const BSONElement& priorityField,
+                                                         TicketHolder::Priority defaultPriority);
+
+/**
+ * Records the ticket priority of the operation. On mongod the operation's Locker queues for
+ * tickets with it.
+ */
+void setOperationTicketPriority(OperationContext* opCtx, TicketHolder::Priority priority);
+
+/**
+ * Returns 'cmdObj' with the ticket priority of the operation appended, so that the commands a low
+ * priority operation sends to the shards also run at low priority there. The command is returned
+ * unchanged if the operation has normal priority or the command already carries a priority.
+ */
+BSONObj appendTicketPriority(OperationContext* opCtx, const BSONObj& cmdObj);
+
+}  // namespace mongo
@@ -119,6 +119,7 @@ private:
     void doTTLPass() {
         const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
         OperationContext& opCtx = *opCtxPtr;
+        opCtx.lockState()->setTicketPriority(TicketHolder::Priority::kLow);
 
         // If part of replSet but not in a readable state (e.g. during initial sync), skip.
         if (repl::ReplicationCoordinator::get(&opCtx)->getReplicationMode() ==
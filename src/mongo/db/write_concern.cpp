@@ -41,12 +41,15 @@
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/latency_histogram.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/rpc/protocol.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -60,6 +63,10 @@ static Counter64 gleWtimeouts;
 static ServerStatusMetricField<Counter64> gleWtimeoutsDisplay("getLastError.wtimeouts",
                                                               &gleWtimeouts);
 
+static LatencyHistogram waitForWriteConcernLatency;
+static ServerStatusMetricField<LatencyHistogram> displayWaitForWriteConcernLatency(
+    "writeConcern.waitLatency", &waitForWriteConcernLatency);
+
 MONGO_FP_DECLARE(hangBeforeWaitingForWriteConcern);
 
 bool commandSpecifiesWriteConcern(const BSONObj& cmdObj) {
@@ -169,6 +176,9 @@ Status waitForWriteConcern(OperationContext* opCtx,
 
     auto const replCoord = repl::ReplicationCoordinator::get(opCtx);
 
+    Timer waitTimer;
+    ON_BLOCK_EXIT([&] { waitForWriteConcernLatency.record(waitTimer.micros()); });
+
     if (!opCtx->getClient()->isInDirectClient()) {
         // Respecting this failpoint for internal clients prevents stepup from working properly.
         MONGO_FAIL_POINT_PAUSE_WHILE_SET(hangBeforeWaitingForWriteConcern);
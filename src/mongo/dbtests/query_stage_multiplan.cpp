@@ -45,7 +45,9 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/mock_yield_policies.h"
+#include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/plan_ranker.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
@@ -53,7 +55,10 @@
 #include "mongo/db/query/stage_builder.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -78,6 +83,62 @@ std::unique_ptr<QuerySolution> createQuerySolution() {
     return soln;
 }
 
+PlanRankingDecision* createDecision(size_t numPlans) {
+    unique_ptr<PlanRankingDecision> why(new PlanRankingDecision());
+    for (size_t i = 0; i < numPlans; ++i) {
+        CommonStats common("COLLSCAN");
+        auto stats = stdx::make_unique<PlanStageStats>(common, STAGE_COLLSCAN);
+        stats->specific.reset(new CollectionScanStats());
+        why->stats.push_back(std::move(stats));
+        why->scores.push_back(0U);
+        why->candidateOrder.push_back(i);
+    }
+    return why.release();
+}
+
+/**
+ * A yield policy that never yields, but advances the clock by a millisecond each time a candidate
+ * plan is about to be worked.
+ */
+class ClockAdvancingYieldPolicy final : public PlanYieldPolicy {
+public:
+    explicit ClockAdvancingYieldPolicy(ClockSourceMock* clock)
+        : PlanYieldPolicy(PlanExecutor::NO_YIELD, clock), _clock(clock) {}
+
+    bool shouldYieldOrInterrupt() override {
+        _clock->advance(Milliseconds(1));
+        return false;
+    }
+
+private:
+    ClockSourceMock* const _clock;
+};
+
+/**
+ * A yield policy that yields each time a candidate plan is about to be worked. Working a plan
+ * takes a millisecond and each yield takes 100 milliseconds.
+ */
+class SlowYieldPolicy final : public PlanYieldPolicy {
+public:
+    explicit SlowYieldPolicy(ClockSourceMock* clock)
+        : PlanYieldPolicy(PlanExecutor::NO_YIELD, clock), _clock(clock) {}
+
+    using PlanYieldPolicy::yieldOrInterrupt;
+
+    bool shouldYieldOrInterrupt() override {
+        _clock->advance(Milliseconds(1));
+        return true;
+    }
+
+    Status yieldOrInterrupt(RecordFetcher* fetcher) override {
+        _clock->advance(Milliseconds(100));
+        return Status::OK();
+    }
+
+private:
+    ClockSourceMock* const _clock;
+};
+
 class QueryStageMultiPlanTest : public unittest::Test {
 public:
     QueryStageMultiPlanTest() : _client(_opCtx.get()) {
@@ -546,5 +607,199 @@ TEST_F(QueryStageMultiPlanTest, ShouldReportErrorIfKilledDuringPlanning) {
               multiPlanStage.pickBestPlan(&alwaysPlanKilledYieldPolicy));
 }
 
+TEST_F(QueryStageMultiPlanTest, ShouldStopTrialPeriodAfterMaxMillis) {
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("foo" << (i % 10)));
+    }
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    const auto coll = ctx.getCollection();
+
+    // No document matches, so neither plan ends the trial period by returning results or by
+    // hitting EOF within the first works.
+    auto queryRequest = stdx::make_unique<QueryRequest>(nss);
+    queryRequest->setFilter(BSON("foo" << 10));
+    auto canonicalQuery =
+        uassertStatusOK(CanonicalQuery::canonicalize(opCtx(), std::move(queryRequest)));
+
+    unique_ptr<WorkingSet> sharedWs(new WorkingSet());
+    MultiPlanStage multiPlanStage(opCtx(),
+                                  ctx.getCollection(),
+                                  canonicalQuery.get(),
+                                  MultiPlanStage::CachingMode::NeverCache);
+    for (int i = 0; i < 2; ++i) {
+        CollectionScanParams csparams;
+        csparams.collection = coll;
+        csparams.direction = CollectionScanParams::FORWARD;
+        multiPlanStage.addPlan(
+            createQuerySolution(),
+            new CollectionScan(_opCtx.get(), csparams, sharedWs.get(), canonicalQuery->root()),
+            sharedWs.get());
+    }
+
+    const int maxMillisOldValue = internalQueryPlanEvaluationMaxMillis.load();
+    internalQueryPlanEvaluationMaxMillis.store(10);
+    ON_BLOCK_EXIT([&] { internalQueryPlanEvaluationMaxMillis.store(maxMillisOldValue); });
+
+    // The clock advances by 2ms each time both plans are worked, so the trial period stops after
+    // working each plan 5 times.
+    auto clock = dynamic_cast<ClockSourceMock*>(serviceContext()->getFastClockSource());
+    ASSERT(clock);
+    ClockAdvancingYieldPolicy yieldPolicy(clock);
+    ASSERT_OK(multiPlanStage.pickBestPlan(&yieldPolicy));
+
+    auto stats = multiPlanStage.getStats();
+    ASSERT_EQ(2U, stats->children.size());
+    for (const auto& child : stats->children) {
+        ASSERT_EQ(5U, child->common.works);
+    }
+}
+
+// Time spent yielding during the trial period does not count against
+// internalQueryPlanEvaluationMaxMillis.
+TEST_F(QueryStageMultiPlanTest, ShouldNotCountYieldTimeAgainstMaxMillis) {
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("foo" << (i % 10)));
+    }
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    const auto coll = ctx.getCollection();
+
+    auto queryRequest = stdx::make_unique<QueryRequest>(nss);
+    queryRequest->setFilter(BSON("foo" << 10));
+    auto canonicalQuery =
+        uassertStatusOK(CanonicalQuery::canonicalize(opCtx(), std::move(queryRequest)));
+
+    unique_ptr<WorkingSet> sharedWs(new WorkingSet());
+    MultiPlanStage multiPlanStage(opCtx(),
+                                  ctx.getCollection(),
+                                  canonicalQuery.get(),
+                                  MultiPlanStage::CachingMode::NeverCache);
+    for (int i = 0; i < 2; ++i) {
+        CollectionScanParams csparams;
+        csparams.collection = coll;
+        csparams.direction = CollectionScanParams::FORWARD;
+        multiPlanStage.addPlan(
+            createQuerySolution(),
+            new CollectionScan(_opCtx.get(), csparams, sharedWs.get(), canonicalQuery->root()),
+            sharedWs.get());
+    }
+
+    const int maxMillisOldValue = internalQueryPlanEvaluationMaxMillis.load();
+    internalQueryPlanEvaluationMaxMillis.store(10);
+    ON_BLOCK_EXIT([&] { internalQueryPlanEvaluationMaxMillis.store(maxMillisOldValue); });
+
+    // Only the 2ms spent working both plans count, so the trial period still stops after working
+    // each plan 5 times.
+    auto clock = dynamic_cast<ClockSourceMock*>(serviceContext()->getFastClockSource());
+    ASSERT(clock);
+    SlowYieldPolicy yieldPolicy(clock);
+    ASSERT_OK(multiPlanStage.pickBestPlan(&yieldPolicy));
+
+    auto stats = multiPlanStage.getStats();
+    ASSERT_EQ(2U, stats->children.size());
+    for (const auto& child : stats->children) {
+        ASSERT_EQ(5U, child->common.works);
+    }
+}
+
+// A query that misses the plan cache while another operation ranks the plans for the same shape
+// waits for that ranking, then uses the winning plan it cached rather than running its own trial.
+TEST_F(QueryStageMultiPlanTest, ShouldUseWinningPlanCachedByConcurrentRanking) {
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("foo" << (i % 10)));
+    }
+
+    addIndex(BSON("foo" << 1));
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    const Collection* coll = ctx.getCollection();
+    PlanCache* planCache = coll->infoCache()->getPlanCache();
+
+    auto queryRequest = stdx::make_unique<QueryRequest>(nss);
+    queryRequest->setFilter(BSON("foo" << 7));
+    auto canonicalQuery =
+        uassertStatusOK(CanonicalQuery::canonicalize(opCtx(), std::move(queryRequest)));
+
+    // Plan 0: IXScan over foo == 7, which would win a trial period.
+    std::vector<IndexDescriptor*> indexes;
+    coll->getIndexCatalog()->findIndexesByKeyPattern(
+        _opCtx.get(), BSON("foo" << 1), false, &indexes);
+    ASSERT_EQ(indexes.size(), 1U);
+
+    IndexScanParams ixparams;
+    ixparams.descriptor = indexes[0];
+    ixparams.bounds.isSimpleRange = true;
+    ixparams.bounds.startKey = BSON("" << 7);
+    ixparams.bounds.endKey = BSON("" << 7);
+    ixparams.bounds.boundInclusion = BoundInclusion::kIncludeBothStartAndEndKeys;
+    ixparams.direction = 1;
+
+    unique_ptr<WorkingSet> sharedWs(new WorkingSet());
+    IndexScan* ix = new IndexScan(_opCtx.get(), ixparams, sharedWs.get(), NULL);
+    unique_ptr<PlanStage> firstRoot(new FetchStage(_opCtx.get(), sharedWs.get(), ix, NULL, coll));
+
+    // Plan 1: CollScan with matcher.
+    CollectionScanParams csparams;
+    csparams.collection = coll;
+    csparams.direction = CollectionScanParams::FORWARD;
+    unique_ptr<PlanStage> secondRoot(
+        new CollectionScan(_opCtx.get(), csparams, sharedWs.get(), canonicalQuery->root()));
+
+    auto ixscanSolution = createQuerySolution();
+    ixscanSolution->cacheData->solnType = SolutionCacheData::USE_INDEX_TAGS_SOLN;
+
+    unique_ptr<MultiPlanStage> mps = make_unique<MultiPlanStage>(
+        _opCtx.get(), coll, canonicalQuery.get(), MultiPlanStage::CachingMode::AlwaysCache);
+    MultiPlanStage* rawMps = mps.get();
+    mps->addPlan(std::move(ixscanSolution), firstRoot.release(), sharedWs.get());
+    mps->addPlan(createQuerySolution(), secondRoot.release(), sharedWs.get());
+
+    // Another operation is ranking the plans for this query shape, and has cached the collection
+    // scan as the winner by the time it finishes.
+    auto otherClient = serviceContext()->makeClient("concurrentRanking");
+    auto otherOpCtx = otherClient->makeOperationContext();
+    auto ranking = planCache->startRanking(otherOpCtx.get(), *canonicalQuery);
+    ASSERT(ranking);
+
+    auto cachedCollscan = createQuerySolution();
+    auto cachedIxscan = createQuerySolution();
+    cachedIxscan->cacheData->solnType = SolutionCacheData::USE_INDEX_TAGS_SOLN;
+    std::vector<QuerySolution*> solutions = {cachedCollscan.get(), cachedIxscan.get()};
+    ASSERT_OK(planCache->add(*canonicalQuery, solutions, createDecision(2U), Date_t{}));
+
+    stdx::thread rankingThread([&] {
+        sleepmillis(100);
+        ranking.reset();
+    });
+
+    // Picking the best plan waits for the other ranking with the collection lock yielded.
+    auto statusWithPlanExecutor = PlanExecutor::make(_opCtx.get(),
+                                                     std::move(sharedWs),
+                                                     std::move(mps),
+                                                     std::move(canonicalQuery),
+                                                     coll,
+                                                     PlanExecutor::YIELD_AUTO);
+    rankingThread.join();
+    ASSERT_OK(statusWithPlanExecutor.getStatus());
+    auto exec = std::move(statusWithPlanExecutor.getValue());
+
+    ASSERT(rawMps->bestPlanChosen());
+    ASSERT_EQUALS(1, rawMps->bestPlanIdx());
+
+    int results = 0;
+    BSONObj obj;
+    PlanExecutor::ExecState state;
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL))) {
+        ASSERT_EQUALS(obj["foo"].numberInt(), 7);
+        ++results;
+    }
+    ASSERT_EQUALS(PlanExecutor::IS_EOF, state);
+    ASSERT_EQUALS(results, N / 10);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -33,6 +33,7 @@
 #include "mongo/s/async_requests_sender.h"
 
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/ticket_priority.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/client/shard_registry.h"
@@ -62,7 +63,7 @@ AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
       _readPreference(readPreference),
       _retryPolicy(retryPolicy) {
     for (const auto& request : requests) {
-        _remotes.emplace_back(request.shardId, request.cmdObj);
+        _remotes.emplace_back(request.shardId, appendTicketPriority(opCtx, request.cmdObj));
     }
 
     // Initialize command metadata to handle the read preference.
@@ -366,8 +366,10 @@ void CatalogCache::_scheduleCollectionRefresh(WithLock lk,
         const Status& status, ChunkManager* routingInfoAfterRefresh) {
         if (isIncremental) {
             _stats.numActiveIncrementalRefreshes.subtractAndFetch(1);
+            _stats.totalIncrementalRefreshTimeMicros.addAndFetch(t.micros());
         } else {
             _stats.numActiveFullRefreshes.subtractAndFetch(1);
+            _stats.totalFullRefreshTimeMicros.addAndFetch(t.micros());
         }
 
         if (!status.isOK()) {
@@ -413,6 +415,11 @@ void CatalogCache::_scheduleCollectionRefresh(WithLock lk,
             StatusWith<CatalogCacheLoader::CollectionAndChangedChunks> swCollAndChunks) noexcept {
         std::shared_ptr<ChunkManager> newRoutingInfo;
         try {
+            Timer buildTimer;
+            ON_BLOCK_EXIT([&] {
+                _stats.totalRoutingTableBuildTimeMicros.addAndFetch(buildTimer.micros());
+            });
+
             newRoutingInfo = refreshCollectionRoutingInfo(
                 opCtx, nss, std::move(existingRoutingInfo), std::move(swCollAndChunks));
 
@@ -474,6 +481,10 @@ void CatalogCache::Stats::report(BSONObjBuilder* builder) const {
     builder->append("countFullRefreshesStarted", countFullRefreshesStarted.load());
 
     builder->append("countFailedRefreshes", countFailedRefreshes.load());
+
+    builder->append("totalIncrementalRefreshTimeMicros", totalIncrementalRefreshTimeMicros.load());
+    builder->append("totalFullRefreshTimeMicros", totalFullRefreshTimeMicros.load());
+    builder->append("totalRoutingTableBuildTimeMicros", totalRoutingTableBuildTimeMicros.load());
 }
 
 CachedDatabaseInfo::CachedDatabaseInfo(std::shared_ptr<CatalogCache::DatabaseInfoEntry> db)
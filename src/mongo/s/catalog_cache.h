@@ -225,6 +225,15 @@ private:
         // for whatever reason
         AtomicInt64 countFailedRefreshes{0};
 
+        // Cumulative, always-increasing counters of how much time incremental and full refreshes
+        // took from being kicked off until completion, including loading the chunks
+        AtomicInt64 totalIncrementalRefreshTimeMicros{0};
+        AtomicInt64 totalFullRefreshTimeMicros{0};
+
+        // Cumulative, always-increasing counter of how much time was spent building routing tables
+        // from the loaded chunks
+        AtomicInt64 totalRoutingTableBuildTimeMicros{0};
+
         /**
          * Reports the accumulated statistics for serverStatus.
          */
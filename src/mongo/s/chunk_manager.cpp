@@ -32,6 +32,9 @@
 
 #include "mongo/s/chunk_manager.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
@@ -66,8 +69,308 @@ std::string extractKeyStringInternal(const BSONObj& shardKeyValue, Ordering orde
     return {ks.getBuffer(), ks.getSize()};
 }
 
+/**
+ * Applies the changes in order to the chunks with the given max keys, each change replacing all
+ * the chunks it overlaps, and appends the resulting chunks and max keys to the output arguments.
+ */
+void applyChanges(const ChunkMap::Chunks& chunks,
+                  const KeyStringArray& maxKeyStrings,
+                  const std::vector<const ChunkMap::ChangedChunk*>& changes,
+                  ChunkMap::Chunks* outChunks,
+                  KeyStringArray* outMaxKeyStrings) {
+    // Apply the changes to each other first, keyed by their max key. The positions of the existing
+    // chunks which each change overlaps are recorded as it goes, because these chunks must be
+    // erased even if the change itself gets replaced by a later one.
+    std::map<StringData, const ChunkMap::ChangedChunk*> updates;
+    std::vector<std::pair<size_t, size_t>> erased;
+    erased.reserve(changes.size());
+
+    for (const auto* change : changes) {
+        // The first chunk with a max key that is > min overlaps min and the first chunk with a max
+        // key that is > max cannot overlap max
+        updates.erase(updates.upper_bound(change->minKeyString),
+                      updates.upper_bound(change->maxKeyString));
+        updates.emplace(change->maxKeyString, change);
+
+        erased.emplace_back(maxKeyStrings.upperBound(change->minKeyString),
+                            maxKeyStrings.upperBound(change->maxKeyString));
+    }
+
+    // Turn the erased positions into sorted, disjoint intervals
+    std::sort(erased.begin(), erased.end());
+    std::vector<std::pair<size_t, size_t>> erasedIntervals;
+    for (const auto& interval : erased) {
+        if (!erasedIntervals.empty() && interval.first <= erasedIntervals.back().second) {
+            auto& last = erasedIntervals.back();
+            last.second = std::max(last.second, interval.second);
+        } else {
+            erasedIntervals.push_back(interval);
+        }
+    }
+
+    outChunks->reserve(outChunks->size() + chunks.size() + updates.size());
+
+    auto nextErased = erasedIntervals.cbegin();
+    size_t pos = 0;
+
+    // Appends the existing chunks at positions [pos, end), which have not been erased. Runs of
+    // consecutive chunks are copied in bulk.
+    const auto copyExisting = [&](size_t end) {
+        while (pos < end) {
+            if (nextErased != erasedIntervals.cend() && nextErased->first <= pos) {
+                pos = std::max(pos, std::min(end, nextErased->second));
+                if (pos == nextErased->second) {
+                    ++nextErased;
+                }
+                continue;
+            }
+
+            const size_t runEnd = nextErased != erasedIntervals.cend()
+                ? std::min(end, nextErased->first)
+                : end;
+            outChunks->insert(outChunks->end(), chunks.begin() + pos, chunks.begin() + runEnd);
+            outMaxKeyStrings->append(maxKeyStrings, pos, runEnd);
+            pos = runEnd;
+        }
+    };
+
+    for (const auto& update : updates) {
+        copyExisting(maxKeyStrings.upperBound(update.first));
+        outChunks->push_back(update.second->chunk);
+        outMaxKeyStrings->push_back(update.first);
+    }
+    copyExisting(chunks.size());
+}
+
+/**
+ * Checks that the range of chunk "next" starts where the range of chunk "prev" ends.
+ */
+void checkContiguous(const Chunk& prev, const Chunk& next) {
+    uassert(ErrorCodes::ConflictingOperationInProgress,
+            str::stream() << "Gap or an overlap between ranges "
+                          << ChunkRange(next.getMin(), next.getMax()).toString()
+                          << " and "
+                          << ChunkRange(prev.getMin(), prev.getMax()).toString(),
+            SimpleBSONObjComparator::kInstance.evaluate(prev.getMax() == next.getMin()));
+}
+
 }  // namespace
 
+void KeyStringArray::reserve(size_t numKeys, size_t numBytes) {
+    _offsets.reserve(numKeys + 1);
+    _buffer.reserve(numBytes);
+}
+
+void KeyStringArray::push_back(StringData key) {
+    dassert(size() == 0 || (*this)[size() - 1] < key);
+    _buffer.insert(_buffer.end(), key.rawData(), key.rawData() + key.size());
+    invariant(_buffer.size() <= std::numeric_limits<uint32_t>::max());
+    _offsets.push_back(_buffer.size());
+}
+
+void KeyStringArray::append(const KeyStringArray& other, size_t begin, size_t end) {
+    if (begin == end) {
+        return;
+    }
+
+    const uint32_t otherBegin = other._offsets[begin];
+    const uint32_t otherEnd = other._offsets[end];
+    const uint32_t shift = _buffer.size();
+
+    _buffer.insert(
+        _buffer.end(), other._buffer.begin() + otherBegin, other._buffer.begin() + otherEnd);
+    invariant(_buffer.size() <= std::numeric_limits<uint32_t>::max());
+
+    for (size_t i = begin + 1; i <= end; ++i) {
+        _offsets.push_back(other._offsets[i] - otherBegin + shift);
+    }
+}
+
+size_t KeyStringArray::upperBound(StringData key) const {
+    size_t n = size();
+    if (n == 0) {
+        return 0;
+    }
+
+    // The answer is always within [base, base + n]. Both candidates for the next base are computed
+    // up front, so that the compiler can select between them without branching.
+    size_t base = 0;
+    while (n > 1) {
+        const size_t half = n / 2;
+        base = ((*this)[base + half - 1] <= key) ? base + half : base;
+        n -= half;
+    }
+
+    return base + ((*this)[base] <= key);
+}
+
+ChunkMap::const_iterator& ChunkMap::const_iterator::operator++() {
+    if (++_pos == _map->_blocks[_block]->chunks.size()) {
+        ++_block;
+        _pos = 0;
+    }
+    return *this;
+}
+
+ChunkMap::const_iterator ChunkMap::const_iterator::nextShardRun() const {
+    const auto& block = *_map->_blocks[_block];
+    const size_t runEnd = block.shardRunEnds[_pos];
+    if (runEnd == block.chunks.size()) {
+        return {_map, _block + 1, 0};
+    }
+    return {_map, _block, runEnd};
+}
+
+ChunkMap::const_iterator ChunkMap::upperBound(StringData keyString) const {
+    const size_t block = _blockMaxKeyStrings.upperBound(keyString);
+    if (block == _blocks.size()) {
+        return end();
+    }
+    return {this, block, _blocks[block]->maxKeyStrings.upperBound(keyString)};
+}
+
+ChunkMap ChunkMap::createMerged(const std::vector<ChangedChunk>& changes) const {
+    // A run of consecutive blocks to be rebuilt, along with the changes which fall within it
+    struct Run {
+        size_t firstBlock;
+        size_t lastBlock;
+        std::vector<const ChangedChunk*> changes;
+    };
+
+    // Each change touches the blocks from the one holding the first chunk it overlaps, to the one
+    // holding the first chunk after it
+    const size_t lastBlock = _blocks.empty() ? 0 : _blocks.size() - 1;
+    std::vector<std::pair<size_t, size_t>> touched;
+    touched.reserve(changes.size());
+    for (const auto& change : changes) {
+        touched.emplace_back(
+            std::min(_blockMaxKeyStrings.upperBound(change.minKeyString), lastBlock),
+            std::min(_blockMaxKeyStrings.upperBound(change.maxKeyString), lastBlock));
+    }
+
+    std::vector<Run> runs;
+    {
+        auto sortedTouched = touched;
+        std::sort(sortedTouched.begin(), sortedTouched.end());
+        for (const auto& blocks : sortedTouched) {
+            if (!runs.empty() && blocks.first <= runs.back().lastBlock) {
+                runs.back().lastBlock = std::max(runs.back().lastBlock, blocks.second);
+            } else {
+                runs.push_back({blocks.first, blocks.second, {}});
+            }
+        }
+    }
+
+    // Changes which overlap each other touch common blocks, so they end up in the same run, where
+    // they must be applied in their original order
+    for (size_t i = 0; i < changes.size(); ++i) {
+        auto it = std::upper_bound(
+            runs.begin(), runs.end(), touched[i].first, [](size_t block, const Run& run) {
+                return block < run.firstBlock;
+            });
+        std::prev(it)->changes.push_back(&changes[i]);
+    }
+
+    ChunkMap merged;
+    size_t nextBlock = 0;
+
+    for (const auto& run : runs) {
+        for (; nextBlock < run.firstBlock; ++nextBlock) {
+            merged._appendBlock(_blocks[nextBlock]);
+        }
+
+        Chunks chunks;
+        KeyStringArray maxKeyStrings;
+        for (; nextBlock <= run.lastBlock && nextBlock < _blocks.size(); ++nextBlock) {
+            const auto& block = *_blocks[nextBlock];
+            chunks.insert(chunks.end(), block.chunks.begin(), block.chunks.end());
+            maxKeyStrings.append(block.maxKeyStrings, 0, block.maxKeyStrings.size());
+        }
+
+        Chunks runChunks;
+        KeyStringArray runMaxKeyStrings;
+        applyChanges(chunks, maxKeyStrings, run.changes, &runChunks, &runMaxKeyStrings);
+
+        if (runChunks.empty()) {
+            continue;
+        }
+
+        // The blocks which are not rebuilt have already been checked, so only the rebuilt chunks
+        // and their boundaries with the neighbouring blocks need to be
+        if (!merged._blocks.empty()) {
+            checkContiguous(*merged._blocks.back()->chunks.back(), *runChunks.front());
+        }
+        for (size_t i = 1; i < runChunks.size(); ++i) {
+            checkContiguous(*runChunks[i - 1], *runChunks[i]);
+        }
+        if (nextBlock < _blocks.size()) {
+            checkContiguous(*runChunks.back(), *_blocks[nextBlock]->chunks.front());
+        }
+
+        merged._appendChunks(runChunks, runMaxKeyStrings);
+    }
+
+    for (; nextBlock < _blocks.size(); ++nextBlock) {
+        merged._appendBlock(_blocks[nextBlock]);
+    }
+
+    return merged;
+}
+
+void ChunkMap::appendShardVersions(ShardVersionMap* shardVersions) const {
+    for (const auto& block : _blocks) {
+        for (const auto& entry : block->shardVersions) {
+            auto result = shardVersions->insert(entry);
+            if (!result.second && entry.second > result.first->second) {
+                result.first->second = entry.second;
+            }
+        }
+    }
+}
+
+bool ChunkMap::sharesBlockWith(const ChunkMap& other, const_iterator it) const {
+    const auto& block = _blocks[it._block];
+    return std::find(other._blocks.begin(), other._blocks.end(), block) != other._blocks.end();
+}
+
+void ChunkMap::_appendChunks(const Chunks& chunks, const KeyStringArray& maxKeyStrings) {
+    // Spread the chunks evenly, so that the blocks have room to grow before they need splitting
+    const size_t numBlocks = (chunks.size() + kMaxChunksPerBlock - 1) / kMaxChunksPerBlock;
+
+    size_t begin = 0;
+    for (size_t i = 0; i < numBlocks; ++i) {
+        const size_t end = chunks.size() * (i + 1) / numBlocks;
+        const size_t blockSize = end - begin;
+
+        auto block = std::make_shared<Block>();
+        block->chunks.assign(chunks.begin() + begin, chunks.begin() + end);
+        block->maxKeyStrings.append(maxKeyStrings, begin, end);
+        block->shardRunEnds.resize(blockSize);
+
+        for (size_t pos = blockSize; pos-- > 0;) {
+            const auto& chunk = block->chunks[pos];
+            const bool lastInRun = pos + 1 == blockSize ||
+                block->chunks[pos + 1]->getShardId() != chunk->getShardId();
+            block->shardRunEnds[pos] = lastInRun ? pos + 1 : block->shardRunEnds[pos + 1];
+
+            auto result = block->shardVersions.emplace(chunk->getShardId(), chunk->getLastmod());
+            if (!result.second && chunk->getLastmod() > result.first->second) {
+                result.first->second = chunk->getLastmod();
+            }
+        }
+
+        _appendBlock(std::move(block));
+        begin = end;
+    }
+}
+
+void ChunkMap::_appendBlock(std::shared_ptr<const Block> block) {
+    const auto& maxKeyStrings = block->maxKeyStrings;
+    _blockMaxKeyStrings.push_back(maxKeyStrings[maxKeyStrings.size() - 1]);
+    _size += block->chunks.size();
+    _blocks.push_back(std::move(block));
+}
+
 ChunkManager::ChunkManager(NamespaceString nss,
                            boost::optional<UUID> uuid,
                            KeyPattern shardKeyPattern,
@@ -83,8 +386,7 @@ ChunkManager::ChunkManager(NamespaceString nss,
       _defaultCollator(std::move(defaultCollator)),
       _unique(unique),
       _chunkMap(std::move(chunkMap)),
-      _chunkMapViews(
-          _constructChunkMapViews(collectionVersion.epoch(), _chunkMap, _shardKeyOrdering)),
+      _chunkMapViews(_constructChunkMapViews(_chunkMap)),
       _collectionVersion(collectionVersion) {}
 
 std::shared_ptr<Chunk> ChunkManager::findIntersectingChunk(const BSONObj& shardKey,
@@ -100,12 +402,12 @@ std::shared_ptr<Chunk> ChunkManager::findIntersectingChunk(const BSONObj& shardK
         }
     }
 
-    const auto it = _chunkMap.upper_bound(_extractKeyString(shardKey));
+    const auto it = _chunkMap.upperBound(_extractKeyString(shardKey));
     uassert(ErrorCodes::ShardKeyNotFound,
             str::stream() << "Cannot target single shard using key " << shardKey,
-            it != _chunkMap.end() && it->second->containsKey(shardKey));
+            it != _chunkMap.end() && (*it)->containsKey(shardKey));
 
-    return it->second;
+    return *it;
 }
 
 std::shared_ptr<Chunk> ChunkManager::findIntersectingChunkWithSimpleCollation(
@@ -117,11 +419,11 @@ bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey, const ShardId& sha
     if (shardKey.isEmpty())
         return false;
 
-    const auto it = _rangeMapUpperBound(shardKey);
-    if (it == _chunkMapViews.chunkRangeMap.end())
+    const auto it = _chunkMap.upperBound(_extractKeyString(shardKey));
+    if (it == _chunkMap.end())
         return false;
 
-    return it->shardId == shardId;
+    return (*it)->getShardId() == shardId;
 }
 
 void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
@@ -185,16 +487,16 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
     // For now, we satisfy that assumption by adding a shard with no matches rather than returning
     // an empty set of shards.
     if (shardIds->empty()) {
-        shardIds->insert(_chunkMapViews.chunkRangeMap.begin()->shardId);
+        shardIds->insert((*_chunkMap.begin())->getShardId());
     }
 }
 
 void ChunkManager::getShardIdsForRange(const BSONObj& min,
                                        const BSONObj& max,
                                        std::set<ShardId>* shardIds) const {
-    const auto bounds = _overlappingRanges(min, max, true);
-    for (auto it = bounds.first; it != bounds.second; ++it) {
-        shardIds->insert(it->shardId);
+    const auto bounds = _overlappingChunks(min, max, true);
+    for (auto it = bounds.first; it < bounds.second; it = it.nextShardRun()) {
+        shardIds->insert((*it)->getShardId());
 
         // No need to iterate through the rest of the ranges, because we already know we need to use
         // all shards.
@@ -205,18 +507,20 @@ void ChunkManager::getShardIdsForRange(const BSONObj& min,
 }
 
 bool ChunkManager::rangeOverlapsShard(const ChunkRange& range, const ShardId& shardId) const {
-    const auto bounds = _overlappingRanges(range.getMin(), range.getMax(), false);
-    const auto it = std::find_if(bounds.first, bounds.second, [&shardId](const auto& scr) {
-        return scr.shardId == shardId;
-    });
-    return it != bounds.second;
+    const auto bounds = _overlappingChunks(range.getMin(), range.getMax(), false);
+    for (auto it = bounds.first; it < bounds.second; it = it.nextShardRun()) {
+        if ((*it)->getShardId() == shardId) {
+            return true;
+        }
+    }
+    return false;
 }
 
 ChunkManager::ConstRangeOfChunks ChunkManager::getNextChunkOnShard(const BSONObj& shardKey,
                                                                    const ShardId& shardId) const {
-    for (auto it = _chunkMap.upper_bound(_extractKeyString(shardKey)); it != _chunkMap.end();
+    for (auto it = _chunkMap.upperBound(_extractKeyString(shardKey)); it != _chunkMap.end();
          ++it) {
-        const auto& chunk = it->second;
+        const auto& chunk = *it;
         if (chunk->getShardId() == shardId) {
             const auto begin = it;
             const auto end = ++it;
@@ -375,11 +679,6 @@ std::string ChunkManager::toString() const {
         sb << "\t" << chunk->toString() << '\n';
     }
 
-    sb << "Ranges:\n";
-    for (const auto& entry : _chunkMapViews.chunkRangeMap) {
-        sb << "\t" << entry.range.toString() << " @ " << entry.shardId << '\n';
-    }
-
     sb << "Shard versions:\n";
     for (const auto& entry : _chunkMapViews.shardVersions) {
         sb << "\t" << entry.first << ": " << entry.second.toString() << '\n';
@@ -388,144 +687,46 @@ std::string ChunkManager::toString() const {
     return sb.str();
 }
 
-ChunkManager::ChunkMapViews ChunkManager::_constructChunkMapViews(const OID& epoch,
-                                                                  const ChunkMap& chunkMap,
-                                                                  Ordering shardKeyOrdering) {
-    ChunkRangeMap chunkRangeMap;
+ChunkManager::ChunkMapViews ChunkManager::_constructChunkMapViews(const ChunkMap& chunkMap) {
     ShardVersionMap shardVersions;
-    ChunkMap::const_iterator current = chunkMap.cbegin();
-
-    while (current != chunkMap.cend()) {
-        const auto& firstChunkInRange = current->second;
-
-        // Tracks the max shard version for the shard on which the current range will reside
-        auto shardVersionIt = shardVersions.find(firstChunkInRange->getShardId());
-        if (shardVersionIt == shardVersions.end()) {
-            shardVersionIt =
-                shardVersions.emplace(firstChunkInRange->getShardId(), ChunkVersion(0, 0, epoch))
-                    .first;
-        }
-
-        auto& maxShardVersion = shardVersionIt->second;
-
-        current = std::find_if(
-            current,
-            chunkMap.cend(),
-            [&firstChunkInRange, &maxShardVersion](const ChunkMap::value_type& chunkMapEntry) {
-                const auto& currentChunk = chunkMapEntry.second;
-
-                if (currentChunk->getShardId() != firstChunkInRange->getShardId())
-                    return true;
-
-                if (currentChunk->getLastmod() > maxShardVersion)
-                    maxShardVersion = currentChunk->getLastmod();
-
-                return false;
-            });
-
-        const auto rangeLast = std::prev(current);
-
-        const BSONObj rangeMin = firstChunkInRange->getMin();
-        const BSONObj rangeMax = rangeLast->second->getMax();
-
-        if (!chunkRangeMap.empty()) {
-            uassert(
-                ErrorCodes::ConflictingOperationInProgress,
-                str::stream()
-                    << "Metadata contains chunks with the same or out-of-order max value; "
-                       "expected "
-                    << chunkRangeMap.back().max()
-                    << " < "
-                    << rangeMax,
-                SimpleBSONObjComparator::kInstance.evaluate(chunkRangeMap.back().max() < rangeMax));
-            // Make sure there are no gaps in the ranges
-            uassert(ErrorCodes::ConflictingOperationInProgress,
-                    str::stream() << "Gap or an overlap between ranges "
-                                  << ChunkRange(rangeMin, rangeMax).toString()
-                                  << " and "
-                                  << chunkRangeMap.back().range.toString(),
-                    SimpleBSONObjComparator::kInstance.evaluate(chunkRangeMap.back().max() ==
-                                                                rangeMin));
-        }
-
-        chunkRangeMap.emplace_back(
-            ShardAndChunkRange{{rangeMin, rangeMax},
-                               firstChunkInRange->getShardId(),
-                               extractKeyStringInternal(rangeMax, shardKeyOrdering)});
-
-        // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
-        // somewhere, which should have been caught at chunk load time
-        invariant(maxShardVersion.isSet());
-    }
+    chunkMap.appendShardVersions(&shardVersions);
 
     if (!chunkMap.empty()) {
-        invariant(!chunkRangeMap.empty());
         invariant(!shardVersions.empty());
 
-        checkAllElementsAreOfType(MinKey, chunkRangeMap.front().min());
-        checkAllElementsAreOfType(MaxKey, chunkRangeMap.back().max());
+        checkAllElementsAreOfType(MinKey, chunkMap.front()->getMin());
+        checkAllElementsAreOfType(MaxKey, chunkMap.back()->getMax());
 
-        DEV for (size_t i = 0; i < chunkRangeMap.size() - 1; ++i) {
-            const auto& c1 = chunkRangeMap[i];
-            const auto& c2 = chunkRangeMap[i + 1];
-
-            invariant(SimpleBSONObjComparator::kInstance.evaluate(c1.max() == c2.min()),
-                      str::stream() << "Found gap between " << c1.range.toString() << " and "
-                                    << c2.range.toString());
+        // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
+        // somewhere, which should have been caught at chunk load time
+        for (const auto& entry : shardVersions) {
+            invariant(entry.second.isSet());
         }
     }
 
-    return {std::move(chunkRangeMap), std::move(shardVersions)};
+    return {std::move(shardVersions)};
 }
 
 std::string ChunkManager::_extractKeyString(const BSONObj& shardKeyValue) const {
     return extractKeyStringInternal(shardKeyValue, _shardKeyOrdering);
 }
 
-ChunkManager::ChunkRangeMap::const_iterator ChunkManager::_rangeMapUpperBound(
-    const BSONObj& key) const {
-
-    // This class is necessary, because the last argument to std::upper_bound is a functor which
-    // implements the BinaryPredicate concept. A binary predicate pred must be able to evaluate both
-    // pred(*iter1, *iter2) and pred(*iter1, value). The type of "value" in this case is
-    // std::string, while the type of *Iter is ShardAndChunkRange.
-    struct Key {
-        static const std::string& extract(const std::string& k) {
-            return k;
-        }
-        static void extract(std::string&& k) = delete;
-        static const std::string& extract(const ShardAndChunkRange& scr) {
-            return scr.ksMax;
-        }
-        static const std::string& extract(ShardAndChunkRange&&) = delete;
-    };
-
-    return std::upper_bound(_chunkMapViews.chunkRangeMap.cbegin(),
-                            _chunkMapViews.chunkRangeMap.cend(),
-                            _extractKeyString(key),
-                            [](const auto& lhs, const auto& rhs) -> bool {
-                                return Key::extract(lhs) < Key::extract(rhs);
-                            });
-}
-
-std::pair<ChunkManager::ChunkRangeMap::const_iterator, ChunkManager::ChunkRangeMap::const_iterator>
-ChunkManager::_overlappingRanges(const mongo::BSONObj& min,
-                                 const mongo::BSONObj& max,
-                                 bool isMaxInclusive) const {
+std::pair<ChunkMap::const_iterator, ChunkMap::const_iterator> ChunkManager::_overlappingChunks(
+    const mongo::BSONObj& min, const mongo::BSONObj& max, bool isMaxInclusive) const {
     dassert(SimpleBSONObjComparator::kInstance.evaluate(min <= max));
-    const auto begin = _rangeMapUpperBound(min);
-    auto end = _rangeMapUpperBound(max);
+    const auto begin = _chunkMap.upperBound(_extractKeyString(min));
+    auto end = _chunkMap.upperBound(_extractKeyString(max));
 
-    // The chunk range map must always cover the entire key space
-    invariant(begin != _chunkMapViews.chunkRangeMap.cend());
+    // The chunk map must always cover the entire key space
+    invariant(begin != _chunkMap.end());
 
     // Bump the end chunk, because the second iterator in the returned pair is exclusive. There is
     // one caveat - if the exclusive max boundary of the range looked up is the same as the
     // inclusive min of the end chunk returned, it is still possible that the min is not in the end
     // chunk, in which case bumping the end will result in one extra chunk claimed to cover the
     // range.
-    if (end != _chunkMapViews.chunkRangeMap.cend() &&
-        (isMaxInclusive || SimpleBSONObjComparator::kInstance.evaluate(max > end->min()))) {
+    if (end != _chunkMap.end() &&
+        (isMaxInclusive || SimpleBSONObjComparator::kInstance.evaluate(max > (*end)->getMin()))) {
         ++end;
     }
 
@@ -554,7 +755,9 @@ std::shared_ptr<ChunkManager> ChunkManager::makeUpdated(
     const std::vector<ChunkType>& changedChunks) {
 
     const auto startingCollectionVersion = getVersion();
-    auto chunkMap = _chunkMap;
+
+    std::vector<ChunkMap::ChangedChunk> changes;
+    changes.reserve(changedChunks.size());
 
     ChunkVersion collectionVersion = startingCollectionVersion;
     for (const auto& chunk : changedChunks) {
@@ -570,22 +773,9 @@ std::shared_ptr<ChunkManager> ChunkManager::makeUpdated(
         invariant(chunkVersion >= collectionVersion);
         collectionVersion = chunkVersion;
 
-        const auto chunkMinKeyString = _extractKeyString(chunk.getMin());
-        const auto chunkMaxKeyString = _extractKeyString(chunk.getMax());
-
-        // Returns the first chunk with a max key that is > min - implies that the chunk overlaps
-        // min
-        const auto low = chunkMap.upper_bound(chunkMinKeyString);
-
-        // Returns the first chunk with a max key that is > max - implies that the next chunk cannot
-        // not overlap max
-        const auto high = chunkMap.upper_bound(chunkMaxKeyString);
-
-        // Erase all chunks from the map, which overlap the chunk we got from the persistent store
-        chunkMap.erase(low, high);
-
-        // Insert only the chunk itself
-        chunkMap.insert(std::make_pair(chunkMaxKeyString, std::make_shared<Chunk>(chunk)));
+        changes.push_back({_extractKeyString(chunk.getMin()),
+                           _extractKeyString(chunk.getMax()),
+                           std::make_shared<Chunk>(chunk)});
     }
 
     // If at least one diff was applied, the metadata is correct, but it might not have changed so
@@ -599,6 +789,9 @@ std::shared_ptr<ChunkManager> ChunkManager::makeUpdated(
         return shared_from_this();
     }
 
+    // Each changed chunk replaces all the chunks it overlaps
+    auto chunkMap = _chunkMap.createMerged(changes);
+
     return std::shared_ptr<ChunkManager>(
         new ChunkManager(_nss,
                          _uuid,
@@ -34,6 +34,7 @@
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/s/chunk.h"
@@ -48,12 +49,204 @@ class CanonicalQuery;
 struct QuerySolutionNode;
 class OperationContext;
 
-// Ordered map from the max for each chunk to an entry describing the chunk
-using ChunkMap = std::map<std::string, std::shared_ptr<Chunk>>;
-
 // Map from a shard is to the max chunk version on that shard
 using ShardVersionMap = std::map<ShardId, ChunkVersion>;
 
+/**
+ * Sorted array of KeyString-encoded keys, stored back to back in a single buffer. Looking up a key
+ * only touches the buffer and the array of offsets into it, and the binary search picks the half
+ * to continue in with a conditional move rather than a branch.
+ */
+class KeyStringArray {
+public:
+    size_t size() const {
+        return _offsets.size() - 1;
+    }
+
+    StringData operator[](size_t i) const {
+        return StringData(_buffer.data() + _offsets[i], _offsets[i + 1] - _offsets[i]);
+    }
+
+    void reserve(size_t numKeys, size_t numBytes);
+
+    /**
+     * Appends a key, which must not sort before the last key in the array.
+     */
+    void push_back(StringData key);
+
+    /**
+     * Appends the keys at positions [begin, end) of "other".
+     */
+    void append(const KeyStringArray& other, size_t begin, size_t end);
+
+    /**
+     * Returns the position of the first key which sorts after "key", or size() if there is none.
+     */
+    size_t upperBound(StringData key) const;
+
+    size_t bufferSize() const {
+        return _buffer.size();
+    }
+
+private:
+    std::vector<char> _buffer;
+
+    // Offset of each key in the buffer, followed by the size of the buffer
+    std::vector<uint32_t> _offsets{0};
+};
+
+/**
+ * Chunks of a collection sorted by their max key, along with the KeyString encodings of these max
+ * keys. The union of all chunks' ranges must cover the complete space from [MinKey, MaxKey).
+ *
+ * The chunks are stored in immutable blocks of bounded size, which successive versions of the
+ * routing table share. Applying a set of changes only rebuilds the blocks which the changes touch
+ * and the array of block pointers, so the cost of a refresh does not grow with the number of
+ * chunks it leaves alone.
+ */
+class ChunkMap {
+    struct Block;
+
+public:
+    using Chunks = std::vector<std::shared_ptr<Chunk>>;
+
+    // Maximum number of chunks stored in a block
+    static const size_t kMaxChunksPerBlock = 1024;
+
+    /**
+     * A chunk, which is replacing whatever chunks it overlaps, along with the KeyString encodings
+     * of its bounds.
+     */
+    struct ChangedChunk {
+        std::string minKeyString;
+        std::string maxKeyString;
+        std::shared_ptr<Chunk> chunk;
+    };
+
+    class const_iterator {
+    public:
+        const_iterator() = default;
+
+        const std::shared_ptr<Chunk>& operator*() const {
+            return _map->_blocks[_block]->chunks[_pos];
+        }
+
+        const_iterator& operator++();
+        const_iterator operator++(int) {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return _block == other._block && _pos == other._pos;
+        }
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+        bool operator<(const const_iterator& other) const {
+            return _block < other._block || (_block == other._block && _pos < other._pos);
+        }
+
+        /**
+         * Returns the first chunk after this one, which is either on a different shard or starts a
+         * new block. Allows visiting the shards of a range of chunks without stepping through the
+         * chunks one by one.
+         */
+        const_iterator nextShardRun() const;
+
+    private:
+        friend class ChunkMap;
+
+        const_iterator(const ChunkMap* map, size_t block, size_t pos)
+            : _map(map), _block(block), _pos(pos) {}
+
+        const ChunkMap* _map{nullptr};
+        size_t _block{0};
+        size_t _pos{0};
+    };
+
+    const_iterator begin() const {
+        return {this, 0, 0};
+    }
+
+    const_iterator end() const {
+        return {this, _blocks.size(), 0};
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    size_t numBlocks() const {
+        return _blocks.size();
+    }
+
+    const std::shared_ptr<Chunk>& front() const {
+        return _blocks.front()->chunks.front();
+    }
+
+    const std::shared_ptr<Chunk>& back() const {
+        return _blocks.back()->chunks.back();
+    }
+
+    /**
+     * Returns the first chunk whose max key sorts after "keyString", that is the chunk which
+     * contains that key.
+     */
+    const_iterator upperBound(StringData keyString) const;
+
+    /**
+     * Returns a copy of this map with the changes applied in order, each of them replacing all the
+     * chunks it overlaps. Blocks which no change touches are shared with this map.
+     *
+     * Throws ConflictingOperationInProgress if the rebuilt part of the map has gaps or overlaps.
+     */
+    ChunkMap createMerged(const std::vector<ChangedChunk>& changes) const;
+
+    /**
+     * Adds the max version of the chunks on each shard to "shardVersions". Takes time proportional
+     * to the number of blocks rather than chunks.
+     */
+    void appendShardVersions(ShardVersionMap* shardVersions) const;
+
+    /**
+     * Returns whether the two maps share the block which contains "it", which must be an iterator
+     * of this map. Used for testing.
+     */
+    bool sharesBlockWith(const ChunkMap& other, const_iterator it) const;
+
+private:
+    struct Block {
+        Chunks chunks;
+        KeyStringArray maxKeyStrings;
+
+        // For each chunk, the position within the block of the next chunk on a different shard
+        std::vector<uint32_t> shardRunEnds;
+
+        // Max version of the chunks on each shard, which has chunks in this block
+        ShardVersionMap shardVersions;
+    };
+
+    /**
+     * Splits the chunks into blocks of at most kMaxChunksPerBlock chunks and appends them.
+     */
+    void _appendChunks(const Chunks& chunks, const KeyStringArray& maxKeyStrings);
+
+    void _appendBlock(std::shared_ptr<const Block> block);
+
+    std::vector<std::shared_ptr<const Block>> _blocks;
+
+    // KeyString encodings of the max key of the last chunk in each block
+    KeyStringArray _blockMaxKeyStrings;
+
+    size_t _size{0};
+};
+
 /**
  * In-memory representation of the routing table for a single sharded collection.
  */
@@ -79,8 +272,8 @@ public:
         bool operator!=(const ConstChunkIterator& other) const {
             return !(*this == other);
         }
-        const ChunkMap::mapped_type& operator*() const {
-            return _iter->second;
+        const std::shared_ptr<Chunk>& operator*() const {
+            return *_iter;
         }
 
     private:
@@ -162,7 +355,7 @@ public:
     ChunkVersion getVersion(const ShardId& shardId) const;
 
     ConstRangeOfChunks chunks() const {
-        return {ConstChunkIterator{_chunkMap.cbegin()}, ConstChunkIterator{_chunkMap.cend()}};
+        return {ConstChunkIterator{_chunkMap.begin()}, ConstChunkIterator{_chunkMap.end()}};
     }
 
     int numChunks() const {
@@ -261,46 +454,20 @@ public:
     }
 
 private:
-    /**
-     * Represents a range of chunk keys [getMin(), getMax()) and the id of the shard on which they
-     * reside according to the metadata.
-     */
-    struct ShardAndChunkRange {
-        const BSONObj& min() const {
-            return range.getMin();
-        }
-
-        const BSONObj& max() const {
-            return range.getMax();
-        }
-
-        ChunkRange range;
-        ShardId shardId;
-        std::string ksMax;
-    };
-
-    using ChunkRangeMap = std::vector<ShardAndChunkRange>;
-
     /**
      * Contains different transformations of the chunk map for efficient querying
      */
     struct ChunkMapViews {
-        // Transformation of the chunk map containing what range of keys reside on which shard. The
-        // index is the max key of the respective range and the union of all ranges in a such
-        // constructed map must cover the complete space from [MinKey, MaxKey).
-        const ChunkRangeMap chunkRangeMap;
-
         // Map from shard id to the maximum chunk version for that shard. If a shard contains no
         // chunks, it won't be present in this map.
         const ShardVersionMap shardVersions;
     };
 
     /**
-     * Does a single pass over the chunkMap and constructs the ChunkMapViews object.
+     * Constructs the ChunkMapViews object from the per-block summaries of the chunkMap and checks
+     * that the chunks cover the complete key space.
      */
-    static ChunkMapViews _constructChunkMapViews(const OID& epoch,
-                                                 const ChunkMap& chunkMap,
-                                                 Ordering shardKeyOrdering);
+    static ChunkMapViews _constructChunkMapViews(const ChunkMap& chunkMap);
 
     ChunkManager(NamespaceString nss,
                  boost::optional<UUID> uuid,
@@ -312,9 +479,7 @@ private:
 
     std::string _extractKeyString(const BSONObj& shardKeyValue) const;
 
-    ChunkRangeMap::const_iterator _rangeMapUpperBound(const BSONObj& key) const;
-
-    std::pair<ChunkRangeMap::const_iterator, ChunkRangeMap::const_iterator> _overlappingRanges(
+    std::pair<ChunkMap::const_iterator, ChunkMap::const_iterator> _overlappingChunks(
         const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const;
 
     // The shard versioning mechanism hinges on keeping track of the number of times we reload
@@ -338,8 +503,7 @@ private:
     // Whether the sharding key is unique
     const bool _unique;
 
-    // Map from the max for each chunk to an entry describing the chunk. The union of all chunks'
-    // ranges must cover the complete space from [MinKey, MaxKey).
+    // All chunks of the collection, sorted by max key
     const ChunkMap _chunkMap;
 
     // Different transformations of the chunk map for efficient querying
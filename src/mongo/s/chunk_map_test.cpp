@@ -0,0 +1,281 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/chunk_manager.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("TestDB", "TestColl");
+const KeyPattern kShardKeyPattern(BSON("x" << 1));
+
+ChunkType makeChunk(const BSONObj& min, const BSONObj& max, ChunkVersion version, ShardId shard) {
+    return ChunkType(kNss, ChunkRange(min, max), version, std::move(shard));
+}
+
+std::shared_ptr<ChunkManager> makeChunkManager(const OID& epoch, std::vector<int> splitPoints) {
+    std::vector<ChunkType> chunks;
+    ChunkVersion version(1, 0, epoch);
+
+    BSONObj min = kShardKeyPattern.globalMin();
+    for (int splitPoint : splitPoints) {
+        const auto max = BSON("x" << splitPoint);
+        chunks.push_back(makeChunk(min, max, version, ShardId("0")));
+        version.incMinor();
+        min = max;
+    }
+    chunks.push_back(makeChunk(min, kShardKeyPattern.globalMax(), version, ShardId("0")));
+
+    return ChunkManager::makeNew(
+        kNss, UUID::gen(), kShardKeyPattern, nullptr, false, epoch, chunks);
+}
+
+void assertChunkBounds(const ChunkManager& cm, const std::vector<BSONObj>& maxKeys) {
+    std::vector<BSONObj> actualMaxKeys;
+    for (const auto& chunk : cm.chunks()) {
+        actualMaxKeys.push_back(chunk->getMax());
+    }
+
+    ASSERT_EQ(maxKeys.size(), actualMaxKeys.size());
+    for (size_t i = 0; i < maxKeys.size(); ++i) {
+        ASSERT_BSONOBJ_EQ(maxKeys[i], actualMaxKeys[i]);
+    }
+}
+
+TEST(KeyStringArrayTest, UpperBound) {
+    KeyStringArray keys;
+    ASSERT_EQ(0U, keys.upperBound("b"));
+
+    for (auto key : {"b", "d", "f", "h", "j"}) {
+        keys.push_back(key);
+    }
+    ASSERT_EQ(5U, keys.size());
+
+    ASSERT_EQ(0U, keys.upperBound("a"));
+    ASSERT_EQ(1U, keys.upperBound("b"));
+    ASSERT_EQ(1U, keys.upperBound("c"));
+    ASSERT_EQ(4U, keys.upperBound("h"));
+    ASSERT_EQ(4U, keys.upperBound("i"));
+    ASSERT_EQ(5U, keys.upperBound("j"));
+    ASSERT_EQ(5U, keys.upperBound("z"));
+
+    // Keys which are prefixes of each other sort shorter first
+    ASSERT_EQ(1U, keys.upperBound("ba"));
+    ASSERT_EQ(0U, keys.upperBound(""));
+}
+
+TEST(KeyStringArrayTest, AppendSlice) {
+    KeyStringArray keys;
+    for (auto key : {"aa", "b", "ccc", "d"}) {
+        keys.push_back(key);
+    }
+
+    KeyStringArray slice;
+    slice.push_back("a");
+    slice.append(keys, 1, 3);
+    slice.append(keys, 3, 3);
+
+    ASSERT_EQ(3U, slice.size());
+    ASSERT_EQ("a", slice[0]);
+    ASSERT_EQ("b", slice[1]);
+    ASSERT_EQ("ccc", slice[2]);
+    ASSERT_EQ(2U, slice.upperBound("b"));
+}
+
+TEST(ChunkMapTest, SplitReplacesChunkInPlace) {
+    const OID epoch = OID::gen();
+    auto cm = makeChunkManager(epoch, {0, 10, 20});
+
+    ChunkVersion version = cm->getVersion();
+    version.incMinor();
+    const auto left = makeChunk(BSON("x" << 10), BSON("x" << 15), version, ShardId("0"));
+    version.incMinor();
+    const auto right = makeChunk(BSON("x" << 15), BSON("x" << 20), version, ShardId("0"));
+
+    auto updated = cm->makeUpdated({left, right});
+    ASSERT_EQ(5, updated->numChunks());
+    assertChunkBounds(*updated,
+                      {BSON("x" << 0),
+                       BSON("x" << 10),
+                       BSON("x" << 15),
+                       BSON("x" << 20),
+                       kShardKeyPattern.globalMax()});
+
+    ASSERT_BSONOBJ_EQ(BSON("x" << 15),
+                      updated->findIntersectingChunkWithSimpleCollation(BSON("x" << 17))->getMin());
+
+    // The original routing table is left untouched
+    ASSERT_EQ(4, cm->numChunks());
+}
+
+TEST(ChunkMapTest, MergeReplacesSeveralChunks) {
+    const OID epoch = OID::gen();
+    auto cm = makeChunkManager(epoch, {0, 10, 20, 30, 40});
+
+    ChunkVersion version = cm->getVersion();
+    version.incMajor();
+    const auto merged = makeChunk(BSON("x" << 10), BSON("x" << 40), version, ShardId("1"));
+
+    auto updated = cm->makeUpdated({merged});
+    assertChunkBounds(*updated,
+                      {BSON("x" << 0),
+                       BSON("x" << 10),
+                       BSON("x" << 40),
+                       kShardKeyPattern.globalMax()});
+
+    const auto chunk = updated->findIntersectingChunkWithSimpleCollation(BSON("x" << 25));
+    ASSERT_EQ(ShardId("1"), chunk->getShardId());
+    ASSERT_TRUE(updated->keyBelongsToShard(BSON("x" << 39), ShardId("1")));
+    ASSERT_FALSE(updated->keyBelongsToShard(BSON("x" << 40), ShardId("1")));
+}
+
+TEST(ChunkMapTest, LaterChangesReplaceEarlierOnes) {
+    const OID epoch = OID::gen();
+    auto cm = makeChunkManager(epoch, {0, 10, 20});
+
+    // Split [10, 20) into [10, 15) and [15, 20), then merge it back and move it
+    ChunkVersion version = cm->getVersion();
+    version.incMinor();
+    const auto left = makeChunk(BSON("x" << 10), BSON("x" << 15), version, ShardId("0"));
+    version.incMinor();
+    const auto right = makeChunk(BSON("x" << 15), BSON("x" << 20), version, ShardId("0"));
+    version.incMajor();
+    const auto moved = makeChunk(BSON("x" << 10), BSON("x" << 20), version, ShardId("1"));
+
+    auto updated = cm->makeUpdated({left, right, moved});
+    assertChunkBounds(*updated,
+                      {BSON("x" << 0),
+                       BSON("x" << 10),
+                       BSON("x" << 20),
+                       kShardKeyPattern.globalMax()});
+    ASSERT_EQ(ShardId("1"),
+              updated->findIntersectingChunkWithSimpleCollation(BSON("x" << 12))->getShardId());
+    ASSERT_EQ(version, updated->getVersion(ShardId("1")));
+}
+
+TEST(ChunkMapTest, ChangesAtBothEnds) {
+    const OID epoch = OID::gen();
+    auto cm = makeChunkManager(epoch, {0, 10, 20});
+
+    ChunkVersion version = cm->getVersion();
+    version.incMajor();
+    const auto first =
+        makeChunk(kShardKeyPattern.globalMin(), BSON("x" << 0), version, ShardId("1"));
+    version.incMinor();
+    const auto last =
+        makeChunk(BSON("x" << 20), kShardKeyPattern.globalMax(), version, ShardId("1"));
+
+    auto updated = cm->makeUpdated({first, last});
+    assertChunkBounds(*updated,
+                      {BSON("x" << 0),
+                       BSON("x" << 10),
+                       BSON("x" << 20),
+                       kShardKeyPattern.globalMax()});
+    ASSERT_TRUE(updated->keyBelongsToShard(BSON("x" << -5), ShardId("1")));
+    ASSERT_TRUE(updated->keyBelongsToShard(BSON("x" << 5), ShardId("0")));
+    ASSERT_TRUE(updated->keyBelongsToShard(BSON("x" << 25), ShardId("1")));
+}
+
+TEST(ChunkMapTest, UpdateSharesUntouchedBlocks) {
+    const auto chunkAt = [](int i, int shard) {
+        return std::make_shared<Chunk>(makeChunk(BSON("x" << i),
+                                                 BSON("x" << i + 1),
+                                                 ChunkVersion(1, i, OID()),
+                                                 ShardId(std::to_string(shard))));
+    };
+
+    // Fixed-width keys sort the same way as the numbers they encode
+    const auto keyAt = [](int i) {
+        const auto digits = std::to_string(i);
+        return std::string(8 - digits.size(), '0') + digits;
+    };
+
+    const int numChunks = 3 * ChunkMap::kMaxChunksPerBlock;
+    std::vector<ChunkMap::ChangedChunk> initial;
+    for (int i = 0; i < numChunks; ++i) {
+        initial.push_back({keyAt(i), keyAt(i + 1), chunkAt(i, 0)});
+    }
+
+    const auto chunkMap = ChunkMap().createMerged(initial);
+    ASSERT_EQ(size_t(numChunks), chunkMap.size());
+    ASSERT_EQ(3U, chunkMap.numBlocks());
+
+    // Move a single chunk in the middle block
+    const int moved = numChunks / 2;
+    const auto updated =
+        chunkMap.createMerged({{keyAt(moved), keyAt(moved + 1), chunkAt(moved, 1)}});
+    ASSERT_EQ(size_t(numChunks), updated.size());
+
+    ASSERT_TRUE(updated.sharesBlockWith(chunkMap, updated.begin()));
+    ASSERT_FALSE(updated.sharesBlockWith(chunkMap, updated.upperBound(keyAt(moved))));
+    ASSERT_TRUE(updated.sharesBlockWith(chunkMap, updated.upperBound(keyAt(numChunks - 1))));
+
+    const auto it = updated.upperBound(keyAt(moved));
+    ASSERT_EQ(ShardId("1"), (*it)->getShardId());
+    ASSERT_EQ(ShardId("0"), (*updated.upperBound(keyAt(moved + 1)))->getShardId());
+
+    // Runs of chunks on the same shard are skipped over at once
+    size_t numRuns = 0;
+    for (auto run = updated.begin(); run < updated.end(); run = run.nextShardRun()) {
+        ++numRuns;
+    }
+    ASSERT_EQ(5U, numRuns);
+}
+
+TEST(ChunkMapTest, ShardVersionsAcrossBlocks) {
+    const OID epoch = OID::gen();
+    std::vector<int> splitPoints;
+    for (size_t i = 1; i < 2 * ChunkMap::kMaxChunksPerBlock + 10; ++i) {
+        splitPoints.push_back(i);
+    }
+    auto cm = makeChunkManager(epoch, splitPoints);
+
+    ChunkVersion version = cm->getVersion();
+    version.incMajor();
+    const auto moved = makeChunk(BSON("x" << 100), BSON("x" << 101), version, ShardId("1"));
+
+    auto updated = cm->makeUpdated({moved});
+    ASSERT_EQ(cm->numChunks(), updated->numChunks());
+    ASSERT_EQ(version, updated->getVersion(ShardId("1")));
+    ASSERT_EQ(version, updated->getVersion());
+
+    std::set<ShardId> shardIds;
+    updated->getShardIdsForRange(BSON("x" << 50), BSON("x" << 2000), &shardIds);
+    ASSERT_EQ(2U, shardIds.size());
+
+    shardIds.clear();
+    updated->getShardIdsForRange(BSON("x" << 101), BSON("x" << 2000), &shardIds);
+    ASSERT_EQ(1U, shardIds.size());
+    ASSERT_EQ(1U, shardIds.count(ShardId("0")));
+}
+
+}  // namespace
+}  // namespace mongo
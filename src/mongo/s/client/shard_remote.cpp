@@ -44,6 +44,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/query_request.h"
 #include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/ticket_priority.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/metadata/repl_set_metadata.h"
@@ -179,10 +180,14 @@ StatusWith<Shard::CommandResponse> ShardRemote::_runCommand(OperationContext* op
     const Milliseconds requestTimeout =
         std::min(opCtx->getRemainingMaxTimeMillis(), maxTimeMSOverride);
 
+    // Commands sent to the config servers, such as routing table refreshes, are shared by all
+    // operations and do not inherit the priority of the one which triggered them
+    const BSONObj cmdObjWithPriority = isConfig() ? cmdObj : appendTicketPriority(opCtx, cmdObj);
+
     const RemoteCommandRequest request(
         host,
         dbName,
-        appendMaxTimeToCmdObj(requestTimeout, cmdObj),
+        appendMaxTimeToCmdObj(requestTimeout, cmdObjWithPriority),
         _appendMetadataForCommand(opCtx, readPrefWithMinOpTime),
         opCtx,
         requestTimeout < Milliseconds::max() ? requestTimeout : RemoteCommandRequest::kNoTimeout);
@@ -54,6 +54,7 @@
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/query_request.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/ticket_priority.h"
 #include "mongo/db/views/resolved_view.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/get_status_from_command_result.h"
@@ -182,6 +183,9 @@ void execCommandClient(OperationContext* opCtx,
 
     c->incrementCommandsExecuted();
 
+    Timer executionTimer;
+    ON_BLOCK_EXIT([&] { c->recordLatency(executionTimer.micros()); });
+
     if (c->shouldAffectCommandCounter()) {
         globalOpCounters.gotCommand();
     }
@@ -270,6 +274,12 @@ void runCommand(OperationContext* opCtx, const OpMsgRequest& request, BSONObjBui
 
     initializeOperationSessionInfo(opCtx, request.body, command->requiresAuth(), true, true);
 
+    // Handle command option priority. The commands sent to the shards on behalf of a low priority
+    // operation carry it, so that they queue for tickets at low priority there as well.
+    const auto priority = uassertStatusOK(resolveTicketPriority(
+        opCtx, request.body[kTicketPriorityFieldName], command->getTicketPriority()));
+    setOperationTicketPriority(opCtx, priority);
+
     int loops = 5;
 
     while (true) {
@@ -38,8 +38,11 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/ticket_priority.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 
@@ -49,6 +52,15 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// Budget for the documents buffered by one merger, within which the next batch is requested from a
+// remote before its buffer runs dry. Zero disables reading ahead.
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryARMReadAheadBufferBytes, int, 0);
+
+// Statistics across all mergers, reported in serverStatus
+AtomicInt64 totalRemoteWaitTimeMillis{0};
+AtomicInt64 countReadAheadBatches{0};
+AtomicInt64 countReadAheadBatchesWithoutWait{0};
+
 /**
  * Returns the sort key out of the $sortKey metadata field in 'obj'. This object is of the form
  * {'': 'firstSortKey', '': 'secondSortKey', ...}.
@@ -271,7 +283,7 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return hasSort ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_params->tailableMode != TailableMode::kTailable);
 
@@ -285,8 +297,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     invariant(!_remotes[smallestRemote].docBuffer.empty());
     invariant(_remotes[smallestRemote].status.isOK());
 
-    ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
-    _remotes[smallestRemote].docBuffer.pop();
+    ClusterQueryResult front = _popNextResult(lk, smallestRemote);
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
@@ -297,15 +308,14 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     return front;
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock lk) {
     size_t remotesAttempted = 0;
     while (remotesAttempted < _remotes.size()) {
         // It is illegal to call this method if there is an error received from any shard.
         invariant(_remotes[_gettingFromRemote].status.isOK());
 
         if (_remotes[_gettingFromRemote].hasNext()) {
-            ClusterQueryResult front = _remotes[_gettingFromRemote].docBuffer.front();
-            _remotes[_gettingFromRemote].docBuffer.pop();
+            ClusterQueryResult front = _popNextResult(lk, _gettingFromRemote);
 
             if (_params->tailableMode == TailableMode::kTailable &&
                 !_remotes[_gettingFromRemote].hasNext()) {
@@ -328,6 +338,46 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
     return {};
 }
 
+ClusterQueryResult AsyncResultsMerger::_popNextResult(WithLock lk, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    ClusterQueryResult front = remote.docBuffer.front();
+    remote.docBuffer.pop();
+
+    const long long resultBytes = front.getResult() ? front.getResult()->objsize() : 0;
+    remote.bufferedBytes -= resultBytes;
+    _bufferedBytes -= resultBytes;
+
+    if (_shouldReadAhead(lk, remoteIndex)) {
+        remote.status = _askForNextBatch(lk, remoteIndex);
+        if (remote.status.isOK()) {
+            remote.readAheadPending = true;
+            countReadAheadBatches.addAndFetch(1);
+        }
+    }
+
+    return front;
+}
+
+bool AsyncResultsMerger::_shouldReadAhead(WithLock, size_t remoteIndex) const {
+    const long long budget = internalQueryARMReadAheadBufferBytes.load();
+    if (budget <= 0 || _params->tailableMode != TailableMode::kNormal ||
+        _lifecycleState != kAlive) {
+        return false;
+    }
+
+    const auto& remote = _remotes[remoteIndex];
+
+    // A remote with no buffered results is asked for its next batch by nextEvent() as usual
+    if (!remote.status.isOK() || remote.exhausted() || remote.cbHandle.isValid() ||
+        !remote.hasNext()) {
+        return false;
+    }
+
+    return remote.docBuffer.size() <= remote.lastBatchSize / 2 &&
+        _bufferedBytes + remote.lastBatchBytes <= budget;
+}
+
 Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
     auto& remote = _remotes[remoteIndex];
 
@@ -349,6 +399,7 @@ Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
                                     boost::none,
                                     boost::none)
                          .toBSON();
+    cmdObj = appendTicketPriority(_opCtx, cmdObj);
 
     executor::RemoteCommandRequest request(
         remote.getTargetHost(), _params->nsString.db().toString(), cmdObj, _metadataObj, _opCtx);
@@ -399,7 +450,15 @@ StatusWith<executor::TaskExecutor::EventHandle> AsyncResultsMerger::nextEvent()
             return remote.status;
         }
 
-        if (!remote.hasNext() && !remote.exhausted() && !remote.cbHandle.isValid()) {
+        if (remote.hasNext() || remote.exhausted()) {
+            continue;
+        }
+
+        if (!remote.waitStart) {
+            remote.waitStart = _executor->now();
+        }
+
+        if (!remote.cbHandle.isValid()) {
             // If this remote is not exhausted and there is no outstanding request for it, schedule
             // work to retrieve the next batch.
             auto nextBatchStatus = _askForNextBatch(lk, i);
@@ -492,7 +551,22 @@ void AsyncResultsMerger::_handleBatchResponse(WithLock lk,
                                               CbData const& cbData,
                                               size_t remoteIndex) {
     // Got a response from remote, so indicate we are no longer waiting for one.
-    _remotes[remoteIndex].cbHandle = executor::TaskExecutor::CallbackHandle();
+    auto& remote = _remotes[remoteIndex];
+    remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+
+    if (remote.waitStart) {
+        const auto waitTime = duration_cast<Milliseconds>(_executor->now() - *remote.waitStart);
+        remote.totalWaitTime += waitTime;
+        remote.waitStart = boost::none;
+        totalRemoteWaitTimeMillis.addAndFetch(durationCount<Milliseconds>(waitTime));
+    } else if (remote.readAheadPending) {
+        countReadAheadBatchesWithoutWait.addAndFetch(1);
+    }
+
+    if (remote.readAheadPending) {
+        ++remote.numReadAheadBatches;
+        remote.readAheadPending = false;
+    }
 
     //  On shutdown, there is no need to process the response.
     if (_lifecycleState != kAlive) {
@@ -534,6 +608,8 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
         // Clear the results buffer and cursor id.
         std::queue<ClusterQueryResult> emptyBuffer;
         std::swap(remote.docBuffer, emptyBuffer);
+        _bufferedBytes -= remote.bufferedBytes;
+        remote.bufferedBytes = 0;
         remote.cursorId = 0;
     }
 }
@@ -562,6 +638,13 @@ void AsyncResultsMerger::_processBatchResults(WithLock lk,
         return;
     }
 
+    if (remote.exhausted()) {
+        LOG(1) << "Remote cursor on " << remote.getTargetHost() << " for " << remote.cursorNss
+               << " exhausted after the merger waited " << remote.totalWaitTime
+               << " for its results, with " << remote.numReadAheadBatches
+               << " batches requested ahead of time";
+    }
+
     // If the cursor is tailable and we just received an empty batch, the next return value should
     // be boost::none in order to indicate the end of the batch. We do not ask for the next batch if
     // the cursor is tailable, as batches received from remote tailable cursors should be passed
@@ -583,6 +666,13 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                            const CursorResponse& response) {
     auto& remote = _remotes[remoteIndex];
     updateRemoteMetadata(&remote, response);
+
+    // A remote which still has buffered results, because its next batch was requested ahead of
+    // time, is already on the merge queue
+    const bool wasBuffering = remote.hasNext();
+
+    remote.lastBatchSize = response.getBatch().size();
+    remote.lastBatchBytes = 0;
     for (const auto& obj : response.getBatch()) {
         // If there's a sort, we're expecting the remote node to have given us back a sort key.
         if (!_params->sort.isEmpty()) {
@@ -607,11 +697,16 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
         ClusterQueryResult result(obj);
         remote.docBuffer.push(result);
         ++remote.fetchedCount;
+
+        remote.lastBatchBytes += obj.objsize();
     }
 
+    remote.bufferedBytes += remote.lastBatchBytes;
+    _bufferedBytes += remote.lastBatchBytes;
+
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the
     // merge queue.
-    if (!_params->sort.isEmpty() && !response.getBatch().empty()) {
+    if (!_params->sort.isEmpty() && !response.getBatch().empty() && !wasBuffering) {
         _mergeQueue.push(remoteIndex);
     }
     return true;
@@ -696,6 +791,12 @@ executor::TaskExecutor::EventHandle AsyncResultsMerger::kill(OperationContext* o
     return _killCompleteEvent;
 }
 
+void AsyncResultsMerger::reportStats(BSONObjBuilder* builder) {
+    builder->append("totalRemoteWaitTimeMillis", totalRemoteWaitTimeMillis.load());
+    builder->append("countReadAheadBatches", countReadAheadBatches.load());
+    builder->append("countReadAheadBatchesWithoutWait", countReadAheadBatchesWithoutWait.load());
+}
+
 //
 // AsyncResultsMerger::RemoteCursorData
 //
@@ -46,6 +46,7 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class CursorResponse;
 
 /**
@@ -67,6 +68,11 @@ class CursorResponse;
  * This requires waiting until we have a response from every remote before returning results.
  * Without a sort, we are ready to return results as soon as we have *any* response from a remote.
  *
+ * If the internalQueryARMReadAheadBufferBytes server parameter is set, the next batch is requested
+ * from a remote once half of its previous batch has been consumed, rather than once its buffer is
+ * empty, as long as the documents buffered across all remotes fit within that many bytes. This
+ * hides the round trip to the remotes which would otherwise run dry during a sorted merge.
+ *
  * On any error, the caller is responsible for shutting down the ARM using the kill() method.
  *
  * Does not throw exceptions.
@@ -203,6 +209,12 @@ public:
      */
     executor::TaskExecutor::EventHandle kill(OperationContext* opCtx);
 
+    /**
+     * Reports statistics accumulated across all AsyncResultsMergers in this process for
+     * serverStatus.
+     */
+    static void reportStats(BSONObjBuilder* builder);
+
 private:
     /**
      * We instantiate one of these per remote host. It contains the buffer of results we've
@@ -261,6 +273,26 @@ private:
         // Count of fetched docs during ARM processing of the current batch. Used to reduce the
         // batchSize in getMore when mongod returned less docs than the requested batchSize.
         long long fetchedCount = 0;
+
+        // Total size of the documents in 'docBuffer'.
+        long long bufferedBytes = 0;
+
+        // Number of documents and their total size in the last batch received from this remote.
+        // Used to decide when to read ahead and whether the next batch fits in the memory budget.
+        size_t lastBatchSize = 0;
+        long long lastBatchBytes = 0;
+
+        // Set if the pending request was issued while there were still results buffered.
+        bool readAheadPending = false;
+
+        // Set to when the merger had to start waiting for results from this remote, if it is
+        // currently waiting on it.
+        boost::optional<Date_t> waitStart;
+
+        // Total time the merger spent waiting for results from this remote, and how many of the
+        // batches received from it were requested ahead of time.
+        Milliseconds totalWaitTime{0};
+        long long numReadAheadBatches = 0;
     };
 
     class MergingComparator {
@@ -357,6 +389,19 @@ private:
      */
     bool _addBatchToBuffer(WithLock, size_t remoteIndex, const CursorResponse& response);
 
+    /**
+     * Removes and returns the first buffered result of the remote at 'remoteIndex', then requests
+     * the next batch from that remote ahead of time if read-ahead is enabled and the remote's
+     * buffer has fallen below its low-water mark.
+     */
+    ClusterQueryResult _popNextResult(WithLock, size_t remoteIndex);
+
+    /**
+     * Returns whether the next batch should be requested from the remote at 'remoteIndex' while
+     * it still has buffered results.
+     */
+    bool _shouldReadAhead(WithLock, size_t remoteIndex) const;
+
     /**
      * If there is a valid unsignaled event that has been requested via nextEvent() and there are
      * buffered results that are ready to return, signals that event.
@@ -405,6 +450,10 @@ private:
 
     Status _status = Status::OK();
 
+    // Total size of the documents buffered for all remotes, which read-ahead keeps within the
+    // configured budget.
+    long long _bufferedBytes = 0;
+
     executor::TaskExecutor::EventHandle _currentEvent;
 
     // For tailable cursors, set to true if the next result returned from nextReady() should be
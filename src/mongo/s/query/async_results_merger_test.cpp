@@ -36,6 +36,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/query_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/network_interface_mock.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/executor/thread_pool_task_executor_test_fixture.h"
@@ -44,6 +45,7 @@
 #include "mongo/s/sharding_test_fixture.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -284,6 +286,78 @@ TEST_F(AsyncResultsMergerTest, SingleShardUnsorted) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, SortedMergeReadsAheadWithinBudget) {
+    auto* param = ServerParameterSet::getGlobal()
+                      ->getMap()
+                      .find("internalQueryARMReadAheadBufferBytes")
+                      ->second;
+    ASSERT_OK(param->setFromString("1048576"));
+    ON_BLOCK_EXIT([&] { invariant(param->setFromString("0").isOK()); });
+
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+    std::vector<ClusterClientCursorParams::RemoteCursor> cursors;
+    std::vector<BSONObj> batch1 = {fromjson("{$sortKey: {'': 1}}"),
+                                   fromjson("{$sortKey: {'': 3}}"),
+                                   fromjson("{$sortKey: {'': 5}}"),
+                                   fromjson("{$sortKey: {'': 7}}")};
+    cursors.emplace_back(kTestShardIds[0], kTestShardHosts[0], CursorResponse(_nss, 5, batch1));
+    std::vector<BSONObj> batch2 = {fromjson("{$sortKey: {'': 2}}"),
+                                   fromjson("{$sortKey: {'': 4}}"),
+                                   fromjson("{$sortKey: {'': 6}}"),
+                                   fromjson("{$sortKey: {'': 8}}")};
+    cursors.emplace_back(kTestShardIds[1], kTestShardHosts[1], CursorResponse(_nss, 6, batch2));
+    makeCursorFromExistingCursors(std::move(cursors), findCmd);
+
+    const auto assertNextSortKey = [&](int sortKey) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("$sortKey" << BSON("" << sortKey)),
+                          *unittest::assertGet(arm->nextReady()).getResult());
+    };
+
+    // Nothing is requested while the remotes have more than half of their batch buffered.
+    assertNextSortKey(1);
+    assertNextSortKey(2);
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    // Consuming half of the first remote's batch requests its next batch ahead of time.
+    assertNextSortKey(3);
+    ASSERT_TRUE(networkHasReadyRequests());
+    ASSERT_EQ(5,
+              unittest::assertGet(
+                  GetMoreRequest::parseFromBSON("testdb", getNthPendingRequest(0u).cmdObj))
+                  .cursorid);
+
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch3 = {fromjson("{$sortKey: {'': 9}}"),
+                                   fromjson("{$sortKey: {'': 11}}")};
+    responses.emplace_back(_nss, CursorId(0), batch3);
+    scheduleNetworkResponses(std::move(responses),
+                             CursorResponse::ResponseType::SubsequentResponse);
+
+    assertNextSortKey(4);
+    ASSERT_TRUE(networkHasReadyRequests());
+    ASSERT_EQ(6,
+              unittest::assertGet(
+                  GetMoreRequest::parseFromBSON("testdb", getNthPendingRequest(0u).cmdObj))
+                  .cursorid);
+
+    responses.clear();
+    std::vector<BSONObj> batch4 = {fromjson("{$sortKey: {'': 10}}"),
+                                   fromjson("{$sortKey: {'': 12}}")};
+    responses.emplace_back(_nss, CursorId(0), batch4);
+    scheduleNetworkResponses(std::move(responses),
+                             CursorResponse::ResponseType::SubsequentResponse);
+
+    // The batches which arrived while results were still buffered merge in order.
+    for (int sortKey = 5; sortKey <= 12; ++sortKey) {
+        assertNextSortKey(sortKey);
+    }
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, SingleShardSorted) {
     BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
     std::vector<ClusterClientCursorParams::RemoteCursor> cursors;
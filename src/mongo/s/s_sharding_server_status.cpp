@@ -34,6 +34,8 @@
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/query/async_results_merger.h"
+#include "mongo/s/write_ops/batch_write_exec.h"
 
 namespace mongo {
 namespace {
@@ -82,6 +84,15 @@ public:
 
         BSONObjBuilder result;
         catalogCache->report(&result);
+
+        BSONObjBuilder mergerStatsBuilder(result.subobjStart("asyncResultsMerger"));
+        AsyncResultsMerger::reportStats(&mergerStatsBuilder);
+        mergerStatsBuilder.doneFast();
+
+        BSONObjBuilder writeLatencyBuilder(result.subobjStart("shardWriteLatencies"));
+        ShardWriteLatencyStats::get(opCtx).report(&writeLatencyBuilder);
+        writeLatencyBuilder.doneFast();
+
         return result.obj();
     }
 
@@ -48,6 +48,7 @@
 #include "mongo/db/auth/authz_manager_external_state_s.h"
 #include "mongo/db/auth/user_cache_invalidator_job.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/cpu_sampling_profile.h"
 #include "mongo/db/ftdc/ftdc_mongos.h"
 #include "mongo/db/initialize_server_global_state.h"
 #include "mongo/db/kill_sessions.h"
@@ -421,6 +422,8 @@ ExitCode runMongosServer(ServiceContext* serviceContext) {
         cacheInvalidatorThread.go();
     }
 
+    startCpuSamplingProfiler();
+
     PeriodicTask::startRunningPeriodicTasks();
 
     // Set up the periodic runner for background job execution
@@ -87,6 +87,58 @@ StatusWith<long long> retrieveTotalShardSize(OperationContext* opCtx, const Shar
     return totalSizeElem.numberLong();
 }
 
+StatusWith<std::vector<std::pair<ChunkRange, long long>>> retrieveChunkDataSizes(
+    OperationContext* opCtx, const ShardId& shardId, const NamespaceString& nss) {
+    auto shardStatus = Grid::get(opCtx)->shardRegistry()->getShard(opCtx, shardId);
+    if (!shardStatus.isOK()) {
+        return shardStatus.getStatus();
+    }
+
+    auto cmdStatus = shardStatus.getValue()->runCommandWithFixedRetryAttempts(
+        opCtx,
+        ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+        "admin",
+        BSON("_shardsvrGetChunkDataSizes" << nss.ns()),
+        Shard::RetryPolicy::kIdempotent);
+
+    if (!cmdStatus.isOK()) {
+        return std::move(cmdStatus.getStatus());
+    }
+
+    if (!cmdStatus.getValue().commandStatus.isOK()) {
+        return std::move(cmdStatus.getValue().commandStatus);
+    }
+
+    BSONElement chunksElem = cmdStatus.getValue().response["chunks"];
+    if (chunksElem.type() != Array) {
+        return {ErrorCodes::NoSuchKey, "chunks field not found in _shardsvrGetChunkDataSizes"};
+    }
+
+    std::vector<std::pair<ChunkRange, long long>> chunkDataSizes;
+
+    for (const auto& chunkElem : chunksElem.Obj()) {
+        if (chunkElem.type() != Object) {
+            return {ErrorCodes::NoSuchKey, "chunk entry in _shardsvrGetChunkDataSizes is invalid"};
+        }
+
+        const BSONObj chunkObj = chunkElem.Obj();
+
+        auto swRange = ChunkRange::fromBSON(chunkObj);
+        if (!swRange.isOK()) {
+            return swRange.getStatus();
+        }
+
+        BSONElement sizeElem = chunkObj["size"];
+        if (!sizeElem.isNumber()) {
+            return {ErrorCodes::NoSuchKey, "size field not found in chunk entry"};
+        }
+
+        chunkDataSizes.emplace_back(std::move(swRange.getValue()), sizeElem.numberLong());
+    }
+
+    return std::move(chunkDataSizes);
+}
+
 StatusWith<std::vector<BSONObj>> selectChunkSplitPoints(OperationContext* opCtx,
                                                         const ShardId& shardId,
                                                         const NamespaceString& nss,
@@ -60,6 +60,19 @@ namespace shardutil {
  */
 StatusWith<long long> retrieveTotalShardSize(OperationContext* opCtx, const ShardId& shardId);
 
+/**
+ * Asks the primary of the specified shard to estimate the size in bytes of the data in each chunk
+ * of the given collection, which the shard owns. Orphaned documents are not counted towards any
+ * chunk.
+ *
+ * Returns OK with the range and estimated data size of each chunk or an error. Known errors are:
+ *  ShardNotFound if shard by that id is not available on the registry
+ *  NamespaceNotSharded if the shard does not know the collection as sharded
+ *  NoSuchKey if the chunk sizes could not be retrieved from the response
+ */
+StatusWith<std::vector<std::pair<ChunkRange, long long>>> retrieveChunkDataSizes(
+    OperationContext* opCtx, const ShardId& shardId, const NamespaceString& nss);
+
 /**
  * Ask the specified shard to figure out the split points for a given chunk.
  *
@@ -38,12 +38,16 @@
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/connection_string.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/s/async_requests_sender.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/write_ops/batch_write_op.h"
 #include "mongo/s/write_ops/write_error_detail.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -51,6 +55,11 @@ namespace {
 
 const ReadPreferenceSetting kPrimaryOnlyReadPreference(ReadPreference::PrimaryOnly);
 
+// Maximum number of child batches of an unordered write which may be outstanding on one shard
+MONGO_EXPORT_SERVER_PARAMETER(maxInFlightWriteBatchesPerShard, int, 2);
+
+const auto getShardWriteLatencyStats = ServiceContext::declareDecoration<ShardWriteLatencyStats>();
+
 //
 // Map which allows associating ConnectionString hosts with TargetedWriteBatches
 // This is needed since the dispatcher only returns hosts with responses.
@@ -122,53 +131,60 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
         //    exactly when the metadata changed.
         //
 
-        OwnedPointerMap<ShardId, TargetedWriteBatch> childBatchesOwned;
-        std::map<ShardId, TargetedWriteBatch*>& childBatches = childBatchesOwned.mutableMap();
+        // Unordered writes without a transaction number can be split into several waves of child
+        // batches, which are all sent before waiting for any response, so that each shard keeps
+        // up to maxInFlightWriteBatchesPerShard batches busy instead of waiting for the slowest
+        // shard after every batch. Each wave has at most one batch per shard.
+        const size_t maxWaves =
+            (clientRequest.getWriteCommandBase().getOrdered() || opCtx->getTxnNumber())
+            ? 1
+            : std::max(1, maxInFlightWriteBatchesPerShard.load());
+
+        std::vector<std::unique_ptr<OwnedShardBatchMap>> waves;
 
         // If we've already had a targeting error, we've refreshed the metadata once and can
         // record target errors definitively.
         bool recordTargetErrors = refreshedTargeter;
-        Status targetStatus = batchOp.targetBatch(targeter, recordTargetErrors, &childBatches);
-        if (!targetStatus.isOK()) {
-            // Don't do anything until a targeter refresh
-            targeter.noteCouldNotTarget();
-            refreshedTargeter = true;
-            ++stats->numTargetErrors;
-            dassert(childBatches.size() == 0u);
+
+        while (waves.size() < maxWaves) {
+            auto wave = stdx::make_unique<OwnedShardBatchMap>();
+            std::map<ShardId, TargetedWriteBatch*>& childBatches = wave->mutableMap();
+
+            Status targetStatus = batchOp.targetBatch(targeter, recordTargetErrors, &childBatches);
+            if (!targetStatus.isOK()) {
+                // Don't do anything until a targeter refresh
+                targeter.noteCouldNotTarget();
+                refreshedTargeter = true;
+                ++stats->numTargetErrors;
+                dassert(childBatches.size() == 0u);
+                break;
+            }
+
+            // Stop once all the remaining writes have been targeted
+            if (childBatches.empty()) {
+                break;
+            }
+
+            waves.push_back(std::move(wave));
         }
 
         //
         // Send all child batches
         //
 
-        const size_t numToSend = childBatches.size();
-        size_t numSent = 0;
-
-        while (numSent != numToSend) {
-            // Collect batches out on the network, mapped by endpoint
-            OwnedShardBatchMap ownedPendingBatches;
-            OwnedShardBatchMap::MapType& pendingBatches = ownedPendingBatches.mutableMap();
+        std::vector<std::unique_ptr<AsyncRequestsSender>> senders;
 
+        for (const auto& wave : waves) {
             //
             // Construct the requests.
             //
 
             std::vector<AsyncRequestsSender::Request> requests;
 
-            // Get as many batches as we can at once
-            for (auto& childBatch : childBatches) {
-                TargetedWriteBatch* const nextBatch = childBatch.second;
-
-                // If the batch is nullptr, we sent it previously, so skip
-                if (!nextBatch)
-                    continue;
-
-                // If we already have a batch for this shard, wait until the next time
+            for (const auto& childBatch : wave->map()) {
+                const TargetedWriteBatch* const nextBatch = childBatch.second;
                 const auto& targetShardId = nextBatch->getEndpoint().shardName;
 
-                if (pendingBatches.count(targetShardId))
-                    continue;
-
                 const auto request = [&] {
                     const auto shardBatchRequest(batchOp.buildBatchRequest(*nextBatch));
 
@@ -192,28 +208,27 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                 LOG(4) << "Sending write batch to " << targetShardId << ": " << redact(request);
 
                 requests.emplace_back(targetShardId, request);
-
-                // Indicate we're done by setting the batch to nullptr. We'll only get duplicate
-                // hostEndpoints if we have broadcast and non-broadcast endpoints for the same host,
-                // so this should be pretty efficient without moving stuff around.
-                childBatch.second = nullptr;
-
-                // Recv-side is responsible for cleaning up the nextBatch when used
-                pendingBatches.emplace(targetShardId, nextBatch);
             }
 
-            AsyncRequestsSender ars(opCtx,
-                                    Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
-                                    clientRequest.getTargetingNS().db().toString(),
-                                    requests,
-                                    kPrimaryOnlyReadPreference,
-                                    opCtx->getTxnNumber() ? Shard::RetryPolicy::kIdempotent
-                                                          : Shard::RetryPolicy::kNoRetry);
-            numSent += pendingBatches.size();
+            senders.push_back(stdx::make_unique<AsyncRequestsSender>(
+                opCtx,
+                Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
+                clientRequest.getTargetingNS().db().toString(),
+                requests,
+                kPrimaryOnlyReadPreference,
+                opCtx->getTxnNumber() ? Shard::RetryPolicy::kIdempotent
+                                      : Shard::RetryPolicy::kNoRetry));
+        }
+
+        //
+        // Receive the responses.
+        //
 
-            //
-            // Receive the responses.
-            //
+        for (size_t waveIndex = 0; waveIndex < waves.size(); ++waveIndex) {
+            // Batches out on the network, mapped by endpoint. The wave owns the batches and cleans
+            // them up once all its responses have been received.
+            const auto& pendingBatches = waves[waveIndex]->map();
+            auto& ars = *senders[waveIndex];
 
             while (!ars.done()) {
                 // Block until a response is available.
@@ -235,12 +250,6 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                     // and retarget the batch
                     LOG(4) << "Unable to send write batch to " << batch->getEndpoint().shardName
                            << causedBy(response.swResponse.getStatus());
-
-                    // We're done with this batch. Clean up when we can't resolve a host.
-                    auto it = childBatches.find(batch->getEndpoint().shardName);
-                    invariant(it != childBatches.end());
-                    delete it->second;
-                    it->second = nullptr;
                     continue;
                 }
 
@@ -250,6 +259,11 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                 Status responseStatus = response.swResponse.getStatus();
                 BatchedCommandResponse batchedCommandResponse;
                 if (responseStatus.isOK()) {
+                    const auto& elapsed = response.swResponse.getValue().elapsedMillis;
+                    if (elapsed) {
+                        ShardWriteLatencyStats::get(opCtx).record(response.shardId, *elapsed);
+                    }
+
                     std::string errMsg;
                     if (!batchedCommandResponse.parseBSON(response.swResponse.getValue().data,
                                                           &errMsg) ||
@@ -370,4 +384,26 @@ const HostOpTimeMap& BatchWriteExecStats::getWriteOpTimes() const {
     return _writeOpTimes;
 }
 
+ShardWriteLatencyStats& ShardWriteLatencyStats::get(ServiceContext* serviceContext) {
+    return getShardWriteLatencyStats(serviceContext);
+}
+
+ShardWriteLatencyStats& ShardWriteLatencyStats::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+void ShardWriteLatencyStats::record(const ShardId& shardId, Milliseconds latency) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _histograms[shardId].increment(durationCount<Microseconds>(latency),
+                                   Command::ReadWriteType::kWrite);
+}
+
+void ShardWriteLatencyStats::report(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (const auto& histogram : _histograms) {
+        BSONObjBuilder shardBuilder(builder->subobjStart(histogram.first.toString()));
+        histogram.second.append(true, &shardBuilder);
+    }
+}
+
 }  // namespace
@@ -34,14 +34,20 @@
 #include "mongo/bson/timestamp.h"
 #include "mongo/client/connection_string.h"
 #include "mongo/db/repl/optime.h"
+#include "mongo/db/stats/operation_latency_histogram.h"
 #include "mongo/s/ns_targeter.h"
+#include "mongo/s/shard_id.h"
 #include "mongo/s/write_ops/batched_command_request.h"
 #include "mongo/s/write_ops/batched_command_response.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
 class BatchWriteExecStats;
+class BSONObjBuilder;
 class OperationContext;
+class ServiceContext;
 
 /**
  * The BatchWriteExec is able to execute client batch write requests, resulting in a batch
@@ -57,6 +63,9 @@ class OperationContext;
  * Both the targeter and dispatcher are assumed to be dedicated to this particular
  * BatchWriteExec instance.
  *
+ * Unordered batches are sent to each shard in several child batches at once, up to the
+ * maxInFlightWriteBatchesPerShard server parameter, so that a slow shard does not hold back the
+ * writes to the others after every child batch.
  */
 class BatchWriteExec {
 public:
@@ -106,4 +115,28 @@ private:
     HostOpTimeMap _writeOpTimes;
 };
 
+/**
+ * Latency histograms of the child write batches sent to each shard, accumulated across all the
+ * batch writes executed by this process.
+ */
+class ShardWriteLatencyStats {
+public:
+    static ShardWriteLatencyStats& get(ServiceContext* serviceContext);
+    static ShardWriteLatencyStats& get(OperationContext* opCtx);
+
+    /**
+     * Records how long a shard took to respond to a child write batch.
+     */
+    void record(const ShardId& shardId, Milliseconds latency);
+
+    /**
+     * Appends the histogram of each shard for serverStatus.
+     */
+    void report(BSONObjBuilder* builder) const;
+
+private:
+    mutable stdx::mutex _mutex;
+    std::map<ShardId, OperationLatencyHistogram> _histograms;
+};
+
 }  // namespace mongo
@@ -255,6 +255,46 @@ TEST_F(BatchWriteExecTest, MultiOpLarge) {
     future.timed_get(kFutureTimeout);
 }
 
+TEST_F(BatchWriteExecTest, UnorderedMultiOpLargeSendsBatchesTogether) {
+    const int kNumDocsToInsert = 100'000;
+    const std::string kDocValue(200, 'x');
+
+    std::vector<BSONObj> docsToInsert;
+    docsToInsert.reserve(kNumDocsToInsert);
+    for (int i = 0; i < kNumDocsToInsert; i++) {
+        docsToInsert.push_back(BSON("_id" << i << "someLargeKeyToWasteSpace" << kDocValue));
+    }
+
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setWriteCommandBase([] {
+            write_ops::WriteCommandBase writeCommandBase;
+            writeCommandBase.setOrdered(false);
+            return writeCommandBase;
+        }());
+        insertOp.setDocuments(docsToInsert);
+        return insertOp;
+    }());
+    request.setWriteConcern(BSONObj());
+
+    auto future = launchAsync([&] {
+        BatchedCommandResponse response;
+        BatchWriteExecStats stats;
+        BatchWriteExec::executeBatch(operationContext(), nsTargeter, request, &response, &stats);
+
+        ASSERT(response.getOk());
+        ASSERT_EQUALS(response.getN(), kNumDocsToInsert);
+
+        // Both child batches were in flight on the shard at the same time
+        ASSERT_EQUALS(stats.numRounds, 1);
+    });
+
+    expectInsertsReturnSuccess(docsToInsert.begin(), docsToInsert.begin() + 66576);
+    expectInsertsReturnSuccess(docsToInsert.begin() + 66576, docsToInsert.end());
+
+    future.timed_get(kFutureTimeout);
+}
+
 TEST_F(BatchWriteExecTest, SingleOpError) {
     BatchedCommandResponse errResponse;
     errResponse.setStatus({ErrorCodes::UnknownError, "mock error"});
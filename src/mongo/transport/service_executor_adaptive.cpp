@@ -39,6 +39,7 @@
 #include "mongo/transport/service_entry_point_utils.h"
 #include "mongo/transport/service_executor_task_names.h"
 #include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/cpu_sampling_profiler.h"
 #include "mongo/util/duration.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/thread_idle_callback.h"
@@ -236,7 +237,10 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
         });
 
         TickTimer _localTimer(_tickSource);
-        task();
+        {
+            CpuSamplingProfiler::ScopedTag profilerTag(taskNameToString(taskName).rawData());
+            task();
+        }
         _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
             ._totalSpentExecuting.addAndFetch(_localTimer.sinceStartTicks());
 
@@ -0,0 +1,142 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/adaptive_ticket_controller.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+AdaptiveTicketController::AdaptiveTicketController(TicketHolder* holder, Options options)
+    : _holder(holder),
+      _options(std::move(options)),
+      _lastReleased(holder->numReleased()),
+      _lastQueued(holder->numQueued()) {
+    invariant(_options.minTickets > 0);
+    invariant(_options.minTickets <= _options.maxTickets);
+    invariant(_options.additiveIncrease > 0);
+    invariant(_options.multiplicativeDecrease > 0 && _options.multiplicativeDecrease < 1);
+    invariant(_options.throughputSmoothing > 0 && _options.throughputSmoothing <= 1);
+}
+
+AdaptiveTicketController::Adjustment AdaptiveTicketController::adjust(bool storageUnderPressure) {
+    const long long released = _holder->numReleased();
+    const long long queued = _holder->numQueued();
+    const long long completed = released - _lastReleased;
+    const long long queuedSinceLast = queued - _lastQueued;
+
+    const double previousAverage = _averageCompleted.value_or(completed);
+    const double average = _options.throughputSmoothing * completed +
+        (1 - _options.throughputSmoothing) * previousAverage;
+
+    const int current = _holder->outof();
+    const int shrunk = std::max(_options.minTickets,
+                                static_cast<int>(current * _options.multiplicativeDecrease));
+    const int grown = std::min(_options.maxTickets, current + _options.additiveIncrease);
+
+    int target = current;
+    StringData reason;
+    if (storageUnderPressure) {
+        target = shrunk;
+        reason = "storagePressure"_sd;
+    } else if (queuedSinceLast == 0) {
+        reason = "notQueued"_sd;
+    } else if (_lastAdjustment == Adjustment::kIncrease &&
+               average < previousAverage * (1 - _options.throughputTolerance)) {
+        target = shrunk;
+        reason = "throughputDropped"_sd;
+    } else {
+        target = grown;
+        reason = "queued"_sd;
+    }
+
+    // Bring a pool which was sized outside the bounds back within them.
+    target = std::max(_options.minTickets, std::min(_options.maxTickets, target));
+
+    Adjustment adjustment = Adjustment::kNone;
+    if (target != current) {
+        Status status = _holder->resize(target);
+        if (status.isOK()) {
+            adjustment = target > current ? Adjustment::kIncrease : Adjustment::kDecrease;
+            LOG(1) << "Resized ticket pool from " << current << " to " << target << " ("
+                   << reason << ")";
+        } else {
+            warning() << "Failed to resize ticket pool from " << current << " to " << target
+                      << ": " << status;
+        }
+    }
+
+    // Tickets which were handed out while shrinking belong to the next interval.
+    _lastReleased = _holder->numReleased();
+    _lastQueued = _holder->numQueued();
+    _averageCompleted = average;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _lastAdjustment = adjustment;
+    _lastReason = reason;
+    if (adjustment == Adjustment::kIncrease) {
+        _numIncreases++;
+    } else if (adjustment == Adjustment::kDecrease) {
+        _numDecreases++;
+    }
+    return adjustment;
+}
+
+void AdaptiveTicketController::append(BSONObjBuilder* builder) const {
+    builder->append("minTickets", _options.minTickets);
+    builder->append("maxTickets", _options.maxTickets);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    builder->append("increases", _numIncreases);
+    builder->append("decreases", _numDecreases);
+    builder->append("lastAdjustment", _adjustmentName(_lastAdjustment));
+    builder->append("lastReason", _lastReason);
+}
+
+StringData AdaptiveTicketController::_adjustmentName(Adjustment adjustment) {
+    switch (adjustment) {
+        case Adjustment::kNone:
+            return "none"_sd;
+        case Adjustment::kIncrease:
+            return "increase"_sd;
+        case Adjustment::kDecrease:
+            return "decrease"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace mongo
@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class TicketHolder;
+
+/**
+ * Resizes a TicketHolder with an additive-increase/multiplicative-decrease (AIMD) policy, based
+ * on what happened to it since the previous call to adjust():
+ *
+ *  - If the caller reports that the storage engine is under pressure, the pool shrinks
+ *    multiplicatively so that fewer concurrent operations compete for it.
+ *  - If no acquisition had to queue for a ticket, the pool is large enough and is left alone.
+ *  - If acquisitions queued, the pool grows additively, unless the previous interval grew it
+ *    and the moving average of completed acquisitions per interval fell noticeably since. Adding
+ *    concurrency made things worse in that case, so the pool shrinks multiplicatively instead.
+ *    The average keeps a single slow interval from undoing an increase.
+ *
+ * The size always stays within [minTickets, maxTickets]. adjust() is meant to be called at a
+ * fixed interval from a single background thread. The statistics may be read from any thread.
+ */
+class AdaptiveTicketController {
+    MONGO_DISALLOW_COPYING(AdaptiveTicketController);
+
+public:
+    struct Options {
+        int minTickets = 16;
+        int maxTickets = 512;
+
+        // Number of tickets added when acquisitions queue.
+        int additiveIncrease = 8;
+
+        // Factor the pool is multiplied by when it shrinks.
+        double multiplicativeDecrease = 0.75;
+
+        // Fraction by which the average of completed acquisitions must fall after an increase
+        // before the increase is considered to have hurt.
+        double throughputTolerance = 0.1;
+
+        // Weight of the latest interval in the exponentially weighted moving average of completed
+        // acquisitions.
+        double throughputSmoothing = 0.5;
+    };
+
+    enum class Adjustment { kNone, kIncrease, kDecrease };
+
+    AdaptiveTicketController(TicketHolder* holder, Options options);
+
+    /**
+     * Samples the TicketHolder and resizes it according to the policy above. Shrinking does not
+     * wait for the tickets being removed to be released. Returns the adjustment which was made.
+     */
+    Adjustment adjust(bool storageUnderPressure);
+
+    /**
+     * Appends the bounds, the number of adjustments made and the reason for the last one.
+     */
+    void append(BSONObjBuilder* builder) const;
+
+private:
+    static StringData _adjustmentName(Adjustment adjustment);
+
+    TicketHolder* const _holder;
+    const Options _options;
+
+    // Only accessed by the thread calling adjust().
+    long long _lastReleased = 0;
+    long long _lastQueued = 0;
+    boost::optional<double> _averageCompleted;
+
+    // Guards the statistics below, which are reported from other threads.
+    mutable stdx::mutex _mutex;
+    Adjustment _lastAdjustment = Adjustment::kNone;
+    StringData _lastReason = "none"_sd;
+    long long _numIncreases = 0;
+    long long _numDecreases = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,188 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/adaptive_ticket_controller.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/ticketholder.h"
+
+namespace mongo {
+namespace {
+
+using Adjustment = AdaptiveTicketController::Adjustment;
+
+AdaptiveTicketController::Options makeOptions() {
+    AdaptiveTicketController::Options options;
+    options.minTickets = 8;
+    options.maxTickets = 64;
+    options.additiveIncrease = 4;
+    options.multiplicativeDecrease = 0.5;
+    options.throughputTolerance = 0.1;
+    return options;
+}
+
+/**
+ * Completes 'count' acquisitions, of which the first 'queued' are made to queue behind a ticket
+ * held by the test.
+ */
+void runAcquisitions(TicketHolder* holder, int count, int queued) {
+    for (int i = 0; i < count; i++) {
+        if (i < queued) {
+            // Exhaust the pool so that the timed wait below has to queue.
+            int held = 0;
+            while (holder->tryAcquire()) {
+                held++;
+            }
+            ASSERT_FALSE(holder->waitForTicketUntil(Date_t::now()));
+            for (int j = 0; j < held; j++) {
+                holder->release();
+            }
+        }
+        ASSERT(holder->tryAcquire());
+        holder->release();
+    }
+}
+
+TEST(AdaptiveTicketControllerTest, HoldsWhenNothingQueues) {
+    TicketHolder holder(16);
+    AdaptiveTicketController controller(&holder, makeOptions());
+
+    runAcquisitions(&holder, 100, 0);
+    ASSERT(controller.adjust(false) == Adjustment::kNone);
+    ASSERT_EQ(holder.outof(), 16);
+}
+
+TEST(AdaptiveTicketControllerTest, GrowsAdditivelyWhileQueued) {
+    TicketHolder holder(16);
+    AdaptiveTicketController controller(&holder, makeOptions());
+
+    runAcquisitions(&holder, 100, 1);
+    ASSERT(controller.adjust(false) == Adjustment::kIncrease);
+    ASSERT_EQ(holder.outof(), 20);
+
+    runAcquisitions(&holder, 100, 1);
+    ASSERT(controller.adjust(false) == Adjustment::kIncrease);
+    ASSERT_EQ(holder.outof(), 24);
+}
+
+TEST(AdaptiveTicketControllerTest, ShrinksWhenThroughputDropsAfterIncrease) {
+    TicketHolder holder(16);
+    AdaptiveTicketController controller(&holder, makeOptions());
+
+    runAcquisitions(&holder, 100, 1);
+    ASSERT(controller.adjust(false) == Adjustment::kIncrease);
+    ASSERT_EQ(holder.outof(), 20);
+
+    // Within the tolerance the increase is kept and the pool grows further.
+    runAcquisitions(&holder, 95, 1);
+    ASSERT(controller.adjust(false) == Adjustment::kIncrease);
+    ASSERT_EQ(holder.outof(), 24);
+
+    runAcquisitions(&holder, 50, 1);
+    ASSERT(controller.adjust(false) == Adjustment::kDecrease);
+    ASSERT_EQ(holder.outof(), 12);
+
+    // A lower throughput following a decrease does not shrink the pool again.
+    runAcquisitions(&holder, 10, 1);
+    ASSERT(controller.adjust(false) == Adjustment::kIncrease);
+    ASSERT_EQ(holder.outof(), 16);
+}
+
+TEST(AdaptiveTicketControllerTest, OneSlowIntervalDoesNotShrink) {
+    TicketHolder holder(16);
+    AdaptiveTicketController controller(&holder, makeOptions());
+
+    runAcquisitions(&holder, 100, 1);
+    ASSERT(controller.adjust(false) == Adjustment::kIncrease);
+    ASSERT_EQ(holder.outof(), 20);
+
+    // Fewer acquisitions complete than the tolerance allows, but only in a single interval.
+    runAcquisitions(&holder, 80, 1);
+    ASSERT(controller.adjust(false) == Adjustment::kIncrease);
+    ASSERT_EQ(holder.outof(), 24);
+
+    // Once the drop lasts, the average follows and the pool shrinks.
+    runAcquisitions(&holder, 40, 1);
+    ASSERT(controller.adjust(false) == Adjustment::kDecrease);
+    ASSERT_EQ(holder.outof(), 12);
+}
+
+TEST(AdaptiveTicketControllerTest, ShrinksUnderStoragePressure) {
+    TicketHolder holder(32);
+    AdaptiveTicketController controller(&holder, makeOptions());
+
+    runAcquisitions(&holder, 100, 10);
+    ASSERT(controller.adjust(true) == Adjustment::kDecrease);
+    ASSERT_EQ(holder.outof(), 16);
+
+    runAcquisitions(&holder, 100, 0);
+    ASSERT(controller.adjust(true) == Adjustment::kDecrease);
+    ASSERT_EQ(holder.outof(), 8);
+
+    // The minimum is never crossed.
+    ASSERT(controller.adjust(true) == Adjustment::kNone);
+    ASSERT_EQ(holder.outof(), 8);
+}
+
+TEST(AdaptiveTicketControllerTest, StaysWithinBounds) {
+    TicketHolder holder(128);
+    AdaptiveTicketController controller(&holder, makeOptions());
+
+    runAcquisitions(&holder, 10, 0);
+    ASSERT(controller.adjust(false) == Adjustment::kDecrease);
+    ASSERT_EQ(holder.outof(), 64);
+
+    runAcquisitions(&holder, 10, 1);
+    ASSERT(controller.adjust(false) == Adjustment::kNone);
+    ASSERT_EQ(holder.outof(), 64);
+}
+
+TEST(AdaptiveTicketControllerTest, ReportsAdjustments) {
+    TicketHolder holder(16);
+    AdaptiveTicketController controller(&holder, makeOptions());
+
+    runAcquisitions(&holder, 10, 1);
+    controller.adjust(false);
+    controller.adjust(true);
+
+    BSONObjBuilder builder;
+    controller.append(&builder);
+    BSONObj stats = builder.obj();
+    ASSERT_EQ(stats["minTickets"].numberInt(), 8);
+    ASSERT_EQ(stats["maxTickets"].numberInt(), 64);
+    ASSERT_EQ(stats["increases"].numberLong(), 1);
+    ASSERT_EQ(stats["decreases"].numberLong(), 1);
+    ASSERT_EQ(stats["lastAdjustment"].String(), "decrease");
+    ASSERT_EQ(stats["lastReason"].String(), "storagePressure");
+}
+
+}  // namespace
+}  // namespace mongo
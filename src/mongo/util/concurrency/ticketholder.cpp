@@ -31,13 +31,224 @@
 
 #include "mongo/util/concurrency/ticketholder.h"
 
+#include <algorithm>
 #include <iostream>
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
+struct TicketHolder::Waiter {
+    stdx::condition_variable cv;
+    bool granted = false;
+};
+
+constexpr int TicketHolder::kNumPriorities;
+constexpr int TicketHolder::kNormalPriorityWeight;
+
+StringData TicketHolder::priorityName(Priority priority) {
+    switch (priority) {
+        case Priority::kNormal:
+            return "normal"_sd;
+        case Priority::kLow:
+            return "low"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+StatusWith<TicketHolder::Priority> TicketHolder::parsePriority(StringData name) {
+    for (auto priority : {Priority::kNormal, Priority::kLow}) {
+        if (name == priorityName(priority)) {
+            return priority;
+        }
+    }
+    return Status(ErrorCodes::BadValue,
+                  str::stream() << "Unknown priority '" << name
+                                << "', expected 'normal' or 'low'");
+}
+
+bool TicketHolder::tryAcquire(Priority priority) {
+    // Tickets are handed to queued acquisitions in order, so no acquisition may take one ahead of
+    // them.
+    if (_hasWaiters()) {
+        return false;
+    }
+    return _tryAcquireFromPool();
+}
+
+void TicketHolder::waitForTicket(Priority priority) {
+    invariant(waitForTicketUntil(Date_t::max(), priority));
+}
+
+bool TicketHolder::waitForTicketUntil(Date_t until, Priority priority) {
+    if (tryAcquire(priority))
+        return true;
+
+    QueueStats& stats = _queueStats[static_cast<int>(priority)];
+    stats.queued.fetchAndAdd(1);
+
+    Timer timer;
+    ON_BLOCK_EXIT([&] { stats.totalWaitMicros.fetchAndAdd(timer.micros()); });
+    return _waitInQueue(until, priority);
+}
+
+void TicketHolder::release() {
+    _numReleased.fetchAndAdd(1);
+
+    if (_claimTicketToRetire()) {
+        return;
+    }
+
+    // Hand the ticket straight to the next queued acquisition rather than returning it to the
+    // pool, where a concurrent tryAcquire() could take it first.
+    if (_hasWaiters()) {
+        stdx::lock_guard<stdx::mutex> lk(_queueMutex);
+        if (_grantNext_inlock()) {
+            return;
+        }
+    }
+
+    _releaseToPool();
+
+    // An acquisition may have queued after the check above but before the ticket reached the pool.
+    _grantToWaiters();
+}
+
+long long TicketHolder::numQueued() const {
+    long long total = 0;
+    for (const auto& stats : _queueStats) {
+        total += stats.queued.load();
+    }
+    return total;
+}
+
+void TicketHolder::appendQueueStats(BSONObjBuilder* builder) const {
+    for (int i = 0; i < kNumPriorities; i++) {
+        const QueueStats& stats = _queueStats[i];
+        BSONObjBuilder bb(builder->subobjStart(priorityName(static_cast<Priority>(i))));
+        bb.append("queued", stats.queued.load());
+        bb.append("waiting", stats.waiting.load());
+        bb.append("totalWaitMicros", stats.totalWaitMicros.load());
+    }
+}
+
+bool TicketHolder::_waitInQueue(Date_t until, Priority priority) {
+    Waiter waiter;
+    auto& queue = _queues[static_cast<int>(priority)];
+    QueueStats& stats = _queueStats[static_cast<int>(priority)];
+
+    stdx::unique_lock<stdx::mutex> lk(_queueMutex);
+    queue.push_back(&waiter);
+    stats.waiting.fetchAndAdd(1);
+
+    // A ticket released before this acquisition was queued went back to the pool without being
+    // handed over, so it has to be picked up here.
+    _grantToWaiters_inlock();
+
+    const auto isGranted = [&] { return waiter.granted; };
+    if (until == Date_t::max()) {
+        waiter.cv.wait(lk, isGranted);
+        return true;
+    }
+
+    if (waiter.cv.wait_until(lk, until.toSystemTimePoint(), isGranted)) {
+        return true;
+    }
+
+    queue.erase(std::find(queue.begin(), queue.end(), &waiter));
+    stats.waiting.subtractAndFetch(1);
+    return false;
+}
+
+void TicketHolder::_resize_inlock(int newSize) {
+    // Tickets still scheduled to be retired are kept instead, before any are added to the pool
+    while (_outof.load() < newSize && _claimTicketToRetire()) {
+        _outof.fetchAndAdd(1);
+    }
+
+    while (_outof.load() < newSize) {
+        _releaseToPool();
+        _outof.fetchAndAdd(1);
+    }
+
+    while (_outof.load() > newSize) {
+        if (!_tryAcquireFromPool()) {
+            _ticketsToRetire.fetchAndAdd(1);
+        }
+        _outof.subtractAndFetch(1);
+    }
+
+    _grantToWaiters();
+}
+
+bool TicketHolder::_claimTicketToRetire() {
+    int toRetire = _ticketsToRetire.load();
+    while (toRetire > 0) {
+        const int previous = _ticketsToRetire.compareAndSwap(toRetire, toRetire - 1);
+        if (previous == toRetire) {
+            return true;
+        }
+        toRetire = previous;
+    }
+    return false;
+}
+
+bool TicketHolder::_hasWaiters() const {
+    for (const auto& stats : _queueStats) {
+        if (stats.waiting.load() > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TicketHolder::_grantToWaiters() {
+    // Releases only take the queue mutex when acquisitions are queued.
+    if (!_hasWaiters()) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_queueMutex);
+    _grantToWaiters_inlock();
+}
+
+void TicketHolder::_grantToWaiters_inlock() {
+    while (!_queues[static_cast<int>(Priority::kNormal)].empty() ||
+           !_queues[static_cast<int>(Priority::kLow)].empty()) {
+        if (!_tryAcquireFromPool())
+            return;
+
+        invariant(_grantNext_inlock());
+    }
+}
+
+bool TicketHolder::_grantNext_inlock() {
+    auto& normalQueue = _queues[static_cast<int>(Priority::kNormal)];
+    auto& lowQueue = _queues[static_cast<int>(Priority::kLow)];
+
+    if (normalQueue.empty() && lowQueue.empty()) {
+        return false;
+    }
+
+    const bool grantLow = normalQueue.empty() ||
+        (!lowQueue.empty() && _normalGrantsSinceLow >= kNormalPriorityWeight);
+    const Priority priority = grantLow ? Priority::kLow : Priority::kNormal;
+    _normalGrantsSinceLow = grantLow || lowQueue.empty() ? 0 : _normalGrantsSinceLow + 1;
+
+    auto& queue = _queues[static_cast<int>(priority)];
+    Waiter* waiter = queue.front();
+    queue.pop_front();
+    _queueStats[static_cast<int>(priority)].waiting.subtractAndFetch(1);
+
+    waiter->granted = true;
+    waiter->cv.notify_one();
+    return true;
+}
+
 #if defined(__linux__)
 namespace {
 void _check(int ret) {
@@ -57,7 +268,7 @@ TicketHolder::~TicketHolder() {
     _check(sem_destroy(&_sem));
 }
 
-bool TicketHolder::tryAcquire() {
+bool TicketHolder::_tryAcquireFromPool() {
     while (0 != sem_trywait(&_sem)) {
         if (errno == EAGAIN)
             return false;
@@ -67,30 +278,7 @@ bool TicketHolder::tryAcquire() {
     return true;
 }
 
-void TicketHolder::waitForTicket() {
-    while (0 != sem_wait(&_sem)) {
-        if (errno != EINTR)
-            _check(-1);
-    }
-}
-
-bool TicketHolder::waitForTicketUntil(Date_t until) {
-    const long long millisSinceEpoch = until.toMillisSinceEpoch();
-    struct timespec ts;
-
-    ts.tv_sec = millisSinceEpoch / 1000;
-    ts.tv_nsec = (millisSinceEpoch % 1000) * (1000 * 1000);
-    while (0 != sem_timedwait(&_sem, &ts)) {
-        if (errno == ETIMEDOUT)
-            return false;
-
-        if (errno != EINTR)
-            _check(-1);
-    }
-    return true;
-}
-
-void TicketHolder::release() {
+void TicketHolder::_releaseToPool() {
     _check(sem_post(&_sem));
 }
 
@@ -107,15 +295,7 @@ Status TicketHolder::resize(int newSize) {
                                     << "; given "
                                     << newSize);
 
-    while (_outof.load() < newSize) {
-        release();
-        _outof.fetchAndAdd(1);
-    }
-
-    while (_outof.load() > newSize) {
-        waitForTicket();
-        _outof.subtractAndFetch(1);
-    }
+    _resize_inlock(newSize);
 
     invariant(_outof.load() == newSize);
     return Status::OK();
@@ -128,7 +308,7 @@ int TicketHolder::available() const {
 }
 
 int TicketHolder::used() const {
-    return outof() - available();
+    return outof() + _ticketsToRetire.load() - available();
 }
 
 int TicketHolder::outof() const {
@@ -141,52 +321,26 @@ TicketHolder::TicketHolder(int num) : _outof(num), _num(num) {}
 
 TicketHolder::~TicketHolder() = default;
 
-bool TicketHolder::tryAcquire() {
+bool TicketHolder::_tryAcquireFromPool() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    return _tryAcquire();
-}
-
-void TicketHolder::waitForTicket() {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    while (!_tryAcquire()) {
-        _newTicket.wait(lk);
+    if (_num <= 0) {
+        if (_num < 0) {
+            std::cerr << "DISASTER! in TicketHolder" << std::endl;
+        }
+        return false;
     }
+    _num--;
+    return true;
 }
 
-bool TicketHolder::waitForTicketUntil(Date_t until) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    return _newTicket.wait_until(lk, until.toSystemTimePoint(), [this] { return _tryAcquire(); });
-}
-
-void TicketHolder::release() {
-    {
-        stdx::lock_guard<stdx::mutex> lk(_mutex);
-        _num++;
-    }
-    _newTicket.notify_one();
+void TicketHolder::_releaseToPool() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _num++;
 }
 
 Status TicketHolder::resize(int newSize) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-    int used = _outof.load() - _num;
-    if (used > newSize) {
-        std::stringstream ss;
-        ss << "can't resize since we're using (" << used << ") "
-           << "more than newSize(" << newSize << ")";
-
-        std::string errmsg = ss.str();
-        log() << errmsg;
-        return Status(ErrorCodes::BadValue, errmsg);
-    }
-
-    _outof.store(newSize);
-    _num = _outof.load() - used;
-
-    // Potentially wasteful, but easier to see is correct
-    _newTicket.notify_all();
+    stdx::lock_guard<stdx::mutex> lk(_resizeMutex);
+    _resize_inlock(newSize);
     return Status::OK();
 }
 
@@ -195,22 +349,11 @@ int TicketHolder::available() const {
 }
 
 int TicketHolder::used() const {
-    return outof() - _num;
+    return outof() + _ticketsToRetire.load() - _num;
 }
 
 int TicketHolder::outof() const {
     return _outof.load();
 }
-
-bool TicketHolder::_tryAcquire() {
-    if (_num <= 0) {
-        if (_num < 0) {
-            std::cerr << "DISASTER! in TicketHolder" << std::endl;
-        }
-        return false;
-    }
-    _num--;
-    return true;
-}
 #endif
 }
@@ -30,7 +30,12 @@
 #include <semaphore.h>
 #endif
 
+#include <deque>
+
 #include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
@@ -38,21 +43,44 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
+
 class TicketHolder {
     MONGO_DISALLOW_COPYING(TicketHolder);
 
 public:
+    /**
+     * Classes of acquisitions. When acquisitions of both classes are queued, released tickets are
+     * handed out by weighted round robin, kNormalPriorityWeight to normal priority acquisitions
+     * for each one to a low priority acquisition. Low priority work therefore keeps making
+     * progress without holding up latency-sensitive operations.
+     */
+    enum class Priority { kNormal, kLow };
+    static constexpr int kNumPriorities = 2;
+    static constexpr int kNormalPriorityWeight = 8;
+
+    static StringData priorityName(Priority priority);
+    static StatusWith<Priority> parsePriority(StringData name);
+
     explicit TicketHolder(int num);
     ~TicketHolder();
 
-    bool tryAcquire();
+    /**
+     * Takes a ticket if one is available and no acquisition of any priority is queued for one.
+     */
+    bool tryAcquire(Priority priority = Priority::kNormal);
 
-    void waitForTicket();
+    void waitForTicket(Priority priority = Priority::kNormal);
 
-    bool waitForTicketUntil(Date_t until);
+    bool waitForTicketUntil(Date_t until, Priority priority = Priority::kNormal);
 
     void release();
 
+    /**
+     * Changes the number of tickets. Growing makes the new tickets available at once. Shrinking
+     * does not wait for tickets in use: it removes the available ones, and retires the rest of the
+     * removed tickets as they are released.
+     */
     Status resize(int newSize);
 
     int available() const;
@@ -61,20 +89,94 @@ public:
 
     int outof() const;
 
+    /**
+     * Returns the number of tickets which have been released since this TicketHolder was
+     * created, i.e. the number of completed acquisitions.
+     */
+    long long numReleased() const {
+        return _numReleased.load();
+    }
+
+    /**
+     * Returns the number of acquisitions which could not get a ticket immediately and had to
+     * queue for one.
+     */
+    long long numQueued() const;
+
+    /**
+     * Appends, for each priority, the number of acquisitions which had to queue, the number
+     * currently queued and the total time spent queued.
+     */
+    void appendQueueStats(BSONObjBuilder* builder) const;
+
 private:
+    struct Waiter;
+
+    struct QueueStats {
+        AtomicInt64 queued;
+        AtomicInt64 waiting;
+        AtomicInt64 totalWaitMicros;
+    };
+
+    /**
+     * Queues behind the other acquisitions until a ticket is handed over or 'until' passes.
+     */
+    bool _waitInQueue(Date_t until, Priority priority);
+
+    /**
+     * Returns whether any acquisition is queued for a ticket.
+     */
+    bool _hasWaiters() const;
+
+    /**
+     * Hands the tickets available in the pool to queued acquisitions.
+     */
+    void _grantToWaiters();
+    void _grantToWaiters_inlock();
+
+    /**
+     * Hands a ticket, which the caller holds, to the next queued acquisition picked by weighted
+     * round robin. Returns false if no acquisition is queued.
+     */
+    bool _grantNext_inlock();
+
+    // Take and return tickets regardless of queued acquisitions.
+    bool _tryAcquireFromPool();
+    void _releaseToPool();
+
+    /**
+     * Changes _outof to 'newSize' by adding tickets to the pool, or by taking them out of it and
+     * scheduling those in use to be retired. The caller must hold _resizeMutex.
+     */
+    void _resize_inlock(int newSize);
+
+    /**
+     * Claims one of the tickets scheduled to be retired. Returns false if there is none.
+     */
+    bool _claimTicketToRetire();
+
+    AtomicInt64 _numReleased;
+
+    // Tickets in use which a resize removed from the pool, and which are dropped when released
+    // instead of being handed to another acquisition.
+    AtomicInt32 _ticketsToRetire;
+    stdx::mutex _resizeMutex;
+    QueueStats _queueStats[kNumPriorities];
+
+    // Acquisitions waiting for a ticket, in arrival order for each priority.
+    stdx::mutex _queueMutex;
+    std::deque<Waiter*> _queues[kNumPriorities];
+    int _normalGrantsSinceLow = 0;
+
 #if defined(__linux__)
     mutable sem_t _sem;
 
     // You can read _outof without a lock, but have to hold _resizeMutex to change.
     AtomicInt32 _outof;
-    stdx::mutex _resizeMutex;
 #else
-    bool _tryAcquire();
-
     AtomicInt32 _outof;
     int _num;
     stdx::mutex _mutex;
-    stdx::condition_variable _newTicket;
 #endif
 };
 
@@ -31,8 +31,14 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/time_support.h"
 
 namespace {
 using namespace mongo;
@@ -71,4 +77,155 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+TEST(TicketholderTest, ShrinkingRetiresTicketsAsTheyAreReleased) {
+    TicketHolder holder(10);
+    for (int i = 0; i < 10; i++) {
+        ASSERT(holder.tryAcquire());
+    }
+
+    // Shrinking below the tickets in use does not wait for them
+    ASSERT_OK(holder.resize(6));
+    ASSERT_EQ(holder.outof(), 6);
+    ASSERT_EQ(holder.used(), 10);
+    ASSERT_EQ(holder.available(), 0);
+
+    // Growing again keeps tickets which were still to be retired
+    ASSERT_OK(holder.resize(8));
+    ASSERT_EQ(holder.outof(), 8);
+    ASSERT_EQ(holder.used(), 10);
+
+    holder.release();
+    holder.release();
+    ASSERT_EQ(holder.used(), 8);
+    ASSERT_EQ(holder.available(), 0);
+    ASSERT_FALSE(holder.tryAcquire());
+
+    holder.release();
+    ASSERT_EQ(holder.used(), 7);
+    ASSERT_EQ(holder.available(), 1);
+
+    for (int i = 0; i < 7; i++) {
+        holder.release();
+    }
+    ASSERT_EQ(holder.used(), 0);
+    ASSERT_EQ(holder.available(), 8);
+}
+
+using Priority = TicketHolder::Priority;
+
+long long waitingFor(const TicketHolder& holder, Priority priority) {
+    BSONObjBuilder builder;
+    holder.appendQueueStats(&builder);
+    return builder.obj()[TicketHolder::priorityName(priority)]["waiting"].numberLong();
+}
+
+void waitUntilQueued(const TicketHolder& holder, Priority priority, long long count) {
+    while (waitingFor(holder, priority) < count) {
+        sleepmillis(1);
+    }
+}
+
+TEST(TicketholderTest, LowPriorityDoesNotTakeTicketsAheadOfQueuedNormalPriority) {
+    TicketHolder holder(1);
+    ASSERT(holder.tryAcquire());
+
+    stdx::thread waiter([&] {
+        holder.waitForTicket(Priority::kNormal);
+        holder.release();
+    });
+    waitUntilQueued(holder, Priority::kNormal, 1);
+
+    holder.release();
+    waiter.join();
+
+    // Once nothing is queued, low priority acquisitions take tickets like any other.
+    ASSERT(holder.tryAcquire(Priority::kLow));
+    ASSERT_FALSE(holder.waitForTicketUntil(Date_t::now() + Milliseconds(1), Priority::kLow));
+    holder.release();
+
+    BSONObjBuilder builder;
+    holder.appendQueueStats(&builder);
+    BSONObj stats = builder.obj();
+    ASSERT_EQ(stats["normal"]["queued"].numberLong(), 1);
+    ASSERT_EQ(stats["normal"]["waiting"].numberLong(), 0);
+    ASSERT_EQ(stats["low"]["queued"].numberLong(), 1);
+    ASSERT_EQ(stats["low"]["waiting"].numberLong(), 0);
+    ASSERT_EQ(holder.numQueued(), 2);
+}
+
+TEST(TicketholderTest, ReleaseHandsTicketToQueuedAcquisition) {
+    TicketHolder holder(1);
+    ASSERT(holder.tryAcquire());
+
+    stdx::thread waiter([&] { holder.waitForTicket(Priority::kLow); });
+    waitUntilQueued(holder, Priority::kLow, 1);
+
+    // Even normal priority acquisitions must not take a ticket ahead of a queued one.
+    ASSERT_FALSE(holder.tryAcquire(Priority::kNormal));
+
+    // The released ticket goes to the queued acquisition without passing through the pool.
+    holder.release();
+    waiter.join();
+    ASSERT_EQ(holder.available(), 0);
+    ASSERT_EQ(holder.used(), 1);
+
+    holder.release();
+    ASSERT_EQ(holder.available(), 1);
+    ASSERT(holder.tryAcquire(Priority::kNormal));
+    holder.release();
+}
+
+TEST(TicketholderTest, QueuedAcquisitionsAreGrantedByWeight) {
+    TicketHolder holder(5);
+    for (int i = 0; i < 5; i++) {
+        ASSERT(holder.tryAcquire());
+    }
+    ASSERT_FALSE(holder.tryAcquire(Priority::kLow));
+
+    stdx::mutex mutex;
+    std::vector<Priority> grants;
+    std::vector<stdx::thread> waiters;
+    auto startWaiter = [&](Priority priority, long long queuedBefore) {
+        waiters.emplace_back([&, priority] {
+            holder.waitForTicket(priority);
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            grants.push_back(priority);
+        });
+        waitUntilQueued(holder, priority, queuedBefore + 1);
+    };
+
+    // The low priority acquisitions arrive first but only get every ninth ticket.
+    const int numLow = 2;
+    const int numNormal = 2 * TicketHolder::kNormalPriorityWeight;
+    for (int i = 0; i < numLow; i++) {
+        startWaiter(Priority::kLow, i);
+    }
+    for (int i = 0; i < numNormal; i++) {
+        startWaiter(Priority::kNormal, i);
+    }
+
+    // Hand out one ticket at a time so that the order of the grants is deterministic.
+    for (int i = 0; i < numLow + numNormal; i++) {
+        holder.release();
+        auto numGrants = [&] {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            return grants.size();
+        };
+        while (numGrants() < static_cast<size_t>(i + 1)) {
+            sleepmillis(1);
+        }
+    }
+    for (auto& waiter : waiters) {
+        waiter.join();
+    }
+
+    std::vector<Priority> expected;
+    for (int i = 0; i < numLow; i++) {
+        expected.insert(expected.end(), TicketHolder::kNormalPriorityWeight, Priority::kNormal);
+        expected.push_back(Priority::kLow);
+    }
+    ASSERT(grants == expected);
+    ASSERT_EQ(holder.used(), 5);
+}
 }  // namespace
@@ -0,0 +1,624 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/cpu_sampling_profiler.h"
+
+#include "mongo/base/status.h"
+#include "mongo/bson/bsonobjbuilder.h"
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <boost/functional/hash.hpp>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sstream>
+#include <sys/time.h>
+#include <ucontext.h>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+// A buffer takes about 6KB. At the default 100 samples per second a thread fills at most 10 slots
+// between drains.
+const size_t kMaxFramesPerSample = 48;
+const size_t kSamplesPerThread = 16;    // per thread buffer, must be a power of two
+const size_t kMaxThreadBuffers = 1024;  // threads registering past this are not sampled
+const size_t kMaxStacks = 20000;        // max number of distinct stacks we count
+const auto kDrainInterval = Milliseconds(100);
+
+const char kUntaggedName[] = "untagged";
+
+//
+// Per thread sample buffer.
+//
+// A single producer, single consumer ring. The producer is the SIGPROF handler running on the
+// owning thread, the consumer is the drain thread. Neither side takes a lock, so the handler stays
+// async-signal-safe.
+//
+
+struct Sample {
+    const char* tag;
+    std::uint32_t numFrames;
+    std::array<std::uintptr_t, kMaxFramesPerSample> frames;
+};
+
+struct ThreadSampleBuffer {
+    // Bounds of the owning thread's stack. The frame pointer walk never reads outside of them.
+    std::uintptr_t stackLow = 0;
+    std::uintptr_t stackHigh = 0;
+
+    std::array<Sample, kSamplesPerThread> samples;
+
+    AtomicUInt64 head;  // next slot the handler writes
+    AtomicUInt64 tail;  // next slot the drain thread reads
+};
+
+// Read by the signal handler, so these must be trivially constructible.
+thread_local const char* threadTag = nullptr;
+thread_local ThreadSampleBuffer* threadBuffer = nullptr;
+
+// The run of the profiler in which this thread last tried to register. A thread that could not get
+// a buffer does not try again until the profiler is restarted.
+thread_local std::uint64_t threadRegistrationRun = 0;
+
+// Updated by the signal handler.
+AtomicUInt64 numSamples;
+AtomicUInt64 numUnregisteredSamples;
+AtomicUInt64 numDroppedSamples;
+
+//
+// Capture the stack of the thread interrupted by SIGPROF.
+//
+// mongod is built with frame pointers, so each frame starts with the caller's frame pointer
+// followed by the return address. Code built without frame pointers, such as some of libc, can end
+// the walk early, but since every address is checked against the thread's stack bounds it can not
+// make us read unmapped memory.
+//
+std::uint32_t captureStack(const ucontext_t* context,
+                           const ThreadSampleBuffer& buffer,
+                           std::array<std::uintptr_t, kMaxFramesPerSample>* frames) {
+#if defined(__x86_64__)
+    const std::uintptr_t pc = context->uc_mcontext.gregs[REG_RIP];
+    const std::uintptr_t sp = context->uc_mcontext.gregs[REG_RSP];
+    std::uintptr_t fp = context->uc_mcontext.gregs[REG_RBP];
+#elif defined(__aarch64__)
+    const std::uintptr_t pc = context->uc_mcontext.pc;
+    const std::uintptr_t sp = context->uc_mcontext.sp;
+    std::uintptr_t fp = context->uc_mcontext.regs[29];
+#endif
+
+    std::uint32_t numFrames = 0;
+    (*frames)[numFrames++] = pc;
+
+    const std::uintptr_t low = std::max(sp, buffer.stackLow);
+    while (numFrames < kMaxFramesPerSample && fp >= low &&
+           fp + 2 * sizeof(std::uintptr_t) <= buffer.stackHigh &&
+           fp % sizeof(std::uintptr_t) == 0) {
+        const auto frame = reinterpret_cast<const std::uintptr_t*>(fp);
+        const std::uintptr_t next = frame[0];
+        const std::uintptr_t returnAddress = frame[1];
+        if (returnAddress == 0)
+            break;
+
+        (*frames)[numFrames++] = returnAddress;
+
+        // Stacks grow down, so the caller's frame is always at a higher address.
+        if (next <= fp)
+            break;
+        fp = next;
+    }
+
+    return numFrames;
+}
+
+void sigprofHandler(int, siginfo_t*, void* context) {
+    const int savedErrno = errno;
+
+    numSamples.fetchAndAdd(1);
+
+    ThreadSampleBuffer* buffer = threadBuffer;
+    if (!buffer) {
+        numUnregisteredSamples.fetchAndAdd(1);
+    } else {
+        const auto head = buffer->head.load();
+        if (head - buffer->tail.load() == kSamplesPerThread) {
+            numDroppedSamples.fetchAndAdd(1);
+        } else {
+            Sample& sample = buffer->samples[head % kSamplesPerThread];
+            sample.tag = threadTag;
+            sample.numFrames =
+                captureStack(static_cast<const ucontext_t*>(context), *buffer, &sample.frames);
+            buffer->head.store(head + 1);
+        }
+    }
+
+    errno = savedErrno;
+}
+
+//
+// Aggregated stacks.
+//
+
+struct StackKey {
+    const char* tag;
+    std::vector<std::uintptr_t> frames;
+
+    bool operator==(const StackKey& other) const {
+        return tag == other.tag && frames == other.frames;
+    }
+};
+
+struct StackKeyHasher {
+    std::size_t operator()(const StackKey& key) const {
+        std::size_t hash = std::hash<const char*>()(key.tag);
+        boost::hash_range(hash, key.frames.begin(), key.frames.end());
+        return hash;
+    }
+};
+
+class Profiler;
+Profiler& getProfiler();
+
+class Profiler {
+public:
+    Status start(int samplesPerSecond) {
+        if (samplesPerSecond < 1 || samplesPerSecond > 1000000) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "Invalid number of samples per second: "
+                                        << samplesPerSecond);
+        }
+
+        stdx::lock_guard<stdx::mutex> controlLk(_controlMutex);
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        if (!_handlerInstalled) {
+            struct sigaction action;
+            struct sigaction previous;
+            memset(&action, 0, sizeof(action));
+            action.sa_sigaction = sigprofHandler;
+            action.sa_flags = SA_SIGINFO | SA_RESTART;
+            sigemptyset(&action.sa_mask);
+
+            if (sigaction(SIGPROF, nullptr, &previous) != 0) {
+                return Status(ErrorCodes::InternalError,
+                              str::stream() << "Failed to read the SIGPROF handler: "
+                                            << errnoWithDescription());
+            }
+
+            if (previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN) {
+                return Status(ErrorCodes::IllegalOperation,
+                              "Another SIGPROF handler is installed, is the gperftools CPU "
+                              "profiler running?");
+            }
+
+            if (sigaction(SIGPROF, &action, nullptr) != 0) {
+                return Status(ErrorCodes::InternalError,
+                              str::stream() << "Failed to install the SIGPROF handler: "
+                                            << errnoWithDescription());
+            }
+
+            // The handler is never removed: a SIGPROF still in flight when the timer is stopped
+            // would otherwise terminate the process.
+            _handlerInstalled = true;
+        }
+
+        struct itimerval timer;
+        timer.it_interval.tv_sec = 0;
+        timer.it_interval.tv_usec = std::max(1, 1000000 / samplesPerSecond);
+        timer.it_value = timer.it_interval;
+
+        if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+            return Status(ErrorCodes::InternalError,
+                          str::stream() << "Failed to start the profiling timer: "
+                                        << errnoWithDescription());
+        }
+
+        _samplesPerSecond = samplesPerSecond;
+
+        if (!_running.load()) {
+            _running.store(true);
+            _runId.fetchAndAdd(1);
+            _stopRequested = false;
+            _drainThread = stdx::thread([this] { _drainLoop(); });
+            log() << "Started the CPU sampling profiler at " << samplesPerSecond
+                  << " samples per second";
+        }
+
+        return Status::OK();
+    }
+
+    void stop() {
+        // Held until the drain thread is joined, so that a concurrent start() can not replace it.
+        stdx::lock_guard<stdx::mutex> controlLk(_controlMutex);
+
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (!_running.load())
+                return;
+
+            struct itimerval timer;
+            memset(&timer, 0, sizeof(timer));
+            setitimer(ITIMER_PROF, &timer, nullptr);
+
+            _running.store(false);
+            _stopRequested = true;
+            _drainCV.notify_one();
+        }
+
+        _drainThread.join();
+        log() << "Stopped the CPU sampling profiler";
+    }
+
+    bool isRunning() const {
+        return _running.load();
+    }
+
+    void registerThread() {
+        if (threadBuffer || !_running.load())
+            return;
+
+        const auto runId = _runId.load();
+        if (threadRegistrationRun == runId)
+            return;
+        threadRegistrationRun = runId;
+
+        pthread_attr_t attr;
+        if (pthread_getattr_np(pthread_self(), &attr) != 0)
+            return;
+
+        void* stackAddr = nullptr;
+        size_t stackSize = 0;
+        const int ret = pthread_attr_getstack(&attr, &stackAddr, &stackSize);
+        pthread_attr_destroy(&attr);
+        if (ret != 0)
+            return;
+
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_buffers.size() >= kMaxThreadBuffers)
+                return;
+
+            auto buffer = stdx::make_unique<ThreadSampleBuffer>();
+            buffer->stackLow = reinterpret_cast<std::uintptr_t>(stackAddr);
+            buffer->stackHigh = buffer->stackLow + stackSize;
+            threadBuffer = buffer.get();
+            _buffers.push_back(std::move(buffer));
+        }
+
+        // Frees the buffer when this thread exits, whether or not the profiler is still running.
+        static thread_local struct Unregister {
+            ~Unregister() {
+                ThreadSampleBuffer* buffer = threadBuffer;
+                threadBuffer = nullptr;
+
+                // The handler only ever writes to the buffer of the thread it interrupts, so once
+                // this thread's handler can no longer see the buffer it is safe to free.
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+                getProfiler()._unregisterThread(buffer);
+            }
+        } unregister;
+        (void)unregister;
+    }
+
+    std::vector<CpuSamplingProfiler::FoldedStack> getFoldedStacks() {
+        // Symbolizing is slow, so it is done on a copy to keep the drain thread and registering
+        // threads from waiting on it.
+        std::vector<std::pair<StackKey, long long>> stacks;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _drain_inlock();
+            stacks.assign(_stacks.begin(), _stacks.end());
+        }
+
+        stdx::lock_guard<stdx::mutex> symbolsLk(_symbolsMutex);
+
+        std::vector<CpuSamplingProfiler::FoldedStack> result;
+        result.reserve(stacks.size());
+        for (const auto& entry : stacks) {
+            StringBuilder sb;
+            sb << (entry.first.tag ? entry.first.tag : kUntaggedName);
+
+            // Frames are recorded innermost first, folded stacks list the outermost first.
+            const auto& frames = entry.first.frames;
+            for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+                // Return addresses point after the call, back up into the calling instruction.
+                const bool isLeaf = (it + 1 == frames.rend());
+                sb << ';' << _symbolize_inlock(isLeaf ? *it : *it - 1);
+            }
+
+            result.push_back({sb.str(), entry.second});
+        }
+
+        std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+            return a.samples > b.samples;
+        });
+        return result;
+    }
+
+    void appendStats(BSONObjBuilder* builder) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _drain_inlock();
+
+        builder->append("running", _running.load());
+        builder->append("samplesPerSecond", _samplesPerSecond);
+        builder->append("samples", static_cast<long long>(numSamples.load()));
+        builder->append("unregisteredThreadSamples",
+                        static_cast<long long>(numUnregisteredSamples.load()));
+        builder->append("droppedSamples", static_cast<long long>(numDroppedSamples.load()));
+        builder->append("droppedStacks", _numDroppedStacks);
+        builder->append("numStacks", static_cast<long long>(_stacks.size()));
+        builder->append("numThreads", static_cast<long long>(_buffers.size()));
+
+        BSONObjBuilder tagsBuilder(builder->subobjStart("tags"));
+        for (const auto& entry : _tagSamples) {
+            tagsBuilder.append(entry.first ? entry.first : kUntaggedName, entry.second);
+        }
+    }
+
+    void reset() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _drain_inlock();
+
+        _stacks.clear();
+        _tagSamples.clear();
+        _numDroppedStacks = 0;
+        numSamples.store(0);
+        numUnregisteredSamples.store(0);
+        numDroppedSamples.store(0);
+    }
+
+private:
+    void _unregisterThread(ThreadSampleBuffer* buffer) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _drainBuffer_inlock(buffer);
+
+        auto it = std::find_if(_buffers.begin(), _buffers.end(), [&](const auto& owned) {
+            return owned.get() == buffer;
+        });
+        invariant(it != _buffers.end());
+        _buffers.erase(it);
+    }
+
+    void _drainLoop() {
+        setThreadName("CpuSamplingProfiler");
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (!_stopRequested) {
+            _drainCV.wait_for(
+                lk, kDrainInterval.toSystemDuration(), [&] { return _stopRequested; });
+            _drain_inlock();
+        }
+    }
+
+    void _drain_inlock() {
+        for (const auto& buffer : _buffers) {
+            _drainBuffer_inlock(buffer.get());
+        }
+    }
+
+    void _drainBuffer_inlock(ThreadSampleBuffer* buffer) {
+        const auto head = buffer->head.load();
+        for (auto i = buffer->tail.load(); i != head; i++) {
+            const Sample& sample = buffer->samples[i % kSamplesPerThread];
+            _record_inlock(sample);
+        }
+        buffer->tail.store(head);
+    }
+
+    void _record_inlock(const Sample& sample) {
+        _tagSamples[sample.tag]++;
+
+        StackKey key{sample.tag,
+                     std::vector<std::uintptr_t>(sample.frames.begin(),
+                                                 sample.frames.begin() + sample.numFrames)};
+
+        auto it = _stacks.find(key);
+        if (it != _stacks.end()) {
+            it->second++;
+        } else if (_stacks.size() < kMaxStacks) {
+            _stacks.emplace(std::move(key), 1);
+        } else {
+            _numDroppedStacks++;
+        }
+    }
+
+    // Must be called with _symbolsMutex held.
+    const std::string& _symbolize_inlock(std::uintptr_t address) {
+        auto it = _symbols.find(address);
+        if (it != _symbols.end())
+            return it->second;
+
+        std::string name;
+        Dl_info dli;
+        if (dladdr(reinterpret_cast<void*>(address), &dli) && dli.dli_sname) {
+            int status;
+            char* demangled = abi::__cxa_demangle(dli.dli_sname, 0, 0, &status);
+            if (demangled) {
+                // strip off function parameters as they are very verbose and not useful
+                char* p = strchr(demangled, '(');
+                name = p ? std::string(demangled, p - demangled) : std::string(demangled);
+                free(demangled);
+            } else {
+                name = dli.dli_sname;
+            }
+        }
+
+        if (name.empty()) {
+            std::ostringstream s;
+            s << reinterpret_cast<void*>(address);
+            name = s.str();
+        }
+
+        // Semicolons separate frames in the folded format.
+        std::replace(name.begin(), name.end(), ';', ':');
+
+        return _symbols.emplace(address, std::move(name)).first->second;
+    }
+
+    // Serializes start() and stop(). Acquired before _mutex.
+    stdx::mutex _controlMutex;
+
+    // Guards the members below up to _symbolsMutex, and the registration of thread buffers.
+    stdx::mutex _mutex;
+    stdx::condition_variable _drainCV;
+
+    AtomicBool _running;
+    bool _stopRequested = false;
+    bool _handlerInstalled = false;
+    int _samplesPerSecond = 0;
+    stdx::thread _drainThread;
+
+    // Incremented every time the profiler starts running.
+    AtomicUInt64 _runId;
+
+    std::vector<std::unique_ptr<ThreadSampleBuffer>> _buffers;
+
+    stdx::unordered_map<StackKey, long long, StackKeyHasher> _stacks;
+    stdx::unordered_map<const char*, long long> _tagSamples;
+    long long _numDroppedStacks = 0;
+
+    // Guards _symbols. Never held together with _mutex.
+    stdx::mutex _symbolsMutex;
+
+    // Symbol name for each address seen, kept across resets.
+    stdx::unordered_map<std::uintptr_t, std::string> _symbols;
+};
+
+Profiler& getProfiler() {
+    static Profiler* profiler = new Profiler();
+    return *profiler;
+}
+
+}  // namespace
+
+CpuSamplingProfiler::ScopedTag::ScopedTag(const char* tag) : _previousTag(threadTag) {
+    threadTag = tag;
+    registerThread();
+}
+
+CpuSamplingProfiler::ScopedTag::~ScopedTag() {
+    threadTag = _previousTag;
+}
+
+bool CpuSamplingProfiler::isSupported() {
+    return true;
+}
+
+Status CpuSamplingProfiler::start(int samplesPerSecond) {
+    return getProfiler().start(samplesPerSecond);
+}
+
+void CpuSamplingProfiler::stop() {
+    getProfiler().stop();
+}
+
+bool CpuSamplingProfiler::isRunning() {
+    return getProfiler().isRunning();
+}
+
+void CpuSamplingProfiler::registerThread() {
+    getProfiler().registerThread();
+}
+
+std::vector<CpuSamplingProfiler::FoldedStack> CpuSamplingProfiler::getFoldedStacks() {
+    return getProfiler().getFoldedStacks();
+}
+
+void CpuSamplingProfiler::appendStats(BSONObjBuilder* builder) {
+    getProfiler().appendStats(builder);
+}
+
+void CpuSamplingProfiler::reset() {
+    getProfiler().reset();
+}
+
+}  // namespace mongo
+
+#else
+
+namespace mongo {
+
+CpuSamplingProfiler::ScopedTag::ScopedTag(const char* tag) : _previousTag(nullptr) {}
+
+CpuSamplingProfiler::ScopedTag::~ScopedTag() {}
+
+bool CpuSamplingProfiler::isSupported() {
+    return false;
+}
+
+Status CpuSamplingProfiler::start(int samplesPerSecond) {
+    return Status(ErrorCodes::IllegalOperation,
+                  "The CPU sampling profiler is not supported on this platform");
+}
+
+void CpuSamplingProfiler::stop() {}
+
+bool CpuSamplingProfiler::isRunning() {
+    return false;
+}
+
+void CpuSamplingProfiler::registerThread() {}
+
+std::vector<CpuSamplingProfiler::FoldedStack> CpuSamplingProfiler::getFoldedStacks() {
+    return {};
+}
+
+void CpuSamplingProfiler::appendStats(BSONObjBuilder* builder) {
+    builder->append("running", false);
+}
+
+void CpuSamplingProfiler::reset() {}
+
+}  // namespace mongo
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A low overhead on-CPU sampling profiler meant to be left running on production servers.
+ *
+ * While running, a process wide ITIMER_PROF timer delivers SIGPROF to the thread that is using the
+ * CPU, samplesPerSecond times for every second of CPU time. The signal handler walks the frame
+ * pointers of the interrupted thread and appends the stack, along with the thread's current tag,
+ * to a fixed size buffer that only that thread writes to. A background thread drains the buffers
+ * and counts identical stacks.
+ *
+ * Only threads that have registered own a buffer. ScopedTag registers the current thread while the
+ * profiler is running, up to a fixed number of threads, and the buffer is freed when the thread
+ * exits. Samples that land on other threads are counted but their stacks are lost.
+ *
+ * The profiler shares SIGPROF with the gperftools CPU profiler and refuses to start if another
+ * SIGPROF handler is installed.
+ */
+class CpuSamplingProfiler {
+    MONGO_DISALLOW_COPYING(CpuSamplingProfiler);
+
+public:
+    /**
+     * A stack in the folded format used by flame graph tools: the tag, then the frames from the
+     * outermost to the innermost, separated by semicolons.
+     */
+    struct FoldedStack {
+        std::string stack;
+        long long samples;
+    };
+
+    /**
+     * Tags the samples taken on this thread while in scope. Tags nest, the innermost one wins.
+     */
+    class ScopedTag {
+        MONGO_DISALLOW_COPYING(ScopedTag);
+
+    public:
+        /**
+         * tag is read from the signal handler and must stay valid for the life of the process,
+         * i.e., a string literal or the name of a Command.
+         */
+        explicit ScopedTag(const char* tag);
+        ~ScopedTag();
+
+    private:
+        const char* const _previousTag;
+    };
+
+    /**
+     * Returns true if the profiler can run on this platform.
+     */
+    static bool isSupported();
+
+    /**
+     * Starts sampling, or changes the sampling rate if already running.
+     */
+    static Status start(int samplesPerSecond);
+
+    /**
+     * Stops sampling. The collected stacks are kept until reset() is called.
+     */
+    static void stop();
+
+    static bool isRunning();
+
+    /**
+     * Gives the current thread a sample buffer so that its stacks are recorded. Does nothing if
+     * the thread is already registered or the profiler is not running.
+     */
+    static void registerThread();
+
+    /**
+     * Returns the stacks sampled since the last reset, the most frequent first.
+     */
+    static std::vector<FoldedStack> getFoldedStacks();
+
+    /**
+     * Appends sampling statistics and the number of samples for each tag.
+     */
+    static void appendStats(BSONObjBuilder* builder);
+
+    /**
+     * Discards the stacks and statistics collected so far.
+     */
+    static void reset();
+};
+
+}  // namespace mongo
@@ -0,0 +1,198 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/cpu_sampling_profiler.h"
+
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+const char kSpinTag[] = "cpuSamplingProfilerTestSpin";
+
+long long getTagSamples(StringData tag) {
+    BSONObjBuilder builder;
+    CpuSamplingProfiler::appendStats(&builder);
+    return builder.obj()["tags"].Obj()[tag].safeNumberLong();
+}
+
+TEST(CpuSamplingProfilerTest, StartRejectsInvalidRates) {
+    if (!CpuSamplingProfiler::isSupported()) {
+        ASSERT_NOT_OK(CpuSamplingProfiler::start(100));
+        return;
+    }
+
+    ASSERT_NOT_OK(CpuSamplingProfiler::start(0));
+    ASSERT_NOT_OK(CpuSamplingProfiler::start(-1));
+    ASSERT_FALSE(CpuSamplingProfiler::isRunning());
+}
+
+TEST(CpuSamplingProfilerTest, SamplesTaggedThread) {
+    if (!CpuSamplingProfiler::isSupported())
+        return;
+
+    CpuSamplingProfiler::reset();
+    ASSERT_OK(CpuSamplingProfiler::start(1000));
+    ASSERT_TRUE(CpuSamplingProfiler::isRunning());
+
+    AtomicBool done;
+    AtomicUInt64 sink;
+    stdx::thread spinner([&] {
+        CpuSamplingProfiler::ScopedTag tag(kSpinTag);
+        while (!done.load()) {
+            sink.fetchAndAdd(1);
+        }
+    });
+
+    Timer timer;
+    while (getTagSamples(kSpinTag) < 20 && timer.seconds() < 60) {
+        sleepmillis(10);
+    }
+
+    done.store(true);
+    spinner.join();
+    CpuSamplingProfiler::stop();
+    ASSERT_FALSE(CpuSamplingProfiler::isRunning());
+
+    ASSERT_GTE(getTagSamples(kSpinTag), 20);
+
+    long long spinSamples = 0;
+    for (const auto& folded : CpuSamplingProfiler::getFoldedStacks()) {
+        ASSERT_GT(folded.samples, 0);
+        if (StringData(folded.stack).startsWith(std::string(kSpinTag) + ';')) {
+            spinSamples += folded.samples;
+        }
+    }
+    ASSERT_EQ(getTagSamples(kSpinTag), spinSamples);
+
+    CpuSamplingProfiler::reset();
+    ASSERT_TRUE(CpuSamplingProfiler::getFoldedStacks().empty());
+    ASSERT_EQ(0, getTagSamples(kSpinTag));
+}
+
+TEST(CpuSamplingProfilerTest, ScopedTagsNest) {
+    if (!CpuSamplingProfiler::isSupported())
+        return;
+
+    CpuSamplingProfiler::reset();
+    ASSERT_OK(CpuSamplingProfiler::start(1000));
+
+    AtomicBool done;
+    AtomicUInt64 sink;
+    stdx::thread spinner([&] {
+        CpuSamplingProfiler::ScopedTag outer("outer");
+        {
+            CpuSamplingProfiler::ScopedTag inner(kSpinTag);
+        }
+        while (!done.load()) {
+            sink.fetchAndAdd(1);
+        }
+    });
+
+    Timer timer;
+    while (getTagSamples("outer") < 20 && timer.seconds() < 60) {
+        sleepmillis(10);
+    }
+
+    done.store(true);
+    spinner.join();
+    CpuSamplingProfiler::stop();
+
+    ASSERT_GTE(getTagSamples("outer"), 20);
+    ASSERT_EQ(0, getTagSamples(kSpinTag));
+    CpuSamplingProfiler::reset();
+}
+
+long long getNumThreads() {
+    BSONObjBuilder builder;
+    CpuSamplingProfiler::appendStats(&builder);
+    return builder.obj()["numThreads"].safeNumberLong();
+}
+
+TEST(CpuSamplingProfilerTest, ConcurrentStartAndStop) {
+    if (!CpuSamplingProfiler::isSupported())
+        return;
+
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([] {
+            for (int j = 0; j < 100; j++) {
+                ASSERT_OK(CpuSamplingProfiler::start(100));
+                CpuSamplingProfiler::stop();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_FALSE(CpuSamplingProfiler::isRunning());
+    CpuSamplingProfiler::reset();
+}
+
+TEST(CpuSamplingProfilerTest, ExitedThreadBufferFreedWhileStopped) {
+    if (!CpuSamplingProfiler::isSupported())
+        return;
+
+    const auto numThreads = getNumThreads();
+    ASSERT_OK(CpuSamplingProfiler::start(100));
+
+    AtomicBool registered;
+    AtomicBool done;
+    stdx::thread worker([&] {
+        CpuSamplingProfiler::ScopedTag tag(kSpinTag);
+        registered.store(true);
+        while (!done.load()) {
+            sleepmillis(1);
+        }
+    });
+
+    while (!registered.load()) {
+        sleepmillis(1);
+    }
+
+    CpuSamplingProfiler::stop();
+    ASSERT_EQ(numThreads + 1, getNumThreads());
+
+    done.store(true);
+    worker.join();
+    ASSERT_EQ(numThreads, getNumThreads());
+    CpuSamplingProfiler::reset();
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/thread_resource_usage.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+namespace mongo {
+namespace {
+
+#if defined(_POSIX_THREAD_CPUTIME) && _POSIX_THREAD_CPUTIME >= 0
+boost::optional<Nanoseconds> readCpuClock(clockid_t clock) {
+    struct timespec ts;
+    if (clock_gettime(clock, &ts) != 0) {
+        return boost::none;
+    }
+    return Seconds(ts.tv_sec) + Nanoseconds(ts.tv_nsec);
+}
+#endif
+
+boost::optional<long long> readBytesRead() {
+#ifdef __linux__
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0) {
+        return boost::none;
+    }
+    // Block input operations are counted in units of 512 bytes regardless of the device.
+    return static_cast<long long>(usage.ru_inblock) * 512;
+#else
+    return boost::none;
+#endif
+}
+
+}  // namespace
+
+void ThreadResourceUsage::start() {
+    _threadId = stdx::this_thread::get_id();
+
+    bool hasCpuClock = false;
+#if defined(_POSIX_THREAD_CPUTIME) && _POSIX_THREAD_CPUTIME >= 0
+    if (pthread_getcpuclockid(pthread_self(), &_cpuClock) == 0) {
+        auto cpuTime = readCpuClock(_cpuClock);
+        hasCpuClock = static_cast<bool>(cpuTime);
+        _startCpuTime = cpuTime.value_or(Nanoseconds{0});
+    }
+#endif
+
+    _startBytesRead = readBytesRead().value_or(0);
+
+    _hasCpuClock.store(hasCpuClock);
+    _started.store(true);
+}
+
+boost::optional<Nanoseconds> ThreadResourceUsage::cpuTime() const {
+    if (!_hasCpuClock.load()) {
+        return boost::none;
+    }
+
+#if defined(_POSIX_THREAD_CPUTIME) && _POSIX_THREAD_CPUTIME >= 0
+    if (auto cpuTime = readCpuClock(_cpuClock)) {
+        return *cpuTime - _startCpuTime;
+    }
+#endif
+    return boost::none;
+}
+
+boost::optional<long long> ThreadResourceUsage::bytesRead() const {
+    if (!_started.load() || _threadId != stdx::this_thread::get_id()) {
+        return boost::none;
+    }
+
+    if (auto bytesRead = readBytesRead()) {
+        return *bytesRead - _startBytesRead;
+    }
+    return boost::none;
+}
+
+}  // namespace mongo
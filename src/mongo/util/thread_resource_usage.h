@@ -0,0 +1,90 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Measures the resources one thread consumes while running an operation: the CPU time it uses and
+ * the number of bytes it causes to be read from block devices, i.e. reads which were not served
+ * from the file system cache.
+ *
+ * start() must be called once, on the thread to be measured. Other threads, such as those running
+ * currentOp, may call isStarted() and cpuTime() concurrently with it. Platforms which cannot
+ * provide a counter return boost::none for it.
+ */
+class ThreadResourceUsage {
+public:
+    /**
+     * Binds to the calling thread and records its current counters as the starting point.
+     */
+    void start();
+
+    bool isStarted() const {
+        return _started.load();
+    }
+
+    /**
+     * Returns the CPU time the bound thread has used since start(). May be called from any thread
+     * as long as the bound thread is still running.
+     */
+    boost::optional<Nanoseconds> cpuTime() const;
+
+    /**
+     * Returns the number of bytes the bound thread has read from disk since start(). Only
+     * available when called on the bound thread.
+     */
+    boost::optional<long long> bytesRead() const;
+
+private:
+    // Set last by start(), so that a thread which sees them set also sees the fields below.
+    AtomicBool _started;
+    AtomicBool _hasCpuClock;
+
+    stdx::thread::id _threadId;
+
+#ifndef _WIN32
+    clockid_t _cpuClock;
+#endif
+
+    Nanoseconds _startCpuTime{0};
+    long long _startBytesRead = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/thread_resource_usage.h"
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+TEST(ThreadResourceUsage, NotStartedReportsNothing) {
+    ThreadResourceUsage usage;
+    ASSERT_FALSE(usage.isStarted());
+    ASSERT_FALSE(usage.cpuTime());
+    ASSERT_FALSE(usage.bytesRead());
+}
+
+TEST(ThreadResourceUsage, CpuTimeAdvancesWhileBusy) {
+    ThreadResourceUsage usage;
+    usage.start();
+    ASSERT_TRUE(usage.isStarted());
+
+    auto before = usage.cpuTime();
+    if (!before) {
+        return;  // Not supported on this platform.
+    }
+
+    Timer timer;
+    volatile unsigned long long sink = 0;
+    while (timer.millis() < 20) {
+        sink = sink + 1;
+    }
+
+    auto after = usage.cpuTime();
+    ASSERT_TRUE(after);
+    ASSERT_GREATER_THAN(*after, *before);
+}
+
+TEST(ThreadResourceUsage, CpuTimeIsReadableFromAnotherThread) {
+    ThreadResourceUsage usage;
+    usage.start();
+    if (!usage.cpuTime()) {
+        return;  // Not supported on this platform.
+    }
+
+    boost::optional<Nanoseconds> fromOtherThread;
+    stdx::thread reader([&] { fromOtherThread = usage.cpuTime(); });
+    reader.join();
+
+    ASSERT_TRUE(fromOtherThread);
+    ASSERT_GREATER_THAN_OR_EQUALS(*fromOtherThread, Nanoseconds{0});
+}
+
+TEST(ThreadResourceUsage, BytesReadIsOnlyAvailableOnTheBoundThread) {
+    ThreadResourceUsage usage;
+    usage.start();
+    if (!usage.bytesRead()) {
+        return;  // Not supported on this platform.
+    }
+
+    ASSERT_GREATER_THAN_OR_EQUALS(*usage.bytesRead(), 0);
+
+    boost::optional<long long> fromOtherThread{0};
+    stdx::thread reader([&] { fromOtherThread = usage.bytesRead(); });
+    reader.join();
+    ASSERT_FALSE(fromOtherThread);
+}
+
+TEST(ThreadResourceUsage, SleepingDoesNotUseCpuTime) {
+    ThreadResourceUsage usage;
+    usage.start();
+    if (!usage.cpuTime()) {
+        return;  // Not supported on this platform.
+    }
+
+    sleepmillis(50);
+    ASSERT_LESS_THAN(*usage.cpuTime(), Milliseconds{40});
+}
+
+}  // namespace
+}  // namespace mongo